@@ -0,0 +1,294 @@
+/**
+ * @file bench_golden.c
+ * @brief Golden matrix rendering and PNG comparison
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_golden.h"
+#include "bench_host.h"
+#include "bench_png.h"
+#include "drawing/drawing_render_core.h"
+#include "drawing/drawing_text_stb.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_effect_cache.h"
+#include "color/gradient.h"
+
+#define GOLDEN_CLOCK_TEXT L"12:34:56"
+#define GOLDEN_MARKDOWN_TEXT L"# 12:34\n**05:06** *07:08*\n> 09:10\n<color:#FF5F6D_#FFC371_#47CF73>23:59</color>"
+#define GOLDEN_CUSTOM_GRADIENT "#FF5F6D_#FFC371_#47CF73"
+#define GOLDEN_TEXT_COLOR RGB(255, 200, 80)
+
+/** Second clock value: mid-cycle for the 2 s gradient loop */
+#define GOLDEN_ANIMATED_TIME 1250
+
+/* Fonts embedded by resource/resource.rc, relative to asset/font */
+static const char* const GOLDEN_FONTS[] = {
+    "MIT/ProFontWindows Essence.ttf",
+    "SIL/DepartureMono Essence.otf",
+    "SIL/DaddyTimeMono Essence.otf",
+    "SIL/Rec Mono Casual Essence.ttf",
+    "SIL/Terminess Nerd Font Essence.ttf",
+    "OFL/Jacquard 12 Essence.ttf",
+    "OFL/Jacquarda Bastarda 9 Essence.ttf",
+    "OFL/Pixelify Sans Essence.ttf",
+    "OFL/Rubik Burned Essence.ttf",
+    "OFL/Rubik Glitch Essence.ttf",
+    "OFL/Rubik Marker Hatch Essence.ttf",
+    "OFL/Rubik Puddles Essence.ttf",
+    "OFL/Wallpoet Essence.ttf",
+};
+
+/** Font used for the effect and gradient cases */
+#define GOLDEN_EFFECT_FONT "OFL/Rubik Burned Essence.ttf"
+
+static const int GOLDEN_FONT_SIZES[] = { 28, 72 };
+#define GOLDEN_MARKDOWN_SIZE 48
+
+static const struct {
+    const char* name;
+    EffectType type;
+} GOLDEN_EFFECTS[] = {
+    { "none",        EFFECT_TYPE_NONE },
+    { "glow",        EFFECT_TYPE_GLOW },
+    { "glass",       EFFECT_TYPE_GLASS },
+    { "neon",        EFFECT_TYPE_NEON },
+    { "holographic", EFFECT_TYPE_HOLOGRAPHIC },
+    { "liquid",      EFFECT_TYPE_LIQUID },
+};
+
+static const struct {
+    const char* name;
+    GradientType type;
+} GOLDEN_GRADIENTS[] = {
+    { "solid",    GRADIENT_NONE },
+    { "candy",    GRADIENT_CANDY },
+    { "breeze",   GRADIENT_BREEZE },
+    { "sunset",   GRADIENT_SUNSET },
+    { "streamer", GRADIENT_STREAMER },
+    { "custom",   GRADIENT_CUSTOM },
+};
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+typedef struct {
+    const char* goldenDir;
+    BOOL write;
+    int tolerance;
+    int cases;
+    int failures;
+} GoldenRun;
+
+/* ============================================================================
+ * Rendering
+ * ============================================================================ */
+
+/** Premultiplied BGRA -> straight RGBA, as stored in the PNGs */
+static void ToStraightRGBA(const DWORD* bits, unsigned char* rgba, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++) {
+        DWORD p = bits[i];
+        unsigned int a = p >> 24;
+        unsigned char* out = rgba + i * 4;
+        if (a == 0) {
+            out[0] = out[1] = out[2] = out[3] = 0;
+            continue;
+        }
+        unsigned int r = (p >> 16) & 0xFF, g = (p >> 8) & 0xFF, b = p & 0xFF;
+        r = (r * 255 + a / 2) / a;
+        g = (g * 255 + a / 2) / a;
+        b = (b * 255 + a / 2) / a;
+        out[0] = (unsigned char)(r > 255 ? 255 : r);
+        out[1] = (unsigned char)(g > 255 ? 255 : g);
+        out[2] = (unsigned char)(b > 255 ? 255 : b);
+        out[3] = (unsigned char)a;
+    }
+}
+
+static BOOL RenderCase(const wchar_t* text, int fontSize, GradientType gradient,
+                       EffectType effect, DWORD timeMs,
+                       unsigned char** rgba, int* width, int* height) {
+    RenderCoreDocument doc;
+    RenderCore_Parse(text, &doc);
+
+    int w = 0, h = 0;
+    DWORD* bits = NULL;
+    BOOL ok = RenderCore_Measure(&doc, fontSize, &w, &h) && w > 0 && h > 0;
+    if (ok) {
+        bits = (DWORD*)calloc((size_t)w * (size_t)h, sizeof(DWORD));
+        *rgba = (unsigned char*)malloc((size_t)w * (size_t)h * 4);
+        ok = bits && *rgba;
+    }
+
+    if (ok) {
+        RenderCoreStyle style;
+        style.textColor = GOLDEN_TEXT_COLOR;
+        style.gradientMode = gradient;
+        style.fontSize = fontSize;
+
+        BenchHost_SetEffect(effect);
+        RenderCore_PinTime(TRUE, timeMs);
+        EffectCache_Clear();
+        RenderCore_Draw(&doc, &style, bits, w, h);
+        RenderCore_PinTime(FALSE, 0);
+        BenchHost_SetEffect(EFFECT_TYPE_NONE);
+
+        ToStraightRGBA(bits, *rgba, (size_t)w * (size_t)h);
+        *width = w;
+        *height = h;
+    } else {
+        free(*rgba);
+        *rgba = NULL;
+    }
+
+    free(bits);
+    RenderCore_FreeDocument(&doc);
+    return ok;
+}
+
+/* ============================================================================
+ * Compare / write
+ * ============================================================================ */
+
+static void CheckCase(GoldenRun* run, const char* caseName, const wchar_t* text, int fontSize,
+                      GradientType gradient, EffectType effect, DWORD timeMs) {
+    char path[MAX_PATH * 2];
+    snprintf(path, sizeof(path), "%s/%s.png", run->goldenDir, caseName);
+    run->cases++;
+
+    unsigned char* actual = NULL;
+    int w = 0, h = 0;
+    if (!RenderCase(text, fontSize, gradient, effect, timeMs, &actual, &w, &h)) {
+        fprintf(stderr, "FAIL %s: render failed\n", caseName);
+        run->failures++;
+        return;
+    }
+
+    if (run->write) {
+        if (!BenchPng_Write(path, actual, w, h)) {
+            fprintf(stderr, "FAIL %s: cannot write %s\n", caseName, path);
+            run->failures++;
+        }
+        free(actual);
+        return;
+    }
+
+    unsigned char* expected = NULL;
+    int ew = 0, eh = 0;
+    if (!BenchPng_Read(path, &expected, &ew, &eh)) {
+        fprintf(stderr, "FAIL %s: missing or unreadable golden %s\n", caseName, path);
+        run->failures++;
+    } else if (ew != w || eh != h) {
+        fprintf(stderr, "FAIL %s: size %dx%d, golden %dx%d\n", caseName, w, h, ew, eh);
+        run->failures++;
+    } else {
+        int maxDiff = 0;
+        size_t badPixels = 0;
+        size_t pixels = (size_t)w * (size_t)h;
+        for (size_t i = 0; i < pixels; i++) {
+            int worst = 0;
+            for (int c = 0; c < 4; c++) {
+                int d = abs((int)actual[i * 4 + c] - (int)expected[i * 4 + c]);
+                if (d > worst) worst = d;
+            }
+            if (worst > maxDiff) maxDiff = worst;
+            if (worst > run->tolerance) badPixels++;
+        }
+        if (badPixels > 0) {
+            fprintf(stderr, "FAIL %s: %zu of %zu pixels differ by more than %d (max %d)\n",
+                    caseName, badPixels, pixels, run->tolerance, maxDiff);
+            run->failures++;
+        }
+    }
+
+    free(expected);
+    free(actual);
+}
+
+static void Slug(const char* in, char* out, size_t size) {
+    size_t n = 0;
+    const char* base = strrchr(in, '/');
+    base = base ? base + 1 : in;
+    for (const char* p = base; *p && *p != '.' && n + 1 < size; p++) {
+        out[n++] = isalnum((unsigned char)*p) ? (char)tolower((unsigned char)*p) : '-';
+    }
+    out[n] = '\0';
+}
+
+int BenchGolden_Run(const char* fontDir, const char* goldenDir, BOOL write, int tolerance) {
+    GoldenRun run = { goldenDir, write, tolerance, 0, 0 };
+    char fontPath[MAX_PATH * 2];
+    char caseName[160];
+    char fontSlug[64];
+
+    /* One clear message instead of a failure per case; writing creates the leaf directory */
+    DWORD attributes = GetFileAttributesA(goldenDir);
+    if (attributes == INVALID_FILE_ATTRIBUTES && write && CreateDirectoryA(goldenDir, NULL)) {
+        attributes = FILE_ATTRIBUTE_DIRECTORY;
+    }
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        fprintf(stderr, "catime_bench: golden directory not found: %s\n", goldenDir);
+        return -1;
+    }
+
+    GetGradientTypeByName(GOLDEN_CUSTOM_GRADIENT);
+    SetEffectQualityFloor(EFFECT_QUALITY_FULL);
+    SetEffectQuality(EFFECT_QUALITY_FULL);
+
+    /* Font coverage: plain text, no effect */
+    for (int f = 0; f < COUNT_OF(GOLDEN_FONTS); f++) {
+        snprintf(fontPath, sizeof(fontPath), "%s/%s", fontDir, GOLDEN_FONTS[f]);
+        Slug(GOLDEN_FONTS[f], fontSlug, sizeof(fontSlug));
+        if (!InitFontSTB(fontPath)) {
+            fprintf(stderr, "FAIL font-%s: cannot load %s\n", fontSlug, fontPath);
+            run.cases++;
+            run.failures++;
+            continue;
+        }
+        for (int s = 0; s < COUNT_OF(GOLDEN_FONT_SIZES); s++) {
+            snprintf(caseName, sizeof(caseName), "font-%s-px%d", fontSlug, GOLDEN_FONT_SIZES[s]);
+            CheckCase(&run, caseName, GOLDEN_CLOCK_TEXT, GOLDEN_FONT_SIZES[s],
+                      GRADIENT_NONE, EFFECT_TYPE_NONE, 0);
+        }
+    }
+
+    snprintf(fontPath, sizeof(fontPath), "%s/%s", fontDir, GOLDEN_EFFECT_FONT);
+    if (!InitFontSTB(fontPath)) {
+        fprintf(stderr, "catime_bench: cannot load %s\n", fontPath);
+        return -1;
+    }
+
+    /* Effects x gradients */
+    for (int e = 0; e < COUNT_OF(GOLDEN_EFFECTS); e++) {
+        for (int g = 0; g < COUNT_OF(GOLDEN_GRADIENTS); g++) {
+            BOOL animated = IsEffectTimeDependent(GOLDEN_EFFECTS[e].type) ||
+                            IsGradientAnimated(GOLDEN_GRADIENTS[g].type);
+            for (int s = 0; s < COUNT_OF(GOLDEN_FONT_SIZES); s++) {
+                for (int t = 0; t <= (animated ? 1 : 0); t++) {
+                    DWORD timeMs = t ? GOLDEN_ANIMATED_TIME : 0;
+                    snprintf(caseName, sizeof(caseName), "effect-%s-%s-px%d-t%lu",
+                             GOLDEN_EFFECTS[e].name, GOLDEN_GRADIENTS[g].name,
+                             GOLDEN_FONT_SIZES[s], (unsigned long)timeMs);
+                    CheckCase(&run, caseName, GOLDEN_CLOCK_TEXT, GOLDEN_FONT_SIZES[s],
+                              GOLDEN_GRADIENTS[g].type, GOLDEN_EFFECTS[e].type, timeMs);
+                }
+            }
+        }
+    }
+
+    /* Markdown layout and color-tag gradients under each effect */
+    for (int e = 0; e < COUNT_OF(GOLDEN_EFFECTS); e++) {
+        for (int t = 0; t <= 1; t++) {
+            DWORD timeMs = t ? GOLDEN_ANIMATED_TIME : 0;
+            snprintf(caseName, sizeof(caseName), "markdown-%s-px%d-t%lu",
+                     GOLDEN_EFFECTS[e].name, GOLDEN_MARKDOWN_SIZE, (unsigned long)timeMs);
+            CheckCase(&run, caseName, GOLDEN_MARKDOWN_TEXT, GOLDEN_MARKDOWN_SIZE,
+                      GRADIENT_NONE, GOLDEN_EFFECTS[e].type, timeMs);
+        }
+    }
+
+    fprintf(stderr, "Golden %s: %d case(s), %d failure(s)\n",
+            write ? "write" : "check", run.cases, run.failures);
+    return run.failures;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file bench_golden.h
+ * @brief Golden-image check of the render core
+ *
+ * Renders a fixed matrix with the animation clock pinned:
+ * - every embedded font at two sizes, plain text
+ * - every effect x every gradient x two sizes at two clock values
+ *   (the second only where the effect or gradient animates)
+ * - a markdown sample with color tags under every effect
+ * Each case is one PNG named after the case in the golden directory.
+ *
+ * The checked-in sets were rendered before the optimizations they guard:
+ * - bench/golden: cases without an effect from the original tree, effect
+ *   cases from the first per-run effect pipeline, which deliberately
+ *   changed how glows meet across glyphs; every later rewrite must match
+ * - bench/golden-sdf: the distance field atlas as it was introduced
+ * Regenerate them with --write-golden only for an intended visual change.
+ */
+
+#ifndef BENCH_GOLDEN_H
+#define BENCH_GOLDEN_H
+
+#include <windows.h>
+
+/** @brief Default largest per-channel difference still accepted */
+#define BENCH_GOLDEN_DEFAULT_TOLERANCE 2
+
+/**
+ * @brief Render the matrix and write or compare golden PNGs
+ * @param fontDir Directory holding the MIT/SIL/OFL font folders
+ * @param goldenDir Directory of golden PNGs (created when writing if its parent exists)
+ * @param write TRUE regenerates the goldens instead of comparing
+ * @param tolerance Largest per-channel difference that still passes
+ * @return Number of failed cases, or -1 if the directory is missing or nothing could be rendered
+ */
+int BenchGolden_Run(const char* fontDir, const char* goldenDir, BOOL write, int tolerance);
+
+#endif /* BENCH_GOLDEN_H */
@@ -0,0 +1,34 @@
+/**
+ * @file bench_host.c
+ * @brief Stand-ins for menu_preview.c and log_core.c
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "bench_host.h"
+#include "log.h"
+
+static EffectType g_effect = EFFECT_TYPE_NONE;
+static BOOL g_verbose = FALSE;
+
+void BenchHost_SetEffect(EffectType effect) {
+    g_effect = effect;
+}
+
+void BenchHost_SetVerbose(BOOL verbose) {
+    g_verbose = verbose;
+}
+
+EffectType GetActiveEffect(void) {
+    return g_effect;
+}
+
+void WriteLog(LogLevel level, const char* format, ...) {
+    if (!g_verbose && level < LOG_LEVEL_WARNING) return;
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
@@ -0,0 +1,26 @@
+/**
+ * @file bench_host.h
+ * @brief App-side symbols the render core expects, supplied by catime_bench
+ *
+ * In the app, GetActiveEffect() and WriteLog() come from menu_preview.c and
+ * log_core.c, which pull in the window, tray and config layers. The bench
+ * replaces them with these minimal versions.
+ */
+
+#ifndef BENCH_HOST_H
+#define BENCH_HOST_H
+
+#include <windows.h>
+#include "menu_preview.h"
+
+/**
+ * @brief Effect returned by GetActiveEffect() from now on
+ */
+void BenchHost_SetEffect(EffectType effect);
+
+/**
+ * @brief Print core log lines to stderr (default: silent)
+ */
+void BenchHost_SetVerbose(BOOL verbose);
+
+#endif /* BENCH_HOST_H */
@@ -0,0 +1,236 @@
+/**
+ * @file bench_markdown.c
+ * @brief Generated markdown inputs: fuzz checks and the throughput document
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_markdown.h"
+#include "markdown/markdown_parser.h"
+
+#define FUZZ_MAX_CHARS 2048
+#define FUZZ_MAX_PIECES 48
+
+/* Pieces of every construct, including broken and unterminated ones */
+static const wchar_t* const FUZZ_PIECES[] = {
+    L"<md>", L"</md>", L"\n", L"\r\n", L" ", L"  ", L"abc", L"12:34", L"\xFEFF", L"\x4E2D\x6587",
+    L"# ", L"## ", L"###### ", L"#", L"---", L"***", L"* * *",
+    L"- ", L"-", L"+ ", L"* ", L"1. ", L"05. ", L"- [ ] ", L"- [x] ", L"- [X]",
+    L"> ", L">", L">>", L"> [!NOTE]", L"> [!TIP] ", L"> [!WARNING]\n", L"[!CAUTION]",
+    L"*", L"**", L"***", L"_", L"__", L"~~", L"`", L"```", L"```c\n",
+    L"[", L"]", L"(", L")", L"[link", L"](https://example.com", L" \"title\"", L"'", L"\\", L"\\*",
+    L"<color:#FF0000>", L"<color:#00ff00_#0000FF>", L"<color:#", L"<color:>", L"</color>",
+    L"<font:Arial>", L"<font: Segoe UI >", L"<font:", L"</font>", L"<", L">",
+};
+
+static unsigned int g_fuzzState = 1;
+
+static unsigned int FuzzNext(void) {
+    /* xorshift32 */
+    g_fuzzState ^= g_fuzzState << 13;
+    g_fuzzState ^= g_fuzzState >> 17;
+    g_fuzzState ^= g_fuzzState << 5;
+    return g_fuzzState;
+}
+
+static int GenerateInput(wchar_t* out, int capacity) {
+    int length = 0;
+    int pieces = (int)(FuzzNext() % FUZZ_MAX_PIECES);
+    int pieceCount = (int)(sizeof(FUZZ_PIECES) / sizeof(FUZZ_PIECES[0]));
+
+    for (int i = 0; i < pieces; i++) {
+        if (FuzzNext() % 8 == 0) {
+            /* Any printable BMP character, or a control character */
+            unsigned int r = FuzzNext();
+            wchar_t c = (r & 1) ? (wchar_t)(0x20 + (r >> 1) % 0x5F) : (wchar_t)(1 + (r >> 1) % 0xD7FE);
+            if (length < capacity - 1) out[length++] = c;
+            continue;
+        }
+        const wchar_t* piece = FUZZ_PIECES[FuzzNext() % (unsigned int)pieceCount];
+        while (*piece && length < capacity - 1) out[length++] = *piece++;
+    }
+    out[length] = L'\0';
+    return length;
+}
+
+static void PrintInput(const wchar_t* input) {
+    fprintf(stderr, "  input: \"");
+    for (const wchar_t* p = input; *p; p++) {
+        if (*p >= 0x20 && *p < 0x7F && *p != L'"' && *p != L'\\') fputc((int)*p, stderr);
+        else fprintf(stderr, "\\u%04X", (unsigned int)*p);
+    }
+    fprintf(stderr, "\"\n");
+}
+
+#define CHECK_SPANS(array, count, textLength) \
+    for (int i = 0; i < (count); i++) { \
+        if ((array)[i].startPos < 0 || (array)[i].startPos > (array)[i].endPos || \
+            (array)[i].endPos > (textLength)) return #array " span outside the display text"; \
+    }
+
+/** @return NULL if the document is consistent, otherwise what is wrong */
+static const char* CheckDocument(const wchar_t* input, const MarkdownDocument* doc) {
+    if (!doc->displayText) return "no display text";
+    int inputLength = (int)wcslen(input);
+    int textLength = (int)wcslen(doc->displayText);
+    if (textLength > inputLength * 2) return "display text more than twice the input";
+
+    CHECK_SPANS(doc->links, doc->linkCount, textLength);
+    CHECK_SPANS(doc->headings, doc->headingCount, textLength);
+    CHECK_SPANS(doc->styles, doc->styleCount, textLength);
+    CHECK_SPANS(doc->listItems, doc->listItemCount, textLength);
+    CHECK_SPANS(doc->blockquotes, doc->blockquoteCount, textLength);
+    CHECK_SPANS(doc->colorTags, doc->colorTagCount, textLength);
+    CHECK_SPANS(doc->fontTags, doc->fontTagCount, textLength);
+
+    for (int i = 0; i < doc->linkCount; i++) {
+        if (!doc->links[i].linkText || !doc->links[i].linkUrl) return "link without text or URL";
+    }
+    for (int i = 0; i < doc->colorTagCount; i++) {
+        if (doc->colorTags[i].colorCount < 1 || doc->colorTags[i].colorCount > MAX_COLOR_TAG_COLORS) {
+            return "color tag color count out of range";
+        }
+    }
+    for (int i = 0; i < doc->headingCount; i++) {
+        if (doc->headings[i].level < 1 || doc->headings[i].level > 6) return "heading level out of range";
+    }
+    return NULL;
+}
+
+/** @return NULL if ParseMarkdownLinks agrees with the document */
+static const char* CheckLegacy(const wchar_t* input, const MarkdownDocument* doc) {
+    wchar_t* text;
+    MarkdownLink* links; int linkCount;
+    MarkdownHeading* headings; int headingCount;
+    MarkdownStyle* styles; int styleCount;
+    MarkdownListItem* listItems; int listItemCount;
+    MarkdownBlockquote* blockquotes; int blockquoteCount;
+    MarkdownColorTag* colorTags; int colorTagCount;
+    MarkdownFontTag* fontTags; int fontTagCount;
+
+    if (!ParseMarkdownLinks(input, &text, &links, &linkCount, &headings, &headingCount,
+                            &styles, &styleCount, &listItems, &listItemCount,
+                            &blockquotes, &blockquoteCount, &colorTags, &colorTagCount,
+                            &fontTags, &fontTagCount)) {
+        return "ParseMarkdownLinks failed";
+    }
+
+    const char* problem = NULL;
+    if (wcscmp(text, doc->displayText) != 0) {
+        problem = "ParseMarkdownLinks text differs";
+    } else if (linkCount != doc->linkCount || headingCount != doc->headingCount ||
+               styleCount != doc->styleCount || listItemCount != doc->listItemCount ||
+               blockquoteCount != doc->blockquoteCount || colorTagCount != doc->colorTagCount ||
+               fontTagCount != doc->fontTagCount) {
+        problem = "ParseMarkdownLinks element counts differ";
+    } else if ((headingCount && memcmp(headings, doc->headings, headingCount * sizeof(*headings))) ||
+               (styleCount && memcmp(styles, doc->styles, styleCount * sizeof(*styles))) ||
+               (listItemCount && memcmp(listItems, doc->listItems, listItemCount * sizeof(*listItems))) ||
+               (blockquoteCount && memcmp(blockquotes, doc->blockquotes, blockquoteCount * sizeof(*blockquotes)))) {
+        problem = "ParseMarkdownLinks elements differ";
+    } else {
+        /* Unused colors and the bytes after a font name are not part of the result */
+        for (int i = 0; i < colorTagCount && !problem; i++) {
+            const MarkdownColorTag* a = &colorTags[i];
+            const MarkdownColorTag* b = &doc->colorTags[i];
+            if (a->startPos != b->startPos || a->endPos != b->endPos || a->colorCount != b->colorCount ||
+                memcmp(a->colors, b->colors, (size_t)a->colorCount * sizeof(COLORREF)) != 0) {
+                problem = "ParseMarkdownLinks color tags differ";
+            }
+        }
+        for (int i = 0; i < fontTagCount && !problem; i++) {
+            if (fontTags[i].startPos != doc->fontTags[i].startPos || fontTags[i].endPos != doc->fontTags[i].endPos ||
+                wcscmp(fontTags[i].fontName, doc->fontTags[i].fontName) != 0) {
+                problem = "ParseMarkdownLinks font tags differ";
+            }
+        }
+        for (int i = 0; i < linkCount && !problem; i++) {
+            if (links[i].startPos != doc->links[i].startPos || links[i].endPos != doc->links[i].endPos ||
+                wcscmp(links[i].linkText, doc->links[i].linkText) != 0 ||
+                wcscmp(links[i].linkUrl, doc->links[i].linkUrl) != 0) {
+                problem = "ParseMarkdownLinks links differ";
+            }
+        }
+    }
+
+    FreeMarkdownLinks(links, linkCount);
+    free(headings);
+    free(styles);
+    free(listItems);
+    free(blockquotes);
+    free(colorTags);
+    free(fontTags);
+    free(text);
+    return problem;
+}
+
+int BenchMarkdown_Fuzz(unsigned int seed, int cases) {
+    static wchar_t input[FUZZ_MAX_CHARS];
+    g_fuzzState = seed ? seed : 1;
+    int failures = 0;
+
+    for (int n = 0; n < cases; n++) {
+        GenerateInput(input, FUZZ_MAX_CHARS);
+
+        MarkdownDocument doc;
+        BOOL parsed = ParseMarkdownDocument(input, &doc);
+        const char* problem = NULL;
+        if (parsed) {
+            problem = CheckDocument(input, &doc);
+            if (!problem) problem = CheckLegacy(input, &doc);
+        } else if (input[0] != L'\0' && !(input[0] == 0xFEFF && input[1] == L'\0')) {
+            problem = "parse failed on non-empty input";
+        }
+        FreeMarkdownDocument(&doc);
+
+        if (problem) {
+            failures++;
+            fprintf(stderr, "Fuzz case %d: %s\n", n, problem);
+            PrintInput(input);
+        }
+    }
+
+    fprintf(stderr, "Markdown fuzz: %d case(s), seed %u, %d failure(s)\n", cases, seed, failures);
+    return failures;
+}
+
+/* One block of everything a plugin document tends to contain */
+static const wchar_t BENCH_DOCUMENT_BLOCK[] =
+    L"# Status 12:34:56\n"
+    L"Build **passed** in *42 s*, see [the log](https://example.com/log/42).\n"
+    L"- [x] fetch ~~old~~ sources\n"
+    L"- [ ] deploy `release` build\n"
+    L"  - nested item with __bold__ text\n"
+    L"1. first\n"
+    L"2. second\n"
+    L"> [!NOTE]\n"
+    L"> Queue is <color:#47CF73>healthy</color>, latency <font:Consolas>12 ms</font>\n"
+    L"> plain quote with ***emphasis***\n"
+    L"---\n"
+    L"Plain paragraph text that only has to be copied to the display text.\n\n";
+
+wchar_t* BenchMarkdown_BuildDocument(int chars) {
+    static const wchar_t open[] = L"<md>\n";
+    static const wchar_t close[] = L"\n</md>";
+    int openLength = (int)wcslen(open);
+    int closeLength = (int)wcslen(close);
+    int blockLength = (int)wcslen(BENCH_DOCUMENT_BLOCK);
+    if (chars < openLength + closeLength) return NULL;
+
+    wchar_t* doc = (wchar_t*)malloc(((size_t)chars + 1) * sizeof(wchar_t));
+    if (!doc) return NULL;
+
+    wmemcpy(doc, open, (size_t)openLength);
+    int length = openLength;
+    int body = chars - closeLength;
+    while (length + blockLength <= body) {
+        wmemcpy(doc + length, BENCH_DOCUMENT_BLOCK, (size_t)blockLength);
+        length += blockLength;
+    }
+    /* Pad to the exact size with plain text */
+    while (length < body) doc[length++] = L'x';
+    wmemcpy(doc + length, close, (size_t)closeLength);
+    doc[chars] = L'\0';
+    return doc;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file bench_markdown.h
+ * @brief Markdown parser fuzzing and throughput input for catime_bench
+ *
+ * The fuzz mode feeds generated markup (fragments of every construct the
+ * parser knows, mixed with random characters) to ParseMarkdownDocument
+ * and checks each result:
+ * - display text no longer than twice the input
+ * - every element span inside the display text, start <= end
+ * - link strings present, color tags with 1..MAX_COLOR_TAG_COLORS colors
+ * - ParseMarkdownLinks returns the same text and elements
+ * Build with -fsanitize=address,undefined to catch memory errors as well.
+ */
+
+#ifndef BENCH_MARKDOWN_H
+#define BENCH_MARKDOWN_H
+
+#include <windows.h>
+
+/** @brief Size of the throughput document in characters (1 MB as UTF-8) */
+#define BENCH_MARKDOWN_DOCUMENT_CHARS (1024 * 1024)
+
+/**
+ * @brief Parse generated inputs and check every result
+ * @param seed Generator seed; the same seed replays the same inputs
+ * @param cases Number of inputs
+ * @return Number of failing inputs (each is printed to stderr)
+ */
+int BenchMarkdown_Fuzz(unsigned int seed, int cases);
+
+/**
+ * @brief Build a plugin-style <md> document of mixed markdown
+ * @param chars Document length in characters, excluding the terminator
+ * @return Document to free(), or NULL on allocation failure
+ */
+wchar_t* BenchMarkdown_BuildDocument(int chars);
+
+#endif /* BENCH_MARKDOWN_H */
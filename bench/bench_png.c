@@ -0,0 +1,503 @@
+/**
+ * @file bench_png.c
+ * @brief Fixed-Huffman deflate PNG writer and matching reader
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_png.h"
+
+/* LZ77 window and match search (deflate limits: 32 KB back, 3-258 bytes) */
+#define LZ_WINDOW 32768
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH 258
+#define LZ_HASH_BITS 15
+#define LZ_MAX_CHAIN 32
+
+static const unsigned short LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const unsigned char LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const unsigned short DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const unsigned char DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static DWORD g_crcTable[256];
+static BOOL g_crcReady = FALSE;
+
+static DWORD Crc32(DWORD crc, const unsigned char* data, size_t size) {
+    if (!g_crcReady) {
+        for (DWORD n = 0; n < 256; n++) {
+            DWORD c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            g_crcTable[n] = c;
+        }
+        g_crcReady = TRUE;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = g_crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static DWORD Adler32(const unsigned char* data, size_t size) {
+    DWORD a = 1, b = 0;
+    for (size_t i = 0; i < size; i++) {
+        a = (a + data[i]) % 65521u;
+        b = (b + a) % 65521u;
+    }
+    return (b << 16) | a;
+}
+
+static void PutBE32(unsigned char* p, DWORD v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static DWORD GetBE32(const unsigned char* p) {
+    return ((DWORD)p[0] << 24) | ((DWORD)p[1] << 16) | ((DWORD)p[2] << 8) | p[3];
+}
+
+static BOOL WriteChunk(FILE* f, const char* type, const unsigned char* data, size_t size) {
+    unsigned char header[8];
+    PutBE32(header, (DWORD)size);
+    memcpy(header + 4, type, 4);
+
+    DWORD crc = Crc32(0, header + 4, 4);
+    if (size) crc = Crc32(crc, data, size);
+    unsigned char trailer[4];
+    PutBE32(trailer, crc);
+
+    return fwrite(header, 1, 8, f) == 8 &&
+           (size == 0 || fwrite(data, 1, size, f) == size) &&
+           fwrite(trailer, 1, 4, f) == 4;
+}
+
+/* ============================================================================
+ * Row filters
+ * ============================================================================ */
+
+static int Paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return (pb <= pc) ? b : c;
+}
+
+/** Filter one row with type @p type; @p prev is NULL for the first row */
+static void FilterRow(int type, const unsigned char* row, const unsigned char* prev,
+                      size_t stride, unsigned char* out) {
+    for (size_t i = 0; i < stride; i++) {
+        int a = (i >= 4) ? row[i - 4] : 0;
+        int b = prev ? prev[i] : 0;
+        int c = (prev && i >= 4) ? prev[i - 4] : 0;
+        int predicted = 0;
+        switch (type) {
+            case 1: predicted = a; break;
+            case 2: predicted = b; break;
+            case 3: predicted = (a + b) >> 1; break;
+            case 4: predicted = Paeth(a, b, c); break;
+        }
+        out[i] = (unsigned char)(row[i] - predicted);
+    }
+}
+
+/* ============================================================================
+ * Deflate (one fixed-Huffman block)
+ * ============================================================================ */
+
+typedef struct {
+    unsigned char* out;
+    size_t pos;
+    DWORD bits;
+    int count;
+} BitWriter;
+
+/** Append @p n bits, least significant first (deflate's order for everything but codes) */
+static void PutBits(BitWriter* w, DWORD value, int n) {
+    w->bits |= value << w->count;
+    w->count += n;
+    while (w->count >= 8) {
+        w->out[w->pos++] = (unsigned char)w->bits;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+/** Append a Huffman code, which deflate stores most significant bit first */
+static void PutCode(BitWriter* w, DWORD code, int n) {
+    DWORD reversed = 0;
+    for (int i = 0; i < n; i++) reversed |= ((code >> i) & 1) << (n - 1 - i);
+    PutBits(w, reversed, n);
+}
+
+/** Fixed literal/length code (RFC 1951 3.2.6) */
+static void PutSymbol(BitWriter* w, int symbol) {
+    if (symbol < 144) PutCode(w, 0x30 + symbol, 8);
+    else if (symbol < 256) PutCode(w, 0x190 + (symbol - 144), 9);
+    else if (symbol < 280) PutCode(w, symbol - 256, 7);
+    else PutCode(w, 0xC0 + (symbol - 280), 8);
+}
+
+static void PutMatch(BitWriter* w, int length, int distance) {
+    int l = 28;
+    while (LENGTH_BASE[l] > length) l--;
+    PutSymbol(w, 257 + l);
+    PutBits(w, (DWORD)(length - LENGTH_BASE[l]), LENGTH_EXTRA[l]);
+
+    int d = 29;
+    while (DISTANCE_BASE[d] > distance) d--;
+    PutCode(w, (DWORD)d, 5);
+    PutBits(w, (DWORD)(distance - DISTANCE_BASE[d]), DISTANCE_EXTRA[d]);
+}
+
+static DWORD Hash3(const unsigned char* p) {
+    return ((DWORD)p[0] * 0x9E3779B1u ^ (DWORD)p[1] * 0x85EBCA6Bu ^ (DWORD)p[2] * 0xC2B2AE35u)
+           >> (32 - LZ_HASH_BITS);
+}
+
+/**
+ * @brief Greedy LZ77 over hash chains into one fixed-Huffman block
+ * @param out At least size * 9 / 8 + 16 bytes (every byte a 9-bit literal)
+ * @return Bytes written
+ */
+static size_t Deflate(const unsigned char* data, size_t size, unsigned char* out) {
+    BitWriter w = { out, 0, 0, 0 };
+    PutBits(&w, 1, 1);      /* BFINAL */
+    PutBits(&w, 1, 2);      /* BTYPE 01: fixed Huffman */
+
+    int* head = (int*)malloc(sizeof(int) << LZ_HASH_BITS);
+    int* prev = (int*)malloc(sizeof(int) * LZ_WINDOW);
+    if (head && prev) {
+        for (int i = 0; i < (1 << LZ_HASH_BITS); i++) head[i] = -1;
+    }
+
+    size_t i = 0;
+    while (i < size) {
+        int bestLength = 0, bestDistance = 0;
+        if (head && prev && i + LZ_MIN_MATCH <= size) {
+            size_t limit = size - i < LZ_MAX_MATCH ? size - i : LZ_MAX_MATCH;
+            DWORD h = Hash3(data + i);
+            int candidate = head[h];
+            for (int chain = 0; candidate >= 0 && chain < LZ_MAX_CHAIN; chain++) {
+                size_t distance = i - (size_t)candidate;
+                if (distance > LZ_WINDOW) break;
+                size_t length = 0;
+                while (length < limit && data[candidate + length] == data[i + length]) length++;
+                if ((int)length > bestLength) {
+                    bestLength = (int)length;
+                    bestDistance = (int)distance;
+                    if (length == limit) break;
+                }
+                int next = prev[candidate % LZ_WINDOW];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+        }
+
+        size_t advance = 1;
+        if (bestLength >= LZ_MIN_MATCH) {
+            PutMatch(&w, bestLength, bestDistance);
+            advance = (size_t)bestLength;
+        } else {
+            PutSymbol(&w, data[i]);
+        }
+
+        if (head && prev) {
+            for (size_t k = 0; k < advance && i + k + LZ_MIN_MATCH <= size; k++) {
+                DWORD h = Hash3(data + i + k);
+                prev[(i + k) % LZ_WINDOW] = head[h];
+                head[h] = (int)(i + k);
+            }
+        }
+        i += advance;
+    }
+
+    PutSymbol(&w, 256);     /* end of block */
+    if (w.count > 0) PutBits(&w, 0, 8 - w.count);
+
+    free(head);
+    free(prev);
+    return w.pos;
+}
+
+BOOL BenchPng_Write(const char* path, const unsigned char* rgba, int width, int height) {
+    if (!rgba || width <= 0 || height <= 0) return FALSE;
+
+    /* Each scanline gets the filter with the smallest sum of absolute
+     * residuals (the libpng heuristic) */
+    size_t stride = (size_t)width * 4;
+    size_t rawSize = (stride + 1) * (size_t)height;
+    size_t zCapacity = 2 + rawSize + rawSize / 8 + 16 + 4;
+
+    unsigned char* raw = (unsigned char*)malloc(rawSize);
+    unsigned char* z = (unsigned char*)malloc(zCapacity);
+    unsigned char* trial = (unsigned char*)malloc(stride);
+    if (!raw || !z || !trial) {
+        free(raw);
+        free(z);
+        free(trial);
+        return FALSE;
+    }
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = rgba + stride * (size_t)y;
+        const unsigned char* prevRow = y > 0 ? row - stride : NULL;
+        unsigned char* outRow = raw + (stride + 1) * (size_t)y;
+        size_t bestSum = (size_t)-1;
+        for (int type = 0; type <= 4; type++) {
+            FilterRow(type, row, prevRow, stride, trial);
+            size_t sum = 0;
+            for (size_t i = 0; i < stride; i++) sum += (size_t)abs((signed char)trial[i]);
+            if (sum < bestSum) {
+                bestSum = sum;
+                outRow[0] = (unsigned char)type;
+                memcpy(outRow + 1, trial, stride);
+            }
+        }
+    }
+    free(trial);
+
+    z[0] = 0x78;
+    z[1] = 0x01;
+    size_t zSize = 2 + Deflate(raw, rawSize, z + 2);
+    PutBE32(z + zSize, Adler32(raw, rawSize));
+    zSize += 4;
+
+    unsigned char ihdr[13];
+    PutBE32(ihdr, (DWORD)width);
+    PutBE32(ihdr + 4, (DWORD)height);
+    ihdr[8] = 8;    /* bit depth */
+    ihdr[9] = 6;    /* RGBA */
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    FILE* f = fopen(path, "wb");
+    BOOL ok = f != NULL;
+    if (ok) {
+        ok = fwrite(PNG_SIGNATURE, 1, 8, f) == 8 &&
+             WriteChunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+             WriteChunk(f, "IDAT", z, zSize) &&
+             WriteChunk(f, "IEND", NULL, 0);
+        ok = (fclose(f) == 0) && ok;
+    }
+
+    free(raw);
+    free(z);
+    return ok;
+}
+
+static unsigned char* ReadFileBytes(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    unsigned char* data = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long len = ftell(f);
+        if (len > 0 && fseek(f, 0, SEEK_SET) == 0) {
+            data = (unsigned char*)malloc((size_t)len);
+            if (data && fread(data, 1, (size_t)len, f) != (size_t)len) {
+                free(data);
+                data = NULL;
+            }
+            *size = (size_t)len;
+        }
+    }
+    fclose(f);
+    return data;
+}
+
+/* ============================================================================
+ * Inflate (stored and fixed-Huffman blocks)
+ * ============================================================================ */
+
+typedef struct {
+    const unsigned char* in;
+    size_t size;
+    size_t pos;     /* in bits */
+} BitReader;
+
+/** Read @p n bits least significant first; -1 past the end */
+static int GetBits(BitReader* r, int n) {
+    int value = 0;
+    for (int i = 0; i < n; i++) {
+        size_t byte = r->pos >> 3;
+        if (byte >= r->size) return -1;
+        value |= ((r->in[byte] >> (r->pos & 7)) & 1) << i;
+        r->pos++;
+    }
+    return value;
+}
+
+/** Read a Huffman code of @p n more bits onto @p code, most significant first */
+static int GetCode(BitReader* r, int code, int n) {
+    for (int i = 0; i < n; i++) {
+        int bit = GetBits(r, 1);
+        if (bit < 0) return -1;
+        code = (code << 1) | bit;
+    }
+    return code;
+}
+
+/** Fixed literal/length symbol, or -1 */
+static int GetSymbol(BitReader* r) {
+    int code = GetCode(r, 0, 7);
+    if (code < 0) return -1;
+    if (code <= 0x17) return 256 + code;
+    code = GetCode(r, code, 1);
+    if (code < 0) return -1;
+    if (code >= 0x30 && code <= 0xBF) return code - 0x30;
+    if (code >= 0xC0 && code <= 0xC7) return 280 + (code - 0xC0);
+    code = GetCode(r, code, 1);
+    if (code >= 0x190 && code <= 0x1FF) return 144 + (code - 0x190);
+    return -1;
+}
+
+/**
+ * @brief Inflate a zlib stream of stored and fixed-Huffman blocks
+ * @return Bytes produced, or (size_t)-1 on a malformed or unsupported stream
+ */
+static size_t Inflate(const unsigned char* z, size_t zSize, unsigned char* out, size_t outSize) {
+    BitReader r = { z, zSize, 16 };     /* past the zlib header */
+    size_t outPos = 0;
+    for (;;) {
+        int final = GetBits(&r, 1);
+        int type = GetBits(&r, 2);
+        if (final < 0 || type < 0) return (size_t)-1;
+
+        if (type == 0) {
+            size_t in = (r.pos + 7) >> 3;
+            if (in + 4 > zSize) return (size_t)-1;
+            size_t len = (size_t)z[in] | ((size_t)z[in + 1] << 8);
+            in += 4;
+            if (in + len > zSize || outPos + len > outSize) return (size_t)-1;
+            memcpy(out + outPos, z + in, len);
+            outPos += len;
+            r.pos = (in + len) << 3;
+        } else if (type == 1) {
+            for (;;) {
+                int symbol = GetSymbol(&r);
+                if (symbol < 0 || symbol > 285) return (size_t)-1;
+                if (symbol < 256) {
+                    if (outPos >= outSize) return (size_t)-1;
+                    out[outPos++] = (unsigned char)symbol;
+                    continue;
+                }
+                if (symbol == 256) break;
+
+                int l = symbol - 257;
+                int extra = GetBits(&r, LENGTH_EXTRA[l]);
+                int d = GetCode(&r, 0, 5);
+                if (extra < 0 || d < 0 || d > 29) return (size_t)-1;
+                size_t length = LENGTH_BASE[l] + (size_t)extra;
+                int dExtra = GetBits(&r, DISTANCE_EXTRA[d]);
+                if (dExtra < 0) return (size_t)-1;
+                size_t distance = DISTANCE_BASE[d] + (size_t)dExtra;
+                if (distance > outPos || outPos + length > outSize) return (size_t)-1;
+                /* Byte by byte: a match may overlap its own output */
+                for (size_t k = 0; k < length; k++, outPos++) out[outPos] = out[outPos - distance];
+            }
+        } else {
+            /* Dynamic Huffman: written by image editors, never by this file */
+            return (size_t)-1;
+        }
+        if (final) break;
+    }
+    return outPos;
+}
+
+BOOL BenchPng_Read(const char* path, unsigned char** rgba, int* width, int* height) {
+    size_t fileSize = 0;
+    unsigned char* file = ReadFileBytes(path, &fileSize);
+    if (!file) return FALSE;
+
+    BOOL ok = FALSE;
+    unsigned char* z = NULL;
+    unsigned char* raw = NULL;
+    size_t zSize = 0;
+    int w = 0, h = 0;
+
+    if (fileSize < 8 || memcmp(file, PNG_SIGNATURE, 8) != 0) goto done;
+
+    /* Gather IHDR and the concatenated IDAT payload */
+    for (size_t pos = 8; pos + 12 <= fileSize; ) {
+        DWORD len = GetBE32(file + pos);
+        const unsigned char* type = file + pos + 4;
+        const unsigned char* data = file + pos + 8;
+        if (pos + 12 + len > fileSize) goto done;
+
+        if (memcmp(type, "IHDR", 4) == 0 && len == 13) {
+            w = (int)GetBE32(data);
+            h = (int)GetBE32(data + 4);
+            if (data[8] != 8 || data[9] != 6 || data[12] != 0) goto done;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            unsigned char* grown = (unsigned char*)realloc(z, zSize + len);
+            if (!grown) goto done;
+            z = grown;
+            memcpy(z + zSize, data, len);
+            zSize += len;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + len;
+    }
+    if (w <= 0 || h <= 0 || zSize < 6) goto done;
+
+    size_t stride = (size_t)w * 4;
+    size_t rawSize = (stride + 1) * (size_t)h;
+    raw = (unsigned char*)malloc(rawSize);
+    if (!raw) goto done;
+
+    if (Inflate(z, zSize, raw, rawSize) != rawSize) goto done;
+
+    *rgba = (unsigned char*)malloc(stride * (size_t)h);
+    if (!*rgba) goto done;
+    for (int y = 0; y < h; y++) {
+        unsigned char* row = raw + (stride + 1) * (size_t)y + 1;
+        const unsigned char* prevRow = y > 0 ? row - (stride + 1) : NULL;
+        int type = row[-1];
+        if (type > 4) {
+            free(*rgba);
+            *rgba = NULL;
+            goto done;
+        }
+        /* Undo the filter in place; prevRow is already unfiltered */
+        for (size_t i = 0; i < stride; i++) {
+            int a = (i >= 4) ? row[i - 4] : 0;
+            int b = prevRow ? prevRow[i] : 0;
+            int c = (prevRow && i >= 4) ? prevRow[i - 4] : 0;
+            int predicted = 0;
+            switch (type) {
+                case 1: predicted = a; break;
+                case 2: predicted = b; break;
+                case 3: predicted = (a + b) >> 1; break;
+                case 4: predicted = Paeth(a, b, c); break;
+            }
+            row[i] = (unsigned char)(row[i] + predicted);
+        }
+        memcpy(*rgba + stride * (size_t)y, row, stride);
+    }
+    *width = w;
+    *height = h;
+    ok = TRUE;
+
+done:
+    free(raw);
+    free(z);
+    free(file);
+    return ok;
+}
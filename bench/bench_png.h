@@ -0,0 +1,29 @@
+/**
+ * @file bench_png.h
+ * @brief Compact RGBA PNG files for golden images
+ *
+ * Images are written as 8-bit RGBA, each row with the PNG filter that
+ * leaves the smallest residuals, compressed as one fixed-Huffman deflate
+ * block. They open in any viewer and need no zlib dependency; checked-in
+ * goldens come out at about a third of the stored-block size. The reader
+ * accepts stored and fixed-Huffman blocks; a golden re-saved by an image
+ * editor (dynamic Huffman) must be regenerated with --write-golden.
+ */
+
+#ifndef BENCH_PNG_H
+#define BENCH_PNG_H
+
+#include <windows.h>
+
+/**
+ * @brief Write straight-alpha RGBA pixels (4 bytes each, top row first)
+ */
+BOOL BenchPng_Write(const char* path, const unsigned char* rgba, int width, int height);
+
+/**
+ * @brief Read a PNG written by BenchPng_Write
+ * @param rgba Receives a malloc'd buffer the caller frees
+ */
+BOOL BenchPng_Read(const char* path, unsigned char** rgba, int* width, int* height);
+
+#endif /* BENCH_PNG_H */
@@ -0,0 +1,915 @@
+/**
+ * @file catime_bench.c
+ * @brief Headless benchmark of the render core, written as CSV
+ *
+ * Groups:
+ * - layout: markdown parse + measure, with the layout cache cold and warm
+ * - parse:  ParseMarkdownDocument and the ParseMarkdownLinks copy on a 1 MB
+ *           document; throughput in MB/s goes to stderr
+ * - render: RenderCore_Draw per effect and effect quality, effect cache
+ *           cleared before each run (cold) or left warm
+ * - blend:  every BlendKernels row function for the scalar set and each
+ *           SIMD set the CPU supports, after checking that every SIMD set
+ *           matches scalar output for spans of 0-67 pixels
+ * - blur:   ApplyGaussianBlurReference next to ApplyGaussianBlurFast for
+ *           radii 2-20 on text-sized to 4K maps; any output difference
+ *           fails the run. ApplyGaussianBlur3 runs at the variance of each
+ *           box; its error against an exact Gaussian goes to stderr and
+ *           fails the run above BLUR3_MAX_ERROR
+ * - scale:  a drag-scale sweep where every frame has a new font size,
+ *           with rasterized glyphs, with the distance field atlas, and as
+ *           interim frames (the first frame bilinearly resized)
+ * - viewport: 4K-256K character documents drawn through a window of
+ *           VIEWPORT_HEIGHT rows that scrolls every frame, next to the
+ *           full-height composition where that buffer fits in memory
+ * Each group runs at several font sizes; the window size is the measured
+ * text size, as in the app.
+ *
+ * Regression checks (exit code 1 on failure):
+ * - --baseline FILE compares each row's p50 against a CSV from an earlier
+ *   run and fails rows slower by more than --max-regression percent
+ * - --golden DIR renders the bench_golden.h matrix and compares it with
+ *   the PNGs in DIR; --write-golden DIR regenerates them. bench/golden and
+ *   bench/golden-sdf are the checked-in sets that CTest runs, and
+ *   bench/baseline.csv holds timings of the tree before the rewrites
+ *
+ * --sdf draws every other group (and the golden matrix) with distance
+ * field text; SDF goldens belong in their own directory.
+ *
+ * --fuzz-markdown N checks the parser on N generated inputs (bench_markdown.h)
+ * and exits; --seed picks the inputs. --verify-kernels runs only the blend
+ * kernel check. Both exit with 1 on any mismatch, as does a full run whose
+ * kernel check or blur comparison fails.
+ *
+ * Usage: catime_bench [--font-dir DIR] [--font PATH] [--out FILE] [--iterations N]
+ *                     [--baseline FILE [--max-regression PCT]]
+ *                     [--golden DIR | --write-golden DIR [--tolerance N]] [--sdf] [--verbose]
+ *                     [--fuzz-markdown N [--seed S]] [--verify-kernels]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include "bench_host.h"
+#include "bench_golden.h"
+#include "bench_markdown.h"
+#include "drawing/drawing_render_core.h"
+#include "drawing/drawing_text_stb.h"
+#include "drawing/drawing_text_layout.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_effect_cache.h"
+#include "drawing/drawing_blend_simd.h"
+#include "drawing/drawing_worker_pool.h"
+#include "color/gradient.h"
+
+#ifndef CATIME_BENCH_FONT_DIR
+#define CATIME_BENCH_FONT_DIR "asset/font"
+#endif
+#define BENCH_DEFAULT_FONT "OFL/Rubik Burned Essence.ttf"
+
+#define DEFAULT_ITERATIONS 50
+#define DEFAULT_MAX_REGRESSION 25.0
+
+/* Slowdowns below this are timer noise, whatever the percentage */
+#define REGRESSION_FLOOR_US 20.0
+
+#define BENCH_KEY_SIZE 128
+
+typedef struct {
+    const char* name;
+    const wchar_t* text;
+} BenchText;
+
+static const BenchText BENCH_TEXTS[] = {
+    { "clock",    L"12:34:56" },
+    { "markdown", L"# 12:34\n**05:06** *07:08*\n> 09:10\n<color:#FF0000_#0000FF>23:59</color>" },
+};
+
+static const int BENCH_FONT_SIZES[] = { 32, 96, 240 };
+
+static const struct {
+    const char* name;
+    EffectType type;
+} BENCH_EFFECTS[] = {
+    { "none",        EFFECT_TYPE_NONE },
+    { "glow",        EFFECT_TYPE_GLOW },
+    { "glass",       EFFECT_TYPE_GLASS },
+    { "neon",        EFFECT_TYPE_NEON },
+    { "holographic", EFFECT_TYPE_HOLOGRAPHIC },
+    { "liquid",      EFFECT_TYPE_LIQUID },
+};
+
+/* Drag-scale sweep: one new size per frame, as HandleScaleWindow produces */
+#define SCALE_SWEEP_MIN_PX 40
+#define SCALE_SWEEP_STEPS 160
+
+/* Long documents behind a MAX_WINDOW_HEIGHT-style viewport */
+#define VIEWPORT_HEIGHT 480
+#define VIEWPORT_FULL_MAX_PIXELS (16 * 1024 * 1024)
+
+static const int VIEWPORT_DOCUMENT_CHARS[] = { 4096, 32768, 262144 };
+
+static const EffectQuality BENCH_QUALITIES[] = {
+    EFFECT_QUALITY_FULL, EFFECT_QUALITY_HALF, EFFECT_QUALITY_QUARTER
+};
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+/* Blur engine comparison: map sizes and radii 2, 4, ..., 20 */
+static const SIZE BLUR_SIZES[] = { { 160, 64 }, { 480, 160 }, { 1280, 360 }, { 3840, 1080 } };
+#define BLUR_MIN_RADIUS 2
+#define BLUR_MAX_RADIUS 20
+#define BLUR_RADIUS_STEP 2
+/* Largest difference from an exact Gaussian accepted for ApplyGaussianBlur3 away
+ * from the edges; each of its six box passes rounds down, so up to 6 is bias */
+#define BLUR3_MAX_ERROR 12
+
+/* Blend kernel check: every span width through two AVX2 blocks plus a tail */
+#define KERNEL_VERIFY_MAX_SPAN 67
+
+typedef struct {
+    char key[BENCH_KEY_SIZE];   /* group,case,variant,width,height */
+    double p50;
+} BenchResult;
+
+static int g_iterations = DEFAULT_ITERATIONS;
+static FILE* g_out = NULL;
+static double g_usPerTick = 0.0;
+
+static BenchResult* g_results = NULL;
+static int g_resultCount = 0;
+static int g_resultCapacity = 0;
+
+/* ============================================================================
+ * Timing and CSV
+ * ============================================================================ */
+
+static LONGLONG Now(void) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static int CompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/** Write one row from per-iteration samples (microseconds) */
+static void EmitRow(const char* group, const char* name, const char* variant,
+                    int width, int height, double* samples, int count) {
+    qsort(samples, (size_t)count, sizeof(double), CompareDouble);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+
+    int p95 = (count * 95 + 99) / 100;
+    if (p95 < 1) p95 = 1;
+
+    fprintf(g_out, "%s,%s,%s,%d,%d,%d,%.2f,%.2f,%.2f,%.2f\n",
+            group, name, variant, width, height, count,
+            sum / count, samples[count / 2], samples[p95 - 1], samples[0]);
+    fflush(g_out);
+
+    if (g_resultCount == g_resultCapacity) {
+        int capacity = g_resultCapacity ? g_resultCapacity * 2 : 256;
+        BenchResult* grown = (BenchResult*)realloc(g_results, sizeof(BenchResult) * (size_t)capacity);
+        if (!grown) return;
+        g_results = grown;
+        g_resultCapacity = capacity;
+    }
+    BenchResult* result = &g_results[g_resultCount++];
+    snprintf(result->key, sizeof(result->key), "%s,%s,%s,%d,%d", group, name, variant, width, height);
+    result->p50 = samples[count / 2];
+}
+
+/* ============================================================================
+ * Baseline comparison
+ * ============================================================================ */
+
+/**
+ * @brief Compare this run's p50 values with a CSV written by an earlier run
+ * @return Number of regressed rows, or -1 if the baseline cannot be read
+ */
+static int CompareBaseline(const char* path, double maxRegressionPercent) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "catime_bench: cannot read baseline %s\n", path);
+        return -1;
+    }
+
+    char line[512];
+    int compared = 0, regressions = 0;
+    while (fgets(line, sizeof(line), f)) {
+        /* key = first five fields; p50 is the eighth */
+        char* fields[10];
+        int n = 0;
+        char* ctx = NULL;
+        for (char* tok = strtok_s(line, ",\r\n", &ctx); tok && n < 10; tok = strtok_s(NULL, ",\r\n", &ctx)) {
+            fields[n++] = tok;
+        }
+        if (n < 10 || strcmp(fields[0], "group") == 0) continue;
+
+        char key[BENCH_KEY_SIZE];
+        snprintf(key, sizeof(key), "%s,%s,%s,%s,%s", fields[0], fields[1], fields[2], fields[3], fields[4]);
+        double baseP50 = atof(fields[7]);
+
+        for (int i = 0; i < g_resultCount; i++) {
+            if (strcmp(g_results[i].key, key) != 0) continue;
+            compared++;
+            double current = g_results[i].p50;
+            double limit = baseP50 * (1.0 + maxRegressionPercent / 100.0);
+            if (current > limit && current - baseP50 > REGRESSION_FLOOR_US) {
+                fprintf(stderr, "REGRESSION %s: p50 %.2f us, baseline %.2f us (+%.0f%%)\n",
+                        key, current, baseP50, (current / baseP50 - 1.0) * 100.0);
+                regressions++;
+            }
+            break;
+        }
+    }
+    fclose(f);
+
+    fprintf(stderr, "Baseline: %d row(s) compared, %d regression(s) over %.0f%%\n",
+            compared, regressions, maxRegressionPercent);
+    return regressions;
+}
+
+/* ============================================================================
+ * Groups
+ * ============================================================================ */
+
+static void BenchLayout(const BenchText* sample, int fontSize, double* samples) {
+    int width = 0, height = 0;
+
+    for (int cached = 0; cached <= 1; cached++) {
+        for (int i = 0; i < g_iterations; i++) {
+            if (!cached) {
+                TextLayout_Clear();
+                RenderCore_ClearParseCache();
+            }
+            LONGLONG start = Now();
+            RenderCoreDocument doc;
+            RenderCore_Parse(sample->text, &doc);
+            RenderCore_Measure(&doc, fontSize, &width, &height);
+            RenderCore_FreeDocument(&doc);
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+        }
+        char variant[32];
+        snprintf(variant, sizeof(variant), "%s/px%d", cached ? "warm" : "cold", fontSize);
+        EmitRow("layout", sample->name, variant, width, height, samples, g_iterations);
+    }
+}
+
+static void BenchParse(double* samples) {
+    wchar_t* text = BenchMarkdown_BuildDocument(BENCH_MARKDOWN_DOCUMENT_CHARS);
+    if (!text) return;
+
+    for (int legacy = 0; legacy <= 1; legacy++) {
+        for (int i = 0; i < g_iterations; i++) {
+            LONGLONG start = Now();
+            if (legacy) {
+                wchar_t* display;
+                MarkdownLink* links; int linkCount;
+                MarkdownHeading* headings; int headingCount;
+                MarkdownStyle* styles; int styleCount;
+                MarkdownListItem* listItems; int listItemCount;
+                MarkdownBlockquote* blockquotes; int blockquoteCount;
+                MarkdownColorTag* colorTags; int colorTagCount;
+                MarkdownFontTag* fontTags; int fontTagCount;
+                if (ParseMarkdownLinks(text, &display, &links, &linkCount, &headings, &headingCount,
+                                       &styles, &styleCount, &listItems, &listItemCount,
+                                       &blockquotes, &blockquoteCount, &colorTags, &colorTagCount,
+                                       &fontTags, &fontTagCount)) {
+                    FreeMarkdownLinks(links, linkCount);
+                    free(headings); free(styles); free(listItems); free(blockquotes);
+                    free(colorTags); free(fontTags); free(display);
+                }
+            } else {
+                MarkdownDocument doc;
+                ParseMarkdownDocument(text, &doc);
+                FreeMarkdownDocument(&doc);
+            }
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+        }
+        const char* variant = legacy ? "legacy" : "arena";
+        EmitRow("parse", "doc1mb", variant, 0, 0, samples, g_iterations);
+        /* EmitRow sorted the samples; one character of ASCII text is one UTF-8 byte */
+        double p50 = samples[g_iterations / 2];
+        if (p50 > 0.0) {
+            fprintf(stderr, "parse doc1mb %s: %.1f MB/s\n", variant,
+                    (double)BENCH_MARKDOWN_DOCUMENT_CHARS / p50 * 1000000.0 / (1024.0 * 1024.0));
+        }
+    }
+    free(text);
+}
+
+static void BenchRender(const BenchText* sample, int fontSize, double* samples) {
+    RenderCoreDocument doc;
+    RenderCore_Parse(sample->text, &doc);
+
+    int width = 0, height = 0;
+    if (!RenderCore_Measure(&doc, fontSize, &width, &height) || width <= 0 || height <= 0) {
+        RenderCore_FreeDocument(&doc);
+        return;
+    }
+
+    size_t bytes = (size_t)width * (size_t)height * sizeof(DWORD);
+    DWORD* bits = (DWORD*)malloc(bytes);
+    if (!bits) {
+        RenderCore_FreeDocument(&doc);
+        return;
+    }
+
+    RenderCoreStyle style;
+    style.textColor = RGB(255, 200, 80);
+    style.gradientMode = GRADIENT_NONE;
+    style.fontSize = fontSize;
+
+    for (int e = 0; e < COUNT_OF(BENCH_EFFECTS); e++) {
+        BenchHost_SetEffect(BENCH_EFFECTS[e].type);
+        int qualityCount = (BENCH_EFFECTS[e].type == EFFECT_TYPE_NONE) ? 1 : COUNT_OF(BENCH_QUALITIES);
+
+        for (int q = 0; q < qualityCount; q++) {
+            SetEffectQualityFloor(BENCH_QUALITIES[q]);
+            SetEffectQuality(BENCH_QUALITIES[q]);
+
+            for (int cached = 0; cached <= 1; cached++) {
+                /* Time-dependent effects never hit the cache */
+                if (cached && (BENCH_EFFECTS[e].type == EFFECT_TYPE_NONE ||
+                               IsEffectTimeDependent(BENCH_EFFECTS[e].type))) {
+                    continue;
+                }
+
+                EffectCache_Clear();
+                for (int i = 0; i < g_iterations; i++) {
+                    if (!cached) EffectCache_Clear();
+                    memset(bits, 0, bytes);
+                    LONGLONG start = Now();
+                    RenderCore_Draw(&doc, &style, bits, width, height);
+                    samples[i] = (double)(Now() - start) * g_usPerTick;
+                }
+
+                char variant[48];
+                snprintf(variant, sizeof(variant), "q%d/%s/px%d",
+                         (int)BENCH_QUALITIES[q], cached ? "warm" : "cold", fontSize);
+                EmitRow("render", BENCH_EFFECTS[e].name, variant, width, height, samples, g_iterations);
+            }
+        }
+    }
+
+    BenchHost_SetEffect(EFFECT_TYPE_NONE);
+    SetEffectQualityFloor(EFFECT_QUALITY_FULL);
+    SetEffectQuality(EFFECT_QUALITY_FULL);
+    free(bits);
+    RenderCore_FreeDocument(&doc);
+}
+
+/**
+ * @brief Interim frames of the sweep: the SCALE_SWEEP_MIN_PX frame resized
+ *        in proportion to each size, as the app paints during a wheel gesture
+ */
+static void BenchInterimScale(const RenderCoreDocument* doc, const char* effectName,
+                              DWORD* bits, int maxW, int maxH, double* samples) {
+    RenderCoreStyle style = { RGB(255, 200, 80), GRADIENT_NONE, SCALE_SWEEP_MIN_PX };
+    int baseW = 0, baseH = 0;
+    if (!RenderCore_Measure(doc, style.fontSize, &baseW, &baseH) || baseW <= 0 || baseH <= 0) return;
+    DWORD* frame = (DWORD*)calloc((size_t)baseW * (size_t)baseH, sizeof(DWORD));
+    if (!frame) return;
+    RenderCore_Draw(doc, &style, frame, baseW, baseH);
+
+    const BlendKernels* k = BlendKernels_Get();
+    for (int i = 0; i < g_iterations; i++) {
+        int px = SCALE_SWEEP_MIN_PX + i % SCALE_SWEEP_STEPS;
+        int width = baseW * px / SCALE_SWEEP_MIN_PX;
+        int height = baseH * px / SCALE_SWEEP_MIN_PX;
+        if (width > maxW) width = maxW;
+        if (height > maxH) height = maxH;
+
+        LONGLONG start = Now();
+        BlendKernels_ScaleImage(k, bits, width, height, frame, baseW, baseH);
+        samples[i] = (double)(Now() - start) * g_usPerTick;
+    }
+    EmitRow("scale", effectName, "interim", maxW, maxH, samples, g_iterations);
+    free(frame);
+}
+
+/**
+ * @brief Draw the clock at a different size every frame
+ * @details Sizes climb one pixel per frame and wrap after SCALE_SWEEP_STEPS,
+ *          so each frame is a glyph cache miss unless the atlas serves it.
+ */
+static void BenchScale(const BenchText* sample, double* samples) {
+    int maxPx = SCALE_SWEEP_MIN_PX + SCALE_SWEEP_STEPS - 1;
+    RenderCoreDocument doc;
+    RenderCore_Parse(sample->text, &doc);
+
+    int maxW = 0, maxH = 0;
+    if (!RenderCore_Measure(&doc, maxPx, &maxW, &maxH) || maxW <= 0 || maxH <= 0) {
+        RenderCore_FreeDocument(&doc);
+        return;
+    }
+    DWORD* bits = (DWORD*)malloc((size_t)maxW * (size_t)maxH * sizeof(DWORD));
+    if (!bits) {
+        RenderCore_FreeDocument(&doc);
+        return;
+    }
+
+    int width = 0, height = 0;
+    BOOL wasSdf = IsDistanceFieldTextSTB();
+    for (int sdf = 0; sdf <= 1; sdf++) {
+        SetDistanceFieldTextSTB(sdf ? TRUE : FALSE);
+        for (int e = 0; e < COUNT_OF(BENCH_EFFECTS); e++) {
+            /* Only the effects the atlas changes */
+            EffectType type = BENCH_EFFECTS[e].type;
+            if (type == EFFECT_TYPE_HOLOGRAPHIC || type == EFFECT_TYPE_LIQUID) continue;
+            BenchHost_SetEffect(type);
+            ClearFontCacheSTB();
+
+            /* Atlases are built once per font; time the drag, not the build */
+            if (sdf) {
+                RenderCoreStyle warm = { RGB(255, 200, 80), GRADIENT_NONE, SCALE_SWEEP_MIN_PX - 1 };
+                RenderCore_Measure(&doc, warm.fontSize, &width, &height);
+                RenderCore_Draw(&doc, &warm, bits, width, height);
+            }
+
+            for (int i = 0; i < g_iterations; i++) {
+                RenderCoreStyle style;
+                style.textColor = RGB(255, 200, 80);
+                style.gradientMode = GRADIENT_NONE;
+                style.fontSize = SCALE_SWEEP_MIN_PX + i % SCALE_SWEEP_STEPS;
+
+                LONGLONG start = Now();
+                RenderCore_Measure(&doc, style.fontSize, &width, &height);
+                memset(bits, 0, (size_t)width * (size_t)height * sizeof(DWORD));
+                RenderCore_Draw(&doc, &style, bits, width, height);
+                samples[i] = (double)(Now() - start) * g_usPerTick;
+            }
+            EmitRow("scale", BENCH_EFFECTS[e].name, sdf ? "sdf" : "raster",
+                    maxW, maxH, samples, g_iterations);
+        }
+    }
+
+    SetDistanceFieldTextSTB(wasSdf);
+
+    /* Every effect: interim frames cost the same whatever produced them */
+    for (int e = 0; e < COUNT_OF(BENCH_EFFECTS); e++) {
+        BenchHost_SetEffect(BENCH_EFFECTS[e].type);
+        BenchInterimScale(&doc, BENCH_EFFECTS[e].name, bits, maxW, maxH, samples);
+    }
+
+    BenchHost_SetEffect(EFFECT_TYPE_NONE);
+    free(bits);
+    RenderCore_FreeDocument(&doc);
+}
+
+typedef enum {
+    KERNEL_MAX_SOLID,
+    KERNEL_MAX_COLUMNS,
+    KERNEL_OVERWRITE_COLUMNS,
+    KERNEL_LERP_SOLID,
+    KERNEL_HALVE_ROW,
+    KERNEL_LERP_ROWS,
+    KERNEL_COUNT
+} KernelOp;
+
+static const char* const KERNEL_OP_NAMES[KERNEL_COUNT] = {
+    "maxSolid", "maxColumns", "overwriteColumns", "lerpSolid", "halveRow", "lerpRows"
+};
+
+/** Run one row function over a width x height surface */
+static void RunKernel(const BlendKernels* k, KernelOp op, DWORD* dst, unsigned char* map,
+                      const unsigned char* cov, const DWORD* colors, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        DWORD* row = dst + (size_t)y * width;
+        const unsigned char* covRow = cov + (size_t)y * width;
+        switch (op) {
+            case KERNEL_MAX_SOLID:         k->maxSolid(row, covRow, width, 0x00FFC850); break;
+            case KERNEL_MAX_COLUMNS:       k->maxColumns(row, covRow, colors, width); break;
+            case KERNEL_OVERWRITE_COLUMNS: k->overwriteColumns(row, covRow, colors, width); break;
+            case KERNEL_LERP_SOLID:        k->lerpSolid(row, covRow, width, 0x00FFC850); break;
+            case KERNEL_HALVE_ROW:
+                if ((y & 1) == 0 && y + 1 < height) {
+                    k->halveRow(map + (size_t)(y / 2) * width, covRow, covRow + width, width / 2);
+                }
+                break;
+            case KERNEL_LERP_ROWS:
+                if (y + 1 < height) {
+                    k->lerpRows(map + (size_t)y * width, covRow, covRow + width, 96, width);
+                }
+                break;
+            default: break;
+        }
+    }
+}
+
+static void BenchViewport(int documentChars, int fontSize, double* samples) {
+    wchar_t* text = BenchMarkdown_BuildDocument(documentChars);
+    if (!text) return;
+
+    RenderCoreDocument doc;
+    RenderCore_Parse(text, &doc);
+    free(text);
+
+    int width = 0, height = 0;
+    if (!RenderCore_Measure(&doc, fontSize, &width, &height) || width <= 0 || height <= VIEWPORT_HEIGHT) {
+        RenderCore_FreeDocument(&doc);
+        return;
+    }
+
+    RenderCoreStyle style = { RGB(255, 200, 80), GRADIENT_NONE, fontSize };
+    char name[32];
+    char variant[32];
+    snprintf(name, sizeof(name), "doc%dk", documentChars / 1024);
+
+    size_t bytes = (size_t)width * VIEWPORT_HEIGHT * sizeof(DWORD);
+    DWORD* bits = (DWORD*)malloc(bytes);
+    if (bits) {
+        /* Three lines further every frame, wrapping at the end, as a wheel gesture */
+        int maxScroll = height - VIEWPORT_HEIGHT;
+        int scrollY = 0;
+        for (int i = 0; i < g_iterations; i++) {
+            memset(bits, 0, bytes);
+            LONGLONG start = Now();
+            RenderCore_DrawViewport(&doc, &style, bits, width, VIEWPORT_HEIGHT, scrollY);
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+            scrollY += 3 * fontSize;
+            if (scrollY > maxScroll) scrollY = 0;
+        }
+        snprintf(variant, sizeof(variant), "scroll/px%d", fontSize);
+        EmitRow("viewport", name, variant, width, VIEWPORT_HEIGHT, samples, g_iterations);
+        free(bits);
+    }
+
+    if ((size_t)width * (size_t)height <= VIEWPORT_FULL_MAX_PIXELS) {
+        bytes = (size_t)width * (size_t)height * sizeof(DWORD);
+        bits = (DWORD*)malloc(bytes);
+        if (bits) {
+            for (int i = 0; i < g_iterations; i++) {
+                memset(bits, 0, bytes);
+                LONGLONG start = Now();
+                RenderCore_Draw(&doc, &style, bits, width, height);
+                samples[i] = (double)(Now() - start) * g_usPerTick;
+            }
+            snprintf(variant, sizeof(variant), "full/px%d", fontSize);
+            EmitRow("viewport", name, variant, width, height, samples, g_iterations);
+            free(bits);
+        }
+    }
+
+    RenderCore_FreeDocument(&doc);
+}
+
+/** @return Number of SIMD kernel sets whose output differs from scalar */
+static int VerifyBlendKernels(void) {
+    const BlendKernels* sets[4];
+    int setCount = BlendKernels_GetSupported(sets, COUNT_OF(sets));
+    int failures = 0;
+
+    for (int s = 0; s < setCount; s++) {
+        BOOL same = BlendKernels_Verify(sets[s], 0, KERNEL_VERIFY_MAX_SPAN);
+        fprintf(stderr, "Blend kernels: %s %s scalar for spans 0-%d\n",
+                sets[s]->name, same ? "matches" : "DIFFERS FROM", KERNEL_VERIFY_MAX_SPAN);
+        if (!same) failures++;
+    }
+    if (setCount == 0) fprintf(stderr, "Blend kernels: no SIMD sets on this CPU, scalar only\n");
+    return failures;
+}
+
+static void BenchBlend(int width, int height, double* samples) {
+    size_t pixels = (size_t)width * (size_t)height;
+    DWORD* dst = (DWORD*)malloc(pixels * sizeof(DWORD));
+    unsigned char* cov = (unsigned char*)malloc(pixels);
+    unsigned char* map = (unsigned char*)malloc(pixels);
+    DWORD* colors = (DWORD*)malloc((size_t)width * sizeof(DWORD));
+    if (!dst || !cov || !map || !colors) {
+        free(dst); free(cov); free(map); free(colors);
+        return;
+    }
+
+    /* Text-like coverage: mostly empty, with solid and antialiased runs */
+    unsigned int seed = 12345u;
+    for (size_t i = 0; i < pixels; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned int r = (seed >> 16) & 0xFF;
+        cov[i] = (r < 160) ? 0 : (r < 220) ? 255 : (unsigned char)r;
+    }
+    for (int x = 0; x < width; x++) {
+        colors[x] = RGB(x & 0xFF, 128, 255 - (x & 0xFF));
+    }
+
+    const BlendKernels* sets[4];
+    sets[0] = BlendKernels_GetScalar();
+    int setCount = 1 + BlendKernels_GetSupported(sets + 1, COUNT_OF(sets) - 1);
+
+    for (int s = 0; s < setCount; s++) {
+        for (int op = 0; op < KERNEL_COUNT; op++) {
+            for (int i = 0; i < g_iterations; i++) {
+                memset(dst, 0, pixels * sizeof(DWORD));
+                LONGLONG start = Now();
+                RunKernel(sets[s], (KernelOp)op, dst, map, cov, colors, width, height);
+                samples[i] = (double)(Now() - start) * g_usPerTick;
+            }
+            EmitRow("blend", KERNEL_OP_NAMES[op], sets[s]->name, width, height, samples, g_iterations);
+        }
+    }
+
+    free(dst); free(cov); free(map); free(colors);
+}
+
+/** @return Number of radii where the fast blur differs from the reference */
+/**
+ * @brief Exact separable Gaussian, clamped at the edges like the box blurs
+ * @details Taps out to 4 sigma, normalized; only the accuracy reference,
+ *          so it is computed once per case and not timed.
+ */
+static BOOL ExactGaussian(const unsigned char* src, unsigned char* dest, int w, int h, double sigma) {
+    int taps = (int)ceil(sigma * 4.0);
+    double* kernel = (double*)malloc(sizeof(double) * (size_t)(2 * taps + 1));
+    float* rows = (float*)malloc(sizeof(float) * (size_t)w * (size_t)h);
+    if (!kernel || !rows) {
+        free(kernel);
+        free(rows);
+        return FALSE;
+    }
+
+    double total = 0.0;
+    for (int k = -taps; k <= taps; k++) {
+        kernel[k + taps] = exp(-(double)(k * k) / (2.0 * sigma * sigma));
+        total += kernel[k + taps];
+    }
+    for (int k = 0; k <= 2 * taps; k++) kernel[k] /= total;
+
+    for (int y = 0; y < h; y++) {
+        const unsigned char* in = src + (size_t)y * w;
+        for (int x = 0; x < w; x++) {
+            double sum = 0.0;
+            for (int k = -taps; k <= taps; k++) {
+                int i = x + k < 0 ? 0 : (x + k >= w ? w - 1 : x + k);
+                sum += kernel[k + taps] * in[i];
+            }
+            rows[(size_t)y * w + x] = (float)sum;
+        }
+    }
+    for (int x = 0; x < w; x++) {
+        for (int y = 0; y < h; y++) {
+            double sum = 0.0;
+            for (int k = -taps; k <= taps; k++) {
+                int j = y + k < 0 ? 0 : (y + k >= h ? h - 1 : y + k);
+                sum += kernel[k + taps] * rows[(size_t)j * w + x];
+            }
+            dest[(size_t)y * w + x] = (unsigned char)(sum + 0.5);
+        }
+    }
+
+    free(kernel);
+    free(rows);
+    return TRUE;
+}
+
+/**
+ * @brief Largest and mean absolute difference between two maps, away from the edges
+ * @details The box passes each clamp their own input at the border, the
+ *          Gaussian clamps the source once, so pixels within @p margin of
+ *          an edge measure that choice rather than the profile.
+ * @return FALSE if no pixel is at least @p margin from every edge
+ */
+static BOOL MapError(const unsigned char* a, const unsigned char* b, int w, int h, int margin,
+                     int* maxError, double* meanError) {
+    if (w <= 2 * margin || h <= 2 * margin) return FALSE;
+    long long total = 0;
+    *maxError = 0;
+    for (int y = margin; y < h - margin; y++) {
+        for (int x = margin; x < w - margin; x++) {
+            size_t i = (size_t)y * w + x;
+            int d = abs((int)a[i] - (int)b[i]);
+            if (d > *maxError) *maxError = d;
+            total += d;
+        }
+    }
+    *meanError = (double)total / ((double)(w - 2 * margin) * (double)(h - 2 * margin));
+    return TRUE;
+}
+
+static int BenchBlur(int width, int height, double* samples) {
+    size_t size = (size_t)width * (size_t)height;
+    unsigned char* src = (unsigned char*)malloc(size);
+    unsigned char* expect = (unsigned char*)malloc(size);
+    unsigned char* actual = (unsigned char*)malloc(size);
+    unsigned char* temp = (unsigned char*)malloc(size);
+    unsigned char* gaussian = (unsigned char*)malloc(size);
+    if (!src || !expect || !actual || !temp || !gaussian) {
+        free(src); free(expect); free(actual); free(temp); free(gaussian);
+        return 0;
+    }
+
+    /* Text-like coverage: mostly empty with solid strokes */
+    for (size_t i = 0; i < size; i++) {
+        src[i] = ((i / 7) % 5 == 0) ? 255 : 0;
+    }
+
+    int mismatches = 0;
+    char name[16];
+    for (int radius = BLUR_MIN_RADIUS; radius <= BLUR_MAX_RADIUS; radius += BLUR_RADIUS_STEP) {
+        snprintf(name, sizeof(name), "r%d", radius);
+
+        for (int i = 0; i < g_iterations; i++) {
+            LONGLONG start = Now();
+            ApplyGaussianBlurReference(src, expect, temp, width, height, radius);
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+        }
+        EmitRow("blur", name, "reference", width, height, samples, g_iterations);
+
+        BOOL ran = TRUE;
+        for (int i = 0; i < g_iterations && ran; i++) {
+            LONGLONG start = Now();
+            ran = ApplyGaussianBlurFast(src, actual, temp, width, height, radius);
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+        }
+        if (ran) EmitRow("blur", name, "fast", width, height, samples, g_iterations);
+
+        if (!ran || memcmp(expect, actual, size) != 0) {
+            fprintf(stderr, "Blur %dx%d r=%d: fast output differs from the reference\n",
+                    width, height, radius);
+            mismatches++;
+        }
+
+        /* Three boxes with the variance of this one: the opt-in true-Gaussian profile */
+        float sigma = sqrtf((float)(radius * (radius + 1)) / 3.0f);
+        for (int i = 0; i < g_iterations; i++) {
+            LONGLONG start = Now();
+            ApplyGaussianBlur3(src, actual, temp, width, height, sigma);
+            samples[i] = (double)(Now() - start) * g_usPerTick;
+        }
+        EmitRow("blur", name, "three-box", width, height, samples, g_iterations);
+
+        int margin = (int)ceil(sigma * 4.0f);
+        int boxMax, threeMax;
+        double boxMean, threeMean;
+        if (width > 2 * margin && height > 2 * margin &&
+            ExactGaussian(src, gaussian, width, height, sigma) &&
+            MapError(expect, gaussian, width, height, margin, &boxMax, &boxMean) &&
+            MapError(actual, gaussian, width, height, margin, &threeMax, &threeMean)) {
+            fprintf(stderr, "blur %dx%d r%d (sigma %.2f) vs Gaussian: box max %d mean %.2f, "
+                    "three-box max %d mean %.2f\n",
+                    width, height, radius, sigma, boxMax, boxMean, threeMax, threeMean);
+            if (threeMax > BLUR3_MAX_ERROR) {
+                fprintf(stderr, "Blur %dx%d r=%d: three-box error %d exceeds %d\n",
+                        width, height, radius, threeMax, BLUR3_MAX_ERROR);
+                mismatches++;
+            }
+        }
+    }
+
+    free(src); free(expect); free(actual); free(temp); free(gaussian);
+    return mismatches;
+}
+
+/* ============================================================================
+ * Entry
+ * ============================================================================ */
+
+static void PrintUsage(void) {
+    fprintf(stderr,
+            "Usage: catime_bench [--font-dir DIR] [--font PATH] [--out FILE] [--iterations N]\n"
+            "                    [--baseline FILE [--max-regression PCT]]\n"
+            "                    [--golden DIR | --write-golden DIR [--tolerance N]] [--sdf] [--verbose]\n"
+            "                    [--fuzz-markdown N [--seed S]] [--verify-kernels]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* fontDir = CATIME_BENCH_FONT_DIR;
+    const char* fontPath = NULL;
+    const char* outPath = NULL;
+    const char* baselinePath = NULL;
+    const char* goldenDir = NULL;
+    BOOL writeGolden = FALSE;
+    double maxRegression = DEFAULT_MAX_REGRESSION;
+    int tolerance = BENCH_GOLDEN_DEFAULT_TOLERANCE;
+    int fuzzCases = 0;
+    unsigned int fuzzSeed = 1;
+    BOOL verifyKernelsOnly = FALSE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--font-dir") == 0 && i + 1 < argc) {
+            fontDir = argv[++i];
+        } else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc) {
+            fontPath = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--max-regression") == 0 && i + 1 < argc) {
+            maxRegression = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            goldenDir = argv[++i];
+            writeGolden = FALSE;
+        } else if (strcmp(argv[i], "--write-golden") == 0 && i + 1 < argc) {
+            goldenDir = argv[++i];
+            writeGolden = TRUE;
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            g_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sdf") == 0) {
+            SetDistanceFieldTextSTB(TRUE);
+        } else if (strcmp(argv[i], "--fuzz-markdown") == 0 && i + 1 < argc) {
+            fuzzCases = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            fuzzSeed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--verify-kernels") == 0) {
+            verifyKernelsOnly = TRUE;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            BenchHost_SetVerbose(TRUE);
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (g_iterations < 1) g_iterations = 1;
+
+    if (fuzzCases > 0) {
+        return BenchMarkdown_Fuzz(fuzzSeed, fuzzCases) == 0 ? 0 : 1;
+    }
+
+    if (verifyKernelsOnly) {
+        return VerifyBlendKernels() == 0 ? 0 : 1;
+    }
+
+    if (goldenDir) {
+        int failures = BenchGolden_Run(fontDir, goldenDir, writeGolden, tolerance);
+        WorkerPool_Shutdown();
+        CleanupDrawingEffects();
+        CleanupFontSTB();
+        return failures == 0 ? 0 : 1;
+    }
+
+    char defaultFont[MAX_PATH * 2];
+    if (!fontPath) {
+        snprintf(defaultFont, sizeof(defaultFont), "%s/%s", fontDir, BENCH_DEFAULT_FONT);
+        fontPath = defaultFont;
+    }
+
+    if (!InitFontSTB(fontPath)) {
+        fprintf(stderr, "catime_bench: cannot load font %s\n", fontPath);
+        return 1;
+    }
+
+    g_out = outPath ? fopen(outPath, "w") : stdout;
+    if (!g_out) {
+        fprintf(stderr, "catime_bench: cannot write %s\n", outPath);
+        return 1;
+    }
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    g_usPerTick = 1000000.0 / (double)freq.QuadPart;
+
+    double* samples = (double*)malloc(sizeof(double) * (size_t)g_iterations);
+    if (!samples) return 1;
+
+    fprintf(g_out, "group,case,variant,width,height,iterations,mean_us,p50_us,p95_us,min_us\n");
+
+    for (int t = 0; t < COUNT_OF(BENCH_TEXTS); t++) {
+        for (int s = 0; s < COUNT_OF(BENCH_FONT_SIZES); s++) {
+            BenchLayout(&BENCH_TEXTS[t], BENCH_FONT_SIZES[s], samples);
+        }
+    }
+
+    for (int t = 0; t < COUNT_OF(BENCH_TEXTS); t++) {
+        for (int s = 0; s < COUNT_OF(BENCH_FONT_SIZES); s++) {
+            BenchRender(&BENCH_TEXTS[t], BENCH_FONT_SIZES[s], samples);
+        }
+    }
+
+    BenchParse(samples);
+
+    BenchScale(&BENCH_TEXTS[0], samples);
+
+    for (int d = 0; d < COUNT_OF(VIEWPORT_DOCUMENT_CHARS); d++) {
+        BenchViewport(VIEWPORT_DOCUMENT_CHARS[d], BENCH_FONT_SIZES[0], samples);
+    }
+
+    int blurMismatches = 0;
+    for (int s = 0; s < COUNT_OF(BLUR_SIZES); s++) {
+        blurMismatches += BenchBlur(BLUR_SIZES[s].cx, BLUR_SIZES[s].cy, samples);
+    }
+
+    int kernelMismatches = VerifyBlendKernels();
+    static const SIZE BLEND_SIZES[] = { { 320, 120 }, { 1280, 360 }, { 3840, 1080 } };
+    for (int s = 0; s < COUNT_OF(BLEND_SIZES); s++) {
+        BenchBlend(BLEND_SIZES[s].cx, BLEND_SIZES[s].cy, samples);
+    }
+
+    free(samples);
+    if (g_out != stdout) fclose(g_out);
+
+    int regressions = baselinePath ? CompareBaseline(baselinePath, maxRegression) : 0;
+
+    free(g_results);
+    WorkerPool_Shutdown();
+    CleanupDrawingEffects();
+    CleanupFontSTB();
+    return (regressions == 0 && kernelMismatches == 0 && blurMismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,2 @@
+/* Declarations live in windows.h */
+#include <windows.h>
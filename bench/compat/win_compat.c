@@ -0,0 +1,529 @@
+/**
+ * @file win_compat.c
+ * @brief POSIX implementations behind bench/compat/windows.h
+ *
+ * Handles are small tagged objects so CloseHandle and the wait functions
+ * can tell files, mappings, events and threads apart. Timeouts other than
+ * 0 and INFINITE are treated as INFINITE; the render core never uses them.
+ */
+
+#define _GNU_SOURCE
+#include <windows.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef enum {
+    COMPAT_FILE = 1,
+    COMPAT_MAPPING,
+    COMPAT_EVENT,
+    COMPAT_THREAD
+} CompatKind;
+
+typedef struct {
+    CompatKind kind;
+    int fd;
+    size_t size;
+} CompatFile;
+
+typedef struct {
+    CompatKind kind;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    BOOL manualReset;
+    BOOL signaled;
+} CompatEvent;
+
+typedef struct {
+    CompatKind kind;
+    pthread_t thread;
+    LPTHREAD_START_ROUTINE start;
+    LPVOID param;
+    BOOL joined;
+} CompatThread;
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static ULONGLONG MonotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ULONGLONG)ts.tv_sec * 1000000000ULL + (ULONGLONG)ts.tv_nsec;
+}
+
+DWORD GetTickCount(void) {
+    return (DWORD)(MonotonicNanos() / 1000000ULL);
+}
+
+ULONGLONG GetTickCount64(void) {
+    return MonotonicNanos() / 1000000ULL;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count) {
+    count->QuadPart = (LONGLONG)MonotonicNanos();
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency) {
+    frequency->QuadPart = 1000000000LL;
+    return TRUE;
+}
+
+void Sleep(DWORD ms) {
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+}
+
+/* ============================================================================
+ * Threads and synchronization
+ * ============================================================================ */
+
+void GetSystemInfo(SYSTEM_INFO* info) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    info->dwNumberOfProcessors = (DWORD)(cpus > 0 ? cpus : 1);
+}
+
+DWORD GetCurrentThreadId(void) {
+    return (DWORD)gettid();
+}
+
+DWORD GetCurrentProcessId(void) {
+    return (DWORD)getpid();
+}
+
+static void* ThreadTrampoline(void* arg) {
+    CompatThread* t = (CompatThread*)arg;
+    t->start(t->param);
+    return NULL;
+}
+
+HANDLE CreateThread(void* attributes, SIZE_T stackSize, LPTHREAD_START_ROUTINE start,
+                    LPVOID param, DWORD flags, DWORD* threadId) {
+    (void)attributes; (void)stackSize; (void)flags;
+    CompatThread* t = (CompatThread*)calloc(1, sizeof(CompatThread));
+    if (!t) return NULL;
+    t->kind = COMPAT_THREAD;
+    t->start = start;
+    t->param = param;
+    if (pthread_create(&t->thread, NULL, ThreadTrampoline, t) != 0) {
+        free(t);
+        return NULL;
+    }
+    if (threadId) *threadId = 0;
+    return (HANDLE)t;
+}
+
+HANDLE CreateEventW(void* attributes, BOOL manualReset, BOOL initialState, LPCWSTR name) {
+    (void)attributes; (void)name;
+    CompatEvent* e = (CompatEvent*)calloc(1, sizeof(CompatEvent));
+    if (!e) return NULL;
+    e->kind = COMPAT_EVENT;
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->cond, NULL);
+    e->manualReset = manualReset;
+    e->signaled = initialState;
+    return (HANDLE)e;
+}
+
+BOOL SetEvent(HANDLE event) {
+    CompatEvent* e = (CompatEvent*)event;
+    pthread_mutex_lock(&e->lock);
+    e->signaled = TRUE;
+    pthread_cond_broadcast(&e->cond);
+    pthread_mutex_unlock(&e->lock);
+    return TRUE;
+}
+
+BOOL ResetEvent(HANDLE event) {
+    CompatEvent* e = (CompatEvent*)event;
+    pthread_mutex_lock(&e->lock);
+    e->signaled = FALSE;
+    pthread_mutex_unlock(&e->lock);
+    return TRUE;
+}
+
+DWORD WaitForSingleObject(HANDLE handle, DWORD ms) {
+    CompatKind kind = *(CompatKind*)handle;
+
+    if (kind == COMPAT_THREAD) {
+        CompatThread* t = (CompatThread*)handle;
+        if (!t->joined) {
+            pthread_join(t->thread, NULL);
+            t->joined = TRUE;
+        }
+        return WAIT_OBJECT_0;
+    }
+
+    CompatEvent* e = (CompatEvent*)handle;
+    pthread_mutex_lock(&e->lock);
+    if (ms == 0 && !e->signaled) {
+        pthread_mutex_unlock(&e->lock);
+        return WAIT_TIMEOUT;
+    }
+    while (!e->signaled) {
+        pthread_cond_wait(&e->cond, &e->lock);
+    }
+    if (!e->manualReset) e->signaled = FALSE;
+    pthread_mutex_unlock(&e->lock);
+    return WAIT_OBJECT_0;
+}
+
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD ms) {
+    (void)waitAll;
+    for (DWORD i = 0; i < count; i++) {
+        WaitForSingleObject(handles[i], ms);
+    }
+    return WAIT_OBJECT_0;
+}
+
+BOOL CloseHandle(HANDLE handle) {
+    if (!handle || handle == INVALID_HANDLE_VALUE) return FALSE;
+
+    switch (*(CompatKind*)handle) {
+        case COMPAT_FILE:
+        case COMPAT_MAPPING: {
+            CompatFile* f = (CompatFile*)handle;
+            if (f->kind == COMPAT_FILE) close(f->fd);
+            break;
+        }
+        case COMPAT_EVENT: {
+            CompatEvent* e = (CompatEvent*)handle;
+            pthread_cond_destroy(&e->cond);
+            pthread_mutex_destroy(&e->lock);
+            break;
+        }
+        case COMPAT_THREAD: {
+            CompatThread* t = (CompatThread*)handle;
+            if (!t->joined) pthread_detach(t->thread);
+            break;
+        }
+    }
+    free(handle);
+    return TRUE;
+}
+
+void InitializeCriticalSection(CRITICAL_SECTION* cs) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    cs->impl = malloc(sizeof(pthread_mutex_t));
+    pthread_mutex_init((pthread_mutex_t*)cs->impl, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void DeleteCriticalSection(CRITICAL_SECTION* cs) {
+    if (!cs->impl) return;
+    pthread_mutex_destroy((pthread_mutex_t*)cs->impl);
+    free(cs->impl);
+    cs->impl = NULL;
+}
+
+void EnterCriticalSection(CRITICAL_SECTION* cs) {
+    pthread_mutex_lock((pthread_mutex_t*)cs->impl);
+}
+
+void LeaveCriticalSection(CRITICAL_SECTION* cs) {
+    pthread_mutex_unlock((pthread_mutex_t*)cs->impl);
+}
+
+/* ============================================================================
+ * Strings (UTF-8 <-> wchar_t, MSVC *_s variants)
+ * ============================================================================ */
+
+int MultiByteToWideChar(UINT codePage, DWORD flags, const char* src, int srcLen, wchar_t* dst, int dstLen) {
+    (void)codePage; (void)flags;
+    const unsigned char* s = (const unsigned char*)src;
+    size_t len = (srcLen < 0) ? strlen(src) + 1 : (size_t)srcLen;
+    int out = 0;
+
+    for (size_t i = 0; i < len; ) {
+        unsigned int c = s[i];
+        int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+        if (extra) c &= 0x3Fu >> extra;
+        i++;
+        for (int k = 0; k < extra && i < len; k++, i++) {
+            c = (c << 6) | (s[i] & 0x3Fu);
+        }
+        if (dstLen > 0) {
+            if (out >= dstLen) return 0;
+            dst[out] = (wchar_t)c;
+        }
+        out++;
+    }
+    return out;
+}
+
+int WideCharToMultiByte(UINT codePage, DWORD flags, const wchar_t* src, int srcLen,
+                        char* dst, int dstLen, const char* defaultChar, BOOL* usedDefault) {
+    (void)codePage; (void)flags; (void)defaultChar;
+    if (usedDefault) *usedDefault = FALSE;
+    size_t len = (srcLen < 0) ? wcslen(src) + 1 : (size_t)srcLen;
+    int out = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        unsigned int c = (unsigned int)src[i];
+        unsigned char buf[4];
+        int n;
+        if (c < 0x80) { buf[0] = (unsigned char)c; n = 1; }
+        else if (c < 0x800) { buf[0] = (unsigned char)(0xC0 | (c >> 6)); buf[1] = (unsigned char)(0x80 | (c & 0x3F)); n = 2; }
+        else if (c < 0x10000) { buf[0] = (unsigned char)(0xE0 | (c >> 12)); buf[1] = (unsigned char)(0x80 | ((c >> 6) & 0x3F)); buf[2] = (unsigned char)(0x80 | (c & 0x3F)); n = 3; }
+        else { buf[0] = (unsigned char)(0xF0 | (c >> 18)); buf[1] = (unsigned char)(0x80 | ((c >> 12) & 0x3F)); buf[2] = (unsigned char)(0x80 | ((c >> 6) & 0x3F)); buf[3] = (unsigned char)(0x80 | (c & 0x3F)); n = 4; }
+        if (dstLen > 0) {
+            if (out + n > dstLen) return 0;
+            memcpy(dst + out, buf, (size_t)n);
+        }
+        out += n;
+    }
+    return out;
+}
+
+int strcpy_s(char* dst, size_t size, const char* src) {
+    if (!dst || size == 0) return EINVAL;
+    snprintf(dst, size, "%s", src ? src : "");
+    return 0;
+}
+
+int strncpy_s(char* dst, size_t size, const char* src, size_t count) {
+    if (!dst || size == 0) return EINVAL;
+    size_t n = strnlen(src, count);
+    if (n >= size) n = size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+    return 0;
+}
+
+int strcat_s(char* dst, size_t size, const char* src) {
+    size_t used = strnlen(dst, size);
+    return strcpy_s(dst + used, size - used, src);
+}
+
+int wcscpy_s(wchar_t* dst, size_t size, const wchar_t* src) {
+    return wcsncpy_s(dst, size, src, _TRUNCATE);
+}
+
+int wcsncpy_s(wchar_t* dst, size_t size, const wchar_t* src, size_t count) {
+    if (!dst || size == 0) return EINVAL;
+    size_t n = wcsnlen(src, count);
+    if (n >= size) n = size - 1;
+    wmemcpy(dst, src, n);
+    dst[n] = L'\0';
+    return 0;
+}
+
+int wcscat_s(wchar_t* dst, size_t size, const wchar_t* src) {
+    size_t used = wcsnlen(dst, size);
+    return wcscpy_s(dst + used, size - used, src);
+}
+
+int sprintf_s(char* dst, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(dst, size, format, args);
+    va_end(args);
+    return n;
+}
+
+int _snprintf_s(char* dst, size_t size, size_t count, const char* format, ...) {
+    (void)count;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(dst, size, format, args);
+    va_end(args);
+    return (n >= 0 && (size_t)n < size) ? n : -1;
+}
+
+/* Note: glibc reads %s in wide formats as a narrow string (MSVC: wide) */
+int swprintf_s(wchar_t* dst, size_t size, const wchar_t* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vswprintf(dst, size, format, args);
+    va_end(args);
+    return n;
+}
+
+int _snwprintf_s(wchar_t* dst, size_t size, size_t count, const wchar_t* format, ...) {
+    (void)count;
+    va_list args;
+    va_start(args, format);
+    int n = vswprintf(dst, size, format, args);
+    va_end(args);
+    if (n < 0 && size > 0) dst[size - 1] = L'\0';
+    return n;
+}
+
+char* strtok_s(char* str, const char* delim, char** context) {
+    return strtok_r(str, delim, context);
+}
+
+wchar_t* wcstok_s(wchar_t* str, const wchar_t* delim, wchar_t** context) {
+    return wcstok(str, delim, context);
+}
+
+wchar_t* _wcsdup(const wchar_t* str) {
+    return wcsdup(str);
+}
+
+static BOOL WidePathToUtf8(const wchar_t* path, char* out, size_t size) {
+    return WideCharToMultiByte(CP_UTF8, 0, path, -1, out, (int)size, NULL, NULL) > 0;
+}
+
+FILE* _wfopen(const wchar_t* path, const wchar_t* mode) {
+    char narrowPath[MAX_PATH * 4];
+    char narrowMode[16];
+    if (!WidePathToUtf8(path, narrowPath, sizeof(narrowPath)) ||
+        !WidePathToUtf8(mode, narrowMode, sizeof(narrowMode))) {
+        return NULL;
+    }
+    return fopen(narrowPath, narrowMode);
+}
+
+/* ============================================================================
+ * Files and mappings
+ * ============================================================================ */
+
+HANDLE CreateFileW(LPCWSTR path, DWORD access, DWORD share, void* security,
+                   DWORD disposition, DWORD flags, HANDLE templateFile) {
+    (void)access; (void)share; (void)security; (void)disposition; (void)flags; (void)templateFile;
+    char narrowPath[MAX_PATH * 4];
+    if (!WidePathToUtf8(path, narrowPath, sizeof(narrowPath))) return INVALID_HANDLE_VALUE;
+
+    int fd = open(narrowPath, O_RDONLY);
+    if (fd < 0) return INVALID_HANDLE_VALUE;
+
+    struct stat st;
+    CompatFile* f = (fstat(fd, &st) == 0) ? (CompatFile*)calloc(1, sizeof(CompatFile)) : NULL;
+    if (!f) {
+        close(fd);
+        return INVALID_HANDLE_VALUE;
+    }
+    f->kind = COMPAT_FILE;
+    f->fd = fd;
+    f->size = (size_t)st.st_size;
+    return (HANDLE)f;
+}
+
+HANDLE CreateFileMappingW(HANDLE file, void* security, DWORD protect,
+                          DWORD sizeHigh, DWORD sizeLow, LPCWSTR name) {
+    (void)security; (void)protect; (void)sizeHigh; (void)sizeLow; (void)name;
+    if (!file || file == INVALID_HANDLE_VALUE) return NULL;
+
+    CompatFile* src = (CompatFile*)file;
+    CompatFile* m = (CompatFile*)calloc(1, sizeof(CompatFile));
+    if (!m) return NULL;
+    m->kind = COMPAT_MAPPING;
+    m->fd = src->fd;
+    m->size = src->size;
+    return (HANDLE)m;
+}
+
+/* Views are private heap copies; fonts are read once and kept */
+void* MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T bytes) {
+    (void)access; (void)offsetHigh; (void)offsetLow; (void)bytes;
+    CompatFile* m = (CompatFile*)mapping;
+    unsigned char* view = (unsigned char*)malloc(m->size ? m->size : 1);
+    if (!view) return NULL;
+
+    size_t done = 0;
+    while (done < m->size) {
+        ssize_t n = pread(m->fd, view + done, m->size - done, (off_t)done);
+        if (n <= 0) {
+            free(view);
+            return NULL;
+        }
+        done += (size_t)n;
+    }
+    return view;
+}
+
+BOOL UnmapViewOfFile(const void* view) {
+    if (!view) return FALSE;
+    free((void*)view);
+    return TRUE;
+}
+
+DWORD GetFileAttributesW(LPCWSTR path) {
+    char narrowPath[MAX_PATH * 4];
+    if (!WidePathToUtf8(path, narrowPath, sizeof(narrowPath))) return INVALID_FILE_ATTRIBUTES;
+    return GetFileAttributesA(narrowPath);
+}
+
+DWORD GetFileAttributesA(LPCSTR path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return INVALID_FILE_ATTRIBUTES;
+    return S_ISDIR(st.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+}
+
+BOOL CreateDirectoryA(LPCSTR path, void* security) {
+    (void)security;
+    return mkdir(path, 0777) == 0;
+}
+
+DWORD ExpandEnvironmentStringsW(LPCWSTR src, wchar_t* dst, DWORD size) {
+    size_t len = wcslen(src) + 1;
+    if (dst && size >= len) wmemcpy(dst, src, len);
+    return (DWORD)len;
+}
+
+DWORD ExpandEnvironmentStringsA(LPCSTR src, char* dst, DWORD size) {
+    size_t len = strlen(src) + 1;
+    if (dst && size >= len) memcpy(dst, src, len);
+    return (DWORD)len;
+}
+
+/* ============================================================================
+ * Window, GDI and shell
+ * ============================================================================ */
+
+BOOL PtInRect(const RECT* rect, POINT pt) {
+    return pt.x >= rect->left && pt.x < rect->right && pt.y >= rect->top && pt.y < rect->bottom;
+}
+
+BOOL InvalidateRect(HWND hwnd, const RECT* rect, BOOL erase) {
+    (void)hwnd; (void)rect; (void)erase;
+    return FALSE;
+}
+
+HPEN CreatePen(int style, int width, COLORREF color) {
+    (void)style; (void)width; (void)color;
+    return NULL;
+}
+
+HGDIOBJ SelectObject(HDC hdc, HGDIOBJ obj) {
+    (void)hdc; (void)obj;
+    return NULL;
+}
+
+BOOL DeleteObject(HGDIOBJ obj) {
+    (void)obj;
+    return FALSE;
+}
+
+BOOL MoveToEx(HDC hdc, int x, int y, POINT* previous) {
+    (void)hdc; (void)x; (void)y; (void)previous;
+    return FALSE;
+}
+
+BOOL LineTo(HDC hdc, int x, int y) {
+    (void)hdc; (void)x; (void)y;
+    return FALSE;
+}
+
+HINSTANCE ShellExecuteW(HWND hwnd, LPCWSTR op, LPCWSTR file, LPCWSTR params, LPCWSTR dir, int show) {
+    (void)hwnd; (void)op; (void)file; (void)params; (void)dir; (void)show;
+    return NULL;
+}
+
+HRESULT SHGetFolderPathW(HWND hwnd, int folder, HANDLE token, DWORD flags, wchar_t* path) {
+    (void)hwnd; (void)folder; (void)token; (void)flags;
+    path[0] = L'\0';
+    return -1;
+}
+
+void OutputDebugStringA(LPCSTR text) {
+    fputs(text, stderr);
+}
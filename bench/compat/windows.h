@@ -0,0 +1,222 @@
+/**
+ * @file windows.h
+ * @brief Minimal Win32 surface for building the render core off Windows
+ *
+ * Only what the render core (drawing_render_core.c and the STB, effect,
+ * layout and markdown modules behind it) touches. Types keep their Win32
+ * widths where it matters (DWORD, LONG, COLORREF); wchar_t stays the
+ * platform's, which the core only uses through wide-string functions.
+ * Implementations live in win_compat.c.
+ */
+
+#ifndef CATIME_BENCH_COMPAT_WINDOWS_H
+#define CATIME_BENCH_COMPAT_WINDOWS_H
+
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+/* ============================================================================
+ * Types
+ * ============================================================================ */
+
+typedef int BOOL;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint32_t UINT;
+typedef uint32_t ULONG;
+typedef int32_t LONG;
+typedef int64_t LONGLONG;
+typedef int64_t LONG64;
+typedef uint64_t ULONGLONG;
+typedef int32_t HRESULT;
+typedef size_t SIZE_T;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t INT_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef wchar_t WCHAR;
+typedef char CHAR;
+typedef DWORD COLORREF;
+typedef void* LPVOID;
+typedef DWORD* LPDWORD;
+typedef const char* LPCSTR;
+typedef const wchar_t* LPCWSTR;
+
+typedef void* HANDLE;
+typedef void* HWND;
+typedef void* HDC;
+typedef void* HGDIOBJ;
+typedef void* HBITMAP;
+typedef void* HPEN;
+typedef void* HBRUSH;
+typedef void* HFONT;
+typedef void* HINSTANCE;
+typedef void* HMODULE;
+
+typedef union {
+    struct { DWORD LowPart; LONG HighPart; };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG x, y; } POINT;
+typedef struct { LONG cx, cy; } SIZE;
+
+typedef struct { DWORD dwNumberOfProcessors; } SYSTEM_INFO;
+
+typedef struct {
+    void* impl;
+} CRITICAL_SECTION;
+
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID);
+
+/* ============================================================================
+ * Constants and macros
+ * ============================================================================ */
+
+#define WINAPI
+#define CALLBACK
+
+#define TRUE 1
+#define FALSE 0
+#define MAX_PATH 260
+#define INFINITE 0xFFFFFFFFu
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define WAIT_OBJECT_0 0u
+#define WAIT_TIMEOUT 258u
+#define S_OK 0
+#define SUCCEEDED(hr) ((HRESULT)(hr) >= 0)
+#define FAILED(hr) ((HRESULT)(hr) < 0)
+#define _TRUNCATE ((size_t)-1)
+
+#define CP_UTF8 65001
+#define GENERIC_READ 0x80000000u
+#define FILE_SHARE_READ 0x1u
+#define OPEN_EXISTING 3u
+#define FILE_ATTRIBUTE_NORMAL 0x80u
+#define FILE_ATTRIBUTE_DIRECTORY 0x10u
+#define INVALID_FILE_ATTRIBUTES ((DWORD)-1)
+#define PAGE_READONLY 0x02u
+#define FILE_MAP_READ 0x4u
+#define CSIDL_LOCAL_APPDATA 0x001c
+#define PS_SOLID 0
+#define SW_SHOWNORMAL 1
+
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#define GetRValue(rgb) ((BYTE)(rgb))
+#define GetGValue(rgb) ((BYTE)(((WORD)(rgb)) >> 8))
+#define GetBValue(rgb) ((BYTE)((rgb) >> 16))
+#define LOWORD(l) ((WORD)((UINT_PTR)(l) & 0xffff))
+#define HIWORD(l) ((WORD)(((UINT_PTR)(l) >> 16) & 0xffff))
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#define ZeroMemory(dst, len) memset((dst), 0, (len))
+#define CopyMemory(dst, src, len) memcpy((dst), (src), (len))
+
+/* ============================================================================
+ * Timing, threads and synchronization
+ * ============================================================================ */
+
+DWORD GetTickCount(void);
+ULONGLONG GetTickCount64(void);
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+void Sleep(DWORD ms);
+
+void GetSystemInfo(SYSTEM_INFO* info);
+DWORD GetCurrentThreadId(void);
+DWORD GetCurrentProcessId(void);
+
+HANDLE CreateThread(void* attributes, SIZE_T stackSize, LPTHREAD_START_ROUTINE start,
+                    LPVOID param, DWORD flags, DWORD* threadId);
+HANDLE CreateEventW(void* attributes, BOOL manualReset, BOOL initialState, LPCWSTR name);
+BOOL SetEvent(HANDLE event);
+BOOL ResetEvent(HANDLE event);
+DWORD WaitForSingleObject(HANDLE handle, DWORD ms);
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD ms);
+BOOL CloseHandle(HANDLE handle);
+
+void InitializeCriticalSection(CRITICAL_SECTION* cs);
+void DeleteCriticalSection(CRITICAL_SECTION* cs);
+void EnterCriticalSection(CRITICAL_SECTION* cs);
+void LeaveCriticalSection(CRITICAL_SECTION* cs);
+
+static inline LONG InterlockedIncrement(volatile LONG* p) { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedDecrement(volatile LONG* p) { return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedExchange(volatile LONG* p, LONG v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedExchangeAdd(volatile LONG* p, LONG v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+static inline LONG InterlockedCompareExchange(volatile LONG* p, LONG v, LONG cmp) {
+    __atomic_compare_exchange_n(p, &cmp, v, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return cmp;
+}
+static inline LONG64 InterlockedExchange64(volatile LONG64* p, LONG64 v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+static inline LONG64 InterlockedCompareExchange64(volatile LONG64* p, LONG64 v, LONG64 cmp) {
+    __atomic_compare_exchange_n(p, &cmp, v, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return cmp;
+}
+
+/* ============================================================================
+ * Files, paths and strings
+ * ============================================================================ */
+
+HANDLE CreateFileW(LPCWSTR path, DWORD access, DWORD share, void* security,
+                   DWORD disposition, DWORD flags, HANDLE templateFile);
+HANDLE CreateFileMappingW(HANDLE file, void* security, DWORD protect,
+                          DWORD sizeHigh, DWORD sizeLow, LPCWSTR name);
+void* MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T bytes);
+BOOL UnmapViewOfFile(const void* view);
+DWORD GetFileAttributesW(LPCWSTR path);
+DWORD GetFileAttributesA(LPCSTR path);
+BOOL CreateDirectoryA(LPCSTR path, void* security);
+DWORD ExpandEnvironmentStringsW(LPCWSTR src, wchar_t* dst, DWORD size);
+DWORD ExpandEnvironmentStringsA(LPCSTR src, char* dst, DWORD size);
+
+int MultiByteToWideChar(UINT codePage, DWORD flags, const char* src, int srcLen, wchar_t* dst, int dstLen);
+int WideCharToMultiByte(UINT codePage, DWORD flags, const wchar_t* src, int srcLen,
+                        char* dst, int dstLen, const char* defaultChar, BOOL* usedDefault);
+
+int strcpy_s(char* dst, size_t size, const char* src);
+int strncpy_s(char* dst, size_t size, const char* src, size_t count);
+int strcat_s(char* dst, size_t size, const char* src);
+int wcscpy_s(wchar_t* dst, size_t size, const wchar_t* src);
+int wcsncpy_s(wchar_t* dst, size_t size, const wchar_t* src, size_t count);
+int wcscat_s(wchar_t* dst, size_t size, const wchar_t* src);
+int sprintf_s(char* dst, size_t size, const char* format, ...);
+int _snprintf_s(char* dst, size_t size, size_t count, const char* format, ...);
+int swprintf_s(wchar_t* dst, size_t size, const wchar_t* format, ...);
+int _snwprintf_s(wchar_t* dst, size_t size, size_t count, const wchar_t* format, ...);
+char* strtok_s(char* str, const char* delim, char** context);
+wchar_t* wcstok_s(wchar_t* str, const wchar_t* delim, wchar_t** context);
+wchar_t* _wcsdup(const wchar_t* str);
+FILE* _wfopen(const wchar_t* path, const wchar_t* mode);
+
+/* ============================================================================
+ * Window, GDI and shell entry points the core references but never
+ * reaches without a window (gradient strips, link clicks)
+ * ============================================================================ */
+
+BOOL PtInRect(const RECT* rect, POINT pt);
+BOOL InvalidateRect(HWND hwnd, const RECT* rect, BOOL erase);
+HPEN CreatePen(int style, int width, COLORREF color);
+HGDIOBJ SelectObject(HDC hdc, HGDIOBJ obj);
+BOOL DeleteObject(HGDIOBJ obj);
+BOOL MoveToEx(HDC hdc, int x, int y, POINT* previous);
+BOOL LineTo(HDC hdc, int x, int y);
+HINSTANCE ShellExecuteW(HWND hwnd, LPCWSTR op, LPCWSTR file, LPCWSTR params, LPCWSTR dir, int show);
+HRESULT SHGetFolderPathW(HWND hwnd, int folder, HANDLE token, DWORD flags, wchar_t* path);
+void OutputDebugStringA(LPCSTR text);
+
+#endif /* CATIME_BENCH_COMPAT_WINDOWS_H */
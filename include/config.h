@@ -236,6 +236,11 @@ typedef struct {
     int scale_step_normal;
     int scale_step_fast;
     int text_effect;  /* TextEffectType enum value */
+    int effect_quality;  /* EffectQuality enum value */
+    float render_cpu_budget;  /* Percent of one core, 0 = unlimited */
+    BOOL sdf_text;
+    int max_window_height;  /* Pixels, 0 = fit the text */
+    BOOL trace_export;
 } DisplayConfig;
 
 /**
@@ -50,6 +50,11 @@ typedef struct {
     int scaleStepNormal;
     int scaleStepFast;
     int textEffect;  /* TextEffectType enum value */
+    int effectQuality;  /* EffectQuality enum value */
+    float renderCpuBudget;  /* Percent of one core, 0 = unlimited */
+    BOOL sdfText;
+    int maxWindowHeight;  /* Pixels, 0 = fit the text */
+    BOOL traceExport;
 
     /* Timer */
     int defaultStartTime;
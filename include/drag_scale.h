@@ -88,6 +88,8 @@ BOOL HandleDragWindow(HWND hwnd);
  * 
  * @details
  * Proportional scaling, clamped to MIN/MAX_SCALE_FACTOR, schedules save.
+ * Paints stretch the pre-gesture frame until the scale has been stable for
+ * SCALE_SETTLE_DELAY_MS, then the window re-renders at full quality.
  */
 BOOL HandleScaleWindow(HWND hwnd, int delta);
 
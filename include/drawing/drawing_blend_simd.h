@@ -0,0 +1,126 @@
+/**
+ * @file drawing_blend_simd.h
+ * @brief Row kernels for compositing glyph coverage into the BGRA buffer
+ *
+ * The glyph blenders clip once per row and hand the visible span to one of
+ * these kernels. The same table carries the byte-map resampling rows used
+ * by reduced-resolution effect blurs and the pixel rows of the interim frame
+ * scaler. Scalar versions are the reference; SSE2 and AVX2 versions
+ * are selected at runtime and must match them bit for bit, which is checked
+ * once before a SIMD table is used.
+ */
+
+#ifndef DRAWING_BLEND_SIMD_H
+#define DRAWING_BLEND_SIMD_H
+
+#include <windows.h>
+
+/**
+ * @brief Kernel with one color for the whole span
+ * @param dst First destination pixel (premultiplied 0xAARRGGBB)
+ * @param cov Coverage bytes, one per pixel
+ * @param count Pixels in the span
+ * @param color 0x00RRGGBB
+ */
+typedef void (*BlendRowSolidFn)(DWORD* dst, const unsigned char* cov, int count, DWORD color);
+
+/**
+ * @brief Kernel with one color per pixel
+ * @param colors 0x00RRGGBB per pixel, parallel to cov
+ */
+typedef void (*BlendRowColumnsFn)(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count);
+
+/**
+ * @brief Average 2x2 blocks of two map rows into one half-width row
+ * @param row0 Upper row, 2 * count bytes
+ * @param row1 Lower row, 2 * count bytes
+ * @param count Output bytes
+ */
+typedef void (*MapHalveRowFn)(unsigned char* dst, const unsigned char* row0, const unsigned char* row1, int count);
+
+/**
+ * @brief Blend two map rows: (row0 * (256 - weight) + row1 * weight + 128) / 256
+ * @param weight 0-256
+ */
+typedef void (*MapLerpRowsFn)(unsigned char* dst, const unsigned char* row0, const unsigned char* row1,
+                              int weight, int count);
+
+/**
+ * @brief Horizontal step of bilinear BGRA scaling
+ * @param dst Output pixels
+ * @param src Source row; src[srcX[i] + 1] must be readable for every i
+ * @param srcX Left source pixel per output pixel
+ * @param weights Weight of the right source pixel per output pixel, 0-256
+ * @param count Output pixels
+ * @details Per channel: (left * (256 - weight) + right * weight + 128) / 256,
+ *          which keeps premultiplied pixels premultiplied
+ */
+typedef void (*PixelScaleRowFn)(DWORD* dst, const DWORD* src, const int* srcX,
+                                const WORD* weights, int count);
+
+/**
+ * @brief Kernel set for one instruction set
+ */
+typedef struct {
+    /** Write premultiplied color where coverage > destination alpha */
+    BlendRowSolidFn maxSolid;
+    /** maxSolid with per-pixel colors */
+    BlendRowColumnsFn maxColumns;
+    /** Write premultiplied color wherever coverage != 0 */
+    BlendRowColumnsFn overwriteColumns;
+    /** dest + (color - dest) * coverage / 255 per channel, alpha toward 255 */
+    BlendRowSolidFn lerpSolid;
+    /** Rounded 2x2 box downsample of an 8-bit map */
+    MapHalveRowFn halveRow;
+    /** Vertical step of bilinear 8-bit map upsampling */
+    MapLerpRowsFn lerpRows;
+    /** Horizontal step of bilinear BGRA scaling (vertical step is lerpRows) */
+    PixelScaleRowFn scaleRow;
+    const char* name;
+} BlendKernels;
+
+/**
+ * @brief Best verified kernel set for this CPU
+ */
+const BlendKernels* BlendKernels_Get(void);
+
+/**
+ * @brief Scalar reference kernels
+ */
+const BlendKernels* BlendKernels_GetScalar(void);
+
+/**
+ * @brief SIMD kernel sets this CPU can run, best first, not yet verified
+ * @param sets Output array
+ * @param capacity Entries in sets
+ * @return Number of sets written (0 without x86 SIMD)
+ */
+int BlendKernels_GetSupported(const BlendKernels** sets, int capacity);
+
+/**
+ * @brief Compare every function of a kernel set with the scalar reference
+ * @param minCount Narrowest span checked (0 allowed)
+ * @param maxCount Widest span checked, at most 67
+ * @return TRUE if all outputs are identical on randomized rows
+ */
+BOOL BlendKernels_Verify(const BlendKernels* k, int minCount, int maxCount);
+
+/**
+ * @brief Shared scratch for per-pixel color rows
+ * @param count Entries needed
+ * @return Buffer valid until the next call, or NULL on allocation failure
+ */
+DWORD* BlendKernels_ColumnScratch(int count);
+
+/**
+ * @brief Bilinear resize of a premultiplied BGRA image
+ * @param k Kernel set (BlendKernels_Get() in production)
+ * @param dst Output image, dstWidth * dstHeight, rows packed
+ * @param src Source image, srcWidth * srcHeight, rows packed
+ * @return FALSE on bad sizes or allocation failure (dst untouched)
+ * @note Pixel centers are aligned, edges clamp; not thread-safe (shared scratch)
+ */
+BOOL BlendKernels_ScaleImage(const BlendKernels* k, DWORD* dst, int dstWidth, int dstHeight,
+                             const DWORD* src, int srcWidth, int srcHeight);
+
+#endif /* DRAWING_BLEND_SIMD_H */
@@ -2,6 +2,7 @@
 #define DRAWING_EFFECT_H
 
 #include <windows.h>
+#include "menu_preview.h"
 
 /**
  * @brief Callback for retrieving color at specific coordinates
@@ -30,12 +31,15 @@ typedef void (*GlowColorCallback)(int x, int y, int* r, int* g, int* b, void* us
  * @param b Glow color Blue (0-255) - Used if callback is NULL
  * @param colorCb Optional callback for per-pixel color (e.g., for gradients). If NULL, uses r,g,b.
  * @param userData User data passed to colorCb
+ * @param field Optional distance field aligned with bitmap (SDF_FIELD_* encoding);
+ *              when given, the glow is read from distance instead of blurred
  */
 void RenderGlowEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData);
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field);
 
 /**
  * @brief Render a glass/liquid crystal effect
@@ -53,21 +57,25 @@ void RenderGlowEffect(DWORD* pixels, int destWidth, int destHeight,
  * @param b Base color Blue (0-255)
  * @param colorCb Optional callback for per-pixel color
  * @param userData User data passed to colorCb
+ * @param field Optional distance field aligned with bitmap; replaces the shadow blur
  */
 void RenderGlassEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData);
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field);
 
 /**
  * @brief Render Hong Kong style Neon Tube effect (Double-line Outline + Glow)
+ * @param field Optional distance field aligned with bitmap; replaces erosion and both blurs
  */
 void RenderNeonEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData);
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field);
 
 /**
  * @brief Render Holographic/Prism Dispersion effect
@@ -103,6 +111,82 @@ void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
  */
 void ApplyGaussianBlur(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer, int w, int h, int radius);
 
+/**
+ * @brief Original single-threaded box blur
+ * @details Kept as the reference the fast engine must match bit for bit,
+ *          for the one-time self-check and for catime_bench.
+ *          Same arguments as ApplyGaussianBlur.
+ */
+void ApplyGaussianBlurReference(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer,
+                                int w, int h, int radius);
+
+/**
+ * @brief Streaming box blur behind ApplyGaussianBlur, without its self-check
+ * @return FALSE if the column scratch could not be allocated (dest untouched)
+ */
+BOOL ApplyGaussianBlurFast(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer,
+                           int w, int h, int radius);
+
+/**
+ * @brief Approximate a true Gaussian with three box passes
+ * 
+ * Opt-in alternative to the single box pass of ApplyGaussianBlur: box widths
+ * are chosen so the combined variance equals sigma^2. Costs three
+ * ApplyGaussianBlur passes; src and dest may be the same buffer. catime_bench
+ * measures its error against an exact Gaussian.
+ * 
+ * @param sigma Standard deviation in pixels
+ */
+void ApplyGaussianBlur3(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer, int w, int h, float sigma);
+
+/**
+ * @brief What the renderer needs to know about an effect without running it
+ */
+typedef struct {
+    int padding;         /**< Pixels the effect draws beyond the text coverage */
+    BOOL timeDependent;  /**< Output changes with timeOffset, so frames must be redrawn */
+} EffectTraits;
+
+/**
+ * @brief Look up an effect's traits
+ * @return Traits, or NULL for EFFECT_TYPE_NONE
+ */
+const EffectTraits* GetEffectTraits(EffectType effect);
+
+/**
+ * @brief Check whether an effect needs the animation timer
+ * @return TRUE only for effects whose output varies between identical frames
+ */
+BOOL IsEffectTimeDependent(EffectType effect);
+
+/**
+ * @brief Resolution of the wide blur maps behind glow, neon and holographic
+ *
+ * Values are the downsampling factor. Rims and text bodies always stay at
+ * full resolution; only the soft maps are blurred small and upsampled.
+ */
+typedef enum {
+    EFFECT_QUALITY_FULL = 1,
+    EFFECT_QUALITY_HALF = 2,
+    EFFECT_QUALITY_QUARTER = 4
+} EffectQuality;
+
+/**
+ * @brief Change the blur map resolution; takes effect on the next frame
+ */
+void SetEffectQuality(EffectQuality quality);
+
+/**
+ * @brief Limit the resolution regardless of the configured quality
+ * @details Used by the frame governor; EFFECT_QUALITY_FULL lifts the limit
+ */
+void SetEffectQualityFloor(EffectQuality quality);
+
+/**
+ * @brief Blur map resolution in effect (configured or governor limit, whichever is coarser)
+ */
+EffectQuality GetEffectQuality(void);
+
 /**
  * @brief Free static resources used by drawing effects
  */
@@ -0,0 +1,46 @@
+/**
+ * @file drawing_effect_cache.h
+ * @brief Composed output of time-invariant effect runs, kept between frames
+ *
+ * A static effect's result depends only on its inputs: the run's coverage,
+ * paint and position plus the pixels already under it. Callers hash those
+ * inputs into a key; on a repeat the stored pixels are copied back instead
+ * of running the effect again.
+ */
+
+#ifndef DRAWING_EFFECT_CACHE_H
+#define DRAWING_EFFECT_CACHE_H
+
+#include <windows.h>
+
+/** @brief Initial value for EffectCache_Hash chains */
+#define EFFECT_CACHE_HASH_SEED 14695981039346656037ULL
+
+/**
+ * @brief Fold a byte range into a running hash
+ */
+ULONGLONG EffectCache_Hash(const void* data, size_t size, ULONGLONG hash);
+
+/**
+ * @brief Fold the pixels of a region of the destination into a running hash
+ */
+ULONGLONG EffectCache_HashRegion(const DWORD* pixels, int destWidth, const RECT* region,
+                                 ULONGLONG hash);
+
+/**
+ * @brief Copy a stored result into the destination
+ * @return TRUE on a hit; on a miss the destination is untouched
+ */
+BOOL EffectCache_Restore(ULONGLONG key, DWORD* pixels, int destWidth, const RECT* region);
+
+/**
+ * @brief Keep a composed region for later frames (least recently used entry is replaced)
+ */
+void EffectCache_Store(ULONGLONG key, const DWORD* pixels, int destWidth, const RECT* region);
+
+/**
+ * @brief Drop all stored results and free their memory
+ */
+void EffectCache_Clear(void);
+
+#endif /* DRAWING_EFFECT_CACHE_H */
@@ -0,0 +1,45 @@
+/**
+ * @file drawing_font_metrics.h
+ * @brief Codepoint-to-glyph metrics table for the STB main/fallback faces
+ *
+ * Resolves a character through the fallback chain once and remembers the
+ * owning face, glyph index and unscaled advance. U+0000-U+00FF live in a
+ * direct array; other codepoints in an open-addressing hash table. Kerning
+ * pairs are cached lazily. Everything is dropped when the font changes.
+ */
+
+#ifndef DRAWING_FONT_METRICS_H
+#define DRAWING_FONT_METRICS_H
+
+#include <windows.h>
+
+/** @brief Kerning pair cache slots (direct-mapped, power of two) */
+#define FONT_METRICS_KERN_SLOTS 4096
+
+/**
+ * @brief Resolved glyph for one codepoint
+ */
+typedef struct {
+    int index;          /**< Glyph index in the owning face (0 = missing) */
+    BOOL isFallback;    /**< Owning face is the fallback font */
+    int advanceUnits;   /**< Unscaled horizontal advance */
+} CodepointGlyph;
+
+/**
+ * @brief Resolve a character against main then fallback face
+ * @param c Character (not '\n', '\r' or '\t')
+ * @return Table entry, or NULL if no font is loaded / out of memory
+ */
+const CodepointGlyph* FontMetrics_Lookup(wchar_t c);
+
+/**
+ * @brief Unscaled kerning between two main-face glyphs (cached)
+ */
+int FontMetrics_KernUnits(int leftIndex, int rightIndex);
+
+/**
+ * @brief Drop all tables (font or fallback chain changed)
+ */
+void FontMetrics_Reset(void);
+
+#endif /* DRAWING_FONT_METRICS_H */
@@ -0,0 +1,121 @@
+/**
+ * @file drawing_frame_governor.h
+ * @brief Paint cost measurement driving frame pacing and effect quality
+ *
+ * Every paint is timed per stage with QueryPerformanceCounter and folded
+ * into moving averages. The average frame cost sets the animation interval
+ * so that painting stays within a CPU budget (percent of one core). When
+ * even the longest interval overruns, the governor lowers the effect blur
+ * resolution step by step and finally suspends effects; levels come back
+ * after a sustained quiet period.
+ */
+
+#ifndef DRAWING_FRAME_GOVERNOR_H
+#define DRAWING_FRAME_GOVERNOR_H
+
+#include <windows.h>
+
+/** @brief Fastest animation interval (about 30 fps) */
+#define GOVERNOR_MIN_INTERVAL 33
+
+/** @brief Slowest animation interval before quality is reduced */
+#define GOVERNOR_MAX_INTERVAL 250
+
+/**
+ * @brief Timed parts of a paint
+ */
+typedef enum {
+    FRAME_STAGE_PARSE = 0,   /**< Time text, plugin tags, markdown parse */
+    FRAME_STAGE_LAYOUT,      /**< Measurement and window resize */
+    FRAME_STAGE_RASTER,      /**< Clear, glyphs, images (effects excluded) */
+    FRAME_STAGE_EFFECT,      /**< Text effect passes */
+    FRAME_STAGE_PRESENT,     /**< UpdateLayeredWindow */
+    FRAME_STAGE_COUNT
+} FrameStage;
+
+/**
+ * @brief Degradation steps, applied in order under sustained overload
+ */
+typedef enum {
+    GOVERNOR_LEVEL_CONFIGURED = 0,  /**< Effects at the configured quality */
+    GOVERNOR_LEVEL_HALF,            /**< Blur maps at 1/2 resolution at most */
+    GOVERNOR_LEVEL_QUARTER,         /**< Blur maps at 1/4 resolution */
+    GOVERNOR_LEVEL_NO_EFFECTS       /**< Effects suspended */
+} GovernorLevel;
+
+/**
+ * @brief Snapshot of the governor's measurements
+ */
+typedef struct {
+    double stageMs[FRAME_STAGE_COUNT];  /**< Moving average per stage */
+    double frameMs;                     /**< Moving average of the whole paint */
+    double cpuPercent;                  /**< Paint time over wall time, last window */
+    double budgetPercent;               /**< Configured budget, 0 = unlimited */
+    UINT animationInterval;             /**< Current animation timer interval (ms) */
+    GovernorLevel level;
+    DWORD frames;                       /**< Frames measured since start */
+} FrameGovernorStats;
+
+/**
+ * @brief Set the paint budget
+ * @param percentOfCore CPU share of one core; 0 or less disables the limit
+ */
+void FrameGovernor_SetBudget(float percentOfCore);
+
+/**
+ * @brief Start timing a paint; the first stage begins now
+ */
+void FrameGovernor_BeginFrame(void);
+
+/**
+ * @brief Charge the time since the previous mark to a stage
+ * @note Nested time already reported with FrameGovernor_AddNested is excluded
+ */
+void FrameGovernor_EndStage(FrameStage stage);
+
+/**
+ * @brief Current QPC value for FrameGovernor_AddNested
+ */
+LONGLONG FrameGovernor_Now(void);
+
+/**
+ * @brief Charge a span inside another stage to its own stage
+ * @param startTicks Value of FrameGovernor_Now() when the span began
+ */
+void FrameGovernor_AddNested(FrameStage stage, LONGLONG startTicks);
+
+/**
+ * @brief Finish a paint and update averages, pacing and level
+ * @param effectsInUse An effect is configured (suspended effects count)
+ */
+void FrameGovernor_EndFrame(BOOL effectsInUse);
+
+/**
+ * @brief Close a paint that ended without composing a frame
+ * @details Skipped (unchanged) frames and failed surface setup call this
+ *          instead of FrameGovernor_EndFrame: their time counts toward CPU
+ *          usage but not toward the frame and stage averages
+ */
+void FrameGovernor_CancelFrame(void);
+
+/**
+ * @brief Animation timer interval that keeps animated frames within budget
+ */
+UINT FrameGovernor_AnimationInterval(void);
+
+/**
+ * @brief Minimum spacing between effect frames (0 when cost is negligible)
+ */
+DWORD FrameGovernor_FrameSpacing(void);
+
+/**
+ * @brief Check whether effects are suspended to stay within budget
+ */
+BOOL FrameGovernor_EffectsSuspended(void);
+
+/**
+ * @brief Copy the current measurements (for logs and diagnostics)
+ */
+void FrameGovernor_GetStats(FrameGovernorStats* stats);
+
+#endif /* DRAWING_FRAME_GOVERNOR_H */
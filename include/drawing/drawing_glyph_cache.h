@@ -0,0 +1,82 @@
+/**
+ * @file drawing_glyph_cache.h
+ * @brief Persistent glyph coverage cache for the STB text renderer
+ *
+ * Rasterized glyph bitmaps are keyed by (face, pixel scale, glyph index,
+ * fallback flag) and kept across paints, so a clock that redraws the same
+ * digits every tick only pays for stbtt_GetGlyphBitmap once per glyph.
+ * Memory is bounded by GLYPH_CACHE_MAX_BYTES with LRU eviction. Misses
+ * rasterize from the outline cache (drawing_outline_cache.h), so a new
+ * scale does not decode the font outline again.
+ *
+ * With distance-field text on, lookups are answered by the SDF atlas
+ * instead (see drawing_sdf_atlas.h), so new scales sample rather than
+ * rasterize.
+ */
+
+#ifndef DRAWING_GLYPH_CACHE_H
+#define DRAWING_GLYPH_CACHE_H
+
+#include <windows.h>
+#include "../../libs/stb/stb_truetype.h"
+
+/** @brief Coverage memory budget (bitmaps + entry headers) */
+#define GLYPH_CACHE_MAX_BYTES (4 * 1024 * 1024)
+
+/** @brief Hash bucket count (power of two) */
+#define GLYPH_CACHE_BUCKETS 1024
+
+/**
+ * @brief Cached glyph coverage
+ * @note bitmap is NULL for empty glyphs (w or h == 0); owned by the cache
+ */
+typedef struct {
+    unsigned char* bitmap;
+    int w;
+    int h;
+    int xoff;
+    int yoff;
+} CachedGlyph;
+
+/**
+ * @brief Get glyph coverage, rasterizing on miss
+ * @param face Font the glyph index belongs to
+ * @param scale stb_truetype pixel scale
+ * @param glyphIndex Glyph index in face
+ * @param isFallback TRUE if glyph comes from the fallback chain
+ * @return Cached glyph (valid until next GlyphCache_* call that may evict), or NULL on allocation failure
+ */
+const CachedGlyph* GlyphCache_Get(const stbtt_fontinfo* face, float scale,
+                                  int glyphIndex, BOOL isFallback);
+
+/**
+ * @brief Drop all entries rasterized from one face
+ * @param face Font being unloaded or replaced
+ */
+void GlyphCache_InvalidateFace(const stbtt_fontinfo* face);
+
+/**
+ * @brief Drop all entries and release memory
+ */
+void GlyphCache_Clear(void);
+
+/**
+ * @brief Route lookups through the distance field atlas
+ * @note Callers must drop anything composed from earlier coverage
+ */
+void GlyphCache_SetDistanceField(BOOL enabled);
+
+/**
+ * @brief Check whether lookups are answered by the distance field atlas
+ */
+BOOL GlyphCache_IsDistanceField(void);
+
+/**
+ * @brief Cache statistics for diagnostics
+ * @param hits Output lookup hits (optional)
+ * @param misses Output lookup misses (optional)
+ * @param bytes Output bytes currently held (optional)
+ */
+void GlyphCache_GetStats(DWORD* hits, DWORD* misses, SIZE_T* bytes);
+
+#endif /* DRAWING_GLYPH_CACHE_H */
@@ -9,9 +9,18 @@
 #include <windows.h>
 #include "markdown/markdown_parser.h"
 #include "drawing/drawing_text_stb.h"
+#include "drawing/drawing_style_runs.h"
+
+/**
+ * @brief Vertical window onto text taller than the output buffer
+ */
+typedef struct {
+    int scrollY;  /**< Text block y drawn at the buffer's top row */
+} MarkdownViewport;
 
 /**
  * @brief Measure multi-line Markdown text with headings
+ * @note Builds line boxes only; glyphs are laid out by the render pass
  */
 BOOL MeasureMarkdownSTB(const wchar_t* text,
                         MarkdownHeading* headings, int headingCount,
@@ -19,14 +28,18 @@ BOOL MeasureMarkdownSTB(const wchar_t* text,
 
 /**
  * @brief Render multi-line Markdown text
+ * @param runs Inline attributes of the text (see StyleRuns_Build); an empty
+ *             table draws everything in the base style
+ * @param viewport NULL centers the whole text block; otherwise the block is
+ *                 top-aligned at -scrollY and only lines intersecting the
+ *                 buffer are laid out and drawn
  */
 void RenderMarkdownSTB(void* bits, int width, int height, const wchar_t* text,
                        MarkdownLink* links, int linkCount,
                        MarkdownHeading* headings, int headingCount,
-                       MarkdownStyle* styles, int styleCount,
+                       const StyleRunTable* runs,
                        MarkdownBlockquote* blockquotes, int blockquoteCount,
-                       MarkdownColorTag* colorTags, int colorTagCount,
-                       MarkdownFontTag* fontTags, int fontTagCount,
-                       COLORREF color, int fontSize, float fontScale, int gradientMode);
+                       COLORREF color, int fontSize, float fontScale, int gradientMode,
+                       const MarkdownViewport* viewport);
 
 #endif // DRAWING_MARKDOWN_STB_H
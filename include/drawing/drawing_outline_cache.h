@@ -0,0 +1,63 @@
+/**
+ * @file drawing_outline_cache.h
+ * @brief Decoded glyph outline cache for the STB rasterizer
+ *
+ * stbtt_GetGlyphBitmap decodes the glyf/CFF outline and its bounding box on
+ * every call, so every glyph cache miss caused by a new scale parses the
+ * font again. This cache keeps the decoded vertex array and font-unit box
+ * per (face, glyph index), and rasterizes from them at any scale with
+ * output identical to stbtt_GetGlyphBitmap.
+ *
+ * Memory is bounded by OUTLINE_CACHE_MAX_BYTES with LRU eviction.
+ */
+
+#ifndef DRAWING_OUTLINE_CACHE_H
+#define DRAWING_OUTLINE_CACHE_H
+
+#include <windows.h>
+#include "../../libs/stb/stb_truetype.h"
+
+/** @brief Outline memory budget (vertex arrays + entry headers) */
+#define OUTLINE_CACHE_MAX_BYTES (2 * 1024 * 1024)
+
+/** @brief Hash bucket count (power of two) */
+#define OUTLINE_CACHE_BUCKETS 1024
+
+/** @brief Curve flattening tolerance, same as stbtt_GetGlyphBitmap */
+#define OUTLINE_FLATNESS_PIXELS 0.35f
+
+/**
+ * @brief Rasterize a glyph from its cached outline, decoding it on miss
+ * @param face Font the glyph index belongs to
+ * @param scale stb_truetype pixel scale (x and y)
+ * @param glyphIndex Glyph index in face
+ * @param width Output bitmap width
+ * @param height Output bitmap height
+ * @param xoff Output left bearing in pixels
+ * @param yoff Output top offset in pixels
+ * @return Coverage bitmap to release with stbtt_FreeBitmap, or NULL for
+ *         empty glyphs and allocation failure (sizes still reported)
+ */
+unsigned char* OutlineCache_Rasterize(const stbtt_fontinfo* face, float scale, int glyphIndex,
+                                      int* width, int* height, int* xoff, int* yoff);
+
+/**
+ * @brief Drop all outlines decoded from one face
+ * @param face Font being unloaded or replaced
+ */
+void OutlineCache_InvalidateFace(const stbtt_fontinfo* face);
+
+/**
+ * @brief Drop all outlines and release memory
+ */
+void OutlineCache_Clear(void);
+
+/**
+ * @brief Cache statistics for diagnostics
+ * @param hits Output lookup hits (optional)
+ * @param misses Output lookup misses (optional)
+ * @param bytes Output bytes currently held (optional)
+ */
+void OutlineCache_GetStats(DWORD* hits, DWORD* misses, SIZE_T* bytes);
+
+#endif /* DRAWING_OUTLINE_CACHE_H */
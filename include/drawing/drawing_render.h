@@ -13,9 +13,72 @@
  * @param hwnd Window handle
  * @param ps Paint structure from BeginPaint
  * @note Double-buffering eliminates flicker
- * @note Window auto-resizes to fit text
+ * @note Window auto-resizes to fit text, up to MAX_WINDOW_HEIGHT; taller
+ *       text is drawn through a scrolling viewport
  */
 void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps);
 
+/**
+ * Force the next paint to compose and present even if nothing visible changed
+ * @note Call after anything that discards layered window content
+ *       (e.g. SetLayeredWindowAttributes, WS_EX_LAYERED reset)
+ */
+void InvalidateRenderedFrame(void);
+
+/**
+ * Start an interactive scale gesture (no-op if one is active)
+ * @details Snapshots the last presented frame; until EndInterimScale, paints
+ *          present that snapshot bilinearly resized to the client area
+ *          instead of laying out and rasterizing at every intermediate scale
+ */
+void BeginInterimScale(void);
+
+/**
+ * End the scale gesture and make the next paint compose at full quality
+ */
+void EndInterimScale(void);
+
+/**
+ * @return TRUE between BeginInterimScale and EndInterimScale
+ */
+BOOL IsInterimScaleActive(void);
+
+/**
+ * Unit of a ScrollRenderedText request
+ */
+typedef enum {
+    TEXT_SCROLL_WHEEL,  /**< Wheel delta (WHEEL_DELTA per notch, positive = up) */
+    TEXT_SCROLL_LINES,  /**< Lines, positive = down */
+    TEXT_SCROLL_PAGES,  /**< Window heights, positive = down */
+    TEXT_SCROLL_EDGE    /**< Negative = start, positive = end */
+} TextScrollUnit;
+
+/**
+ * Scroll text taller than MAX_WINDOW_HEIGHT
+ * @return FALSE if the text fits the window (nothing to scroll), so the
+ *         caller can give the input its usual meaning
+ * @note Repaints only if the position changed; scrolling to the end keeps
+ *       the view at the end as the text grows
+ */
+BOOL ScrollRenderedText(HWND hwnd, TextScrollUnit unit, int amount);
+
+/**
+ * @return TRUE if the last paint showed a scrolling viewport
+ */
+BOOL IsRenderedTextScrollable(void);
+
+/**
+ * Log paint counters, parse memo and glyph/outline cache use, and frame
+ * governor averages (part of the --probe-stats dump)
+ * @note Available without CATIME_PROBES; the counters are always kept
+ */
+void LogRenderStats(void);
+
+/**
+ * Release the persistent back buffer
+ * @note Call once at shutdown
+ */
+void CleanupDrawingRender(void);
+
 #endif /* DRAWING_RENDER_H */
 
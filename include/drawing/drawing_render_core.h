@@ -0,0 +1,152 @@
+/**
+ * @file drawing_render_core.h
+ * @brief Window-independent text composition (text + style -> BGRA pixels)
+ *
+ * The part of a paint that does not touch a window or a DC: markdown
+ * parsing, measurement and STB rasterization with the active text effect
+ * into a caller-owned premultiplied BGRA buffer. HandleWindowPaint wraps
+ * it with window sizing, images and presentation; catime_bench drives it
+ * directly. The effect comes from GetActiveEffect(), which the host
+ * provides (menu_preview.c in the app).
+ *
+ * Parse results are memoized by content hash in a small LRU and shared
+ * read-only between documents. Callers that know where the clock digits
+ * sit pass them to RenderCore_ParseWithTime, so a frame whose only change
+ * is the time reuses the parse and just patches the digits in. The style
+ * run table is built with the parse and memoized along with it.
+ */
+
+#ifndef DRAWING_RENDER_CORE_H
+#define DRAWING_RENDER_CORE_H
+
+#include <windows.h>
+#include "markdown/markdown_parser.h"
+#include "drawing/drawing_style_runs.h"
+
+/** @brief Memoized parse results kept for reuse */
+#define RENDER_CORE_PARSE_CACHE_ENTRIES 8
+
+/** @brief Longest input worth memoizing; longer text is parsed directly */
+#define RENDER_CORE_PARSE_CACHE_MAX_CHARS 16384
+
+struct RenderCoreParseEntry;
+
+/**
+ * @brief Character span of the input text that holds clock output
+ */
+typedef struct {
+    int start;
+    int length;
+} RenderCoreTextRange;
+
+/**
+ * @brief Parsed text ready for measurement and drawing
+ * @note Zero-initialize or fill with RenderCore_Parse. The element arrays
+ *       may belong to a memoized parse shared with other documents and
+ *       must be treated as read-only (link rects are per-draw output).
+ */
+typedef struct {
+    const wchar_t* text;            /**< Display text (markup removed) */
+    wchar_t* ownedText;             /**< Patched display text owned by this document, if any */
+    MarkdownArena arena;            /**< Parser arena behind text and the arrays, if owned */
+    struct RenderCoreParseEntry* shared;  /**< Memoized parse holding the arrays, if any */
+    BOOL isMarkdown;
+    MarkdownLink* links; int linkCount;
+    MarkdownHeading* headings; int headingCount;
+    MarkdownStyle* styles; int styleCount;
+    MarkdownListItem* listItems; int listItemCount;
+    MarkdownBlockquote* blockquotes; int blockquoteCount;
+    MarkdownColorTag* colorTags; int colorTagCount;
+    MarkdownFontTag* fontTags; int fontTagCount;
+    StyleRunTable runs;             /**< Links, styles, color and font tags resolved into runs */
+} RenderCoreDocument;
+
+/**
+ * @brief Text appearance
+ */
+typedef struct {
+    COLORREF textColor;
+    int gradientMode;               /**< GradientType, GRADIENT_NONE for solid */
+    int fontSize;                   /**< Pixel height passed to STB */
+} RenderCoreStyle;
+
+/**
+ * @brief Parse markup, reusing a memoized result for identical text
+ * @note Always pair with RenderCore_FreeDocument. text is not retained.
+ */
+void RenderCore_Parse(const wchar_t* text, RenderCoreDocument* doc);
+
+/**
+ * @brief RenderCore_Parse for text whose time digits change every frame
+ * @param text Input text
+ * @param timeRanges Spans of text holding the time
+ * @param rangeCount Entries in timeRanges (0 behaves like RenderCore_Parse)
+ * @param doc Output document
+ * @details The memo key has the digits inside timeRanges masked. The first
+ *          parse of a key is checked against a parse with the masks, and
+ *          only when both agree on every element is the key reused with
+ *          the digits patched into the display text; otherwise (digits
+ *          that start a list item, hex colors, ...) the exact text is
+ *          the key.
+ */
+void RenderCore_ParseWithTime(const wchar_t* text, const RenderCoreTextRange* timeRanges,
+                              int rangeCount, RenderCoreDocument* doc);
+
+/**
+ * @brief Release the document's reference or allocations
+ */
+void RenderCore_FreeDocument(RenderCoreDocument* doc);
+
+/**
+ * @brief Drop memoized parses no document references
+ */
+void RenderCore_ClearParseCache(void);
+
+/**
+ * @brief Parse memo statistics for diagnostics
+ * @param hits Output parses served from the memo (optional)
+ * @param misses Output parses that ran the parser (optional)
+ */
+void RenderCore_GetParseCacheStats(DWORD* hits, DWORD* misses);
+
+/**
+ * @brief Check whether any color tag animates (more than one color)
+ */
+BOOL RenderCore_HasColorTagGradient(const RenderCoreDocument* doc);
+
+/**
+ * @brief Measure the document with the currently loaded STB font
+ * @return FALSE if no font is loaded or the text is empty
+ */
+BOOL RenderCore_Measure(const RenderCoreDocument* doc, int fontSize, int* width, int* height);
+
+/**
+ * @brief Rasterize the document into a BGRA buffer (not cleared first)
+ * @note Requires a loaded STB font (InitFontSTB)
+ */
+void RenderCore_Draw(const RenderCoreDocument* doc, const RenderCoreStyle* style,
+                     void* bits, int width, int height);
+
+/**
+ * @brief Rasterize the rows [scrollY, scrollY + height) of the document
+ * @param scrollY Text block y shown at the buffer's top row
+ * @details The text block is top-aligned instead of centered. Only the
+ *          lines inside the buffer are laid out and drawn, so the cost
+ *          follows the buffer size rather than the document length.
+ */
+void RenderCore_DrawViewport(const RenderCoreDocument* doc, const RenderCoreStyle* style,
+                             void* bits, int width, int height, int scrollY);
+
+/**
+ * @brief Clock read by time-based effects and animated gradients (ms)
+ * @return Pinned value if set, otherwise GetTickCount()
+ */
+DWORD RenderCore_GetTime(void);
+
+/**
+ * @brief Freeze the animation clock so frames are reproducible
+ * @param pinned FALSE returns to GetTickCount()
+ */
+void RenderCore_PinTime(BOOL pinned, DWORD timeMs);
+
+#endif /* DRAWING_RENDER_CORE_H */
@@ -0,0 +1,79 @@
+/**
+ * @file drawing_sdf_atlas.h
+ * @brief Signed distance field glyph atlas for scale-independent text
+ *
+ * Each face gets one 8-bit atlas of glyph distance fields generated once
+ * with stbtt_GetGlyphSDF at SDF_REFERENCE_PIXELS. Any other size is drawn
+ * by sampling the atlas bilinearly and thresholding with a smoothstep, so a
+ * continuous drag-scale never rasterizes outlines again.
+ *
+ * Sampled glyphs are kept in a fixed arena keyed by (face, scale, glyph)
+ * that is reset when full, so scaling allocates nothing once the arena is
+ * warm. Every sampled glyph carries a field next to its coverage: the
+ * signed distance to the outline in destination pixels, which effects use
+ * in place of blurring the coverage.
+ */
+
+#ifndef DRAWING_SDF_ATLAS_H
+#define DRAWING_SDF_ATLAS_H
+
+#include <windows.h>
+#include "drawing/drawing_glyph_cache.h"
+
+/** @brief Atlas side length in texels (one atlas per face) */
+#define SDF_ATLAS_SIZE 1024
+
+/** @brief Faces with a live atlas; the least recently used one is replaced */
+#define SDF_ATLAS_MAX_FACES 4
+
+/** @brief Pixel height the distance fields are generated at */
+#define SDF_REFERENCE_PIXELS 48.0f
+
+/** @brief Reference pixels of distance stored around each glyph */
+#define SDF_PADDING 16
+
+/** @brief Sampled glyph arena (coverage + field), reset when full */
+#define SDF_SAMPLE_ARENA_BYTES (4 * 1024 * 1024)
+
+/**
+ * @brief Field encoding handed to effects
+ * @details value = SDF_FIELD_EDGE + distance inside the outline in
+ *          destination pixels * SDF_FIELD_STEPS_PER_PIXEL, clamped to 0..255.
+ *          0 therefore means "SDF_FIELD_REACH pixels outside or farther".
+ */
+#define SDF_FIELD_EDGE 128
+#define SDF_FIELD_STEPS_PER_PIXEL 8
+
+/** @brief Farthest distance outside the outline a field can express, in pixels */
+#define SDF_FIELD_REACH ((float)SDF_FIELD_EDGE / SDF_FIELD_STEPS_PER_PIXEL)
+
+/**
+ * @brief Get glyph coverage sampled from the face's distance field atlas
+ * @param face Font the glyph index belongs to
+ * @param scale stb_truetype pixel scale of the destination size
+ * @param glyphIndex Glyph index in face
+ * @return Glyph (valid until the next SdfAtlas_* call), or NULL on allocation failure
+ * @note bitmap is NULL for empty glyphs, like the glyph cache
+ */
+const CachedGlyph* SdfAtlas_Get(const stbtt_fontinfo* face, float scale, int glyphIndex);
+
+/**
+ * @brief Distance field that belongs to coverage returned by SdfAtlas_Get
+ * @param coverage Glyph bitmap as passed to the blenders
+ * @param w Bitmap width
+ * @param h Bitmap height
+ * @return w * h field bytes, or NULL if coverage did not come from the atlas
+ */
+const unsigned char* SdfAtlas_FieldOf(const unsigned char* coverage, int w, int h);
+
+/**
+ * @brief Drop the atlas and sampled glyphs of one face
+ */
+void SdfAtlas_InvalidateFace(const stbtt_fontinfo* face);
+
+/**
+ * @brief Drop all atlases and release memory
+ */
+void SdfAtlas_Clear(void);
+
+#endif /* DRAWING_SDF_ATLAS_H */
@@ -0,0 +1,72 @@
+/**
+ * @file drawing_style_runs.h
+ * @brief Markdown spans flattened into sorted, non-overlapping style runs
+ *
+ * The renderer used to keep one cursor per element array (links, styles,
+ * color tags, font tags), advance all of them for every character and
+ * re-derive color, weight and face per glyph. The run table does that
+ * resolution once per parse: runs tile the display text in order and each
+ * carries the attributes all of its characters share, so the renderer only
+ * switches state at run boundaries.
+ *
+ * Line-level attributes (alert title lines, completed todo strikethrough,
+ * blockquote bars) and heading scale stay with the layout and the renderer.
+ */
+
+#ifndef DRAWING_STYLE_RUNS_H
+#define DRAWING_STYLE_RUNS_H
+
+#include <windows.h>
+#include "markdown/markdown_parser.h"
+
+#define STYLE_RUN_BOLD    0x01
+#define STYLE_RUN_ITALIC  0x02
+#define STYLE_RUN_STRIKE  0x04
+#define STYLE_RUN_COLOR   0x08  /**< color replaces the base (or alert) color */
+
+/** @brief Link text color (#00AFFF) */
+#define STYLE_RUN_LINK_COLOR RGB(0, 175, 255)
+
+/** @brief Inline code color */
+#define STYLE_RUN_CODE_COLOR RGB(100, 100, 100)
+
+/**
+ * @brief Characters [start, end) with fully resolved attributes
+ * @note Color precedence matches the per-character rules it replaces:
+ *       single-color tag over inline code over link. A multi-color tag
+ *       sets gradient and leaves color to the lower-precedence sources.
+ */
+typedef struct {
+    int start;
+    int end;
+    unsigned int flags;                /**< STYLE_RUN_* */
+    COLORREF color;                    /**< Valid with STYLE_RUN_COLOR */
+    const MarkdownColorTag* gradient;  /**< Animated color tag, or NULL */
+    const wchar_t* fontName;           /**< Font tag face, NULL for the main font */
+    int linkIndex;                     /**< Index into the links array, -1 outside links */
+} StyleRun;
+
+/**
+ * @brief Runs covering a whole display text
+ * @note Pointers in the runs refer to the arrays the table was built from
+ */
+typedef struct {
+    StyleRun* runs;
+    int count;
+    BOOL hasColorTags;  /**< Any color tag was parsed (animates off the frame clock) */
+} StyleRunTable;
+
+/**
+ * @brief Build the run table for parsed markdown
+ * @param table Output table; runs are allocated from arena
+ * @param arena Arena owning the element arrays
+ * @param textLength Display text length in characters
+ * @return FALSE on allocation failure (table left empty)
+ */
+BOOL StyleRuns_Build(StyleRunTable* table, MarkdownArena* arena, int textLength,
+                     const MarkdownLink* links, int linkCount,
+                     const MarkdownStyle* styles, int styleCount,
+                     const MarkdownColorTag* colorTags, int colorTagCount,
+                     const MarkdownFontTag* fontTags, int fontTagCount);
+
+#endif /* DRAWING_STYLE_RUNS_H */
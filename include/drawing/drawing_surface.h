@@ -0,0 +1,58 @@
+/**
+ * @file drawing_surface.h
+ * @brief Persistent 32-bit back buffer for layered window presentation
+ *
+ * Owns the memory DC and the DIB section across paints. Pixel storage lives
+ * in a pagefile-backed section sized in power-of-two buckets, so the DIB
+ * header is only rebuilt when the client size changes and the backing
+ * memory only when the size crosses a bucket boundary.
+ */
+
+#ifndef DRAWING_SURFACE_H
+#define DRAWING_SURFACE_H
+
+#include <windows.h>
+
+/** @brief Smallest backing section (bytes) */
+#define RENDER_SURFACE_MIN_BYTES (64 * 1024)
+
+/**
+ * @brief Reusable render target
+ * @note Zero-initialize before first use
+ */
+typedef struct {
+    HDC memDC;
+    HBITMAP bitmap;
+    HBITMAP oldBitmap;
+    HANDLE hSection;
+    SIZE_T sectionBytes;
+    void* bits;
+    int width;
+    int height;
+} RenderSurface;
+
+/**
+ * @brief Make surface ready for a width x height top-down BGRA frame
+ * @param surface Surface to (re)configure
+ * @param refDC DC the memory DC should be compatible with
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @return TRUE if memDC/bits are usable, FALSE on GDI failure
+ * @note Pixel contents are undefined afterwards; call RenderSurface_Clear
+ */
+BOOL RenderSurface_Prepare(RenderSurface* surface, HDC refDC, int width, int height);
+
+/**
+ * @brief Fill the whole frame with one premultiplied pixel value
+ * @param surface Prepared surface
+ * @param clearColor 0xAARRGGBB value
+ */
+void RenderSurface_Clear(RenderSurface* surface, DWORD clearColor);
+
+/**
+ * @brief Release DC, DIB and backing section
+ * @param surface Surface to destroy (left zeroed)
+ */
+void RenderSurface_Destroy(RenderSurface* surface);
+
+#endif /* DRAWING_SURFACE_H */
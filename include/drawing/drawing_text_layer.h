@@ -0,0 +1,72 @@
+/**
+ * @file drawing_text_layer.h
+ * @brief Coverage mask that lets text effects run once per text run
+ *
+ * While a layer is open, glyphs that would carry an effect are merged into
+ * one window-sized coverage mask instead of being drawn. Consecutive glyphs
+ * with the same paint share the mask; when the paint changes or the layer
+ * ends, the union bounding box is handed to the flush callback, which runs
+ * the effect a single time over the whole run.
+ *
+ * Glyphs sampled from the distance field atlas also bring their field; a
+ * run made only of such glyphs is flushed with the union field so effects
+ * can shape glow and rims from distance instead of blurring the mask.
+ */
+
+#ifndef DRAWING_TEXT_LAYER_H
+#define DRAWING_TEXT_LAYER_H
+
+#include <windows.h>
+
+/**
+ * @brief Color source shared by every glyph in a run
+ * @note Compared with memcmp, so always memset before filling
+ */
+typedef struct {
+    int gradientType;   /**< GRADIENT_NONE for a solid color */
+    int r;              /**< Solid color, or gradient base color */
+    int g;
+    int b;
+    int startX;         /**< Gradient origin in window x */
+    int totalWidth;     /**< Gradient span */
+    int timeOffset;     /**< Gradient animation phase (0 for solid) */
+} TextLayerPaint;
+
+/**
+ * @brief Draws one finished run
+ * @param pixels Destination buffer
+ * @param x Union box left edge in window coordinates
+ * @param y Union box top edge
+ * @param mask Coverage of the run, w * h bytes, valid during the call only
+ * @param field Distance field of the run (same layout), or NULL if any glyph lacked one
+ */
+typedef void (*TextLayerFlushFn)(DWORD* pixels, int destWidth, int destHeight,
+                                 int x, int y, unsigned char* mask, int w, int h,
+                                 const unsigned char* field, const TextLayerPaint* paint);
+
+/**
+ * @brief Start collecting glyph coverage for a frame
+ * @return FALSE if the mask could not be allocated (glyphs then draw directly)
+ * @note An already open layer is flushed first
+ */
+BOOL TextLayer_Begin(void* bits, int width, int height, TextLayerFlushFn flush);
+
+/**
+ * @brief Merge a glyph into the open layer
+ * @param field Glyph distance field (SDF_FIELD_* encoding), or NULL
+ * @return FALSE if no layer is open and the caller must draw the glyph itself
+ */
+BOOL TextLayer_AddGlyph(int x_pos, int y_pos, const unsigned char* bitmap, int w, int h,
+                        const unsigned char* field, const TextLayerPaint* paint);
+
+/**
+ * @brief Flush the pending run and close the layer
+ */
+void TextLayer_End(void);
+
+/**
+ * @brief Release the mask buffers
+ */
+void TextLayer_Cleanup(void);
+
+#endif /* DRAWING_TEXT_LAYER_H */
@@ -0,0 +1,108 @@
+/**
+ * @file drawing_text_layout.h
+ * @brief Cached line/glyph layout shared by measure and render passes
+ *
+ * A paint used to walk the text five times (two window measurements, the
+ * renderer's own measurement, then a per-line measure and draw pass), each
+ * repeating cmap and kerning lookups. TextLayout is built once per distinct
+ * (text, headings, font size, font) and reused until one of them changes.
+ *
+ * Long documents shown through a scrolling viewport only need glyphs for
+ * the lines on screen. The line boxes form an index whose y values are the
+ * prefix sums of the line heights; when the text changes, lines whose
+ * characters and heading levels are unchanged keep their measured boxes
+ * and only new or edited lines are measured. TextLayout_GetLines then lays
+ * out glyphs for the lines inside a vertical range alone.
+ */
+
+#ifndef DRAWING_TEXT_LAYOUT_H
+#define DRAWING_TEXT_LAYOUT_H
+
+#include <windows.h>
+#include "markdown/markdown_parser.h"
+
+/**
+ * @brief Per-character layout entry (parallel to the text)
+ * @note index == 0 means nothing to rasterize (control char, missing glyph)
+ */
+typedef struct {
+    int index;           /**< Glyph index in main or fallback face */
+    BOOL isFallback;     /**< Glyph comes from the fallback face */
+    int x;               /**< Pen x relative to the block's left edge */
+    int advance;         /**< Advance without kerning */
+    int kern;            /**< Kerning against the next character on the line */
+    float scale;         /**< Main-face scale for this character (heading-aware) */
+    float fallbackScale; /**< Fallback-face scale for this character */
+} LayoutGlyph;
+
+/**
+ * @brief Line box
+ */
+typedef struct {
+    int start;   /**< First character index */
+    int end;     /**< One past the last character (excludes '\n') */
+    int y;       /**< Top relative to the block's top edge */
+    int height;  /**< Tallest run on the line */
+    int ascent;  /**< Baseline offset from y */
+    int width;   /**< Measured width (horizontal rule markers excluded) */
+    int checkboxesBefore;  /**< Checkbox markers (U+25A1, U+25A0) on earlier lines */
+} LayoutLine;
+
+/**
+ * @brief Layout of one text block
+ */
+typedef struct {
+    const wchar_t* text;   /**< Copy of the laid-out text */
+    int length;
+    LayoutGlyph* glyphs;   /**< Entries for lines [glyphLineStart, glyphLineEnd), see TextLayout_Glyph */
+    int glyphStart;        /**< Text index of glyphs[0] */
+    int glyphLineStart;    /**< First line with glyphs */
+    int glyphLineEnd;      /**< One past the last line with glyphs */
+    LayoutLine* lines;     /**< Every line of the text */
+    int lineCount;
+    int width;             /**< Widest line */
+    int height;            /**< Sum of line heights */
+} TextLayout;
+
+/**
+ * @brief Get layout for text, building it on first use
+ * @param text Display text (markdown already stripped)
+ * @param headings Heading ranges (may be NULL)
+ * @param headingCount Number of headings
+ * @param fontSize Pixel size of the base font
+ * @return Cached layout with glyphs for every line (valid until the next
+ *         TextLayout_* call), or NULL if no font / OOM
+ */
+const TextLayout* TextLayout_Get(const wchar_t* text,
+                                 const MarkdownHeading* headings, int headingCount,
+                                 int fontSize);
+
+/**
+ * @brief Get layout with glyphs only for lines overlapping [top, bottom)
+ * @param top Block y of the first pixel row needed
+ * @param bottom Block y one past the last row (top == bottom: line boxes only)
+ * @return Cached layout as for TextLayout_Get; glyphs outside the glyph
+ *         line range must not be accessed
+ */
+const TextLayout* TextLayout_GetLines(const wchar_t* text,
+                                      const MarkdownHeading* headings, int headingCount,
+                                      int fontSize, int top, int bottom);
+
+/**
+ * @brief Glyph of a character on a line in [glyphLineStart, glyphLineEnd)
+ */
+static inline const LayoutGlyph* TextLayout_Glyph(const TextLayout* layout, int index) {
+    return &layout->glyphs[index - layout->glyphStart];
+}
+
+/**
+ * @brief Index of the line containing block y (clamped to the first/last line)
+ */
+int TextLayout_LineAt(const TextLayout* layout, int y);
+
+/**
+ * @brief Drop cached layouts (font change)
+ */
+void TextLayout_Clear(void);
+
+#endif /* DRAWING_TEXT_LAYOUT_H */
@@ -57,23 +57,17 @@ stbtt_fontinfo* GetCachedFontSTB(const wchar_t* fontName);
 void ClearFontCacheSTB(void);
 
 /**
- * @brief Measure single-line text dimensions
+ * @brief Draw glyphs from distance field atlases instead of rasterizing them
+ * @details Every size samples the same per-face atlas, so continuous scaling
+ *          never rasterizes outlines, and glow, glass and neon read their soft
+ *          maps from distance instead of blurring. Off by default.
  */
-BOOL MeasureTextSTB(const wchar_t* text, int fontSize, int* width, int* height);
+void SetDistanceFieldTextSTB(BOOL enabled);
 
 /**
- * @brief Render single-line text to a 32-bit DIB buffer
- * @param bits Pointer to DIB section bits (ARGB)
- * @param width Width of the buffer
- * @param height Height of the buffer
- * @param text Text to render
- * @param color Text color (COLORREF)
- * @param fontSize Font size in pixels
- * @param fontScale DPI scale factor (usually 1.0 or system DPI scale)
- * @param editMode If TRUE, may render background hints
+ * @brief Check whether glyphs come from distance field atlases
  */
-void RenderTextSTB(void* bits, int width, int height, const wchar_t* text, 
-                   COLORREF color, int fontSize, float fontScale, BOOL editMode);
+BOOL IsDistanceFieldTextSTB(void);
 
 /* ============================================================================
  * Internal API for Markdown Renderer (Shared Helpers)
@@ -106,4 +100,16 @@ void BlendCharBitmapGradientSTB(void* destBits, int destWidth, int destHeight,
                                 int startX, int totalWidth, int gradientType,
                                 int timeOffset);
 
+/**
+ * @brief Collect effect glyphs into one layer so the effect runs once per run
+ * @return TRUE if a layer was opened (close it with EndTextLayerSTB)
+ * @note Does nothing without an active effect
+ */
+BOOL BeginTextLayerSTB(void* bits, int width, int height);
+
+/**
+ * @brief Apply the effect to pending glyphs and close the layer
+ */
+void EndTextLayerSTB(void);
+
 #endif // DRAWING_TEXT_STB_H
@@ -0,0 +1,42 @@
+/**
+ * @file drawing_worker_pool.h
+ * @brief Persistent worker threads for splitting effect passes into bands
+ *
+ * Effect passes are independent per row (or per column), so they are cut
+ * into contiguous bands and run on a small pool created on first use. The
+ * calling thread works on bands too and returns once all bands are done,
+ * so callers keep their single-threaded structure and output.
+ */
+
+#ifndef DRAWING_WORKER_POOL_H
+#define DRAWING_WORKER_POOL_H
+
+#include <windows.h>
+
+/** @brief Upper bound on helper threads (caller not included) */
+#define WORKER_POOL_MAX_THREADS 7
+
+/**
+ * @brief Process items [begin, end) of a pass
+ */
+typedef void (*WorkerBandFn)(int begin, int end, void* userData);
+
+/**
+ * @brief Run fn over [0, count) split into bands
+ * @param count Number of items (rows or columns)
+ * @param grain Minimum items per band; small passes stay on the caller
+ * @note Not reentrant: band functions must not call back into the pool
+ */
+void WorkerPool_ParallelFor(int count, int grain, WorkerBandFn fn, void* userData);
+
+/**
+ * @brief Threads that work on a pass, including the caller
+ */
+int WorkerPool_ThreadCount(void);
+
+/**
+ * @brief Stop and join the worker threads
+ */
+void WorkerPool_Shutdown(void);
+
+#endif /* DRAWING_WORKER_POOL_H */
@@ -0,0 +1,77 @@
+/**
+ * @file log_probe.h
+ * @brief Timing probes with a lock-free sample history
+ *
+ * Probes time named stages (paint steps, tray icon updates, plugin file
+ * polls) with QueryPerformanceCounter and push each duration into a
+ * fixed-size ring shared by all threads. Probe_LogStats() writes
+ * p50/p95/p99 per stage to the log; run "catime --probe-stats" to ask the
+ * running instance for a dump.
+ *
+ * The PROBE_* macros expand to nothing unless the build defines
+ * CATIME_PROBES (CMake option of the same name), so release builds carry
+ * no timing code.
+ */
+
+#ifndef LOG_PROBE_H
+#define LOG_PROBE_H
+
+#include <windows.h>
+
+/** @brief Samples kept across all stages (power of two) */
+#define PROBE_HISTORY_SIZE 4096
+
+/**
+ * @brief Timed stages
+ */
+typedef enum {
+    PROBE_PAINT_TOTAL = 0,     /**< Whole HandleWindowPaint (rendered frames) */
+    PROBE_TIME_TEXT,           /**< GetTimeText */
+    PROBE_PLUGIN_SUBST,        /**< Plugin text, <catime> tags, image extraction */
+    PROBE_MARKDOWN_PARSE,      /**< ParseMarkdownLinks */
+    PROBE_MEASURE,             /**< Text/image measurement and window resize */
+    PROBE_DIB_SETUP,           /**< Back buffer prepare and clear */
+    PROBE_RASTERIZE,           /**< Text rendering, effects included */
+    PROBE_EFFECTS,             /**< One text effect pass (per run) */
+    PROBE_IMAGE_DRAW,          /**< Markdown images */
+    PROBE_HIT_REGIONS,         /**< Clickable region alpha fill */
+    PROBE_PRESENT,             /**< UpdateLayeredWindow */
+    PROBE_TRAY_ICON,           /**< UpdateTrayIconToCurrentFrame */
+    PROBE_PLUGIN_POLL,         /**< One plugin output file poll */
+    PROBE_INTERIM_SCALE,       /**< Snapshot resize for one scale-gesture frame */
+    PROBE_STAGE_COUNT
+} ProbeStage;
+
+#ifdef CATIME_PROBES
+
+/** @brief Declare a start timestamp named var */
+#define PROBE_START(var) LONGLONG var = Probe_Now()
+
+/** @brief Record the time since PROBE_START(var) against stage */
+#define PROBE_END(stage, var) Probe_Record((stage), Probe_Now() - (var))
+
+#else
+
+#define PROBE_START(var) ((void)0)
+#define PROBE_END(stage, var) ((void)0)
+
+#endif
+
+/**
+ * @brief Current QPC value
+ */
+LONGLONG Probe_Now(void);
+
+/**
+ * @brief Push one duration into the history (any thread)
+ * @param ticks Duration in QPC ticks
+ */
+void Probe_Record(ProbeStage stage, LONGLONG ticks);
+
+/**
+ * @brief Log sample count, p50/p95/p99 and max per stage
+ * @note Logs a notice instead when probes are compiled out
+ */
+void Probe_LogStats(void);
+
+#endif /* LOG_PROBE_H */
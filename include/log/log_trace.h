@@ -0,0 +1,76 @@
+/**
+ * @file log_trace.h
+ * @brief Span and instant-event tracing exported as Chrome trace_event JSON
+ *
+ * Threads record spans (Trace_Begin/Trace_End) and instant events into a
+ * bounded ring that keeps the newest TRACE_BUFFER_EVENTS entries. The
+ * ring is written to Catime_Trace.json next to Catime_Logs.log when
+ * tracing stops, at exit, or on "catime --trace-save"; open it in
+ * Perfetto or chrome://tracing. Each thread gets its own named track.
+ *
+ * Tracing is off unless TRACE_EXPORT=TRUE in [Display] or catime is
+ * started (or re-invoked) with --trace. While off, every call is a
+ * single flag check.
+ *
+ * Event and thread names must be string literals: only the pointer is
+ * stored.
+ */
+
+#ifndef LOG_TRACE_H
+#define LOG_TRACE_H
+
+#include <windows.h>
+
+/** @brief Events kept in the ring (power of two) */
+#define TRACE_BUFFER_EVENTS 16384
+
+/**
+ * @brief Enable or disable tracing from the config file
+ * @note Disabling writes the collected trace unless --trace keeps it on
+ */
+void Trace_Configure(BOOL enabled);
+
+/**
+ * @brief Enable tracing for the rest of this session (--trace)
+ */
+void Trace_EnableForSession(void);
+
+/**
+ * @brief Check whether events are being recorded
+ */
+BOOL Trace_IsEnabled(void);
+
+/**
+ * @brief Name the calling thread's track
+ */
+void Trace_NameThread(const char* name);
+
+/**
+ * @brief Start a span
+ * @return Start timestamp for Trace_End, 0 when tracing is off
+ */
+LONGLONG Trace_Begin(void);
+
+/**
+ * @brief Record a span on the calling thread's track
+ * @param start Value returned by Trace_Begin; 0 records nothing
+ */
+void Trace_End(const char* name, LONGLONG start);
+
+/**
+ * @brief Record an instant event on the calling thread's track
+ */
+void Trace_Instant(const char* name);
+
+/**
+ * @brief Write the collected events to Catime_Trace.json now
+ * @return TRUE if a file was written
+ */
+BOOL Trace_Save(void);
+
+/**
+ * @brief Write the trace if tracing is on and stop recording (at exit)
+ */
+void Trace_Shutdown(void);
+
+#endif /* LOG_TRACE_H */
@@ -113,10 +113,43 @@ typedef struct {
     wchar_t fontName[MAX_FONT_NAME_LENGTH];
 } MarkdownFontTag;
 
+/**
+ * @brief Bump allocator behind one parse; released as a whole
+ */
+typedef struct MarkdownArenaChunk MarkdownArenaChunk;
+typedef struct {
+    MarkdownArenaChunk* chunk;  /**< Current chunk, earlier ones linked from it */
+    int chunkCount;
+} MarkdownArena;
+
+/**
+ * @brief Parse result whose text, arrays and link strings live in one arena
+ * @note Release with FreeMarkdownDocument only; nothing in it is freed separately
+ */
+typedef struct {
+    wchar_t* displayText;
+    MarkdownLink* links;
+    int linkCount;
+    MarkdownHeading* headings;
+    int headingCount;
+    MarkdownStyle* styles;
+    int styleCount;
+    MarkdownListItem* listItems;
+    int listItemCount;
+    MarkdownBlockquote* blockquotes;
+    int blockquoteCount;
+    MarkdownColorTag* colorTags;
+    int colorTagCount;
+    MarkdownFontTag* fontTags;
+    int fontTagCount;
+    MarkdownArena arena;
+} MarkdownDocument;
+
 /**
  * @brief Internal parser state (used by parsing logic)
  */
 typedef struct {
+    MarkdownArena* arena;
     wchar_t* displayText;
     MarkdownLink* links;
     int linkCount;
@@ -142,6 +175,24 @@ typedef struct {
     int currentPos;
 } ParseState;
 
+/**
+ * @brief Parse markdown into an arena-backed document in a single scan
+ * @param input Input text with markdown
+ * @param doc Output document (zeroed on failure)
+ * @return TRUE on success, FALSE on empty input or allocation failure
+ *
+ * @details
+ * Element records are appended to arrays that grow inside the document's
+ * arena, so there is no counting pre-pass and FreeMarkdownDocument is the
+ * only release. Output matches ParseMarkdownLinks.
+ */
+BOOL ParseMarkdownDocument(const wchar_t* input, MarkdownDocument* doc);
+
+/**
+ * @brief Release a document from ParseMarkdownDocument (left zeroed)
+ */
+void FreeMarkdownDocument(MarkdownDocument* doc);
+
 /**
  * @brief Parse [text](url) links, # headings, inline styles, list items, and blockquotes from input
  * @param input Input text with markdown
@@ -159,8 +210,8 @@ typedef struct {
  * @return TRUE on success, FALSE on allocation failure
  *
  * @details
- * Pre-allocates exact memory (scans once to count, eliminating realloc overhead).
- * Supports:
+ * Wraps ParseMarkdownDocument and copies the result into separately
+ * allocated arrays for callers that keep them. Supports:
  * - Headings: # ## ### #### at line start
  * - Inline styles: *italic*, **bold**, ***bold+italic***, `code`
  * - List items: - item or * item at line start (supports nested lists with indentation)
@@ -360,6 +411,10 @@ BOOL HandleMarkdownClick(MarkdownLink* links, int linkCount, POINT clickPoint);
 
 /* Internal API (state management - markdown_state.c) */
 
+void* MarkdownArenaAlloc(MarkdownArena* arena, size_t bytes);
+void* MarkdownArenaGrow(MarkdownArena* arena, void* block, size_t oldBytes, size_t newBytes);
+wchar_t* MarkdownArenaCopyString(MarkdownArena* arena, const wchar_t* start, size_t length);
+void FreeMarkdownArena(MarkdownArena* arena);
 BOOL EnsureLinkCapacity(ParseState* state);
 BOOL EnsureHeadingCapacity(ParseState* state);
 BOOL EnsureStyleCapacity(ParseState* state);
@@ -368,24 +423,9 @@ BOOL EnsureBlockquoteCapacity(ParseState* state);
 BOOL EnsureColorTagCapacity(ParseState* state);
 BOOL EnsureFontTagCapacity(ParseState* state);
 void CleanupParseState(ParseState* state);
-int GetInitialLinkCapacity(int estimatedCount);
-int GetInitialHeadingCapacity(int estimatedCount);
-int GetInitialStyleCapacity(int estimatedCount);
-int GetInitialListItemCapacity(int estimatedCount);
-int GetInitialBlockquoteCapacity(int estimatedCount);
-int GetInitialColorTagCapacity(int estimatedCount);
-int GetInitialFontTagCapacity(int estimatedCount);
 
 /* Internal API (inline elements - markdown_inline.c) */
 
-BOOL ExtractWideString(const wchar_t* start, const wchar_t* end, wchar_t** output);
-int CountMarkdownLinks(const wchar_t* input);
-int CountMarkdownHeadings(const wchar_t* input);
-int CountMarkdownStyles(const wchar_t* input);
-int CountMarkdownListItems(const wchar_t* input);
-int CountMarkdownBlockquotes(const wchar_t* input);
-int CountMarkdownColorTags(const wchar_t* input);
-int CountMarkdownFontTags(const wchar_t* input);
 BOOL ExtractMarkdownLink(const wchar_t** src, ParseState* state);
 BOOL ExtractMarkdownStyle(const wchar_t** src, ParseState* state);
 BOOL ExtractMarkdownCode(const wchar_t** src, ParseState* state);
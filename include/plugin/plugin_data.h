@@ -7,6 +7,7 @@
 #define PLUGIN_DATA_H
 
 #include <windows.h>
+#include "plugin/plugin_template.h"
 
 /**
  * @brief Initialize plugin data subsystem
@@ -27,6 +28,15 @@ void PluginData_Shutdown(void);
  */
 BOOL PluginData_GetText(wchar_t* buffer, size_t maxLen);
 
+/**
+ * @brief Get the current plugin display text compiled for splicing
+ * @return Template of the text PluginData_GetText would return, or NULL
+ *         if plugin mode is inactive
+ * @note Main thread only; recompiled only after the text changes, and
+ *       valid until the next call
+ */
+const PluginTemplate* PluginData_GetTemplate(void);
+
 /**
  * @brief Clear all plugin data
  */
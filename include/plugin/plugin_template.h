@@ -0,0 +1,85 @@
+/**
+ * @file plugin_template.h
+ * @brief Plugin text compiled into literal, time-slot and image segments
+ *
+ * Plugin text only changes when the plugin writes new output, but the time
+ * inside <catime></catime> changes every frame. Compiling the text once per
+ * change leaves each frame with a linear splice of the current time string
+ * into precompiled segments.
+ */
+
+#ifndef PLUGIN_TEMPLATE_H
+#define PLUGIN_TEMPLATE_H
+
+#include <windows.h>
+#include "markdown/markdown_image.h"
+
+typedef enum {
+    PLUGIN_SEGMENT_LITERAL,  /**< Copied from the source as-is */
+    PLUGIN_SEGMENT_TIME,     /**< <catime>...</catime>, replaced by the time text */
+    PLUGIN_SEGMENT_IMAGE     /**< ![WxH](path), removed from the text, extracted as an image */
+} PluginSegmentType;
+
+/**
+ * @brief One segment; start/length index the template source
+ */
+typedef struct {
+    PluginSegmentType type;
+    int start;
+    int length;
+} PluginSegment;
+
+/**
+ * @brief Character span in expanded text
+ */
+typedef struct {
+    int start;
+    int length;
+} PluginTextRange;
+
+/**
+ * @brief Compiled plugin text
+ * @note Zero-initialize before first compile
+ */
+typedef struct {
+    wchar_t* source;
+    int sourceLength;
+    PluginSegment* segments;
+    int segmentCount;
+    int segmentCapacity;
+    int imageCount;
+    int timeSlotCount;
+} PluginTemplate;
+
+/**
+ * @brief Compile text into segments, reusing the template's buffers
+ * @param tmpl Template to (re)fill
+ * @param text Plugin display text
+ * @return FALSE on allocation failure (template left empty)
+ */
+BOOL PluginTemplate_Compile(PluginTemplate* tmpl, const wchar_t* text);
+
+/**
+ * @brief Splice the time text into the segments
+ * @param tmpl Compiled template
+ * @param timeText Text for every time slot
+ * @param out Output buffer
+ * @param outLen Output buffer size in characters (result is truncated to fit)
+ * @param images Output images, tmpl->imageCount entries (optional; NULL skips extraction)
+ * @param imageCount Output number of images extracted (optional)
+ * @param timeRanges Output spans of out holding the time text (optional)
+ * @param timeRangeCapacity Entries in timeRanges; later slots are not reported
+ * @param timeRangeCount Output number of spans written (optional)
+ * @return Characters written, excluding the terminator
+ */
+int PluginTemplate_Expand(const PluginTemplate* tmpl, const wchar_t* timeText,
+                          wchar_t* out, size_t outLen,
+                          MarkdownImage* images, int* imageCount,
+                          PluginTextRange* timeRanges, int timeRangeCapacity, int* timeRangeCount);
+
+/**
+ * @brief Release template memory (left zeroed)
+ */
+void PluginTemplate_Free(PluginTemplate* tmpl);
+
+#endif /* PLUGIN_TEMPLATE_H */
@@ -72,6 +72,7 @@
 #define TIMER_ID_CONFIG_SAVE 1005            /**< Config save debounce timer */
 #define TIMER_ID_FONT_VALIDATION 1006        /**< Font validation timer (every 2s) */
 #define TIMER_ID_VOLUME_PREVIEW 1007         /**< Volume preview auto-stop timer (3s limit) */
+#define TIMER_ID_SCALE_SETTLE 1008           /**< Scale gesture settle timer (full-quality repaint) */
 #define TIMER_ID_EDIT_MODE_REFRESH 2001      /**< Edit mode refresh timer */
 #define TIMER_ID_RENDER_ANIMATION 2002       /**< Dedicated animation render timer (30-60 FPS) */
 #define TIMER_ID_TOPMOST_ENFORCE 2003        /**< Fast topmost enforcement when near taskbar (50ms) */
@@ -80,6 +81,7 @@
 /** @brief Timer interval constants */
 #define TIMER_REFRESH_INTERVAL_MS 150        /**< Edit mode: ~7 FPS provides responsive feedback without excessive redraws */
 #define CONFIG_SAVE_DELAY_MS 500             /**< Debounce: Batches rapid setting changes to reduce disk writes */
+#define SCALE_SETTLE_DELAY_MS 150            /**< Scale stable this long: stop stretching the last frame, re-render */
 
 /** @brief Media control virtual key codes */
 #define VK_MEDIA_PLAY_PAUSE 0xB3         /**< Media play/pause key */
@@ -23,6 +23,9 @@
 #include "dialog/dialog_common.h"
 #include "drag_scale.h"
 #include "log.h"
+#include "log/log_probe.h"
+#include "log/log_trace.h"
+#include "drawing/drawing_render.h"
 
 extern BOOL CLOCK_WINDOW_TOPMOST;
 extern void SetWindowTopmost(HWND hwnd, BOOL topmost);
@@ -208,6 +211,23 @@ BOOL HandleCliArguments(HWND hwnd, const char* cmdLine) {
         return FALSE;
     }
     
+    /* Timing probe and render counter dump requested from a second instance */
+    if (strcmp(input, "--probe-stats") == 0) {
+        Probe_LogStats();
+        LogRenderStats();
+        return TRUE;
+    }
+    
+    /* Tracing switches (also accepted by a running instance) */
+    if (strcmp(input, "--trace") == 0) {
+        Trace_EnableForSession();
+        return TRUE;
+    }
+    if (strcmp(input, "--trace-save") == 0) {
+        if (!Trace_Save()) LOG_INFO("Trace: nothing recorded (start with --trace or TRACE_EXPORT=TRUE)");
+        return TRUE;
+    }
+    
     /* Ignore command-line flags (double-dash options) */
     if (input[0] == '-' && input[1] == '-') {
         LOG_INFO("Ignoring command-line flag: %s", input);
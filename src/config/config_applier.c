@@ -12,7 +12,12 @@
 #include "window.h"
 #include "font.h"
 #include "color/color.h"
+#include "drawing/drawing_render.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_frame_governor.h"
+#include "drawing/drawing_text_stb.h"
 #include "log.h"
+#include "log/log_trace.h"
 #include "../resource/resource.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -102,6 +107,15 @@ void ApplyDisplaySettings(const ConfigSnapshot* snapshot) {
     g_AppConfig.display.scale_step_fast = snapshot->scaleStepFast;
     CLOCK_TEXT_EFFECT = (TextEffectType)snapshot->textEffect;
     g_AppConfig.display.text_effect = snapshot->textEffect;
+    g_AppConfig.display.effect_quality = snapshot->effectQuality;
+    SetEffectQuality((EffectQuality)snapshot->effectQuality);
+    g_AppConfig.display.render_cpu_budget = snapshot->renderCpuBudget;
+    FrameGovernor_SetBudget(snapshot->renderCpuBudget);
+    g_AppConfig.display.sdf_text = snapshot->sdfText;
+    SetDistanceFieldTextSTB(snapshot->sdfText);
+    g_AppConfig.display.max_window_height = snapshot->maxWindowHeight;
+    g_AppConfig.display.trace_export = snapshot->traceExport;
+    Trace_Configure(snapshot->traceExport);
 
     HWND hwnd = FindWindowW(L"CatimeWindowClass", L"Catime");
     if (hwnd) {
@@ -136,26 +150,12 @@ void ApplyDisplaySettings(const ConfigSnapshot* snapshot) {
 
         BYTE alphaValue = (BYTE)((CLOCK_WINDOW_OPACITY * 255) / 100);
         SetLayeredWindowAttributes(hwnd, RGB(0, 0, 0), alphaValue, LWA_COLORKEY | LWA_ALPHA);
+        InvalidateRenderedFrame();  /* Layered attributes discard the last UpdateLayeredWindow content */
 
-        /* Ensure animation timer is running if effects are active */
-        /* Use adaptive interval based on window size to prevent mouse lag */
-        if (CLOCK_LIQUID_EFFECT || CLOCK_HOLOGRAPHIC_EFFECT || 
-            CLOCK_NEON_EFFECT || CLOCK_GLOW_EFFECT || CLOCK_GLASS_EFFECT) {
-            RECT rect;
-            GetClientRect(hwnd, &rect);
-            int pixels = rect.right * rect.bottom;
-            
-            /* Holographic effect needs more aggressive throttling */
-            UINT interval;
-            if (CLOCK_HOLOGRAPHIC_EFFECT) {
-                interval = (pixels < 30000) ? 50 : 
-                           (pixels < 100000) ? 80 : 
-                           (pixels < 300000) ? 120 : 200;
-            } else {
-                interval = (pixels < 50000) ? 33 : 
-                           (pixels < 200000) ? 50 : 
-                           (pixels < 500000) ? 80 : 120;
-            }
+        /* Ensure animation timer is running if the effect animates */
+        /* Interval comes from measured paint cost to prevent mouse lag */
+        if (IsEffectTimeDependent(GetActiveEffect())) {
+            UINT interval = FrameGovernor_AnimationInterval();
             SetTimer(hwnd, TIMER_ID_RENDER_ANIMATION, interval, NULL); 
         } else {
             KillTimer(hwnd, TIMER_ID_RENDER_ANIMATION);
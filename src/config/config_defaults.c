@@ -59,6 +59,11 @@ static const ConfigItemMeta CONFIG_METADATA[] = {
     {INI_SECTION_DISPLAY, "SCALE_STEP_NORMAL", "10", CONFIG_TYPE_INT, CFG_OFFSET(scaleStepNormal), CFG_NO_SIZE, "Scale scroll step (1-100)"},
     {INI_SECTION_DISPLAY, "SCALE_STEP_FAST", "15", CONFIG_TYPE_INT, CFG_OFFSET(scaleStepFast), CFG_NO_SIZE, "Scale Ctrl+scroll step (1-100)"},
     {INI_SECTION_DISPLAY, "TEXT_EFFECT", "NONE", CONFIG_TYPE_ENUM, CFG_OFFSET(textEffect), CFG_NO_SIZE, "Text effect style (NONE/GLOW/GLASS/NEON/HOLOGRAPHIC/LIQUID)"},
+    {INI_SECTION_DISPLAY, "EFFECT_QUALITY", "FULL", CONFIG_TYPE_ENUM, CFG_OFFSET(effectQuality), CFG_NO_SIZE, "Effect blur resolution (FULL/HALF/QUARTER)"},
+    {INI_SECTION_DISPLAY, "RENDER_CPU_BUDGET", "5", CONFIG_TYPE_FLOAT, CFG_OFFSET(renderCpuBudget), CFG_NO_SIZE, "Paint CPU budget in percent of one core (0 = unlimited)"},
+    {INI_SECTION_DISPLAY, "SDF_TEXT", "FALSE", CONFIG_TYPE_BOOL, CFG_OFFSET(sdfText), CFG_NO_SIZE, "Draw text from signed distance field atlases"},
+    {INI_SECTION_DISPLAY, "MAX_WINDOW_HEIGHT", "0", CONFIG_TYPE_INT, CFG_OFFSET(maxWindowHeight), CFG_NO_SIZE, "Window height limit in pixels, taller text scrolls (0 = unlimited)"},
+    {INI_SECTION_DISPLAY, "TRACE_EXPORT", "FALSE", CONFIG_TYPE_BOOL, CFG_OFFSET(traceExport), CFG_NO_SIZE, "Record a Chrome trace to Catime_Trace.json"},
 
     /* Timer settings */
     {INI_SECTION_TIMER, "CLOCK_DEFAULT_START_TIME", "1500", CONFIG_TYPE_INT, CFG_OFFSET(defaultStartTime), CFG_NO_SIZE, "Default timer duration (seconds)"},
@@ -267,6 +272,38 @@ void WriteDefaultsToConfig(const char* config_path) {
             fputs(";   Controls window scale change when scrolling with Ctrl held.\n", f);
             fputs(";   Range: 1-100%\n", f);
             fputs(";   Default: 15%\n", f);
+            fputs(";\n", f);
+            fputs("; EFFECT_QUALITY: resolution of the soft glow maps behind text effects.\n", f);
+            fputs(";   HALF and QUARTER blur the glow at 1/2 or 1/4 size and scale it back up;\n", f);
+            fputs(";   much cheaper on large windows, outlines stay sharp.\n", f);
+            fputs(";   Values: FULL, HALF, QUARTER\n", f);
+            fputs(";   Default: FULL\n", f);
+            fputs(";\n", f);
+            fputs("; RENDER_CPU_BUDGET: CPU time painting may use (unit: percent of one core).\n", f);
+            fputs(";   Animation speed adapts to the measured paint cost; if that is not\n", f);
+            fputs(";   enough, effect resolution is lowered and finally effects pause.\n", f);
+            fputs(";   Range: 0-100 (0 = unlimited), decimals allowed\n", f);
+            fputs(";   Default: 5\n", f);
+            fputs(";\n", f);
+            fputs("; SDF_TEXT: draw glyphs from one distance field atlas per font.\n", f);
+            fputs(";   Any size, including sizes passed through while drag-scaling, is\n", f);
+            fputs(";   sampled from the same atlas instead of rasterized again. Glow,\n", f);
+            fputs(";   glass shadow and neon are computed from the distance, not blurred.\n", f);
+            fputs(";   Corners are slightly rounder than with regular rasterization.\n", f);
+            fputs(";   Default: FALSE\n", f);
+            fputs(";\n", f);
+            fputs("; MAX_WINDOW_HEIGHT: tallest the window grows to fit its text (unit: pixels).\n", f);
+            fputs(";   Longer text (plugin logs, to-do lists) scrolls inside the window:\n", f);
+            fputs(";   mouse wheel (Shift+wheel in edit mode), Up/Down, PageUp/PageDown,\n", f);
+            fputs(";   Home/End. Only the visible lines are laid out and drawn.\n", f);
+            fputs(";   Range: 0 or more (0 = unlimited)\n", f);
+            fputs(";   Default: 0\n", f);
+            fputs(";\n", f);
+            fputs("; TRACE_EXPORT: record timing spans from all threads for troubleshooting.\n", f);
+            fputs(";   Written as Catime_Trace.json next to Catime_Logs.log when turned off\n", f);
+            fputs(";   or on exit; open it in Perfetto or chrome://tracing.\n", f);
+            fputs(";   Same as starting catime with --trace.\n", f);
+            fputs(";   Default: FALSE\n", f);
             fputs(";========================================================\n", f);
         }
 
@@ -8,6 +8,7 @@
 #include "config/config_defaults.h"
 #include "config.h"
 #include "window/window_core.h"
+#include "drawing/drawing_effect.h"
 #include "log.h"
 #include "../resource/resource.h"
 #include <stdio.h>
@@ -75,6 +76,13 @@ static const EnumStrMap TEXT_EFFECT_MAP[] = {
     {-1, NULL}
 };
 
+static const EnumStrMap EFFECT_QUALITY_MAP[] = {
+    {EFFECT_QUALITY_FULL,    "FULL"},
+    {EFFECT_QUALITY_HALF,    "HALF"},
+    {EFFECT_QUALITY_QUARTER, "QUARTER"},
+    {-1, NULL}
+};
+
 static int StringToEnum(const EnumStrMap* map, const char* str, int defaultVal) {
     if (!map || !str) return defaultVal;
     for (int i = 0; map[i].str != NULL; i++) {
@@ -97,6 +105,7 @@ static const EnumStrMap* GetEnumMapForKey(const char* key) {
     if (strcmp(key, "CLOCK_TIMEOUT_ACTION") == 0) return TIMEOUT_ACTION_MAP;
     if (strcmp(key, "NOTIFICATION_TYPE") == 0) return NOTIFICATION_TYPE_MAP;
     if (strcmp(key, "TEXT_EFFECT") == 0) return TEXT_EFFECT_MAP;
+    if (strcmp(key, "EFFECT_QUALITY") == 0) return EFFECT_QUALITY_MAP;
     return NULL;
 }
 
@@ -278,6 +287,11 @@ void InitializeDefaultSnapshot(ConfigSnapshot* snapshot) {
     snapshot->scaleStepNormal = DEFAULT_SCALE_STEP_NORMAL;
     snapshot->scaleStepFast = DEFAULT_SCALE_STEP_FAST;
     snapshot->textEffect = TEXT_EFFECT_NONE;
+    snapshot->effectQuality = EFFECT_QUALITY_FULL;
+    snapshot->renderCpuBudget = 5.0f;
+    snapshot->sdfText = FALSE;
+    snapshot->maxWindowHeight = 0;
+    snapshot->traceExport = FALSE;
     snapshot->defaultStartTime = DEFAULT_START_TIME_SECONDS;
     snapshot->notificationTimeoutMs = DEFAULT_NOTIFICATION_TIMEOUT_MS;
     snapshot->notificationMaxOpacity = DEFAULT_NOTIFICATION_MAX_OPACITY;
@@ -283,6 +283,11 @@ BOOL ValidateWindowConfig(ConfigSnapshot* snapshot) {
         snapshot->opacityStepFast = MAX_OPACITY;
         modified = TRUE;
     }
+
+    if (snapshot->maxWindowHeight < 0) {
+        snapshot->maxWindowHeight = 0;
+        modified = TRUE;
+    }
     
     return modified;
 }
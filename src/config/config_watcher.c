@@ -16,6 +16,7 @@
 #include "window_procedure/window_procedure.h"
 #include "tray/tray_animation_core.h"
 #include "log.h"
+#include "log/log_trace.h"
 
 /* 200ms debounce batches rapid editor writes (mentioned in file header) */
 #define WATCH_BUFFER_SIZE 8192
@@ -133,6 +134,7 @@ static void CleanupWatchEvents(HANDLE* hEvents) {
 /** Background thread required (ReadDirectoryChangesW blocks) */
 static DWORD WINAPI WatcherThreadProc(LPVOID lpParam) {
     (void)lpParam;
+    Trace_NameThread("Config watcher");
     
     char iniPath[MAX_PATH] = {0};
     GetConfigPath(iniPath, sizeof(iniPath));
@@ -178,8 +180,11 @@ static DWORD WINAPI WatcherThreadProc(LPVOID lpParam) {
         }
         
         if (IsTargetFileChanged(buffer, bytes, wFileName)) {
+            Trace_Instant("Config file changed");
             Sleep(DEBOUNCE_DELAY_MS);
+            LONGLONG traceStart = Trace_Begin();
             NotifyConfigChanges(g_targetHwnd);
+            Trace_End("Notify config changes", traceStart);
         }
     }
     
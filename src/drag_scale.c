@@ -3,7 +3,9 @@
  * @brief Interactive window dragging and scaling with debounced saves
  * 
  * Debounced config saves reduce disk I/O during continuous operations.
- * Centered scaling maintains visual stability during resize.
+ * Centered scaling maintains visual stability during resize. While the wheel
+ * keeps scaling, paints stretch the last frame; the same debounce re-renders
+ * at full quality once the scale has been stable for SCALE_SETTLE_DELAY_MS.
  */
 
 #include <windows.h>
@@ -12,6 +14,7 @@
 #include "drag_scale.h"
 #include "log.h"
 #include "plugin/plugin_data.h"
+#include "drawing/drawing_render.h"
 
 #include "color/color_parser.h"
 
@@ -45,7 +48,19 @@ static VOID CALLBACK ConfigSaveTimerProc(HWND hwnd, UINT msg, UINT_PTR idEvent,
     }
 }
 
-/* Debouncing: Only save after operations stop for CONFIG_SAVE_DELAY_MS */
+static VOID CALLBACK ScaleSettleTimerProc(HWND hwnd, UINT msg, UINT_PTR idEvent, DWORD dwTime) {
+    (void)msg;
+    (void)dwTime;
+    
+    if (idEvent == TIMER_ID_SCALE_SETTLE) {
+        KillTimer(hwnd, TIMER_ID_SCALE_SETTLE);
+        EndInterimScale();
+        RefreshWindow(hwnd, FALSE);
+    }
+}
+
+/* Debouncing: Only save after operations stop for CONFIG_SAVE_DELAY_MS;
+ * a scale gesture also settles (full-quality repaint) after SCALE_SETTLE_DELAY_MS */
 void ScheduleConfigSave(HWND hwnd) {
     if (g_configSaveTimer != 0) {
         KillTimer(hwnd, TIMER_ID_CONFIG_SAVE);
@@ -54,6 +69,12 @@ void ScheduleConfigSave(HWND hwnd) {
     g_configSaveTimer = SetTimer(hwnd, TIMER_ID_CONFIG_SAVE, 
                                  CONFIG_SAVE_DELAY_MS, 
                                  (TIMERPROC)ConfigSaveTimerProc);
+    
+    if (IsInterimScaleActive()) {
+        /* Same ID replaces the pending timer, restarting the settle delay */
+        SetTimer(hwnd, TIMER_ID_SCALE_SETTLE, SCALE_SETTLE_DELAY_MS,
+                 (TIMERPROC)ScaleSettleTimerProc);
+    }
 }
 
 void StartDragWindow(HWND hwnd) {
@@ -86,6 +107,11 @@ void EndEditMode(HWND hwnd) {
 
     CLOCK_EDIT_MODE = FALSE;
 
+    if (IsInterimScaleActive()) {
+        KillTimer(hwnd, TIMER_ID_SCALE_SETTLE);
+        EndInterimScale();
+    }
+
     SetBlurBehind(hwnd, FALSE);
     SetClickThrough(hwnd, TRUE);
     SaveWindowSettings(hwnd);
@@ -169,6 +195,9 @@ BOOL HandleScaleWindow(HWND hwnd, int delta) {
     
     if (newScale == oldScale) return FALSE;
     
+    /* Snapshot the current frame before the window changes size */
+    BeginInterimScale();
+    
     if (isPluginMode) {
         PLUGIN_FONT_SCALE_FACTOR = newScale;
     } else {
@@ -189,5 +218,6 @@ BOOL HandleScaleWindow(HWND hwnd, int delta) {
         SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOREDRAW);
     
     RefreshWindow(hwnd, FALSE);
+    ScheduleConfigSave(hwnd);
     return TRUE;
 }
\ No newline at end of file
@@ -0,0 +1,675 @@
+/**
+ * @file drawing_blend_simd.c
+ * @brief Scalar, SSE2 and AVX2 glyph compositing kernels with runtime dispatch
+ *
+ * Division by 255 uses (x * 0x8081) >> 23, which equals x / 255 for every
+ * 16-bit x, so the SIMD paths reproduce the scalar integer math exactly.
+ */
+
+#include "drawing/drawing_blend_simd.h"
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BLEND_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+/* ============================================================================
+ * Scalar reference
+ * ============================================================================ */
+
+static void MaxSolidScalar(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    DWORD r = (color >> 16) & 0xFF;
+    DWORD g = (color >> 8) & 0xFF;
+    DWORD b = color & 0xFF;
+    for (int i = 0; i < count; i++) {
+        DWORD alpha = cov[i];
+        if (alpha == 0) continue;
+        if (alpha > ((dst[i] >> 24) & 0xFF)) {
+            dst[i] = (alpha << 24) | (((r * alpha) / 255) << 16) |
+                     (((g * alpha) / 255) << 8) | ((b * alpha) / 255);
+        }
+    }
+}
+
+static void MaxColumnsScalar(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    for (int i = 0; i < count; i++) {
+        DWORD alpha = cov[i];
+        if (alpha == 0) continue;
+        if (alpha > ((dst[i] >> 24) & 0xFF)) {
+            DWORD c = colors[i];
+            dst[i] = (alpha << 24) | (((((c >> 16) & 0xFF) * alpha) / 255) << 16) |
+                     (((((c >> 8) & 0xFF) * alpha) / 255) << 8) | (((c & 0xFF) * alpha) / 255);
+        }
+    }
+}
+
+static void OverwriteColumnsScalar(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    for (int i = 0; i < count; i++) {
+        DWORD alpha = cov[i];
+        if (alpha == 0) continue;
+        DWORD c = colors[i];
+        dst[i] = (alpha << 24) | (((((c >> 16) & 0xFF) * alpha) / 255) << 16) |
+                 (((((c >> 8) & 0xFF) * alpha) / 255) << 8) | (((c & 0xFF) * alpha) / 255);
+    }
+}
+
+static void LerpSolidScalar(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    int r = (int)((color >> 16) & 0xFF);
+    int g = (int)((color >> 8) & 0xFF);
+    int b = (int)(color & 0xFF);
+    for (int i = 0; i < count; i++) {
+        int alpha = cov[i];
+        if (alpha == 0) continue;
+        DWORD existing = dst[i];
+        int er = (existing >> 16) & 0xFF;
+        int eg = (existing >> 8) & 0xFF;
+        int eb = existing & 0xFF;
+        int ea = (existing >> 24) & 0xFF;
+        int nr = er + ((r - er) * alpha) / 255;
+        int ng = eg + ((g - eg) * alpha) / 255;
+        int nb = eb + ((b - eb) * alpha) / 255;
+        int na = ea + ((255 - ea) * alpha) / 255;
+        dst[i] = ((DWORD)na << 24) | ((DWORD)nr << 16) | ((DWORD)ng << 8) | (DWORD)nb;
+    }
+}
+
+static void HalveRowScalar(unsigned char* dst, const unsigned char* row0, const unsigned char* row1, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = (unsigned char)((row0[2 * i] + row0[2 * i + 1] + row1[2 * i] + row1[2 * i + 1] + 2) >> 2);
+    }
+}
+
+static void LerpRowsScalar(unsigned char* dst, const unsigned char* row0, const unsigned char* row1,
+                           int weight, int count) {
+    int inverse = 256 - weight;
+    for (int i = 0; i < count; i++) {
+        dst[i] = (unsigned char)((row0[i] * inverse + row1[i] * weight + 128) >> 8);
+    }
+}
+
+static void ScaleRowScalar(DWORD* dst, const DWORD* src, const int* srcX, const WORD* weights, int count) {
+    for (int i = 0; i < count; i++) {
+        DWORD left = src[srcX[i]];
+        DWORD right = src[srcX[i] + 1];
+        DWORD weight = weights[i];
+        DWORD inverse = 256 - weight;
+        DWORD out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            DWORD c = (((left >> shift) & 0xFF) * inverse + ((right >> shift) & 0xFF) * weight + 128) >> 8;
+            out |= c << shift;
+        }
+        dst[i] = out;
+    }
+}
+
+static const BlendKernels g_scalarKernels = {
+    MaxSolidScalar, MaxColumnsScalar, OverwriteColumnsScalar, LerpSolidScalar,
+    HalveRowScalar, LerpRowsScalar, ScaleRowScalar, "scalar"
+};
+
+#ifdef BLEND_HAVE_X86
+
+/* ============================================================================
+ * SSE2 (4 pixels per iteration)
+ * ============================================================================ */
+
+#define SSE2_FN __attribute__((target("sse2")))
+
+/* Coverage byte replicated into all four channels of its pixel */
+static inline SSE2_FN __m128i SpreadCoverage4(__m128i cov32) {
+    __m128i a = _mm_or_si128(cov32, _mm_slli_epi32(cov32, 8));
+    return _mm_or_si128(a, _mm_slli_epi32(a, 16));
+}
+
+static inline SSE2_FN __m128i LoadCoverage4(const unsigned char* cov) {
+    int bytes;
+    memcpy(&bytes, cov, sizeof(bytes));
+    __m128i zero = _mm_setzero_si128();
+    __m128i c16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+    return _mm_unpacklo_epi16(c16, zero);
+}
+
+static inline SSE2_FN __m128i Div255x16(__m128i x) {
+    return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((short)0x8081)), 7);
+}
+
+/* (color * coverage) / 255 per channel; color alpha byte must be 0xFF */
+static inline SSE2_FN __m128i Premultiply4(__m128i color, __m128i cov32) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = SpreadCoverage4(cov32);
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(color, zero), _mm_unpacklo_epi8(a, zero));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(color, zero), _mm_unpackhi_epi8(a, zero));
+    return _mm_packus_epi16(Div255x16(lo), Div255x16(hi));
+}
+
+static inline SSE2_FN __m128i Select4(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static SSE2_FN void MaxSolidSSE2(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    __m128i colorVec = _mm_set1_epi32((int)(color | 0xFF000000));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i cov32 = LoadCoverage4(cov + i);
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i mask = _mm_cmpgt_epi32(cov32, _mm_srli_epi32(d, 24));
+        if (_mm_movemask_epi8(mask) == 0) continue;
+        __m128i p = Premultiply4(colorVec, cov32);
+        _mm_storeu_si128((__m128i*)(dst + i), Select4(mask, p, d));
+    }
+    MaxSolidScalar(dst + i, cov + i, count - i, color);
+}
+
+static SSE2_FN void MaxColumnsSSE2(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i cov32 = LoadCoverage4(cov + i);
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i mask = _mm_cmpgt_epi32(cov32, _mm_srli_epi32(d, 24));
+        if (_mm_movemask_epi8(mask) == 0) continue;
+        __m128i c = _mm_or_si128(_mm_loadu_si128((const __m128i*)(colors + i)), opaque);
+        _mm_storeu_si128((__m128i*)(dst + i), Select4(mask, Premultiply4(c, cov32), d));
+    }
+    MaxColumnsScalar(dst + i, cov + i, colors + i, count - i);
+}
+
+static SSE2_FN void OverwriteColumnsSSE2(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i cov32 = LoadCoverage4(cov + i);
+        __m128i mask = _mm_cmpgt_epi32(cov32, zero);
+        if (_mm_movemask_epi8(mask) == 0) continue;
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i c = _mm_or_si128(_mm_loadu_si128((const __m128i*)(colors + i)), opaque);
+        _mm_storeu_si128((__m128i*)(dst + i), Select4(mask, Premultiply4(c, cov32), d));
+    }
+    OverwriteColumnsScalar(dst + i, cov + i, colors + i, count - i);
+}
+
+/* e + trunc((c - e) * a / 255) on 16-bit lanes */
+static inline SSE2_FN __m128i Lerp16(__m128i e, __m128i c, __m128i a) {
+    __m128i diff = _mm_sub_epi16(c, e);
+    __m128i sign = _mm_srai_epi16(diff, 15);
+    __m128i mag = _mm_sub_epi16(_mm_xor_si128(diff, sign), sign);
+    __m128i q = Div255x16(_mm_mullo_epi16(mag, a));
+    q = _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+    return _mm_add_epi16(e, q);
+}
+
+static SSE2_FN void LerpSolidSSE2(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i colorVec = _mm_set1_epi32((int)(color | 0xFF000000));
+    __m128i cLo = _mm_unpacklo_epi8(colorVec, zero);
+    __m128i cHi = _mm_unpackhi_epi8(colorVec, zero);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i cov32 = LoadCoverage4(cov + i);
+        __m128i mask = _mm_cmpgt_epi32(cov32, zero);
+        if (_mm_movemask_epi8(mask) == 0) continue;
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i a = SpreadCoverage4(cov32);
+        __m128i lo = Lerp16(_mm_unpacklo_epi8(d, zero), cLo, _mm_unpacklo_epi8(a, zero));
+        __m128i hi = Lerp16(_mm_unpackhi_epi8(d, zero), cHi, _mm_unpackhi_epi8(a, zero));
+        _mm_storeu_si128((__m128i*)(dst + i), Select4(mask, _mm_packus_epi16(lo, hi), d));
+    }
+    LerpSolidScalar(dst + i, cov + i, count - i, color);
+}
+
+/* Sum of each byte pair in 16-bit lanes */
+static inline SSE2_FN __m128i PairSums16(__m128i bytes) {
+    __m128i even = _mm_and_si128(bytes, _mm_set1_epi16(0x00FF));
+    return _mm_add_epi16(even, _mm_srli_epi16(bytes, 8));
+}
+
+static SSE2_FN void HalveRowSSE2(unsigned char* dst, const unsigned char* row0, const unsigned char* row1, int count) {
+    __m128i two = _mm_set1_epi16(2);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i lo = _mm_add_epi16(PairSums16(_mm_loadu_si128((const __m128i*)(row0 + 2 * i))),
+                                   PairSums16(_mm_loadu_si128((const __m128i*)(row1 + 2 * i))));
+        __m128i hi = _mm_add_epi16(PairSums16(_mm_loadu_si128((const __m128i*)(row0 + 2 * i + 16))),
+                                   PairSums16(_mm_loadu_si128((const __m128i*)(row1 + 2 * i + 16))));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    HalveRowScalar(dst + i, row0 + 2 * i, row1 + 2 * i, count - i);
+}
+
+/* Products stay below 65536, so unsigned 16-bit lanes cannot overflow */
+static inline SSE2_FN __m128i LerpBytes16(__m128i a, __m128i b, __m128i inverse, __m128i weight) {
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a, inverse), _mm_mullo_epi16(b, weight));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+}
+
+static SSE2_FN void LerpRowsSSE2(unsigned char* dst, const unsigned char* row0, const unsigned char* row1,
+                                 int weight, int count) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i w = _mm_set1_epi16((short)weight);
+    __m128i inv = _mm_set1_epi16((short)(256 - weight));
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(row0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(row1 + i));
+        __m128i lo = LerpBytes16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), inv, w);
+        __m128i hi = LerpBytes16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), inv, w);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    LerpRowsScalar(dst + i, row0 + i, row1 + i, weight, count - i);
+}
+
+/* Left and right source pixel of one output pixel, channels in 16-bit lanes, weighted */
+static inline SSE2_FN __m128i WeightedPair(const DWORD* pair, WORD weight) {
+    __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)pair), _mm_setzero_si128());
+    short w = (short)weight, inv = (short)(256 - weight);
+    return _mm_mullo_epi16(pixels, _mm_set_epi16(w, w, w, w, inv, inv, inv, inv));
+}
+
+static SSE2_FN void ScaleRowSSE2(DWORD* dst, const DWORD* src, const int* srcX, const WORD* weights, int count) {
+    __m128i round = _mm_set1_epi16(128);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i p0 = WeightedPair(src + srcX[i], weights[i]);
+        __m128i p1 = WeightedPair(src + srcX[i + 1], weights[i + 1]);
+        __m128i p2 = WeightedPair(src + srcX[i + 2], weights[i + 2]);
+        __m128i p3 = WeightedPair(src + srcX[i + 3], weights[i + 3]);
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(p0, p1), _mm_unpackhi_epi64(p0, p1));
+        __m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(p2, p3), _mm_unpackhi_epi64(p2, p3));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    ScaleRowScalar(dst + i, src, srcX + i, weights + i, count - i);
+}
+
+static const BlendKernels g_sse2Kernels = {
+    MaxSolidSSE2, MaxColumnsSSE2, OverwriteColumnsSSE2, LerpSolidSSE2,
+    HalveRowSSE2, LerpRowsSSE2, ScaleRowSSE2, "SSE2"
+};
+
+/* ============================================================================
+ * AVX2 (8 pixels per iteration)
+ *
+ * Unpack and pack both work within 128-bit lanes, so unpacking colors and
+ * coverage the same way and packing back restores the original pixel order.
+ * ============================================================================ */
+
+#define AVX2_FN __attribute__((target("avx2")))
+
+static inline AVX2_FN __m256i LoadCoverage8(const unsigned char* cov) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)cov));
+}
+
+static inline AVX2_FN __m256i SpreadCoverage8(__m256i cov32) {
+    __m256i a = _mm256_or_si256(cov32, _mm256_slli_epi32(cov32, 8));
+    return _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+}
+
+static inline AVX2_FN __m256i Div255x16x2(__m256i x) {
+    return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16((short)0x8081)), 7);
+}
+
+static inline AVX2_FN __m256i Premultiply8(__m256i color, __m256i cov32) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i a = SpreadCoverage8(cov32);
+    __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(color, zero), _mm256_unpacklo_epi8(a, zero));
+    __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(color, zero), _mm256_unpackhi_epi8(a, zero));
+    return _mm256_packus_epi16(Div255x16x2(lo), Div255x16x2(hi));
+}
+
+static AVX2_FN void MaxSolidAVX2(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    __m256i colorVec = _mm256_set1_epi32((int)(color | 0xFF000000));
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i cov32 = LoadCoverage8(cov + i);
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i mask = _mm256_cmpgt_epi32(cov32, _mm256_srli_epi32(d, 24));
+        if (_mm256_movemask_epi8(mask) == 0) continue;
+        __m256i p = Premultiply8(colorVec, cov32);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, p, mask));
+    }
+    MaxSolidScalar(dst + i, cov + i, count - i, color);
+}
+
+static AVX2_FN void MaxColumnsAVX2(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    __m256i opaque = _mm256_set1_epi32((int)0xFF000000);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i cov32 = LoadCoverage8(cov + i);
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i mask = _mm256_cmpgt_epi32(cov32, _mm256_srli_epi32(d, 24));
+        if (_mm256_movemask_epi8(mask) == 0) continue;
+        __m256i c = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(colors + i)), opaque);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, Premultiply8(c, cov32), mask));
+    }
+    MaxColumnsScalar(dst + i, cov + i, colors + i, count - i);
+}
+
+static AVX2_FN void OverwriteColumnsAVX2(DWORD* dst, const unsigned char* cov, const DWORD* colors, int count) {
+    __m256i opaque = _mm256_set1_epi32((int)0xFF000000);
+    __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i cov32 = LoadCoverage8(cov + i);
+        __m256i mask = _mm256_cmpgt_epi32(cov32, zero);
+        if (_mm256_movemask_epi8(mask) == 0) continue;
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i c = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(colors + i)), opaque);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, Premultiply8(c, cov32), mask));
+    }
+    OverwriteColumnsScalar(dst + i, cov + i, colors + i, count - i);
+}
+
+static inline AVX2_FN __m256i Lerp16x2(__m256i e, __m256i c, __m256i a) {
+    __m256i diff = _mm256_sub_epi16(c, e);
+    __m256i sign = _mm256_srai_epi16(diff, 15);
+    __m256i mag = _mm256_sub_epi16(_mm256_xor_si256(diff, sign), sign);
+    __m256i q = Div255x16x2(_mm256_mullo_epi16(mag, a));
+    q = _mm256_sub_epi16(_mm256_xor_si256(q, sign), sign);
+    return _mm256_add_epi16(e, q);
+}
+
+static AVX2_FN void LerpSolidAVX2(DWORD* dst, const unsigned char* cov, int count, DWORD color) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i colorVec = _mm256_set1_epi32((int)(color | 0xFF000000));
+    __m256i cLo = _mm256_unpacklo_epi8(colorVec, zero);
+    __m256i cHi = _mm256_unpackhi_epi8(colorVec, zero);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i cov32 = LoadCoverage8(cov + i);
+        __m256i mask = _mm256_cmpgt_epi32(cov32, zero);
+        if (_mm256_movemask_epi8(mask) == 0) continue;
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i a = SpreadCoverage8(cov32);
+        __m256i lo = Lerp16x2(_mm256_unpacklo_epi8(d, zero), cLo, _mm256_unpacklo_epi8(a, zero));
+        __m256i hi = Lerp16x2(_mm256_unpackhi_epi8(d, zero), cHi, _mm256_unpackhi_epi8(a, zero));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(d, _mm256_packus_epi16(lo, hi), mask));
+    }
+    LerpSolidScalar(dst + i, cov + i, count - i, color);
+}
+
+static inline AVX2_FN __m256i PairSums16x2(__m256i bytes) {
+    __m256i even = _mm256_and_si256(bytes, _mm256_set1_epi16(0x00FF));
+    return _mm256_add_epi16(even, _mm256_srli_epi16(bytes, 8));
+}
+
+/* Byte maps have no pixel structure to keep, so lane-wise packs are reordered */
+static AVX2_FN void HalveRowAVX2(unsigned char* dst, const unsigned char* row0, const unsigned char* row1, int count) {
+    __m256i two = _mm256_set1_epi16(2);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i lo = _mm256_add_epi16(PairSums16x2(_mm256_loadu_si256((const __m256i*)(row0 + 2 * i))),
+                                      PairSums16x2(_mm256_loadu_si256((const __m256i*)(row1 + 2 * i))));
+        __m256i hi = _mm256_add_epi16(PairSums16x2(_mm256_loadu_si256((const __m256i*)(row0 + 2 * i + 32))),
+                                      PairSums16x2(_mm256_loadu_si256((const __m256i*)(row1 + 2 * i + 32))));
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, two), 2);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + i), packed);
+    }
+    HalveRowSSE2(dst + i, row0 + 2 * i, row1 + 2 * i, count - i);
+}
+
+static inline AVX2_FN __m256i LerpBytes16x2(__m256i a, __m256i b, __m256i inverse, __m256i weight) {
+    __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(a, inverse), _mm256_mullo_epi16(b, weight));
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+}
+
+static AVX2_FN void LerpRowsAVX2(unsigned char* dst, const unsigned char* row0, const unsigned char* row1,
+                                 int weight, int count) {
+    __m256i w = _mm256_set1_epi16((short)weight);
+    __m256i inv = _mm256_set1_epi16((short)(256 - weight));
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i lo = LerpBytes16x2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row0 + i))),
+                                   _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row1 + i))), inv, w);
+        __m256i hi = LerpBytes16x2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row0 + i + 16))),
+                                   _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row1 + i + 16))), inv, w);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + i), packed);
+    }
+    LerpRowsSSE2(dst + i, row0 + i, row1 + i, weight, count - i);
+}
+
+/* Source pairs are scattered, so 256-bit loads gain nothing over SSE2 here */
+static const BlendKernels g_avx2Kernels = {
+    MaxSolidAVX2, MaxColumnsAVX2, OverwriteColumnsAVX2, LerpSolidAVX2,
+    HalveRowAVX2, LerpRowsAVX2, ScaleRowSSE2, "AVX2"
+};
+
+#endif /* BLEND_HAVE_X86 */
+
+/* ============================================================================
+ * Verification and dispatch
+ * ============================================================================ */
+
+#define VERIFY_SPAN 67  /* Not a multiple of 4 or 8, so tails are exercised */
+
+static DWORD NextRandom(DWORD* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/**
+ * @note Coverage mixes 0, 255 and partial values; destinations mix clear,
+ *       partially covered and opaque pixels. Whole buffers are compared,
+ *       so writes past count are caught as well.
+ */
+BOOL BlendKernels_Verify(const BlendKernels* k, int minCount, int maxCount) {
+    unsigned char cov[VERIFY_SPAN];
+    DWORD colors[VERIFY_SPAN];
+    DWORD base[VERIFY_SPAN];
+    DWORD expected[VERIFY_SPAN];
+    DWORD actual[VERIFY_SPAN];
+    unsigned char mapRows[2][VERIFY_SPAN * 2];
+    unsigned char mapExpected[VERIFY_SPAN];
+    unsigned char mapActual[VERIFY_SPAN];
+    int srcX[VERIFY_SPAN];
+    WORD weights[VERIFY_SPAN];
+    DWORD seed = 0x13572468u;
+
+    if (minCount < 0) minCount = 0;
+    if (maxCount > VERIFY_SPAN) maxCount = VERIFY_SPAN;
+    if (minCount > maxCount) return TRUE;
+
+    /* Every width at least 8 times, with the lerp weight sweeping 0..256 */
+    int widths = maxCount - minCount + 1;
+    int rounds = widths * 8 < 65 ? 65 : widths * 8;
+
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < VERIFY_SPAN; i++) {
+            DWORD r = NextRandom(&seed);
+            cov[i] = (r & 3) == 0 ? 0 : (r & 3) == 1 ? 255 : (unsigned char)(r >> 4);
+            colors[i] = NextRandom(&seed) & 0x00FFFFFF;
+            DWORD a = NextRandom(&seed) & 0xFF;
+            DWORD rgb = NextRandom(&seed);
+            /* Keep destinations premultiplied like the real buffer */
+            base[i] = (a << 24) | ((((rgb >> 16) & 0xFF) * a / 255) << 16) |
+                      ((((rgb >> 8) & 0xFF) * a / 255) << 8) | ((rgb & 0xFF) * a / 255);
+            if ((r & 0x30) == 0) base[i] = 0;
+        }
+        DWORD solid = colors[round % VERIFY_SPAN];
+        int count = maxCount - (round % widths);
+
+        memcpy(expected, base, sizeof(base)); memcpy(actual, base, sizeof(base));
+        g_scalarKernels.maxSolid(expected, cov, count, solid);
+        k->maxSolid(actual, cov, count, solid);
+        if (memcmp(expected, actual, sizeof(actual)) != 0) return FALSE;
+
+        memcpy(expected, base, sizeof(base)); memcpy(actual, base, sizeof(base));
+        g_scalarKernels.maxColumns(expected, cov, colors, count);
+        k->maxColumns(actual, cov, colors, count);
+        if (memcmp(expected, actual, sizeof(actual)) != 0) return FALSE;
+
+        memcpy(expected, base, sizeof(base)); memcpy(actual, base, sizeof(base));
+        g_scalarKernels.overwriteColumns(expected, cov, colors, count);
+        k->overwriteColumns(actual, cov, colors, count);
+        if (memcmp(expected, actual, sizeof(actual)) != 0) return FALSE;
+
+        memcpy(expected, base, sizeof(base)); memcpy(actual, base, sizeof(base));
+        g_scalarKernels.lerpSolid(expected, cov, count, solid);
+        k->lerpSolid(actual, cov, count, solid);
+        if (memcmp(expected, actual, sizeof(actual)) != 0) return FALSE;
+
+        for (int i = 0; i < VERIFY_SPAN * 2; i++) {
+            mapRows[0][i] = (unsigned char)NextRandom(&seed);
+            mapRows[1][i] = (i & 7) == 0 ? 255 : (unsigned char)NextRandom(&seed);
+        }
+        int weight = (round * 4) % 260;  /* 0, 4, ..., 256 */
+
+        memset(mapExpected, 0, sizeof(mapExpected)); memset(mapActual, 0, sizeof(mapActual));
+        g_scalarKernels.halveRow(mapExpected, mapRows[0], mapRows[1], count);
+        k->halveRow(mapActual, mapRows[0], mapRows[1], count);
+        if (memcmp(mapExpected, mapActual, sizeof(mapActual)) != 0) return FALSE;
+
+        g_scalarKernels.lerpRows(mapExpected, mapRows[0], mapRows[1], weight, count);
+        k->lerpRows(mapActual, mapRows[0], mapRows[1], weight, count);
+        if (memcmp(mapExpected, mapActual, sizeof(mapActual)) != 0) return FALSE;
+
+        /* Pixel rows: base doubles as the source, srcX[i] + 1 stays in it */
+        for (int i = 0; i < VERIFY_SPAN; i++) {
+            DWORD r = NextRandom(&seed);
+            srcX[i] = (int)(r % (VERIFY_SPAN - 1));
+            weights[i] = (i & 7) == 0 ? 256 : (i & 7) == 1 ? 0 : (WORD)((r >> 8) & 0xFF);
+        }
+        memset(expected, 0, sizeof(expected)); memset(actual, 0, sizeof(actual));
+        g_scalarKernels.scaleRow(expected, base, srcX, weights, count);
+        k->scaleRow(actual, base, srcX, weights, count);
+        if (memcmp(expected, actual, sizeof(actual)) != 0) return FALSE;
+    }
+    return TRUE;
+}
+
+int BlendKernels_GetSupported(const BlendKernels** sets, int capacity) {
+    int n = 0;
+#ifdef BLEND_HAVE_X86
+    __builtin_cpu_init();
+    if (n < capacity && __builtin_cpu_supports("avx2")) sets[n++] = &g_avx2Kernels;
+    if (n < capacity && __builtin_cpu_supports("sse2")) sets[n++] = &g_sse2Kernels;
+#else
+    (void)sets;
+    (void)capacity;
+#endif
+    return n;
+}
+
+static const BlendKernels* SelectKernels(void) {
+    const BlendKernels* candidates[2];
+    int n = BlendKernels_GetSupported(candidates, 2);
+
+    /* Startup check covers the widest tails; the bench covers every width */
+    for (int i = 0; i < n; i++) {
+        if (BlendKernels_Verify(candidates[i], VERIFY_SPAN - 8, VERIFY_SPAN)) {
+            LOG_INFO("Glyph blend kernels: %s", candidates[i]->name);
+            return candidates[i];
+        }
+        LOG_WARNING("Glyph blend kernels: %s output differs from scalar, not used", candidates[i]->name);
+    }
+    LOG_INFO("Glyph blend kernels: scalar");
+    return &g_scalarKernels;
+}
+
+const BlendKernels* BlendKernels_Get(void) {
+    static const BlendKernels* s_kernels = NULL;
+    if (!s_kernels) {
+        s_kernels = SelectKernels();
+    }
+    return s_kernels;
+}
+
+const BlendKernels* BlendKernels_GetScalar(void) {
+    return &g_scalarKernels;
+}
+
+DWORD* BlendKernels_ColumnScratch(int count) {
+    static DWORD* s_scratch = NULL;
+    static int s_capacity = 0;
+    if (count <= 0) count = 1;
+    if (count > s_capacity) {
+        int newCapacity = s_capacity ? s_capacity : 256;
+        while (newCapacity < count) newCapacity *= 2;
+        DWORD* grown = (DWORD*)realloc(s_scratch, newCapacity * sizeof(DWORD));
+        if (!grown) return NULL;
+        s_scratch = grown;
+        s_capacity = newCapacity;
+    }
+    return s_scratch;
+}
+
+/* ============================================================================
+ * Image scaling
+ * ============================================================================ */
+
+/**
+ * @brief Left tap and right-tap weight for each output coordinate
+ * @note 16.16 fixed point; the last tap is pulled in so tap + 1 stays valid
+ *       for the padded source row
+ */
+static void BuildScaleTaps(int* taps, WORD* weights, int dstSize, int srcSize) {
+    LONGLONG step = ((LONGLONG)srcSize << 16) / dstSize;
+    LONGLONG pos = step / 2 - 32768;
+    for (int i = 0; i < dstSize; i++, pos += step) {
+        LONGLONG clamped = pos < 0 ? 0 : pos;
+        int tap = (int)(clamped >> 16);
+        int weight = (int)((clamped & 0xFFFF) >> 8);
+        if (tap >= srcSize - 1) {
+            tap = srcSize - 1;
+            weight = 0;
+        }
+        taps[i] = tap;
+        weights[i] = (WORD)weight;
+    }
+}
+
+BOOL BlendKernels_ScaleImage(const BlendKernels* k, DWORD* dst, int dstWidth, int dstHeight,
+                             const DWORD* src, int srcWidth, int srcHeight) {
+    static void* s_scratch = NULL;
+    static size_t s_scratchBytes = 0;
+
+    if (!k || !dst || !src || dstWidth <= 0 || dstHeight <= 0 || srcWidth <= 0 || srcHeight <= 0) {
+        return FALSE;
+    }
+
+    /* Column taps, row taps, both weight tables, one padded source row */
+    size_t tapBytes = (size_t)(dstWidth + dstHeight) * sizeof(int);
+    size_t weightBytes = ((size_t)(dstWidth + dstHeight) * sizeof(WORD) + 3) & ~(size_t)3;
+    size_t rowBytes = (size_t)(srcWidth + 1) * sizeof(DWORD);
+    size_t needed = tapBytes + weightBytes + rowBytes;
+    if (needed > s_scratchBytes) {
+        void* grown = realloc(s_scratch, needed);
+        if (!grown) return FALSE;
+        s_scratch = grown;
+        s_scratchBytes = needed;
+    }
+
+    int* colTaps = (int*)s_scratch;
+    int* rowTaps = colTaps + dstWidth;
+    WORD* colWeights = (WORD*)((unsigned char*)s_scratch + tapBytes);
+    WORD* rowWeights = colWeights + dstWidth;
+    DWORD* row = (DWORD*)((unsigned char*)s_scratch + tapBytes + weightBytes);
+
+    BuildScaleTaps(colTaps, colWeights, dstWidth, srcWidth);
+    BuildScaleTaps(rowTaps, rowWeights, dstHeight, srcHeight);
+
+    int lastTap = -1, lastWeight = -1;
+    for (int y = 0; y < dstHeight; y++) {
+        /* Enlarging repeats source rows and weights; reuse the blended row */
+        if (rowTaps[y] != lastTap || rowWeights[y] != lastWeight) {
+            const DWORD* upper = src + (size_t)rowTaps[y] * srcWidth;
+            const DWORD* lower = rowTaps[y] + 1 < srcHeight ? upper + srcWidth : upper;
+            k->lerpRows((unsigned char*)row, (const unsigned char*)upper, (const unsigned char*)lower,
+                        rowWeights[y], srcWidth * 4);
+            row[srcWidth] = row[srcWidth - 1];
+            lastTap = rowTaps[y];
+            lastWeight = rowWeights[y];
+        }
+        k->scaleRow(dst + (size_t)y * dstWidth, row, colTaps, colWeights, dstWidth);
+    }
+    return TRUE;
+}
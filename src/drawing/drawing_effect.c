@@ -3,6 +3,42 @@
 #include <math.h>
 #include <windows.h>
 #include "drawing/drawing_effect.h"
+#include "drawing/drawing_blend_simd.h"
+#include "drawing/drawing_sdf_atlas.h"
+#include "drawing/drawing_worker_pool.h"
+#include "log.h"
+
+/* Pixels each effect reaches beyond the text coverage */
+#define GLOW_PADDING 12
+#define GLASS_PADDING 4
+#define NEON_PADDING 20
+#define HOLOGRAPHIC_PADDING 16
+#define LIQUID_PADDING 12
+
+/* Indexed by EffectType; only the liquid flow reads timeOffset */
+static const EffectTraits g_effectTraits[] = {
+    [EFFECT_TYPE_GLOW]        = { GLOW_PADDING, FALSE },
+    [EFFECT_TYPE_GLASS]       = { GLASS_PADDING, FALSE },
+    [EFFECT_TYPE_NEON]        = { NEON_PADDING, FALSE },
+    [EFFECT_TYPE_HOLOGRAPHIC] = { HOLOGRAPHIC_PADDING, FALSE },
+    [EFFECT_TYPE_LIQUID]      = { LIQUID_PADDING, TRUE },
+};
+
+/* Resolution divisor for the wide blur maps (1, 2 or 4) */
+static EffectQuality g_effectQuality = EFFECT_QUALITY_FULL;
+
+/* Coarsest divisor imposed by the frame governor */
+static EffectQuality g_effectQualityFloor = EFFECT_QUALITY_FULL;
+
+/* Reduced maps need at least this many pixels per side to be worth it */
+#define LOW_RES_MIN_SIDE 8
+
+/* Narrower blurs lose their shape when scaled down further */
+#define LOW_RES_MIN_RADIUS 2
+
+/* Scratch for reduced-resolution blurs (maps, upsample rows and tables) */
+static unsigned char* g_lowResBuffer = NULL;
+static size_t g_lowResCapacity = 0;
 
 /* Static buffers for effect processing to avoid repeated mallocs */
 static unsigned char* g_effectBuffer1 = NULL;
@@ -10,11 +46,26 @@ static unsigned char* g_effectBuffer2 = NULL;
 static unsigned char* g_effectBuffer3 = NULL;
 static int g_effectBufferSize = 0;
 
-/**
- * @brief Apply Optimized Box Blur (Sliding Window)
- * O(1) per pixel regardless of radius
- */
-void ApplyGaussianBlur(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer, int w, int h, int radius) {
+/* Passes are split into bands no smaller than this many pixels */
+#define EFFECT_BAND_MIN_PIXELS 16384
+
+/* Columns per band are kept wide so bands do not share cache lines */
+#define EFFECT_MIN_BAND_COLUMNS 64
+
+/* Running column sums for the vertical pass (one per column) */
+static int* g_columnSums = NULL;
+static int g_columnSumsCapacity = 0;
+
+/* Fast engine is used once it has matched the reference */
+static BOOL g_blurVerified = FALSE;
+static BOOL g_blurUseReference = FALSE;
+
+/* Rows per band for a pass over rows of the given width */
+static int EffectRowGrain(int width) {
+    return (width > 0 && width < EFFECT_BAND_MIN_PIXELS) ? EFFECT_BAND_MIN_PIXELS / width : 1;
+}
+
+void ApplyGaussianBlurReference(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer, int w, int h, int radius) {
     if (w <= 0 || h <= 0) return;
     
     if (radius < 1) {
@@ -102,6 +153,424 @@ void ApplyGaussianBlur(unsigned char* src, unsigned char* dest, unsigned char* t
     }
 }
 
+typedef struct {
+    unsigned char* src;
+    unsigned char* dest;
+    unsigned char* tempBuffer;
+    int* columnSums;
+    int w;
+    int h;
+    int radius;
+} BlurJob;
+
+/**
+ * @brief Horizontal pass for rows [begin, end): src -> tempBuffer
+ * @details The window is clamped to the row ends. The clamped stretches are
+ *          handled in their own loops so the interior loop has no branches.
+ */
+static void BlurRowsBand(int begin, int end, void* jobData) {
+    const BlurJob* job = (const BlurJob*)jobData;
+    int w = job->w;
+    int radius = job->radius;
+    int reciprocal = (1 << 20) / (radius * 2 + 1);
+
+    /* x < leftEnd: outgoing sample clamps to x = 0; x >= rightStart: incoming clamps to w - 1 */
+    int leftEnd = (radius < w) ? radius : w;
+    int rightStart = (w - radius - 1 > 0) ? w - radius - 1 : 0;
+
+    for (int y = begin; y < end; y++) {
+        const unsigned char* rowSrc = job->src + y * w;
+        unsigned char* rowDest = job->tempBuffer + y * w;
+        int first = rowSrc[0];
+        int last = rowSrc[w - 1];
+
+        /* Initialize window for x=0 */
+        int sum = first * (radius + 1);
+        for (int k = 1; k <= radius; k++) {
+            sum += rowSrc[(k < w) ? k : w - 1];
+        }
+
+        int x = 0;
+        int headEnd = (leftEnd < rightStart) ? leftEnd : rightStart;
+        for (; x < headEnd; x++) {
+            rowDest[x] = (unsigned char)((sum * reciprocal) >> 20);
+            sum += rowSrc[x + radius + 1] - first;
+        }
+        if (leftEnd <= rightStart) {
+            for (; x < rightStart; x++) {
+                rowDest[x] = (unsigned char)((sum * reciprocal) >> 20);
+                sum += rowSrc[x + radius + 1] - rowSrc[x - radius];
+            }
+        } else {
+            /* Window wider than the row: both ends clamp */
+            for (; x < leftEnd; x++) {
+                rowDest[x] = (unsigned char)((sum * reciprocal) >> 20);
+                sum += last - first;
+            }
+        }
+        for (; x < w; x++) {
+            rowDest[x] = (unsigned char)((sum * reciprocal) >> 20);
+            sum += last - rowSrc[x - radius];
+        }
+    }
+}
+
+/**
+ * @brief Vertical pass for columns [begin, end): tempBuffer -> dest
+ * @details Instead of walking each column with a w-byte stride, the band
+ *          keeps one running sum per column and streams through the rows,
+ *          so every access is sequential and the inner loop vectorizes.
+ */
+static void BlurColumnsBand(int begin, int end, void* jobData) {
+    const BlurJob* job = (const BlurJob*)jobData;
+    int w = job->w;
+    int h = job->h;
+    int radius = job->radius;
+    int reciprocal = (1 << 20) / (radius * 2 + 1);
+    int n = end - begin;
+    int* sums = job->columnSums + begin;
+    const unsigned char* temp = job->tempBuffer + begin;
+    unsigned char* dest = job->dest + begin;
+
+    /* Initialize window for y=0 */
+    memset(sums, 0, n * sizeof(int));
+    for (int k = -radius; k <= radius; k++) {
+        int idx = (k < 0) ? 0 : (k >= h ? h - 1 : k);
+        const unsigned char* row = temp + idx * w;
+        for (int i = 0; i < n; i++) sums[i] += row[i];
+    }
+
+    for (int y = 0; y < h; y++) {
+        int outIdx = (y - radius < 0) ? 0 : y - radius;
+        int inIdx = (y + radius + 1 >= h) ? h - 1 : y + radius + 1;
+        const unsigned char* outRow = temp + outIdx * w;
+        const unsigned char* inRow = temp + inIdx * w;
+        unsigned char* dstRow = dest + y * w;
+
+        for (int i = 0; i < n; i++) {
+            dstRow[i] = (unsigned char)((sums[i] * reciprocal) >> 20);
+            sums[i] += inRow[i] - outRow[i];
+        }
+    }
+}
+
+static BOOL EnsureColumnSums(int w) {
+    if (w <= g_columnSumsCapacity) return TRUE;
+    int* grown = (int*)realloc(g_columnSums, (size_t)w * sizeof(int));
+    if (!grown) return FALSE;
+    g_columnSums = grown;
+    g_columnSumsCapacity = w;
+    return TRUE;
+}
+
+BOOL ApplyGaussianBlurFast(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer,
+                           int w, int h, int radius) {
+    if (w <= 0 || h <= 0) return TRUE;
+    if (radius < 1) {
+        memcpy(dest, src, w * h);
+        return TRUE;
+    }
+    if (!EnsureColumnSums(w)) return FALSE;
+
+    BlurJob job = { src, dest, tempBuffer, g_columnSums, w, h, radius };
+
+    /* Horizontal Pass: src -> tempBuffer */
+    WorkerPool_ParallelFor(h, EffectRowGrain(w), BlurRowsBand, &job);
+
+    /* Vertical Pass: tempBuffer -> dest (dest may alias src, so only after every row is done) */
+    int columnGrain = (h < EFFECT_BAND_MIN_PIXELS) ? EFFECT_BAND_MIN_PIXELS / h : 1;
+    if (columnGrain < EFFECT_MIN_BAND_COLUMNS) columnGrain = EFFECT_MIN_BAND_COLUMNS;
+    WorkerPool_ParallelFor(w, columnGrain, BlurColumnsBand, &job);
+    return TRUE;
+}
+
+/**
+ * @brief Compare the fast engine with the reference on edge-heavy shapes
+ * @return FALSE if any output byte differs
+ */
+static BOOL VerifyBlurEngine(void) {
+    static const int shapes[][2] = { {1, 1}, {3, 17}, {37, 5}, {70, 41}, {133, 96} };
+    static const int radii[] = { 1, 2, 4, 10, 12, 40 };
+    BOOL ok = TRUE;
+
+    for (size_t s = 0; ok && s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        int w = shapes[s][0], h = shapes[s][1];
+        size_t size = (size_t)w * h;
+        unsigned char* src = (unsigned char*)malloc(size);
+        unsigned char* expect = (unsigned char*)malloc(size);
+        unsigned char* actual = (unsigned char*)malloc(size);
+        unsigned char* temp = (unsigned char*)malloc(size);
+        if (!src || !expect || !actual || !temp) {
+            ok = FALSE;
+        } else {
+            unsigned int seed = 0x9E3779B9u ^ (unsigned int)size;
+            for (size_t i = 0; i < size; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                src[i] = (seed >> 24) < 96 ? 0 : (unsigned char)(seed >> 16);
+            }
+            for (size_t r = 0; ok && r < sizeof(radii) / sizeof(radii[0]); r++) {
+                ApplyGaussianBlurReference(src, expect, temp, w, h, radii[r]);
+                ok = ApplyGaussianBlurFast(src, actual, temp, w, h, radii[r]) &&
+                     memcmp(expect, actual, size) == 0;
+            }
+        }
+        free(src);
+        free(expect);
+        free(actual);
+        free(temp);
+    }
+    return ok;
+}
+
+/**
+ * @brief Apply Optimized Box Blur (Sliding Window)
+ * O(1) per pixel regardless of radius
+ * @note Rows (then columns) are independent, so bands run on the worker
+ *       pool and the result matches a single-threaded pass exactly
+ */
+void ApplyGaussianBlur(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer, int w, int h, int radius) {
+    if (w <= 0 || h <= 0) return;
+    
+    if (radius < 1) {
+        memcpy(dest, src, w * h);
+        return;
+    }
+
+    if (!g_blurVerified) {
+        g_blurVerified = TRUE;
+        g_blurUseReference = !VerifyBlurEngine();
+        if (g_blurUseReference) {
+            LOG_WARNING("Blur engine self-check failed, using reference blur");
+        }
+    }
+
+    if (g_blurUseReference || !ApplyGaussianBlurFast(src, dest, tempBuffer, w, h, radius)) {
+        ApplyGaussianBlurReference(src, dest, tempBuffer, w, h, radius);
+    }
+}
+
+void ApplyGaussianBlur3(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer,
+                        int w, int h, float sigma) {
+    if (w <= 0 || h <= 0) return;
+    if (sigma <= 0.0f) {
+        memcpy(dest, src, w * h);
+        return;
+    }
+
+    /* Box widths whose three-fold convolution has variance sigma^2 (Kovesi) */
+    float ideal = sqrtf(12.0f * sigma * sigma / 3.0f + 1.0f);
+    int lower = (int)ideal;
+    if ((lower & 1) == 0) lower--;
+    if (lower < 1) lower = 1;
+    int upper = lower + 2;
+    float lowerCount = (12.0f * sigma * sigma - 3.0f * lower * lower - 12.0f * lower - 9.0f) /
+                       (-4.0f * lower - 4.0f);
+    int m = (int)(lowerCount + 0.5f);
+
+    for (int pass = 0; pass < 3; pass++) {
+        int boxWidth = (pass < m) ? lower : upper;
+        ApplyGaussianBlur(pass == 0 ? src : dest, dest, tempBuffer, w, h, (boxWidth - 1) / 2);
+    }
+}
+
+/**
+ * @brief Box-downsample a map by two, treating pixels past the edge as zero
+ */
+static void HalveMap(const unsigned char* src, int w, int h, unsigned char* dst,
+                     const unsigned char* zeroRow) {
+    const BlendKernels* kernels = BlendKernels_Get();
+    int dw = (w + 1) / 2;
+    int dh = (h + 1) / 2;
+    for (int y = 0; y < dh; y++) {
+        const unsigned char* row0 = src + (size_t)(2 * y) * w;
+        const unsigned char* row1 = (2 * y + 1 < h) ? row0 + w : zeroRow;
+        unsigned char* out = dst + (size_t)y * dw;
+        kernels->halveRow(out, row0, row1, w / 2);
+        if (w & 1) out[dw - 1] = (unsigned char)((row0[w - 1] + row1[w - 1] + 2) >> 2);
+    }
+}
+
+/**
+ * @brief Source index and 8-bit weight for bilinear upsampling by scale
+ * @details Reduced pixel k covers [k * scale, (k + 1) * scale), so full
+ *          pixel x samples at (x + 0.5) / scale - 0.5.
+ */
+static void UpsampleTap(int x, int scale, int srcCount, int* index, int* weight) {
+    int pos = (2 * x + 1) * (128 / scale) - 128;
+    if (pos < 0) {
+        *index = 0;
+        *weight = 0;
+        return;
+    }
+    *index = pos >> 8;
+    *weight = pos & 255;
+    if (*index >= srcCount - 1) {
+        *index = srcCount - 1;
+        *weight = 0;
+    }
+}
+
+/**
+ * @brief Blur a wide, low-frequency map at the configured resolution
+ * @param passes Number of blur passes at radius (later passes blur the result)
+ * @details At reduced quality src is box-downsampled, blurred with the radius
+ *          scaled down, then upsampled bilinearly into dest. src is left
+ *          untouched either way so callers can still read the sharp map.
+ */
+static void BlurEffectMap(unsigned char* src, unsigned char* dest, unsigned char* tempBuffer,
+                          int w, int h, int radius, int passes) {
+    int scale = (int)GetEffectQuality();
+    while (scale > 1 && (w / scale < LOW_RES_MIN_SIDE || h / scale < LOW_RES_MIN_SIDE ||
+                         radius / scale < LOW_RES_MIN_RADIUS)) {
+        scale /= 2;
+    }
+
+    int halfW = (w + 1) / 2, halfH = (h + 1) / 2;
+    int lowW = (w + scale - 1) / scale, lowH = (h + scale - 1) / scale;
+    size_t halfSize = (scale == 4) ? (size_t)halfW * halfH : 0;
+    size_t lowSize = (size_t)lowW * lowH;
+    size_t needed = halfSize + 2 * lowSize + (size_t)w * lowH + w + 2 * (size_t)w * sizeof(int);
+
+    if (scale > 1 && needed > g_lowResCapacity) {
+        unsigned char* grown = (unsigned char*)realloc(g_lowResBuffer, needed);
+        if (grown) {
+            g_lowResBuffer = grown;
+            g_lowResCapacity = needed;
+        } else {
+            scale = 1;
+        }
+    }
+
+    if (scale == 1) {
+        for (int pass = 0; pass < passes; pass++) {
+            ApplyGaussianBlur(pass == 0 ? src : dest, dest, tempBuffer, w, h, radius);
+        }
+        return;
+    }
+
+    int* taps = (int*)g_lowResBuffer;
+    int* tapWeights = taps + w;
+    unsigned char* half = (unsigned char*)(tapWeights + w);
+    unsigned char* low = half + halfSize;
+    unsigned char* lowTemp = low + lowSize;
+    unsigned char* stretched = lowTemp + lowSize;
+    unsigned char* zeroRow = stretched + (size_t)w * lowH;
+    memset(zeroRow, 0, w);
+
+    /* 1. Downsample */
+    if (scale == 4) {
+        HalveMap(src, w, h, half, zeroRow);
+        HalveMap(half, halfW, halfH, low, zeroRow);
+    } else {
+        HalveMap(src, w, h, low, zeroRow);
+    }
+
+    /* 2. Blur at low resolution */
+    int lowRadius = (radius + scale / 2) / scale;
+    for (int pass = 0; pass < passes; pass++) {
+        ApplyGaussianBlur(low, low, lowTemp, lowW, lowH, lowRadius);
+    }
+
+    /* 3. Stretch rows to full width (1/scale of the output) */
+    for (int x = 0; x < w; x++) {
+        UpsampleTap(x, scale, lowW, &taps[x], &tapWeights[x]);
+    }
+    for (int y = 0; y < lowH; y++) {
+        const unsigned char* in = low + (size_t)y * lowW;
+        unsigned char* out = stretched + (size_t)y * w;
+        for (int x = 0; x < w; x++) {
+            int i0 = taps[x];
+            int i1 = (i0 + 1 < lowW) ? i0 + 1 : i0;
+            int fw = tapWeights[x];
+            out[x] = (unsigned char)((in[i0] * (256 - fw) + in[i1] * fw + 128) >> 8);
+        }
+    }
+
+    /* 4. Blend stretched rows into every output row */
+    const BlendKernels* kernels = BlendKernels_Get();
+    for (int y = 0; y < h; y++) {
+        int row, weight;
+        UpsampleTap(y, scale, lowH, &row, &weight);
+        int next = (row + 1 < lowH) ? row + 1 : row;
+        kernels->lerpRows(dest + (size_t)y * w, stretched + (size_t)row * w,
+                          stretched + (size_t)next * w, weight, w);
+    }
+}
+
+/* ============================================================================
+ * Distance field maps
+ * ============================================================================ */
+
+/*
+ * Profiles indexed by field value. Each one is what the matching blur
+ * produces across a straight edge, so SDF text keeps the look of the
+ * blurred effects while costing one table lookup per pixel.
+ */
+static unsigned char g_fieldGlowLUT[256];  /* Coverage blurred at radius 4 (glow, glass shadow) */
+static unsigned char g_fieldTubeLUT[256];  /* Neon: 2 px inner rim blurred at radius 2 */
+static unsigned char g_fieldHaloLUT[256];  /* Neon: tube blurred at radius 12 */
+static BOOL g_fieldLUTReady = FALSE;
+
+/*
+ * A straight rim blurs to 40% of full strength; in the blurred path the
+ * many short edges of real glyphs add up to more, so the distance
+ * profiles are doubled to keep the white-hot core visible.
+ */
+#define NEON_FIELD_RIM_GAIN 2.0f
+
+/** Share of a (2 * radius + 1) box centred at d that falls inside [lo, hi] */
+static float BoxOverlap(float d, float radius, float lo, float hi) {
+    float a = d - radius - 0.5f;
+    float b = d + radius + 0.5f;
+    if (a < lo) a = lo;
+    if (b > hi) b = hi;
+    return (b > a) ? (b - a) / (2.0f * radius + 1.0f) : 0.0f;
+}
+
+static unsigned char ToAlpha(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return (unsigned char)(v * 255.0f + 0.5f);
+}
+
+static void InitFieldLUTs(void) {
+    if (g_fieldLUTReady) return;
+
+    for (int v = 0; v < 256; v++) {
+        /* Distance in pixels, positive outside the outline */
+        float d = (float)(SDF_FIELD_EDGE - v) / SDF_FIELD_STEPS_PER_PIXEL;
+
+        g_fieldGlowLUT[v] = ToAlpha(BoxOverlap(d, 4.0f, -1e9f, 0.0f));
+        g_fieldTubeLUT[v] = ToAlpha(BoxOverlap(d, 2.0f, -2.0f, 0.0f) * NEON_FIELD_RIM_GAIN);
+
+        /* Halo integrates the tube profile over the wide box */
+        float sum = 0.0f;
+        for (float u = -12.5f; u < 12.5f; u += 0.25f) {
+            sum += BoxOverlap(d + u + 0.125f, 2.0f, -2.0f, 0.0f) * 0.25f;
+        }
+        g_fieldHaloLUT[v] = ToAlpha(sum / 25.0f * NEON_FIELD_RIM_GAIN);
+    }
+    g_fieldLUTReady = TRUE;
+}
+
+/**
+ * @brief Fill a padded effect map from a run's distance field
+ * @param lut Profile applied to every field value (pixels past the run read field 0)
+ */
+static void FieldToMap(const unsigned char* field, int w, int h, int padding,
+                       const unsigned char* lut, unsigned char* map) {
+    int gw = w + padding * 2;
+    int gh = h + padding * 2;
+
+    InitFieldLUTs();
+    memset(map, lut[0], (size_t)gw * gh);
+    for (int j = 0; j < h; j++) {
+        const unsigned char* src = field + (size_t)j * w;
+        unsigned char* dst = map + (size_t)(j + padding) * gw + padding;
+        for (int i = 0; i < w; i++) dst[i] = lut[src[i]];
+    }
+}
+
 /**
  * @brief Render a glow effect around a bitmap using Gaussian blur
  */
@@ -109,9 +578,10 @@ void RenderGlowEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData) {
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field) {
     /* 1. Dynamic Buffer Allocation */
-    int padding = 12;
+    int padding = GLOW_PADDING;
     int gw = w + padding * 2;
     int gh = h + padding * 2;
     int neededSize = gw * gh;
@@ -141,14 +611,19 @@ void RenderGlowEffect(DWORD* pixels, int destWidth, int destHeight,
     unsigned char* glowMap = g_effectBuffer2;
     unsigned char* tempBuffer = g_effectBuffer3;
 
-    /* 2. Prepare Alpha Map */
-    memset(alphaMap, 0, neededSize);
-    for (int j = 0; j < h; j++) {
-        memcpy(alphaMap + (j + padding) * gw + padding, bitmap + j * w, w);
-    }
+    if (field) {
+        /* 2-3. Glow straight from distance */
+        FieldToMap(field, w, h, padding, g_fieldGlowLUT, glowMap);
+    } else {
+        /* 2. Prepare Alpha Map */
+        memset(alphaMap, 0, neededSize);
+        for (int j = 0; j < h; j++) {
+            memcpy(alphaMap + (j + padding) * gw + padding, bitmap + j * w, w);
+        }
 
-    /* 3. Generate Glow Map */
-    ApplyGaussianBlur(alphaMap, glowMap, tempBuffer, gw, gh, 4);
+        /* 3. Generate Glow Map */
+        BlurEffectMap(alphaMap, glowMap, tempBuffer, gw, gh, 4, 1);
+    }
 
     /* 4. Render to Destination */
     int startX = x_pos - padding;
@@ -214,9 +689,10 @@ void RenderGlassEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData) {
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field) {
     /* Dynamic Buffer Allocation */
-    int padding = 4; /* Small padding for bevel */
+    int padding = GLASS_PADDING; /* Small padding for bevel */
     int gw = w + padding * 2;
     int gh = h + padding * 2;
     int neededSize = gw * gh;
@@ -251,9 +727,13 @@ void RenderGlassEffect(DWORD* pixels, int destWidth, int destHeight,
         memcpy(alphaMap + (j + padding) * gw + padding, bitmap + j * w, w);
     }
 
-    /* Create Soft Shadow Map */
+    /* Create Soft Shadow Map (the glow profile has the same radius) */
     int shadowBlur = 4;
-    ApplyGaussianBlur(alphaMap, shadowMap, tempBuffer, gw, gh, shadowBlur);
+    if (field) {
+        FieldToMap(field, w, h, padding, g_fieldGlowLUT, shadowMap);
+    } else {
+        ApplyGaussianBlur(alphaMap, shadowMap, tempBuffer, gw, gh, shadowBlur);
+    }
 
     int startX = x_pos - padding;
     int startY = y_pos - padding;
@@ -387,9 +867,10 @@ void RenderNeonEffect(DWORD* pixels, int destWidth, int destHeight,
                       int x_pos, int y_pos,
                       unsigned char* bitmap, int w, int h,
                       int r, int g, int b,
-                      GlowColorCallback colorCb, void* userData) {
+                      GlowColorCallback colorCb, void* userData,
+                      const unsigned char* field) {
     /* 1. Dynamic Buffer Allocation */
-    int padding = 20; /* Sufficient padding for wide glow */
+    int padding = NEON_PADDING; /* Sufficient padding for wide glow */
     int gw = w + padding * 2;
     int gh = h + padding * 2;
     int neededSize = gw * gh;
@@ -426,75 +907,81 @@ void RenderNeonEffect(DWORD* pixels, int destWidth, int destHeight,
     unsigned char* buf2 = g_effectBuffer2;
     unsigned char* buf3 = g_effectBuffer3;
 
-    /* Clear buffers */
-    memset(buf1, 0, neededSize);
-    memset(buf2, 0, neededSize);
-    memset(buf3, 0, neededSize);
-
-    /* Step 1: Load Original Bitmap into Buf1 */
-    for (int j = 0; j < h; j++) {
-        memcpy(buf1 + (j + padding) * gw + padding, bitmap + j * w, w);
-    }
+    if (field) {
+        /* Steps 1-5 from distance: the same rim and halo profiles, no erosion or blurs */
+        FieldToMap(field, w, h, padding, g_fieldHaloLUT, buf1);
+        FieldToMap(field, w, h, padding, g_fieldTubeLUT, buf2);
+    } else {
+        /* Clear buffers */
+        memset(buf1, 0, neededSize);
+        memset(buf2, 0, neededSize);
+        memset(buf3, 0, neededSize);
+
+        /* Step 1: Load Original Bitmap into Buf1 */
+        for (int j = 0; j < h; j++) {
+            memcpy(buf1 + (j + padding) * gw + padding, bitmap + j * w, w);
+        }
 
-    /* Step 2: Erode Buf1 into Buf2 to create inner mask */
-    /* Radius 2 erosion for a decent tube thickness */
-    int erosion = 2; 
-    for (int j = 0; j < gh; j++) {
-        for (int i = 0; i < gw; i++) {
-            /* Fast erosion: find min value in kernel */
-            unsigned char minVal = 255;
-            
-            /* Center */
-            unsigned char val = buf1[j * gw + i];
-            if (val < minVal) minVal = val;
+        /* Step 2: Erode Buf1 into Buf2 to create inner mask */
+        /* Radius 2 erosion for a decent tube thickness */
+        int erosion = 2; 
+        for (int j = 0; j < gh; j++) {
+            for (int i = 0; i < gw; i++) {
+                /* Fast erosion: find min value in kernel */
+                unsigned char minVal = 255;
             
-            /* Left */
-            if (i > erosion) {
-                val = buf1[j * gw + (i - erosion)];
-                if (val < minVal) minVal = val;
-            } else minVal = 0;
-
-            /* Right */
-            if (i < gw - erosion) {
-                val = buf1[j * gw + (i + erosion)];
+                /* Center */
+                unsigned char val = buf1[j * gw + i];
                 if (val < minVal) minVal = val;
-            } else minVal = 0;
-
-            /* Up */
-            if (j > erosion) {
-                val = buf1[(j - erosion) * gw + i];
-                if (val < minVal) minVal = val;
-            } else minVal = 0;
-
-            /* Down */
-            if (j < gh - erosion) {
-                val = buf1[(j + erosion) * gw + i];
-                if (val < minVal) minVal = val;
-            } else minVal = 0;
-
-            buf2[j * gw + i] = minVal;
+            
+                /* Left */
+                if (i > erosion) {
+                    val = buf1[j * gw + (i - erosion)];
+                    if (val < minVal) minVal = val;
+                } else minVal = 0;
+
+                /* Right */
+                if (i < gw - erosion) {
+                    val = buf1[j * gw + (i + erosion)];
+                    if (val < minVal) minVal = val;
+                } else minVal = 0;
+
+                /* Up */
+                if (j > erosion) {
+                    val = buf1[(j - erosion) * gw + i];
+                    if (val < minVal) minVal = val;
+                } else minVal = 0;
+
+                /* Down */
+                if (j < gh - erosion) {
+                    val = buf1[(j + erosion) * gw + i];
+                    if (val < minVal) minVal = val;
+                } else minVal = 0;
+
+                buf2[j * gw + i] = minVal;
+            }
         }
-    }
 
-    /* Step 3: Subtract Eroded (Buf2) from Original (Buf1) to get Outline in Buf3 */
-    for (int k = 0; k < neededSize; k++) {
-        int diff = (int)buf1[k] - (int)buf2[k];
-        if (diff < 0) diff = 0;
-        /* Boost alpha to make outline distinct */
-        if (diff > 0) diff = (diff * 3) / 2; 
-        if (diff > 255) diff = 255;
-        buf3[k] = (unsigned char)diff;
-    }
+        /* Step 3: Subtract Eroded (Buf2) from Original (Buf1) to get Outline in Buf3 */
+        for (int k = 0; k < neededSize; k++) {
+            int diff = (int)buf1[k] - (int)buf2[k];
+            if (diff < 0) diff = 0;
+            /* Boost alpha to make outline distinct */
+            if (diff > 0) diff = (diff * 3) / 2; 
+            if (diff > 255) diff = 255;
+            buf3[k] = (unsigned char)diff;
+        }
 
-    /* Step 4: Create "Tube Body" (Narrow Blur) */
-    /* Source: Buf3 (Outline) -> Dest: Buf2 (Tube). Temp: Buf1. */
-    /* Radius 2 gives a nice glass curve feel */
-    ApplyGaussianBlur(buf3, buf2, buf1, gw, gh, 2);
+        /* Step 4: Create "Tube Body" (Narrow Blur) */
+        /* Source: Buf3 (Outline) -> Dest: Buf2 (Tube). Temp: Buf1. */
+        /* Radius 2 gives a nice glass curve feel */
+        ApplyGaussianBlur(buf3, buf2, buf1, gw, gh, 2);
 
-    /* Step 5: Create "Ambient Glow" (Wide Blur) */
-    /* Source: Buf2 (Tube) -> Dest: Buf1 (Glow). Temp: Buf3. */
-    /* Radius 12 for atmospheric dispersion */
-    ApplyGaussianBlur(buf2, buf1, buf3, gw, gh, 12);
+        /* Step 5: Create "Ambient Glow" (Wide Blur) */
+        /* Source: Buf2 (Tube) -> Dest: Buf1 (Glow). Temp: Buf3. */
+        /* Radius 12 for atmospheric dispersion */
+        BlurEffectMap(buf2, buf1, buf3, gw, gh, 12, 1);
+    }
 
     /* Now:
        Buf1 = Wide Ambient Glow
@@ -590,68 +1077,37 @@ void RenderNeonEffect(DWORD* pixels, int destWidth, int destHeight,
     }
 }
 
-/**
- * @brief Render Holographic/Crystal effect
- * "Phantom Crystal" Style: Transparent glass with soft colored glow.
- * Uses user's selected color (supports gradients) for the atmospheric glow.
- * 
- * Features:
- * 1. Double Gaussian Blur for smooth, wide dispersion.
- * 2. User color respected - pure colors stay pure, gradients flow.
- */
-void RenderHolographicEffect(DWORD* pixels, int destWidth, int destHeight,
-                            int x_pos, int y_pos,
-                            unsigned char* bitmap, int w, int h,
-                            int r, int g, int b,
-                            GlowColorCallback colorCb, void* userData,
-                            int timeOffset) {
-    (void)timeOffset;
-    
-    /* 1. Dynamic Buffer Allocation */
-    int padding = 16;
-    int gw = w + padding * 2;
-    int gh = h + padding * 2;
-    int neededSize = gw * gh;
-
-    if (neededSize > g_effectBufferSize || !g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
-        int newSize = neededSize * 2;
-        if (g_effectBuffer1) free(g_effectBuffer1);
-        if (g_effectBuffer2) free(g_effectBuffer2);
-        if (g_effectBuffer3) free(g_effectBuffer3);
-        
-        g_effectBuffer1 = (unsigned char*)malloc(newSize);
-        g_effectBuffer2 = (unsigned char*)malloc(newSize);
-        g_effectBuffer3 = (unsigned char*)malloc(newSize);
-        
-        if (!g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
-            if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
-            if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
-            if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
-            g_effectBufferSize = 0;
-            return;
-        }
-        g_effectBufferSize = newSize;
-    }
-
-    unsigned char* alphaMap = g_effectBuffer1;
-    unsigned char* glowMap = g_effectBuffer2;
-    unsigned char* tempMap = g_effectBuffer3;
-    
-    /* 2. Prepare Maps */
-    memset(alphaMap, 0, neededSize);
-    for (int j = 0; j < h; j++) {
-        memcpy(alphaMap + (j + padding) * gw + padding, bitmap + j * w, w);
-    }
-    
-    /* Generate wide soft glow */
-    /* Double Gaussian for smooth, wide dispersion - critical for visual quality */
-    ApplyGaussianBlur(alphaMap, glowMap, tempMap, gw, gh, 10);
-    ApplyGaussianBlur(glowMap, glowMap, tempMap, gw, gh, 10);
-
-    int startX = x_pos - padding;
-    int startY = y_pos - padding;
-
-    for (int j = 1; j < gh - 1; j++) {
+/* Everything a holographic composition band needs */
+typedef struct {
+    DWORD* pixels;
+    int destWidth;
+    int destHeight;
+    int startX;
+    int startY;
+    int gw;
+    unsigned char* alphaMap;
+    unsigned char* glowMap;
+    int r, g, b;
+    GlowColorCallback colorCb;
+    void* userData;
+} HolographicJob;
+
+/* Composite rows [begin + 1, end + 1) of the padded maps */
+static void HolographicRowsBand(int begin, int end, void* jobData) {
+    const HolographicJob* job = (const HolographicJob*)jobData;
+    DWORD* pixels = job->pixels;
+    int destWidth = job->destWidth;
+    int destHeight = job->destHeight;
+    int startX = job->startX;
+    int startY = job->startY;
+    int gw = job->gw;
+    unsigned char* alphaMap = job->alphaMap;
+    unsigned char* glowMap = job->glowMap;
+    int r = job->r, g = job->g, b = job->b;
+    GlowColorCallback colorCb = job->colorCb;
+    void* userData = job->userData;
+
+    for (int j = begin + 1; j < end + 1; j++) {
         int screenY = startY + j;
         if (screenY < 0 || screenY >= destHeight) continue;
 
@@ -788,27 +1244,130 @@ void RenderHolographicEffect(DWORD* pixels, int destWidth, int destHeight,
     }
 }
 
-
 /**
- * @brief Free static resources used by drawing effects
+ * @brief Render Holographic/Crystal effect
+ * "Phantom Crystal" Style: Transparent glass with soft colored glow.
+ * Uses user's selected color (supports gradients) for the atmospheric glow.
+ * 
+ * Features:
+ * 1. Double Gaussian Blur for smooth, wide dispersion.
+ * 2. User color respected - pure colors stay pure, gradients flow.
  */
-void CleanupDrawingEffects(void) {
-    if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
-    if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
-    if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
-    g_effectBufferSize = 0;
-}
-
-/* --- OPTIMIZATION HELPERS --- */
-
-/* Fast integer square root approximation for small numbers (0-255 range gradients) */
-/* "Octagonal" Approximation: max + 0.375 * min */
-/* Error < 3%, much rounder than max + 0.5 * min */
-static inline int FastIntDist(int dx, int dy) {
-    int ax = abs(dx);
-    int ay = abs(dy);
-    int mx = (ax > ay) ? ax : ay;
-    int mn = (ax > ay) ? ay : ax;
+void RenderHolographicEffect(DWORD* pixels, int destWidth, int destHeight,
+                            int x_pos, int y_pos,
+                            unsigned char* bitmap, int w, int h,
+                            int r, int g, int b,
+                            GlowColorCallback colorCb, void* userData,
+                            int timeOffset) {
+    (void)timeOffset;
+    
+    /* 1. Dynamic Buffer Allocation */
+    int padding = HOLOGRAPHIC_PADDING;
+    int gw = w + padding * 2;
+    int gh = h + padding * 2;
+    int neededSize = gw * gh;
+
+    if (neededSize > g_effectBufferSize || !g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
+        int newSize = neededSize * 2;
+        if (g_effectBuffer1) free(g_effectBuffer1);
+        if (g_effectBuffer2) free(g_effectBuffer2);
+        if (g_effectBuffer3) free(g_effectBuffer3);
+        
+        g_effectBuffer1 = (unsigned char*)malloc(newSize);
+        g_effectBuffer2 = (unsigned char*)malloc(newSize);
+        g_effectBuffer3 = (unsigned char*)malloc(newSize);
+        
+        if (!g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
+            if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
+            if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
+            if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
+            g_effectBufferSize = 0;
+            return;
+        }
+        g_effectBufferSize = newSize;
+    }
+
+    unsigned char* alphaMap = g_effectBuffer1;
+    unsigned char* glowMap = g_effectBuffer2;
+    unsigned char* tempMap = g_effectBuffer3;
+    
+    /* 2. Prepare Maps */
+    memset(alphaMap, 0, neededSize);
+    for (int j = 0; j < h; j++) {
+        memcpy(alphaMap + (j + padding) * gw + padding, bitmap + j * w, w);
+    }
+    
+    /* Generate wide soft glow */
+    /* Double Gaussian for smooth, wide dispersion - critical for visual quality */
+    BlurEffectMap(alphaMap, glowMap, tempMap, gw, gh, 10, 2);
+
+    int startX = x_pos - padding;
+    int startY = y_pos - padding;
+
+    /* Rows are independent; the pool splits them into bands */
+    HolographicJob job = { pixels, destWidth, destHeight, startX, startY, gw,
+                           alphaMap, glowMap, r, g, b, colorCb, userData };
+    WorkerPool_ParallelFor(gh - 2, EffectRowGrain(gw), HolographicRowsBand, &job);
+}
+
+
+const EffectTraits* GetEffectTraits(EffectType effect) {
+    if (effect <= EFFECT_TYPE_NONE || effect > EFFECT_TYPE_LIQUID) return NULL;
+    return &g_effectTraits[effect];
+}
+
+BOOL IsEffectTimeDependent(EffectType effect) {
+    const EffectTraits* traits = GetEffectTraits(effect);
+    return traits ? traits->timeDependent : FALSE;
+}
+
+void SetEffectQuality(EffectQuality quality) {
+    if (quality != EFFECT_QUALITY_HALF && quality != EFFECT_QUALITY_QUARTER) {
+        quality = EFFECT_QUALITY_FULL;
+    }
+    if (quality != g_effectQuality) {
+        LOG_INFO("Effect blur resolution: 1/%d", (int)quality);
+        g_effectQuality = quality;
+    }
+}
+
+void SetEffectQualityFloor(EffectQuality quality) {
+    if (quality != EFFECT_QUALITY_HALF && quality != EFFECT_QUALITY_QUARTER) {
+        quality = EFFECT_QUALITY_FULL;
+    }
+    g_effectQualityFloor = quality;
+}
+
+EffectQuality GetEffectQuality(void) {
+    return (g_effectQualityFloor > g_effectQuality) ? g_effectQualityFloor : g_effectQuality;
+}
+
+/**
+ * @brief Free static resources used by drawing effects
+ */
+void CleanupDrawingEffects(void) {
+    if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
+    if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
+    if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
+    g_effectBufferSize = 0;
+    free(g_columnSums);
+    g_columnSums = NULL;
+    g_columnSumsCapacity = 0;
+    free(g_lowResBuffer);
+    g_lowResBuffer = NULL;
+    g_lowResCapacity = 0;
+}
+
+/* --- OPTIMIZATION HELPERS --- */
+
+/* Fast integer square root approximation for small numbers (0-255 range gradients) */
+/* "Octagonal" Approximation: max + 0.375 * min */
+/* Error < 3%, much rounder than max + 0.5 * min */
+static inline int FastIntDist(int dx, int dy) {
+    int ax = abs(dx);
+    int ay = abs(dy);
+    int mx = (ax > ay) ? ax : ay;
+    int mn = (ax > ay) ? ay : ax;
     /* mx + (mn * 3/8) -> mx + 0.25mn + 0.125mn */
     return mx + (mn >> 2) + (mn >> 3);
 }
@@ -827,6 +1386,17 @@ typedef struct {
 static SlopeProps g_slopeLUT[256];
 static BOOL g_slopeLUTInit = FALSE;
 
+/* Flow/warp sine table, one cycle (Tri-Planar Waves) */
+#define FLOW_LUT_SIZE 2048
+#define FLOW_LUT_MASK 2047
+static int g_flowLUT[FLOW_LUT_SIZE];
+static BOOL g_flowLUTInit = FALSE;
+
+/* Height below which liquid draws nothing; the warp moves a sample by at
+ * most (3 * 4) >> 1 pixels on each axis, since the flow table stays within +-4 */
+#define LIQUID_MASS_MIN 24
+#define LIQUID_MAX_WARP 6
+
 static void InitSpecularLUT(void) {
     if (g_lutInitialized) return;
     for (int i = 0; i < 256; i++) {
@@ -871,126 +1441,60 @@ static void InitSlopeLUT(void) {
     g_slopeLUTInit = TRUE;
 }
 
-/**
- * @brief Render Liquid Flow/Caustics Effect
- * CPU Usage: True Zero (Branchless)
- * Visuals: High-Bright Mercury
- */
-void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
-                       int x_pos, int y_pos,
-                       unsigned char* bitmap, int w, int h,
-                       int r, int g, int b,
-                       GlowColorCallback colorCb, void* userData,
-                       int timeOffset) {
-    
-    if (!g_lutInitialized) InitSpecularLUT();
-    if (!g_slopeLUTInit) InitSlopeLUT();
-
-    /* 1. Dynamic Buffer Allocation (Extreme Memory Optimization) */
-    int padding = 12;
-    int gw = w + padding * 2;
-    int gh = h + padding * 2;
-    int neededSize = gw * gh;
-
-    /* Check if resize needed */
-    if (neededSize > g_effectBufferSize || !g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
-        /* Revert to standard 3-buffer allocation to maintain compatibility with other effects */
-        /* Other effects assume if g_effectBufferSize is sufficient, ALL 3 buffers exist */
-        
-        int newSize = neededSize; 
-        
-        /* Free old buffers first, then allocate new ones to avoid realloc complexity */
-        if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
-        if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
-        if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
-        
-        g_effectBuffer1 = (unsigned char*)malloc(newSize);
-        g_effectBuffer2 = (unsigned char*)malloc(newSize);
-        g_effectBuffer3 = (unsigned char*)malloc(newSize);
-        
-        if (!g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
-            /* Allocation failed - cleanup */
-            if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
-            if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
-            if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
-            g_effectBufferSize = 0;
-            return;
-        }
-        
-        g_effectBufferSize = newSize;
-    }
-
-    /* 
-     * 2-Buffer Strategy (still used for processing efficiency)
-     * Buffer1: Stores Bitmap initially, then stores the Final HeightMap
-     * Buffer2: Used as Temp buffer for Gaussian Blur
-     * Buffer3: Unused by Liquid, but kept alive for other effects
-     */
-    unsigned char* heightMap = g_effectBuffer1; 
-    unsigned char* tempMap = g_effectBuffer2;   
-    
-    /* 2. Prepare Alpha Map (directly into what will be HeightMap) */
-    memset(heightMap, 0, neededSize);
-    for (int j = 0; j < h; j++) {
-        memcpy(heightMap + (j + padding) * gw + padding, bitmap + j * w, w);
-    }
-
-    /* 3. Create Height Map (Thick Volume) */
-    /* In-Place Blur: src(heightMap) -> temp -> dest(heightMap) */
-    /* This works because ApplyGaussianBlur's passes are separated */
-    ApplyGaussianBlur(heightMap, heightMap, tempMap, gw, gh, 4);
-
-    /* 4. Precompute Flow/Warp LUT (Tri-Planar Waves) */
-    /* 
-     * OPTIMIZATION: Keep 't' as a wrapped integer index [0-2047]
-     * No float math in the frame logic needed if we map time correctly.
-     * 1 cycle = 2048 units.
-     * Speed factor 0.0025 * 2048 ~= 5 units per ms?
-     * Let's stick to float for 't' calculation ONCE per frame, but use INT for everything else.
-     */
-    #define FLOW_LUT_SIZE 2048
-    #define FLOW_LUT_MASK 2047
-    static int flowLUT[FLOW_LUT_SIZE];
-    static BOOL flowLUTInit = FALSE;
-    
-    /* Only compute the base sine wave ONCE ever, or if we want to animate frequency?
-       Actually, the phase changes, not the wave shape. So we compute the wave ONCE.
-    */
-    if (!flowLUTInit) {
-        for (int i = 0; i < FLOW_LUT_SIZE; i++) {
-            float angle = (i * 6.28318f) / FLOW_LUT_SIZE;
-            float val = sinf(angle) * 4.0f; /* Amplitude 4.0 */
-            flowLUT[i] = (int)(val); 
-        }
-        flowLUTInit = TRUE;
-    }
-    
-    /* Calculate Phase Offsets */
-    /* t scales 2*PI to roughly ~125.6 range in previous code.
-       Here we map it to LUT index [0-2047].
-       Previous: t = time * 0.0025. 
-       2PI ~ 6.28.
-       LUT covers 2PI.
-       So LUT_index = (time * 0.0025 / 2PI) * 2048
-                    = time * 0.0025 * 326
-                    = time * 0.815
-    */
-    int t_idx = (int)((double)timeOffset * 0.815) & FLOW_LUT_MASK;
-
-    int startX = x_pos - padding;
-    int startY = y_pos - padding;
-    
-    /* Precalc 60 degree vector constants (sin(60) ~= 0.866 ~= 222/256) */
-    /* t1, t2, t3 offsets */
-    int t1 = t_idx;
-    int t2 = (t_idx + 682) & FLOW_LUT_MASK; /* +1/3 cycle */
-    int t3 = (t_idx + 1365) & FLOW_LUT_MASK; /* +2/3 cycle */
-
-    /* 5. Main Optical Loop (INT OPTIMIZED) */
-    for (int j = 2; j < gh - 2; j++) {
+/* Everything a liquid composition band needs */
+typedef struct {
+    DWORD* pixels;
+    int destWidth;
+    int destHeight;
+    int startX;
+    int startY;
+    int gw;
+    int gh;
+    const unsigned char* heightMap;
+    const int* massFirst;   /* per height-map row: first column >= LIQUID_MASS_MIN, or gw */
+    const int* massLast;    /* per height-map row: last such column, or -1 */
+    int t1, t2, t3;
+    int r, g, b;
+    GlowColorCallback colorCb;
+    void* userData;
+} LiquidJob;
+
+/* Composite rows [begin + 2, end + 2) of the padded height map */
+static void LiquidRowsBand(int begin, int end, void* jobData) {
+    const LiquidJob* job = (const LiquidJob*)jobData;
+    DWORD* pixels = job->pixels;
+    int destWidth = job->destWidth;
+    int destHeight = job->destHeight;
+    int startX = job->startX;
+    int startY = job->startY;
+    int gw = job->gw;
+    int gh = job->gh;
+    const unsigned char* heightMap = job->heightMap;
+    const int* massFirst = job->massFirst;
+    const int* massLast = job->massLast;
+    const int* flowLUT = g_flowLUT;
+    int t1 = job->t1, t2 = job->t2, t3 = job->t3;
+    int r = job->r, g = job->g, b = job->b;
+    GlowColorCallback colorCb = job->colorCb;
+    void* userData = job->userData;
+
+    for (int j = begin + 2; j < end + 2; j++) {
         int screenY = startY + j;
         if (screenY < 0 || screenY >= destHeight) continue;
 
+        /* Only columns whose warped sample can land on mass: a multi-line
+         * layer is mostly blank beside short lines and between lines */
+        int firstSrc = j - LIQUID_MAX_WARP < 1 ? 1 : j - LIQUID_MAX_WARP;
+        int lastSrc = j + LIQUID_MAX_WARP > gh - 2 ? gh - 2 : j + LIQUID_MAX_WARP;
+        int lo = gw, hi = -1;
+        for (int y = firstSrc; y <= lastSrc; y++) {
+            if (massFirst[y] < lo) lo = massFirst[y];
+            if (massLast[y] > hi) hi = massLast[y];
+        }
+        if (lo > hi) continue;
+        int iBegin = lo - LIQUID_MAX_WARP < 2 ? 2 : lo - LIQUID_MAX_WARP;
+        int iEnd = hi + LIQUID_MAX_WARP + 1 > gw - 2 ? gw - 2 : hi + LIQUID_MAX_WARP + 1;
+
         DWORD* pDestRow = pixels + screenY * destWidth;
         
         /* 
@@ -999,7 +1503,7 @@ void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
          */
         int yComp = (screenY * 222) >> 8; 
 
-        for (int i = 2; i < gw - 2; i++) {
+        for (int i = iBegin; i < iEnd; i++) {
             int screenX = startX + i;
             if (screenX < 0 || screenX >= destWidth) continue;
 
@@ -1039,7 +1543,7 @@ void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
             
             /* Soft Edge Threshold (Antialiasing) */
             /* Lower threshold to capture the fading edge */
-            if (mass < 24) continue; 
+            if (mass < LIQUID_MASS_MIN) continue; 
             
             int edgeAA = 256;
             if (mass < 56) {
@@ -1097,8 +1601,8 @@ void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
             int curR = r, curG = g, curB = b;
             
             if (colorCb) {
-                int sampleX = x_pos - padding + srcX;
-                int sampleY = y_pos - padding + srcY;
+                int sampleX = startX + srcX;
+                int sampleY = startY + srcY;
                 colorCb(sampleX, sampleY, &curR, &curG, &curB, userData);
             }
 
@@ -1153,3 +1657,131 @@ void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
     }
 }
 
+/**
+ * @brief Render Liquid Flow/Caustics Effect
+ * CPU Usage: True Zero (Branchless)
+ * Visuals: High-Bright Mercury
+ */
+void RenderLiquidEffect(DWORD* pixels, int destWidth, int destHeight,
+                       int x_pos, int y_pos,
+                       unsigned char* bitmap, int w, int h,
+                       int r, int g, int b,
+                       GlowColorCallback colorCb, void* userData,
+                       int timeOffset) {
+    
+    if (!g_lutInitialized) InitSpecularLUT();
+    if (!g_slopeLUTInit) InitSlopeLUT();
+
+    /* 1. Dynamic Buffer Allocation (Extreme Memory Optimization) */
+    int padding = LIQUID_PADDING;
+    int gw = w + padding * 2;
+    int gh = h + padding * 2;
+    int neededSize = gw * gh;
+
+    /* Check if resize needed */
+    if (neededSize > g_effectBufferSize || !g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
+        /* Revert to standard 3-buffer allocation to maintain compatibility with other effects */
+        /* Other effects assume if g_effectBufferSize is sufficient, ALL 3 buffers exist */
+        
+        int newSize = neededSize; 
+        
+        /* Free old buffers first, then allocate new ones to avoid realloc complexity */
+        if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
+        if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
+        if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
+        
+        g_effectBuffer1 = (unsigned char*)malloc(newSize);
+        g_effectBuffer2 = (unsigned char*)malloc(newSize);
+        g_effectBuffer3 = (unsigned char*)malloc(newSize);
+        
+        if (!g_effectBuffer1 || !g_effectBuffer2 || !g_effectBuffer3) {
+            /* Allocation failed - cleanup */
+            if (g_effectBuffer1) { free(g_effectBuffer1); g_effectBuffer1 = NULL; }
+            if (g_effectBuffer2) { free(g_effectBuffer2); g_effectBuffer2 = NULL; }
+            if (g_effectBuffer3) { free(g_effectBuffer3); g_effectBuffer3 = NULL; }
+            g_effectBufferSize = 0;
+            return;
+        }
+        
+        g_effectBufferSize = newSize;
+    }
+
+    /* 
+     * 2-Buffer Strategy (still used for processing efficiency)
+     * Buffer1: Stores Bitmap initially, then stores the Final HeightMap
+     * Buffer2: Used as Temp buffer for Gaussian Blur
+     * Buffer3: Per-row mass extents (2 * gh ints; gw > 8 so they fit)
+     */
+    unsigned char* heightMap = g_effectBuffer1; 
+    unsigned char* tempMap = g_effectBuffer2;   
+    
+    /* 2. Prepare Alpha Map (directly into what will be HeightMap) */
+    memset(heightMap, 0, neededSize);
+    for (int j = 0; j < h; j++) {
+        memcpy(heightMap + (j + padding) * gw + padding, bitmap + j * w, w);
+    }
+
+    /* 3. Create Height Map (Thick Volume) */
+    /* In-Place Blur: src(heightMap) -> temp -> dest(heightMap) */
+    /* This works because ApplyGaussianBlur's passes are separated */
+    ApplyGaussianBlur(heightMap, heightMap, tempMap, gw, gh, 4);
+
+    int* massFirst = (int*)g_effectBuffer3;
+    int* massLast = massFirst + gh;
+    for (int j = 0; j < gh; j++) {
+        const unsigned char* row = heightMap + j * gw;
+        int first = 0, last = gw - 1;
+        while (first < gw && row[first] < LIQUID_MASS_MIN) first++;
+        while (last > first && row[last] < LIQUID_MASS_MIN) last--;
+        massFirst[j] = first;
+        massLast[j] = (first < gw) ? last : -1;
+    }
+
+    /* 4. Precompute Flow/Warp LUT (Tri-Planar Waves) */
+    /* 
+     * OPTIMIZATION: Keep 't' as a wrapped integer index [0-2047]
+     * No float math in the frame logic needed if we map time correctly.
+     * 1 cycle = 2048 units.
+     * Speed factor 0.0025 * 2048 ~= 5 units per ms?
+     * Let's stick to float for 't' calculation ONCE per frame, but use INT for everything else.
+     */
+    /* Only compute the base sine wave ONCE ever, or if we want to animate frequency?
+       Actually, the phase changes, not the wave shape. So we compute the wave ONCE.
+    */
+    if (!g_flowLUTInit) {
+        for (int i = 0; i < FLOW_LUT_SIZE; i++) {
+            float angle = (i * 6.28318f) / FLOW_LUT_SIZE;
+            float val = sinf(angle) * 4.0f; /* Amplitude 4.0 */
+            g_flowLUT[i] = (int)(val); 
+        }
+        g_flowLUTInit = TRUE;
+    }
+    
+    /* Calculate Phase Offsets */
+    /* t scales 2*PI to roughly ~125.6 range in previous code.
+       Here we map it to LUT index [0-2047].
+       Previous: t = time * 0.0025. 
+       2PI ~ 6.28.
+       LUT covers 2PI.
+       So LUT_index = (time * 0.0025 / 2PI) * 2048
+                    = time * 0.0025 * 326
+                    = time * 0.815
+    */
+    int t_idx = (int)((double)timeOffset * 0.815) & FLOW_LUT_MASK;
+
+    int startX = x_pos - padding;
+    int startY = y_pos - padding;
+    
+    /* Precalc 60 degree vector constants (sin(60) ~= 0.866 ~= 222/256) */
+    /* t1, t2, t3 offsets */
+    int t1 = t_idx;
+    int t2 = (t_idx + 682) & FLOW_LUT_MASK; /* +1/3 cycle */
+    int t3 = (t_idx + 1365) & FLOW_LUT_MASK; /* +2/3 cycle */
+
+    /* 5. Main Optical Loop (INT OPTIMIZED) */
+    /* Rows are independent; the pool splits them into bands */
+    LiquidJob job = { pixels, destWidth, destHeight, startX, startY, gw, gh,
+                      heightMap, massFirst, massLast, t1, t2, t3, r, g, b, colorCb, userData };
+    WorkerPool_ParallelFor(gh - 4, EffectRowGrain(gw), LiquidRowsBand, &job);
+}
+
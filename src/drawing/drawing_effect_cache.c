@@ -0,0 +1,136 @@
+/**
+ * @file drawing_effect_cache.c
+ * @brief Small LRU of composed effect regions
+ */
+
+#include "drawing/drawing_effect_cache.h"
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* A clock has a handful of runs; more entries only hold stale text */
+#define EFFECT_CACHE_MAX_ENTRIES 8
+
+/* Regions larger than this are cheaper to redraw than to keep around */
+#define EFFECT_CACHE_MAX_REGION_BYTES (4 * 1024 * 1024)
+
+typedef struct {
+    ULONGLONG key;
+    RECT region;
+    DWORD* pixels;
+    size_t capacity;   /* In pixels */
+    DWORD lastUse;
+    BOOL valid;
+} EffectCacheEntry;
+
+static EffectCacheEntry g_entries[EFFECT_CACHE_MAX_ENTRIES];
+static DWORD g_useClock = 0;
+static DWORD g_hits = 0;
+static DWORD g_misses = 0;
+
+static ULONGLONG MixWord(ULONGLONG hash, ULONGLONG word) {
+    hash ^= word;
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 29);
+}
+
+ULONGLONG EffectCache_Hash(const void* data, size_t size, ULONGLONG hash) {
+    const BYTE* p = (const BYTE*)data;
+
+    /* Eight bytes per step; coverage and pixel rows are large */
+    while (size >= 8) {
+        ULONGLONG word;
+        memcpy(&word, p, 8);
+        hash = MixWord(hash, word);
+        p += 8;
+        size -= 8;
+    }
+
+    ULONGLONG tail = 0;
+    memcpy(&tail, p, size);
+    return MixWord(hash, tail ^ ((ULONGLONG)size << 56));
+}
+
+ULONGLONG EffectCache_HashRegion(const DWORD* pixels, int destWidth, const RECT* region,
+                                 ULONGLONG hash) {
+    int w = region->right - region->left;
+    for (int y = region->top; y < region->bottom; y++) {
+        hash = EffectCache_Hash(pixels + (size_t)y * destWidth + region->left,
+                                (size_t)w * sizeof(DWORD), hash);
+    }
+    return hash;
+}
+
+static BOOL SameRegion(const RECT* a, const RECT* b) {
+    return a->left == b->left && a->top == b->top &&
+           a->right == b->right && a->bottom == b->bottom;
+}
+
+BOOL EffectCache_Restore(ULONGLONG key, DWORD* pixels, int destWidth, const RECT* region) {
+    for (int i = 0; i < EFFECT_CACHE_MAX_ENTRIES; i++) {
+        EffectCacheEntry* entry = &g_entries[i];
+        if (!entry->valid || entry->key != key || !SameRegion(&entry->region, region)) continue;
+
+        int w = region->right - region->left;
+        for (int y = region->top; y < region->bottom; y++) {
+            memcpy(pixels + (size_t)y * destWidth + region->left,
+                   entry->pixels + (size_t)(y - region->top) * w, (size_t)w * sizeof(DWORD));
+        }
+        entry->lastUse = ++g_useClock;
+
+        if ((++g_hits % 1000) == 0) {
+            LOG_DEBUG("Effect cache: %lu hits, %lu misses", g_hits, g_misses);
+        }
+        return TRUE;
+    }
+
+    g_misses++;
+    return FALSE;
+}
+
+void EffectCache_Store(ULONGLONG key, const DWORD* pixels, int destWidth, const RECT* region) {
+    int w = region->right - region->left;
+    int h = region->bottom - region->top;
+    if (w <= 0 || h <= 0) return;
+
+    size_t count = (size_t)w * (size_t)h;
+    if (count * sizeof(DWORD) > EFFECT_CACHE_MAX_REGION_BYTES) return;
+
+    EffectCacheEntry* victim = &g_entries[0];
+    for (int i = 0; i < EFFECT_CACHE_MAX_ENTRIES; i++) {
+        EffectCacheEntry* entry = &g_entries[i];
+        if (!entry->valid) {
+            victim = entry;
+            break;
+        }
+        if (entry->lastUse < victim->lastUse) victim = entry;
+    }
+
+    if (count > victim->capacity) {
+        DWORD* grown = (DWORD*)realloc(victim->pixels, count * sizeof(DWORD));
+        if (!grown) {
+            victim->valid = FALSE;
+            return;
+        }
+        victim->pixels = grown;
+        victim->capacity = count;
+    }
+
+    for (int y = 0; y < h; y++) {
+        memcpy(victim->pixels + (size_t)y * w,
+               pixels + (size_t)(region->top + y) * destWidth + region->left,
+               (size_t)w * sizeof(DWORD));
+    }
+    victim->key = key;
+    victim->region = *region;
+    victim->lastUse = ++g_useClock;
+    victim->valid = TRUE;
+}
+
+void EffectCache_Clear(void) {
+    for (int i = 0; i < EFFECT_CACHE_MAX_ENTRIES; i++) {
+        free(g_entries[i].pixels);
+    }
+    memset(g_entries, 0, sizeof(g_entries));
+    g_useClock = 0;
+}
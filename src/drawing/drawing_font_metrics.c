@@ -0,0 +1,137 @@
+/**
+ * @file drawing_font_metrics.c
+ * @brief Per-font codepoint table with a Latin-1 fast path
+ */
+
+#include "drawing/drawing_font_metrics.h"
+#include "drawing/drawing_text_stb.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LATIN1_COUNT 256
+#define HASH_INITIAL_CAPACITY 256
+
+typedef struct {
+    UINT codepoint;
+    BOOL used;
+    CodepointGlyph glyph;
+} HashEntry;
+
+typedef struct {
+    DWORD pair;
+    int kern;
+    BOOL filled;
+} KernEntry;
+
+static CodepointGlyph g_latin1[LATIN1_COUNT];
+static BOOL g_latin1Filled[LATIN1_COUNT];
+
+static HashEntry* g_hash = NULL;
+static int g_hashCapacity = 0;
+static int g_hashCount = 0;
+
+static KernEntry g_kern[FONT_METRICS_KERN_SLOTS];
+
+static UINT HashCodepoint(UINT cp) {
+    cp ^= cp >> 16;
+    cp *= 0x7feb352du;
+    cp ^= cp >> 15;
+    return cp;
+}
+
+/* Same resolution order as before: main face, then fallback (never for space) */
+static void Resolve(wchar_t c, CodepointGlyph* out) {
+    stbtt_fontinfo* mainFace = GetMainFontInfoSTB();
+    int adv, lsb;
+
+    out->index = stbtt_FindGlyphIndex(mainFace, (int)c);
+    out->isFallback = FALSE;
+
+    if (out->index == 0 && IsFallbackFontLoadedSTB() && c != L' ') {
+        stbtt_fontinfo* fallbackFace = GetFallbackFontInfoSTB();
+        int fallbackIndex = stbtt_FindGlyphIndex(fallbackFace, (int)c);
+        if (fallbackIndex != 0) {
+            out->index = fallbackIndex;
+            out->isFallback = TRUE;
+            stbtt_GetGlyphHMetrics(fallbackFace, fallbackIndex, &adv, &lsb);
+            out->advanceUnits = adv;
+            return;
+        }
+    }
+
+    stbtt_GetGlyphHMetrics(mainFace, out->index, &adv, &lsb);
+    out->advanceUnits = adv;
+}
+
+static BOOL GrowHash(void) {
+    int newCapacity = g_hashCapacity ? g_hashCapacity * 2 : HASH_INITIAL_CAPACITY;
+    HashEntry* newTable = (HashEntry*)calloc(newCapacity, sizeof(HashEntry));
+    if (!newTable) return FALSE;
+
+    for (int i = 0; i < g_hashCapacity; i++) {
+        if (!g_hash[i].used) continue;
+        UINT slot = HashCodepoint(g_hash[i].codepoint) & (newCapacity - 1);
+        while (newTable[slot].used) slot = (slot + 1) & (newCapacity - 1);
+        newTable[slot] = g_hash[i];
+    }
+
+    free(g_hash);
+    g_hash = newTable;
+    g_hashCapacity = newCapacity;
+    return TRUE;
+}
+
+const CodepointGlyph* FontMetrics_Lookup(wchar_t c) {
+    if (!IsFontLoadedSTB()) return NULL;
+
+    UINT cp = (UINT)c;
+    if (cp < LATIN1_COUNT) {
+        if (!g_latin1Filled[cp]) {
+            Resolve(c, &g_latin1[cp]);
+            g_latin1Filled[cp] = TRUE;
+        }
+        return &g_latin1[cp];
+    }
+
+    if (g_hashCapacity > 0) {
+        UINT slot = HashCodepoint(cp) & (g_hashCapacity - 1);
+        while (g_hash[slot].used) {
+            if (g_hash[slot].codepoint == cp) return &g_hash[slot].glyph;
+            slot = (slot + 1) & (g_hashCapacity - 1);
+        }
+    }
+
+    /* Keep load factor under 3/4 */
+    if ((g_hashCount + 1) * 4 > g_hashCapacity * 3 && !GrowHash()) {
+        return NULL;
+    }
+
+    UINT slot = HashCodepoint(cp) & (g_hashCapacity - 1);
+    while (g_hash[slot].used) slot = (slot + 1) & (g_hashCapacity - 1);
+
+    g_hash[slot].used = TRUE;
+    g_hash[slot].codepoint = cp;
+    Resolve(c, &g_hash[slot].glyph);
+    g_hashCount++;
+    return &g_hash[slot].glyph;
+}
+
+int FontMetrics_KernUnits(int leftIndex, int rightIndex) {
+    DWORD pair = ((DWORD)(leftIndex & 0xFFFF) << 16) | (DWORD)(rightIndex & 0xFFFF);
+    KernEntry* e = &g_kern[HashCodepoint(pair) & (FONT_METRICS_KERN_SLOTS - 1)];
+    if (e->filled && e->pair == pair) return e->kern;
+
+    e->pair = pair;
+    e->kern = stbtt_GetGlyphKernAdvance(GetMainFontInfoSTB(), leftIndex, rightIndex);
+    e->filled = TRUE;
+    return e->kern;
+}
+
+void FontMetrics_Reset(void) {
+    memset(g_latin1Filled, 0, sizeof(g_latin1Filled));
+    free(g_hash);
+    g_hash = NULL;
+    g_hashCapacity = 0;
+    g_hashCount = 0;
+    memset(g_kern, 0, sizeof(g_kern));
+}
@@ -0,0 +1,256 @@
+/**
+ * @file drawing_frame_governor.c
+ * @brief Moving-average paint cost, budget pacing and effect degradation
+ */
+
+#include "drawing/drawing_frame_governor.h"
+#include "drawing/drawing_effect.h"
+#include "log.h"
+#include <string.h>
+
+/* Moving average weight of the newest frame */
+#define GOVERNOR_EMA_WEIGHT 0.125
+
+/* Usage is judged over windows of at least this length */
+#define GOVERNOR_WINDOW_MS 1000
+
+/* Consecutive over-budget windows before a level is dropped */
+#define GOVERNOR_OVERLOAD_WINDOWS 2
+
+/* Quiet windows before a level is restored; doubles when it does not hold */
+#define GOVERNOR_MIN_HOLD_WINDOWS 10
+#define GOVERNOR_MAX_HOLD_WINDOWS 300
+
+/* A level is restored only while usage stays below this share of the budget */
+#define GOVERNOR_RESTORE_SHARE 0.5
+
+/* Summary log period, in windows */
+#define GOVERNOR_LOG_WINDOWS 60
+
+static const char* const LEVEL_NAMES[] = {
+    "configured quality", "half-resolution effects", "quarter-resolution effects", "effects suspended"
+};
+
+static double g_budgetPercent = 5.0;
+static double g_ticksPerMs = 0.0;
+
+/* Current frame */
+static BOOL g_inFrame = FALSE;
+static LONGLONG g_frameStart = 0;
+static LONGLONG g_lastMark = 0;
+static LONGLONG g_nestedSinceMark = 0;
+static LONGLONG g_stageTicks[FRAME_STAGE_COUNT];
+
+/* Averages */
+static double g_stageEma[FRAME_STAGE_COUNT];
+static double g_frameEma = 0.0;
+static DWORD g_frames = 0;
+
+/* Usage window */
+static LONGLONG g_windowStart = 0;
+static LONGLONG g_windowBusy = 0;
+static double g_cpuPercent = 0.0;
+static DWORD g_windowsSinceLog = 0;
+
+/* Degradation */
+static GovernorLevel g_level = GOVERNOR_LEVEL_CONFIGURED;
+static int g_overWindows = 0;
+static int g_quietWindows = 0;
+static int g_holdWindows = GOVERNOR_MIN_HOLD_WINDOWS;
+static BOOL g_lastChangeWasRestore = FALSE;
+
+static void EnsureFrequency(void) {
+    if (g_ticksPerMs > 0.0) return;
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    g_ticksPerMs = (double)freq.QuadPart / 1000.0;
+}
+
+LONGLONG FrameGovernor_Now(void) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static double TicksToMs(LONGLONG ticks) {
+    EnsureFrequency();
+    return (double)ticks / g_ticksPerMs;
+}
+
+void FrameGovernor_SetBudget(float percentOfCore) {
+    double budget = (percentOfCore > 0.0f) ? (double)percentOfCore : 0.0;
+    if (budget > 100.0) budget = 100.0;
+    if (budget != g_budgetPercent) {
+        LOG_INFO("Render CPU budget: %.1f%% of one core%s", budget, budget > 0.0 ? "" : " (unlimited)");
+    }
+    g_budgetPercent = budget;
+}
+
+void FrameGovernor_BeginFrame(void) {
+    g_frameStart = FrameGovernor_Now();
+    g_lastMark = g_frameStart;
+    g_nestedSinceMark = 0;
+    memset(g_stageTicks, 0, sizeof(g_stageTicks));
+    g_inFrame = TRUE;
+}
+
+void FrameGovernor_EndStage(FrameStage stage) {
+    if (!g_inFrame || stage < 0 || stage >= FRAME_STAGE_COUNT) return;
+    LONGLONG now = FrameGovernor_Now();
+    LONGLONG own = (now - g_lastMark) - g_nestedSinceMark;
+    if (own > 0) g_stageTicks[stage] += own;
+    g_lastMark = now;
+    g_nestedSinceMark = 0;
+}
+
+void FrameGovernor_AddNested(FrameStage stage, LONGLONG startTicks) {
+    if (!g_inFrame || stage < 0 || stage >= FRAME_STAGE_COUNT) return;
+    LONGLONG span = FrameGovernor_Now() - startTicks;
+    if (span <= 0) return;
+    g_stageTicks[stage] += span;
+    g_nestedSinceMark += span;
+}
+
+/* Spacing that keeps one frame of average cost within the budget */
+static double RawSpacingMs(void) {
+    if (g_budgetPercent <= 0.0) return 0.0;
+    return g_frameEma * 100.0 / g_budgetPercent;
+}
+
+static void ApplyLevel(GovernorLevel level, const char* reason) {
+    if (level == g_level) return;
+    GovernorLevel previous = g_level;
+    g_level = level;
+
+    EffectQuality floor = EFFECT_QUALITY_FULL;
+    if (level == GOVERNOR_LEVEL_HALF) floor = EFFECT_QUALITY_HALF;
+    else if (level >= GOVERNOR_LEVEL_QUARTER) floor = EFFECT_QUALITY_QUARTER;
+    SetEffectQualityFloor(floor);
+
+    LOG_INFO("Frame governor: %s -> %s (%s; frame %.2f ms, CPU %.1f%% of %.1f%% budget)",
+             LEVEL_NAMES[previous], LEVEL_NAMES[level], reason,
+             g_frameEma, g_cpuPercent, g_budgetPercent);
+}
+
+static void LogSummary(void) {
+    LOG_DEBUG("Frame governor: %lu frames, frame %.2f ms (parse %.2f, layout %.2f, raster %.2f, "
+              "effect %.2f, present %.2f), CPU %.1f%%, interval %u ms, %s",
+              g_frames, g_frameEma,
+              g_stageEma[FRAME_STAGE_PARSE], g_stageEma[FRAME_STAGE_LAYOUT],
+              g_stageEma[FRAME_STAGE_RASTER], g_stageEma[FRAME_STAGE_EFFECT],
+              g_stageEma[FRAME_STAGE_PRESENT], g_cpuPercent,
+              FrameGovernor_AnimationInterval(), LEVEL_NAMES[g_level]);
+}
+
+static void EvaluateWindow(BOOL effectsInUse) {
+    if (g_budgetPercent <= 0.0 || !effectsInUse) {
+        g_overWindows = 0;
+        g_quietWindows = 0;
+        ApplyLevel(GOVERNOR_LEVEL_CONFIGURED, g_budgetPercent <= 0.0 ? "no budget" : "no effect");
+        return;
+    }
+
+    /* Pacing absorbs overload first; levels drop only once it is exhausted */
+    BOOL over = g_cpuPercent > g_budgetPercent && RawSpacingMs() >= GOVERNOR_MAX_INTERVAL;
+    if (over) {
+        g_quietWindows = 0;
+        if (++g_overWindows >= GOVERNOR_OVERLOAD_WINDOWS && g_level < GOVERNOR_LEVEL_NO_EFFECTS) {
+            if (g_lastChangeWasRestore) {
+                g_holdWindows *= 2;
+                if (g_holdWindows > GOVERNOR_MAX_HOLD_WINDOWS) g_holdWindows = GOVERNOR_MAX_HOLD_WINDOWS;
+            }
+            g_lastChangeWasRestore = FALSE;
+            g_overWindows = 0;
+            ApplyLevel((GovernorLevel)(g_level + 1), "over budget");
+        }
+        return;
+    }
+
+    g_overWindows = 0;
+    if (g_level == GOVERNOR_LEVEL_CONFIGURED) return;
+
+    if (g_cpuPercent < g_budgetPercent * GOVERNOR_RESTORE_SHARE) {
+        if (++g_quietWindows >= g_holdWindows) {
+            g_quietWindows = 0;
+            g_lastChangeWasRestore = TRUE;
+            ApplyLevel((GovernorLevel)(g_level - 1), "headroom");
+        }
+    } else {
+        g_quietWindows = 0;
+    }
+}
+
+void FrameGovernor_EndFrame(BOOL effectsInUse) {
+    if (!g_inFrame) return;
+    g_inFrame = FALSE;
+
+    LONGLONG now = FrameGovernor_Now();
+    LONGLONG frameTicks = now - g_frameStart;
+    double frameMs = TicksToMs(frameTicks);
+
+    if (g_frames == 0) {
+        g_frameEma = frameMs;
+        for (int i = 0; i < FRAME_STAGE_COUNT; i++) g_stageEma[i] = TicksToMs(g_stageTicks[i]);
+        g_windowStart = g_frameStart;
+    } else {
+        g_frameEma += (frameMs - g_frameEma) * GOVERNOR_EMA_WEIGHT;
+        for (int i = 0; i < FRAME_STAGE_COUNT; i++) {
+            g_stageEma[i] += (TicksToMs(g_stageTicks[i]) - g_stageEma[i]) * GOVERNOR_EMA_WEIGHT;
+        }
+    }
+    g_frames++;
+    g_windowBusy += frameTicks;
+
+    double windowMs = TicksToMs(now - g_windowStart);
+    if (windowMs < GOVERNOR_WINDOW_MS) return;
+
+    g_cpuPercent = TicksToMs(g_windowBusy) * 100.0 / windowMs;
+    g_windowStart = now;
+    g_windowBusy = 0;
+
+    EvaluateWindow(effectsInUse);
+
+    if (++g_windowsSinceLog >= GOVERNOR_LOG_WINDOWS) {
+        g_windowsSinceLog = 0;
+        LogSummary();
+    }
+}
+
+void FrameGovernor_CancelFrame(void) {
+    if (!g_inFrame) return;
+    g_inFrame = FALSE;
+
+    /* Nothing was composed, so the averages keep describing real frames;
+     * the time still counts toward CPU usage once a window is open */
+    if (g_frames > 0) g_windowBusy += FrameGovernor_Now() - g_frameStart;
+}
+
+UINT FrameGovernor_AnimationInterval(void) {
+    double spacing = RawSpacingMs();
+    if (spacing <= GOVERNOR_MIN_INTERVAL) return GOVERNOR_MIN_INTERVAL;
+    if (spacing >= GOVERNOR_MAX_INTERVAL) return GOVERNOR_MAX_INTERVAL;
+    /* 10 ms steps so small average drifts do not re-arm the timer */
+    return ((UINT)spacing + 9) / 10 * 10;
+}
+
+DWORD FrameGovernor_FrameSpacing(void) {
+    double spacing = RawSpacingMs();
+    if (spacing >= GOVERNOR_MAX_INTERVAL) return GOVERNOR_MAX_INTERVAL;
+    return (DWORD)spacing;
+}
+
+BOOL FrameGovernor_EffectsSuspended(void) {
+    return g_level == GOVERNOR_LEVEL_NO_EFFECTS;
+}
+
+void FrameGovernor_GetStats(FrameGovernorStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    memcpy(stats->stageMs, g_stageEma, sizeof(stats->stageMs));
+    stats->frameMs = g_frameEma;
+    stats->cpuPercent = g_cpuPercent;
+    stats->budgetPercent = g_budgetPercent;
+    stats->animationInterval = FrameGovernor_AnimationInterval();
+    stats->level = g_level;
+    stats->frames = g_frames;
+}
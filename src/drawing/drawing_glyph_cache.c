@@ -0,0 +1,161 @@
+/**
+ * @file drawing_glyph_cache.c
+ * @brief LRU glyph coverage cache with a fixed memory budget
+ */
+
+#include "drawing/drawing_glyph_cache.h"
+#include "drawing/drawing_sdf_atlas.h"
+#include "drawing/drawing_outline_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct GlyphCacheEntry {
+    const stbtt_fontinfo* face;
+    DWORD scaleBits;
+    int glyphIndex;
+    BOOL isFallback;
+    CachedGlyph glyph;
+    SIZE_T bytes;
+    struct GlyphCacheEntry* hashNext;
+    struct GlyphCacheEntry* lruPrev;
+    struct GlyphCacheEntry* lruNext;
+} GlyphCacheEntry;
+
+static GlyphCacheEntry* g_buckets[GLYPH_CACHE_BUCKETS] = {0};
+static GlyphCacheEntry* g_lruHead = NULL;  /* Most recently used */
+static GlyphCacheEntry* g_lruTail = NULL;  /* Eviction candidate */
+static SIZE_T g_cacheBytes = 0;
+static DWORD g_hits = 0;
+static DWORD g_misses = 0;
+static BOOL g_distanceField = FALSE;
+
+/* Float bits as key so scales compare exactly */
+static DWORD ScaleToBits(float scale) {
+    DWORD bits;
+    memcpy(&bits, &scale, sizeof(bits));
+    return bits;
+}
+
+static UINT HashKey(const stbtt_fontinfo* face, DWORD scaleBits, int glyphIndex, BOOL isFallback) {
+    UINT h = (UINT)((uintptr_t)face >> 4);
+    h = h * 31u + scaleBits;
+    h = h * 31u + (UINT)glyphIndex;
+    h = h * 31u + (isFallback ? 1u : 0u);
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h & (GLYPH_CACHE_BUCKETS - 1);
+}
+
+static void LruUnlink(GlyphCacheEntry* e) {
+    if (e->lruPrev) e->lruPrev->lruNext = e->lruNext; else g_lruHead = e->lruNext;
+    if (e->lruNext) e->lruNext->lruPrev = e->lruPrev; else g_lruTail = e->lruPrev;
+    e->lruPrev = e->lruNext = NULL;
+}
+
+static void LruPushFront(GlyphCacheEntry* e) {
+    e->lruPrev = NULL;
+    e->lruNext = g_lruHead;
+    if (g_lruHead) g_lruHead->lruPrev = e;
+    g_lruHead = e;
+    if (!g_lruTail) g_lruTail = e;
+}
+
+static void RemoveEntry(GlyphCacheEntry* e) {
+    UINT bucket = HashKey(e->face, e->scaleBits, e->glyphIndex, e->isFallback);
+    GlyphCacheEntry** link = &g_buckets[bucket];
+    while (*link && *link != e) link = &(*link)->hashNext;
+    if (*link) *link = e->hashNext;
+
+    LruUnlink(e);
+    g_cacheBytes -= e->bytes;
+    if (e->glyph.bitmap) stbtt_FreeBitmap(e->glyph.bitmap, NULL);
+    free(e);
+}
+
+static void EvictToFit(SIZE_T incoming) {
+    while (g_lruTail && g_cacheBytes + incoming > GLYPH_CACHE_MAX_BYTES) {
+        RemoveEntry(g_lruTail);
+    }
+}
+
+const CachedGlyph* GlyphCache_Get(const stbtt_fontinfo* face, float scale,
+                                  int glyphIndex, BOOL isFallback) {
+    if (!face) return NULL;
+    if (g_distanceField) return SdfAtlas_Get(face, scale, glyphIndex);
+
+    DWORD scaleBits = ScaleToBits(scale);
+    UINT bucket = HashKey(face, scaleBits, glyphIndex, isFallback);
+
+    for (GlyphCacheEntry* e = g_buckets[bucket]; e; e = e->hashNext) {
+        if (e->face == face && e->scaleBits == scaleBits &&
+            e->glyphIndex == glyphIndex && e->isFallback == isFallback) {
+            if (e != g_lruHead) {
+                LruUnlink(e);
+                LruPushFront(e);
+            }
+            g_hits++;
+            return &e->glyph;
+        }
+    }
+
+    g_misses++;
+
+    GlyphCacheEntry* e = (GlyphCacheEntry*)calloc(1, sizeof(GlyphCacheEntry));
+    if (!e) return NULL;
+
+    e->face = face;
+    e->scaleBits = scaleBits;
+    e->glyphIndex = glyphIndex;
+    e->isFallback = isFallback;
+    e->glyph.bitmap = OutlineCache_Rasterize(face, scale, glyphIndex,
+                                             &e->glyph.w, &e->glyph.h,
+                                             &e->glyph.xoff, &e->glyph.yoff);
+    e->bytes = sizeof(GlyphCacheEntry) +
+               (e->glyph.bitmap ? (SIZE_T)e->glyph.w * (SIZE_T)e->glyph.h : 0);
+
+    /* Oversized glyphs still render; they just displace everything else */
+    EvictToFit(e->bytes);
+
+    e->hashNext = g_buckets[bucket];
+    g_buckets[bucket] = e;
+    LruPushFront(e);
+    g_cacheBytes += e->bytes;
+
+    return &e->glyph;
+}
+
+void GlyphCache_InvalidateFace(const stbtt_fontinfo* face) {
+    GlyphCacheEntry* e = g_lruHead;
+    while (e) {
+        GlyphCacheEntry* next = e->lruNext;
+        if (e->face == face) RemoveEntry(e);
+        e = next;
+    }
+    OutlineCache_InvalidateFace(face);
+    SdfAtlas_InvalidateFace(face);
+}
+
+void GlyphCache_Clear(void) {
+    while (g_lruHead) {
+        RemoveEntry(g_lruHead);
+    }
+    memset(g_buckets, 0, sizeof(g_buckets));
+    g_cacheBytes = 0;
+    OutlineCache_Clear();
+    SdfAtlas_Clear();
+}
+
+void GlyphCache_SetDistanceField(BOOL enabled) {
+    g_distanceField = enabled;
+}
+
+BOOL GlyphCache_IsDistanceField(void) {
+    return g_distanceField;
+}
+
+void GlyphCache_GetStats(DWORD* hits, DWORD* misses, SIZE_T* bytes) {
+    if (hits) *hits = g_hits;
+    if (misses) *misses = g_misses;
+    if (bytes) *bytes = g_cacheBytes;
+}
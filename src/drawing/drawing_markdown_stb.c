@@ -5,32 +5,64 @@
 
 #include "drawing/drawing_markdown_stb.h"
 #include "drawing/drawing_text_stb.h"
+#include "drawing/drawing_glyph_cache.h"
+#include "drawing/drawing_blend_simd.h"
+#include "drawing/drawing_text_layout.h"
+#include "drawing/drawing_render_core.h"
 #include "menu_preview.h"
 #include "markdown/markdown_parser.h"
 #include "markdown/markdown_interactive.h"
 #include "color/gradient.h"
 #include "log.h"
 #include <math.h>
+#include <limits.h>
 
 /* Helper Functions */
 
-static float GetScaleForHeading(int level, float baseScale) {
-    switch (level) {
-        case 1: return baseScale * 1.5f;
-        case 2: return baseScale * 1.35f;
-        case 3: return baseScale * 1.2f;
-        case 4: return baseScale * 1.1f;
-        case 5: return baseScale * 1.0f;
-        case 6: return baseScale * 0.9f;
-        default: return baseScale;
-    }
+/* Column color callback for the sheared column blender */
+typedef DWORD (*ColumnColorFn)(int screenX, const void* userData);
+
+/* Visible glyph columns [*start, *end) of a row drawn at screen x = x_pos + shear */
+static BOOL ClipRowSpan(int x_pos, int shear, int w, int destWidth, int* start, int* end) {
+    int rowX = x_pos + shear;
+    *start = (rowX < 0) ? -rowX : 0;
+    *end = (rowX + w > destWidth) ? destWidth - rowX : w;
+    return *start < *end;
 }
 
-static int GetLineHeight(float scale) {
-    int ascent, descent, lineGap;
-    if (!IsFontLoadedSTB()) return 0;
-    stbtt_GetFontVMetrics(GetMainFontInfoSTB(), &ascent, &descent, &lineGap);
-    return (int)((ascent - descent + lineGap) * scale);
+/**
+ * @brief Overwrite-blend a glyph whose color depends only on screen x
+ * @details Colors are resolved once per visible column across all sheared
+ *          rows, then each row is handed to the SIMD kernel.
+ */
+static void BlendColumnsSheared(DWORD* pixels, int destWidth, int destHeight,
+                                int x_pos, int y_pos,
+                                const unsigned char* bitmap, int w, int h, float slant,
+                                ColumnColorFn colorAt, const void* userData) {
+    int maxShear = (int)(h * slant);
+    int minX = (x_pos < 0) ? 0 : x_pos;
+    int maxX = x_pos + w + maxShear;
+    if (maxX > destWidth) maxX = destWidth;
+    if (minX >= maxX) return;
+
+    DWORD* columnColors = BlendKernels_ColumnScratch(maxX - minX);
+    if (!columnColors) return;
+    for (int x = minX; x < maxX; x++) {
+        columnColors[x - minX] = colorAt(x, userData);
+    }
+
+    const BlendKernels* kernels = BlendKernels_Get();
+    for (int j = 0; j < h; ++j) {
+        int screen_y = y_pos + j;
+        if (screen_y < 0 || screen_y >= destHeight) continue;
+        int shear = (int)((h - j) * slant);
+        int start, end;
+        if (!ClipRowSpan(x_pos, shear, w, destWidth, &start, &end)) continue;
+        int rowX = x_pos + shear + start;
+        kernels->overwriteColumns(pixels + screen_y * destWidth + rowX,
+                                  bitmap + j * w + start,
+                                  columnColors + (rowX - minX), end - start);
+    }
 }
 
 /* Italic blend with per-row shear */
@@ -39,81 +71,106 @@ static void BlendCharBitmapItalicSTB(void* destBits, int destWidth, int destHeig
                                       unsigned char* bitmap, int w, int h,
                                       int r, int g, int b, float slant) {
     DWORD* pixels = (DWORD*)destBits;
+    const BlendKernels* kernels = BlendKernels_Get();
+    DWORD color = ((DWORD)r << 16) | ((DWORD)g << 8) | (DWORD)b;
     for (int j = 0; j < h; ++j) {
+        int screen_y = y_pos + j;
+        if (screen_y < 0 || screen_y >= destHeight) continue;
         int shear = (int)((h - j) * slant);  // Top rows shift right more
-        for (int i = 0; i < w; ++i) {
-            int screen_x = x_pos + i + shear;
-            int screen_y = y_pos + j;
-            if (screen_x < 0 || screen_x >= destWidth || screen_y < 0 || screen_y >= destHeight) continue;
-            unsigned char alpha = bitmap[j * w + i];
-            if (alpha == 0) continue;
-            DWORD* dest = &pixels[screen_y * destWidth + screen_x];
-            DWORD existing = *dest;
-            int er = (existing >> 16) & 0xFF;
-            int eg = (existing >> 8) & 0xFF;
-            int eb = existing & 0xFF;
-            int ea = (existing >> 24) & 0xFF;
-            int nr = er + ((r - er) * alpha) / 255;
-            int ng = eg + ((g - eg) * alpha) / 255;
-            int nb = eb + ((b - eb) * alpha) / 255;
-            int na = ea + ((255 - ea) * alpha) / 255;
-            *dest = (na << 24) | (nr << 16) | (ng << 8) | nb;
-        }
+        int start, end;
+        if (!ClipRowSpan(x_pos, shear, w, destWidth, &start, &end)) continue;
+        kernels->lerpSolid(pixels + screen_y * destWidth + x_pos + shear + start,
+                           bitmap + j * w + start, end - start, color);
     }
 }
 
+typedef struct {
+    const GradientInfo* info;
+    int timeOffset;
+    int totalWidth;
+} GradientColumnContext;
+
+static DWORD GradientColumnColor(int screen_x, const void* userData) {
+    const GradientColumnContext* ctx = (const GradientColumnContext*)userData;
+    const GradientInfo* info = ctx->info;
+
+    // Calculate gradient color
+    float t = (ctx->totalWidth > 0) ? (float)screen_x / (float)ctx->totalWidth : 0.0f;
+    if (info->isAnimated) {
+        float animOffset = (float)ctx->timeOffset / (float)(GRADIENT_LUT_SIZE * 2);
+        t = t - animOffset;
+        while (t < 0) t += 1.0f;
+        while (t >= 1.0f) t -= 1.0f;
+    }
+    
+    int r, g, b;
+    if (info->palette && info->paletteCount > 2) {
+        float scaledT = t * (info->paletteCount - 1);
+        int idx1 = (int)scaledT;
+        int idx2 = idx1 + 1;
+        if (idx2 >= info->paletteCount) idx2 = 0;
+        float localT = scaledT - idx1;
+        COLORREF c1 = info->palette[idx1];
+        COLORREF c2 = info->palette[idx2];
+        r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
+        g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
+        b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
+    } else {
+        r = (int)(GetRValue(info->startColor) + (GetRValue(info->endColor) - GetRValue(info->startColor)) * t);
+        g = (int)(GetGValue(info->startColor) + (GetGValue(info->endColor) - GetGValue(info->startColor)) * t);
+        b = (int)(GetBValue(info->startColor) + (GetBValue(info->endColor) - GetBValue(info->startColor)) * t);
+    }
+    return ((DWORD)r << 16) | ((DWORD)g << 8) | (DWORD)b;
+}
+
 /* Italic blend with gradient and per-row shear */
 static void BlendCharBitmapItalicGradientSTB(void* destBits, int destWidth, int destHeight,
                                               int x_pos, int y_pos,
                                               unsigned char* bitmap, int w, int h,
                                               float slant, int gradientMode, int timeOffset, int totalWidth) {
-    DWORD* pixels = (DWORD*)destBits;
     const GradientInfo* info = GetGradientInfo((GradientType)gradientMode);
     if (!info) return;
     
-    for (int j = 0; j < h; ++j) {
-        int shear = (int)((h - j) * slant);
-        for (int i = 0; i < w; ++i) {
-            int screen_x = x_pos + i + shear;
-            int screen_y = y_pos + j;
-            if (screen_x < 0 || screen_x >= destWidth || screen_y < 0 || screen_y >= destHeight) continue;
-            unsigned char alpha = bitmap[j * w + i];
-            if (alpha == 0) continue;
-            
-            // Calculate gradient color
-            float t = (totalWidth > 0) ? (float)screen_x / (float)totalWidth : 0.0f;
-            if (info->isAnimated) {
-                float animOffset = (float)timeOffset / (float)(GRADIENT_LUT_SIZE * 2);
-                t = t - animOffset;
-                while (t < 0) t += 1.0f;
-                while (t >= 1.0f) t -= 1.0f;
-            }
-            
-            int r, g, b;
-            if (info->palette && info->paletteCount > 2) {
-                float scaledT = t * (info->paletteCount - 1);
-                int idx1 = (int)scaledT;
-                int idx2 = idx1 + 1;
-                if (idx2 >= info->paletteCount) idx2 = 0;
-                float localT = scaledT - idx1;
-                COLORREF c1 = info->palette[idx1];
-                COLORREF c2 = info->palette[idx2];
-                r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
-                g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
-                b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
-            } else {
-                r = (int)(GetRValue(info->startColor) + (GetRValue(info->endColor) - GetRValue(info->startColor)) * t);
-                g = (int)(GetGValue(info->startColor) + (GetGValue(info->endColor) - GetGValue(info->startColor)) * t);
-                b = (int)(GetBValue(info->startColor) + (GetBValue(info->endColor) - GetBValue(info->startColor)) * t);
-            }
-            
-            DWORD* dest = &pixels[screen_y * destWidth + screen_x];
-            DWORD finalR = (r * alpha) / 255;
-            DWORD finalG = (g * alpha) / 255;
-            DWORD finalB = (b * alpha) / 255;
-            *dest = (alpha << 24) | (finalR << 16) | (finalG << 8) | finalB;
-        }
+    GradientColumnContext ctx = { info, timeOffset, totalWidth };
+    BlendColumnsSheared((DWORD*)destBits, destWidth, destHeight, x_pos, y_pos,
+                        bitmap, w, h, slant, GradientColumnColor, &ctx);
+}
+
+typedef struct {
+    const MarkdownColorTag* colorTag;
+    int timeOffset;
+    int totalWidth;
+} ColorTagColumnContext;
+
+static DWORD ColorTagColumnColor(int screen_x, const void* userData) {
+    const ColorTagColumnContext* ctx = (const ColorTagColumnContext*)userData;
+    int colorCount = ctx->colorTag->colorCount;
+
+    /* Calculate animated gradient position */
+    float t = (ctx->totalWidth > 0) ? (float)screen_x / (float)ctx->totalWidth : 0.0f;
+    
+    /* Apply animation offset (2 second cycle) */
+    float animOffset = (float)(ctx->timeOffset % 2000) / 2000.0f;
+    t = t - animOffset;
+    while (t < 0.0f) t += 1.0f;
+    while (t >= 1.0f) t -= 1.0f;
+    
+    /* Interpolate between colors */
+    float scaledT = t * (colorCount - 1);
+    int idx1 = (int)scaledT;
+    int idx2 = idx1 + 1;
+    if (idx1 >= colorCount - 1) {
+        idx1 = colorCount - 2;
+        idx2 = colorCount - 1;
     }
+    float localT = scaledT - idx1;
+    
+    COLORREF c1 = ctx->colorTag->colors[idx1];
+    COLORREF c2 = ctx->colorTag->colors[idx2];
+    int r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
+    int g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
+    int b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
+    return ((DWORD)r << 16) | ((DWORD)g << 8) | (DWORD)b;
 }
 
 /**
@@ -131,7 +188,7 @@ static void BlendCharBitmapItalicGradientSTB(void* destBits, int destWidth, int
  * @param w Glyph width
  * @param h Glyph height
  * @param colorTag Color tag with gradient colors
- * @param timeOffset Time offset for animation (from GetTickCount)
+ * @param timeOffset Time offset for animation (from RenderCore_GetTime)
  * @param totalWidth Total width for gradient calculation
  */
 static void BlendCharBitmapColorTagGradientSTB(void* destBits, int destWidth, int destHeight,
@@ -140,49 +197,9 @@ static void BlendCharBitmapColorTagGradientSTB(void* destBits, int destWidth, in
                                                 const MarkdownColorTag* colorTag, int timeOffset, int totalWidth) {
     if (!colorTag || colorTag->colorCount < 2) return;
     
-    DWORD* pixels = (DWORD*)destBits;
-    int colorCount = colorTag->colorCount;
-    
-    for (int j = 0; j < h; ++j) {
-        for (int i = 0; i < w; ++i) {
-            int screen_x = x_pos + i;
-            int screen_y = y_pos + j;
-            if (screen_x < 0 || screen_x >= destWidth || screen_y < 0 || screen_y >= destHeight) continue;
-            unsigned char alpha = bitmap[j * w + i];
-            if (alpha == 0) continue;
-            
-            /* Calculate animated gradient position */
-            float t = (totalWidth > 0) ? (float)screen_x / (float)totalWidth : 0.0f;
-            
-            /* Apply animation offset (2 second cycle) */
-            float animOffset = (float)(timeOffset % 2000) / 2000.0f;
-            t = t - animOffset;
-            while (t < 0.0f) t += 1.0f;
-            while (t >= 1.0f) t -= 1.0f;
-            
-            /* Interpolate between colors */
-            float scaledT = t * (colorCount - 1);
-            int idx1 = (int)scaledT;
-            int idx2 = idx1 + 1;
-            if (idx1 >= colorCount - 1) {
-                idx1 = colorCount - 2;
-                idx2 = colorCount - 1;
-            }
-            float localT = scaledT - idx1;
-            
-            COLORREF c1 = colorTag->colors[idx1];
-            COLORREF c2 = colorTag->colors[idx2];
-            int r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
-            int g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
-            int b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
-            
-            DWORD* dest = &pixels[screen_y * destWidth + screen_x];
-            DWORD finalR = (r * alpha) / 255;
-            DWORD finalG = (g * alpha) / 255;
-            DWORD finalB = (b * alpha) / 255;
-            *dest = (alpha << 24) | (finalR << 16) | (finalG << 8) | finalB;
-        }
-    }
+    ColorTagColumnContext ctx = { colorTag, timeOffset, totalWidth };
+    BlendColumnsSheared((DWORD*)destBits, destWidth, destHeight, x_pos, y_pos,
+                        bitmap, w, h, 0.0f, ColorTagColumnColor, &ctx);
 }
 
 /**
@@ -195,50 +212,9 @@ static void BlendCharBitmapColorTagGradientItalicSTB(void* destBits, int destWid
                                                       float slant) {
     if (!colorTag || colorTag->colorCount < 2) return;
     
-    DWORD* pixels = (DWORD*)destBits;
-    int colorCount = colorTag->colorCount;
-    
-    for (int j = 0; j < h; ++j) {
-        int shear = (int)((h - j) * slant);
-        for (int i = 0; i < w; ++i) {
-            int screen_x = x_pos + i + shear;
-            int screen_y = y_pos + j;
-            if (screen_x < 0 || screen_x >= destWidth || screen_y < 0 || screen_y >= destHeight) continue;
-            unsigned char alpha = bitmap[j * w + i];
-            if (alpha == 0) continue;
-            
-            /* Calculate animated gradient position */
-            float t = (totalWidth > 0) ? (float)screen_x / (float)totalWidth : 0.0f;
-            
-            /* Apply animation offset (2 second cycle) */
-            float animOffset = (float)(timeOffset % 2000) / 2000.0f;
-            t = t - animOffset;
-            while (t < 0.0f) t += 1.0f;
-            while (t >= 1.0f) t -= 1.0f;
-            
-            /* Interpolate between colors */
-            float scaledT = t * (colorCount - 1);
-            int idx1 = (int)scaledT;
-            int idx2 = idx1 + 1;
-            if (idx1 >= colorCount - 1) {
-                idx1 = colorCount - 2;
-                idx2 = colorCount - 1;
-            }
-            float localT = scaledT - idx1;
-            
-            COLORREF c1 = colorTag->colors[idx1];
-            COLORREF c2 = colorTag->colors[idx2];
-            int r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
-            int g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
-            int b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
-            
-            DWORD* dest = &pixels[screen_y * destWidth + screen_x];
-            DWORD finalR = (r * alpha) / 255;
-            DWORD finalG = (g * alpha) / 255;
-            DWORD finalB = (b * alpha) / 255;
-            *dest = (alpha << 24) | (finalR << 16) | (finalG << 8) | finalB;
-        }
-    }
+    ColorTagColumnContext ctx = { colorTag, timeOffset, totalWidth };
+    BlendColumnsSheared((DWORD*)destBits, destWidth, destHeight, x_pos, y_pos,
+                        bitmap, w, h, slant, ColorTagColumnColor, &ctx);
 }
 
 /* Public API */
@@ -246,68 +222,24 @@ static void BlendCharBitmapColorTagGradientItalicSTB(void* destBits, int destWid
 BOOL MeasureMarkdownSTB(const wchar_t* text,
                         MarkdownHeading* headings, int headingCount,
                         int fontSize, int* width, int* height) {
-    if (!IsFontLoadedSTB() || !text) return FALSE;
-
-    stbtt_fontinfo* fontInfo = GetMainFontInfoSTB();
-    stbtt_fontinfo* fallbackFontInfo = GetFallbackFontInfoSTB();
-    BOOL fallbackLoaded = IsFallbackFontLoadedSTB();
-
-    float baseScale = stbtt_ScaleForPixelHeight(fontInfo, (float)fontSize);
-    float fallbackBaseScale = fallbackLoaded ? stbtt_ScaleForPixelHeight(fallbackFontInfo, (float)fontSize) : 0;
+    const TextLayout* layout = TextLayout_GetLines(text, headings, headingCount, fontSize, 0, 0);
+    if (!layout) return FALSE;
 
-    int maxWidth = 0;
-    int curLineWidth = 0;
-    int totalHeight = 0;
-    int curLineMaxHeight = GetLineHeight(baseScale); // Default to base height
-
-    size_t len = wcslen(text);
+    if (width) *width = layout->width;
+    if (height) *height = layout->height;
     
-    // Optimization: Track current heading index
-    int curHeadingIdx = 0;
-
-    for (size_t i = 0; i < len; i++) {
-        if (text[i] == L'\n') {
-            if (curLineWidth > maxWidth) maxWidth = curLineWidth;
-            curLineWidth = 0;
-            totalHeight += curLineMaxHeight;
-            curLineMaxHeight = GetLineHeight(baseScale); // Reset to base
-            continue;
-        }
-        if (text[i] == L'\r') continue;
-        
-        // Skip horizontal rule markers (they span full width, don't affect max width)
-        if (text[i] == L'\x2500') continue;
-
-        // Determine style
-        float scale = baseScale;
-        float fallbackScale = fallbackBaseScale;
-        
-        // Check heading
-        while (curHeadingIdx < headingCount && i >= headings[curHeadingIdx].endPos) {
-            curHeadingIdx++;
-        }
-        if (curHeadingIdx < headingCount && i >= headings[curHeadingIdx].startPos) {
-            scale = GetScaleForHeading(headings[curHeadingIdx].level, baseScale);
-            if (fallbackLoaded) {
-                fallbackScale = GetScaleForHeading(headings[curHeadingIdx].level, fallbackBaseScale);
-            }
-        }
-
-        // Update line height if this char is taller
-        int h = GetLineHeight(scale);
-        if (h > curLineMaxHeight) curLineMaxHeight = h;
+    return TRUE;
+}
 
-        GlyphMetrics gm;
-        GetCharMetricsSTB(text[i], (i < len - 1) ? text[i+1] : 0, scale, fallbackScale, &gm);
-        curLineWidth += gm.advance + gm.kern;
+/** @brief First blockquote that does not end at or before pos */
+static int LowerBoundByEnd(const MarkdownBlockquote* blockquotes, int count, int pos) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (blockquotes[mid].endPos <= pos) lo = mid + 1;
+        else hi = mid;
     }
-    if (curLineWidth > maxWidth) maxWidth = curLineWidth;
-    totalHeight += curLineMaxHeight;
-
-    if (width) *width = maxWidth;
-    if (height) *height = totalHeight;
-    
-    return TRUE;
+    return lo;
 }
 
 /* Alert type colors (GitHub style) */
@@ -333,11 +265,10 @@ static COLORREF GetAlertColor(BlockquoteAlertType type) {
 void RenderMarkdownSTB(void* bits, int width, int height, const wchar_t* text,
                        MarkdownLink* links, int linkCount,
                        MarkdownHeading* headings, int headingCount,
-                       MarkdownStyle* styles, int styleCount,
+                       const StyleRunTable* runs,
                        MarkdownBlockquote* blockquotes, int blockquoteCount,
-                       MarkdownColorTag* colorTags, int colorTagCount,
-                       MarkdownFontTag* fontTags, int fontTagCount,
-                       COLORREF color, int fontSize, float fontScale, int gradientMode) {
+                       COLORREF color, int fontSize, float fontScale, int gradientMode,
+                       const MarkdownViewport* viewport) {
     if (!IsFontLoadedSTB() || !text || !bits) return;
 
     /* Clear previous clickable regions before rendering */
@@ -345,35 +276,60 @@ void RenderMarkdownSTB(void* bits, int width, int height, const wchar_t* text,
 
     stbtt_fontinfo* fontInfo = GetMainFontInfoSTB();
     stbtt_fontinfo* fallbackFontInfo = GetFallbackFontInfoSTB();
-    BOOL fallbackLoaded = IsFallbackFontLoadedSTB();
 
-    float baseScale = stbtt_ScaleForPixelHeight(fontInfo, (float)(fontSize * fontScale));
-    float fallbackBaseScale = fallbackLoaded ? stbtt_ScaleForPixelHeight(fallbackFontInfo, (float)(fontSize * fontScale)) : 0;
-    
-    int baseAscent, baseDescent, baseLineGap;
-    stbtt_GetFontVMetrics(fontInfo, &baseAscent, &baseDescent, &baseLineGap);
+    /* Glyph indices, advances, scales and line boxes come from one cached layout */
+    const TextLayout* layout;
+    int blockTopY;
+    if (viewport) {
+        /* Only the lines on screen get glyphs */
+        layout = TextLayout_GetLines(text, headings, headingCount, (int)(fontSize * fontScale),
+                                     viewport->scrollY, viewport->scrollY + height);
+        blockTopY = -viewport->scrollY;
+    } else {
+        layout = TextLayout_Get(text, headings, headingCount, (int)(fontSize * fontScale));
+        blockTopY = layout ? (height - layout->height) / 2 : 0;
+    }
+    if (!layout) return;
+
+    int firstLine = layout->glyphLineStart;
+    int endLine = layout->glyphLineEnd;
+    if (viewport && firstLine < endLine) {
+        /* The glyph window may reach past the screen on either side */
+        int visibleStart = TextLayout_LineAt(layout, viewport->scrollY);
+        int visibleEnd = TextLayout_LineAt(layout, viewport->scrollY + height - 1) + 1;
+        if (visibleStart > firstLine) firstLine = visibleStart;
+        if (visibleEnd < endLine) endLine = visibleEnd;
+    }
+    int firstChar = (firstLine < layout->lineCount) ? layout->lines[firstLine].start : layout->length;
 
-    /* Checkbox tracking */
-    int checkboxIndex = 0;
+    /* Checkbox tracking (indices count from the top of the text) */
+    int checkboxIndex = (firstLine < layout->lineCount) ? layout->lines[firstLine].checkboxesBefore : 0;
 
-    // Calculate total layout to center vertically
-    int totalTextHeight = 0;
-    int maxLineWidth = 0;
-    MeasureMarkdownSTB(text, headings, headingCount, (int)(fontSize * fontScale), &maxLineWidth, &totalTextHeight);
-    
-    int currentY = (height - totalTextHeight) / 2;
+    int maxLineWidth = layout->width;
     int blockLeftX = (width - maxLineWidth) / 2;  // Left edge of centered text block
     
-    size_t len = wcslen(text);
-    int currentLineStart = 0;
-    
     // State trackers
-    int curHeadingIdx = 0;
-    int curLinkIdx = 0;
-    int curStyleIdx = 0;
-    int curBlockquoteIdx = 0;
-    int curColorTagIdx = 0;
-    int curFontTagIdx = 0;
+    int curBlockquoteIdx = LowerBoundByEnd(blockquotes, blockquoteCount, firstChar);
+
+    /* Inline attributes switch once per style run, not per character */
+    static const StyleRun baseRun = { 0, INT_MAX, 0, 0, NULL, NULL, -1 };
+    const StyleRun* runList = runs ? runs->runs : NULL;
+    int runCount = runs ? runs->count : 0;
+    int curRunIdx = 0;
+    if (firstChar > 0) {
+        /* Skip runs above the first drawn line */
+        int lo = 0, hi = runCount;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (runList[mid].end <= firstChar) lo = mid + 1;
+            else hi = mid;
+        }
+        curRunIdx = lo;
+    }
+    const StyleRun* run = &baseRun;
+    int runEnd = -1;
+    stbtt_fontinfo* runFontInfo = fontInfo;
+    float runFontScale = 0.0f;
 
     /* Calculate global time offset for animated gradient once per frame */
     int timeOffset = 0;
@@ -385,432 +341,383 @@ void RenderMarkdownSTB(void* bits, int width, int height, const wchar_t* text,
      */
     if (GetActiveEffect() == EFFECT_TYPE_LIQUID) {
         /* Raw continuous time for physics simulation */
-        timeOffset = (int)GetTickCount();
+        timeOffset = (int)RenderCore_GetTime();
     } else if (IsGradientAnimated((GradientType)gradientMode)) {
-        DWORD now = GetTickCount();
+        DWORD now = RenderCore_GetTime();
         /* Use a consistent cycle for gradients (2s loop for normal) */
         float progress = (float)(now % 2000) / 2000.0f;
         timeOffset = (int)(progress * GRADIENT_LUT_SIZE * 2);
-    } else if (colorTagCount > 0) {
+    } else if (runs && runs->hasColorTags) {
         /* Color tag gradients also need time offset for animation */
-        timeOffset = (int)GetTickCount();
+        timeOffset = (int)RenderCore_GetTime();
     }
 
-    for (size_t i = 0; i <= len; i++) {
-        if (text[i] == L'\n' || text[i] == L'\0') {
-            // 1. Measure this line to center horizontally AND find max height
-            int lineWidth = 0;
-            int lineMaxHeight = GetLineHeight(baseScale);
-            int maxAscent = (int)(baseAscent * baseScale);
-
-            // Temp indices for measurement pass
-            int tmpHeadingIdx = curHeadingIdx;
-
-            for (size_t j = currentLineStart; j < i; j++) {
-                if (text[j] == L'\r') continue;
-                
-                float scale = baseScale;
-                float fallbackScale = fallbackBaseScale;
-
-                while (tmpHeadingIdx < headingCount && j >= headings[tmpHeadingIdx].endPos) tmpHeadingIdx++;
-                if (tmpHeadingIdx < headingCount && j >= headings[tmpHeadingIdx].startPos) {
-                    scale = GetScaleForHeading(headings[tmpHeadingIdx].level, baseScale);
-                    if (fallbackLoaded) fallbackScale = GetScaleForHeading(headings[tmpHeadingIdx].level, fallbackBaseScale);
-                }
-
-                int h = GetLineHeight(scale);
-                if (h > lineMaxHeight) lineMaxHeight = h;
-                
-                int asc = (int)(baseAscent * scale); // Approximation
-                if (asc > maxAscent) maxAscent = asc;
-
-                GlyphMetrics gm;
-                GetCharMetricsSTB(text[j], (j < i - 1) ? text[j+1] : 0, scale, fallbackScale, &gm);
-                lineWidth += gm.advance + gm.kern;
-            }
-
-            int currentX = blockLeftX;  // All lines start from same left edge
-            // Baseline align: Y + maxAscent
-            int baselineY = currentY + maxAscent;
-
-            // Check for horizontal rule (─── = \x2500\x2500\x2500)
-            if (i - currentLineStart >= 3 && 
-                text[currentLineStart] == L'\x2500' && 
-                text[currentLineStart + 1] == L'\x2500' && 
-                text[currentLineStart + 2] == L'\x2500') {
-                // Draw horizontal line within text block area only
-                int lineY = currentY + lineMaxHeight / 2;
-                DWORD* pixels = (DWORD*)bits;
-                
-                int hrLeft = blockLeftX;
-                int hrRight = blockLeftX + maxLineWidth;
-                int hrWidth = hrRight - hrLeft;
-                
-                const GradientInfo* hrGradInfo = (gradientMode != GRADIENT_NONE) ? 
-                    GetGradientInfo((GradientType)gradientMode) : NULL;
-                
-                for (int x = hrLeft; x < hrRight && x < width; x++) {
-                    if (lineY >= 0 && lineY < height && x >= 0) {
-                        DWORD lineColor;
-                        if (hrGradInfo && hrWidth > 0) {
-                            float t = (float)(x - hrLeft) / (float)hrWidth;
-                            int r, g, b;
+    /* Effects run once over each same-paint run instead of per glyph */
+    BOOL layerOpen = BeginTextLayerSTB(bits, width, height);
+
+    for (int lineIdx = firstLine; lineIdx < endLine; lineIdx++) {
+        const LayoutLine* line = &layout->lines[lineIdx];
+        size_t currentLineStart = (size_t)line->start;
+        size_t i = (size_t)line->end;
+        int currentY = blockTopY + line->y;
+        int lineMaxHeight = line->height;
+
+        int currentX = blockLeftX;  // All lines start from same left edge
+        // Baseline align: Y + maxAscent
+        int baselineY = currentY + line->ascent;
+
+        // Check for horizontal rule (─── = \x2500\x2500\x2500)
+        if (i - currentLineStart >= 3 && 
+            text[currentLineStart] == L'\x2500' && 
+            text[currentLineStart + 1] == L'\x2500' && 
+            text[currentLineStart + 2] == L'\x2500') {
+            // Draw horizontal line within text block area only
+            int lineY = currentY + lineMaxHeight / 2;
+            DWORD* pixels = (DWORD*)bits;
+            
+            int hrLeft = blockLeftX;
+            int hrRight = blockLeftX + maxLineWidth;
+            int hrWidth = hrRight - hrLeft;
+            
+            const GradientInfo* hrGradInfo = (gradientMode != GRADIENT_NONE) ? 
+                GetGradientInfo((GradientType)gradientMode) : NULL;
+            
+            for (int x = hrLeft; x < hrRight && x < width; x++) {
+                if (lineY >= 0 && lineY < height && x >= 0) {
+                    DWORD lineColor;
+                    if (hrGradInfo && hrWidth > 0) {
+                        float t = (float)(x - hrLeft) / (float)hrWidth;
+                        int r, g, b;
+                        
+                        if (hrGradInfo->palette && hrGradInfo->paletteCount > 2) {
+                            // Animated multi-color gradient
+                            float animOffset = (float)timeOffset / (float)(GRADIENT_LUT_SIZE * 2);
+                            t = t - animOffset;
+                            while (t < 0) t += 1.0f;
+                            while (t >= 1.0f) t -= 1.0f;
                             
-                            if (hrGradInfo->palette && hrGradInfo->paletteCount > 2) {
-                                // Animated multi-color gradient
-                                float animOffset = (float)timeOffset / (float)(GRADIENT_LUT_SIZE * 2);
-                                t = t - animOffset;
-                                while (t < 0) t += 1.0f;
-                                while (t >= 1.0f) t -= 1.0f;
-                                
-                                float scaledT = t * (hrGradInfo->paletteCount - 1);
-                                int idx1 = (int)scaledT;
-                                int idx2 = idx1 + 1;
-                                if (idx2 >= hrGradInfo->paletteCount) idx2 = 0;
-                                float localT = scaledT - idx1;
-                                
-                                COLORREF c1 = hrGradInfo->palette[idx1];
-                                COLORREF c2 = hrGradInfo->palette[idx2];
-                                r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
-                                g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
-                                b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
-                            } else {
-                                // 2-color static gradient using startColor/endColor
-                                COLORREF c1 = hrGradInfo->startColor;
-                                COLORREF c2 = hrGradInfo->endColor;
-                                r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * t);
-                                g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * t);
-                                b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * t);
-                            }
-                            lineColor = 0xFF000000 | (r << 16) | (g << 8) | b;
+                            float scaledT = t * (hrGradInfo->paletteCount - 1);
+                            int idx1 = (int)scaledT;
+                            int idx2 = idx1 + 1;
+                            if (idx2 >= hrGradInfo->paletteCount) idx2 = 0;
+                            float localT = scaledT - idx1;
+                            
+                            COLORREF c1 = hrGradInfo->palette[idx1];
+                            COLORREF c2 = hrGradInfo->palette[idx2];
+                            r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * localT);
+                            g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * localT);
+                            b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * localT);
                         } else {
-                            lineColor = 0xFF000000 | (GetRValue(color) << 16) | (GetGValue(color) << 8) | GetBValue(color);
+                            // 2-color static gradient using startColor/endColor
+                            COLORREF c1 = hrGradInfo->startColor;
+                            COLORREF c2 = hrGradInfo->endColor;
+                            r = (int)(GetRValue(c1) + (GetRValue(c2) - GetRValue(c1)) * t);
+                            g = (int)(GetGValue(c1) + (GetGValue(c2) - GetGValue(c1)) * t);
+                            b = (int)(GetBValue(c1) + (GetBValue(c2) - GetBValue(c1)) * t);
                         }
-                        pixels[lineY * width + x] = lineColor;
+                        lineColor = 0xFF000000 | (r << 16) | (g << 8) | b;
+                    } else {
+                        lineColor = 0xFF000000 | (GetRValue(color) << 16) | (GetGValue(color) << 8) | GetBValue(color);
                     }
+                    pixels[lineY * width + x] = lineColor;
                 }
-                currentY += lineMaxHeight;
-                currentLineStart = i + 1;
-                continue;
             }
+            continue;
+        }
 
-            // Check if this line is inside a blockquote
-            while (curBlockquoteIdx < blockquoteCount && 
-                   (int)currentLineStart >= blockquotes[curBlockquoteIdx].endPos) {
-                curBlockquoteIdx++;
-            }
+        // Check if this line is inside a blockquote
+        while (curBlockquoteIdx < blockquoteCount && 
+               (int)currentLineStart >= blockquotes[curBlockquoteIdx].endPos) {
+            curBlockquoteIdx++;
+        }
+        
+        BlockquoteAlertType activeAlertType = BLOCKQUOTE_NORMAL;
+        BOOL inBlockquote = FALSE;
+        if (curBlockquoteIdx < blockquoteCount && 
+            (int)currentLineStart >= blockquotes[curBlockquoteIdx].startPos) {
+            inBlockquote = TRUE;
+            activeAlertType = blockquotes[curBlockquoteIdx].alertType;
+        }
+        
+        // Draw left colored bar for alert blockquotes only (GitHub style)
+        if (inBlockquote && activeAlertType != BLOCKQUOTE_NORMAL) {
+            COLORREF barColor = GetAlertColor(activeAlertType);
+            DWORD barColorDW = 0xFF000000 | (GetRValue(barColor) << 16) | 
+                               (GetGValue(barColor) << 8) | GetBValue(barColor);
+            DWORD* pixels = (DWORD*)bits;
             
-            BlockquoteAlertType activeAlertType = BLOCKQUOTE_NORMAL;
-            BOOL inBlockquote = FALSE;
-            if (curBlockquoteIdx < blockquoteCount && 
-                (int)currentLineStart >= blockquotes[curBlockquoteIdx].startPos) {
-                inBlockquote = TRUE;
-                activeAlertType = blockquotes[curBlockquoteIdx].alertType;
-            }
+            int barX = blockLeftX - 8;  // 8 pixels left of text
+            int barWidth = 3;           // 3 pixels wide
             
-            // Draw left colored bar for alert blockquotes only (GitHub style)
-            if (inBlockquote && activeAlertType != BLOCKQUOTE_NORMAL) {
-                COLORREF barColor = GetAlertColor(activeAlertType);
-                DWORD barColorDW = 0xFF000000 | (GetRValue(barColor) << 16) | 
-                                   (GetGValue(barColor) << 8) | GetBValue(barColor);
-                DWORD* pixels = (DWORD*)bits;
-                
-                int barX = blockLeftX - 8;  // 8 pixels left of text
-                int barWidth = 3;           // 3 pixels wide
-                
-                for (int y = currentY; y < currentY + lineMaxHeight && y < height; y++) {
-                    if (y >= 0) {
-                        for (int x = barX; x < barX + barWidth && x >= 0 && x < width; x++) {
-                            pixels[y * width + x] = barColorDW;
-                        }
+            for (int y = currentY; y < currentY + lineMaxHeight && y < height; y++) {
+                if (y >= 0) {
+                    for (int x = barX; x < barX + barWidth && x >= 0 && x < width; x++) {
+                        pixels[y * width + x] = barColorDW;
                     }
                 }
             }
-            
-            // Check if this is an alert title line (first line with "NOTE:", etc.)
-            BOOL isAlertTitleLine = FALSE;
-            if (inBlockquote && activeAlertType != BLOCKQUOTE_NORMAL) {
-                const wchar_t* lineText = &text[currentLineStart];
-                if (wcsstr(lineText, L"NOTE:") == lineText ||
-                    wcsstr(lineText, L"TIP:") == lineText ||
-                    wcsstr(lineText, L"IMPORTANT:") == lineText ||
-                    wcsstr(lineText, L"WARNING:") == lineText ||
-                    wcsstr(lineText, L"CAUTION:") == lineText) {
-                    isAlertTitleLine = TRUE;
-                }
+        }
+        
+        // Check if this is an alert title line (first line with "NOTE:", etc.)
+        BOOL isAlertTitleLine = FALSE;
+        if (inBlockquote && activeAlertType != BLOCKQUOTE_NORMAL) {
+            /* Prefix compares; a search would scan the rest of the text per line */
+            const wchar_t* lineText = &text[currentLineStart];
+            if (wcsncmp(lineText, L"NOTE:", 5) == 0 ||
+                wcsncmp(lineText, L"TIP:", 4) == 0 ||
+                wcsncmp(lineText, L"IMPORTANT:", 10) == 0 ||
+                wcsncmp(lineText, L"WARNING:", 8) == 0 ||
+                wcsncmp(lineText, L"CAUTION:", 8) == 0) {
+                isAlertTitleLine = TRUE;
             }
-            
-            // Check if this is a completed todo line (starts with ■)
-            BOOL isCompletedTodo = (text[currentLineStart] == L'\x25A0');
-            
-            // 2. Render this line
-            for (size_t j = currentLineStart; j < i; j++) {
-                if (text[j] == L'\r') continue;
-
-                // Determine styles
-                float scale = baseScale;
-                float fallbackScale = fallbackBaseScale;
-                COLORREF drawColor = color;
-
-                // Heading
-                while (curHeadingIdx < headingCount && j >= headings[curHeadingIdx].endPos) curHeadingIdx++;
-                if (curHeadingIdx < headingCount && j >= headings[curHeadingIdx].startPos) {
-                    scale = GetScaleForHeading(headings[curHeadingIdx].level, baseScale);
-                    if (fallbackLoaded) fallbackScale = GetScaleForHeading(headings[curHeadingIdx].level, fallbackBaseScale);
-                }
-                
-                // Apply alert color only to title line (NOTE:, TIP:, etc.)
-                if (isAlertTitleLine) {
-                    drawColor = GetAlertColor(activeAlertType);
-                }
+        }
+        
+        // Check if this is a completed todo line (starts with ■)
+        BOOL isCompletedTodo = (text[currentLineStart] == L'\x25A0');
 
-                // Link - track region for click detection
-                BOOL inLink = FALSE;
-                int activeLinkIdx = -1;
-                while (curLinkIdx < linkCount && j >= links[curLinkIdx].endPos) curLinkIdx++;
-                if (curLinkIdx < linkCount && j >= links[curLinkIdx].startPos) {
-                    drawColor = RGB(0, 175, 255); // Link color #00AFFF
-                    inLink = TRUE;
-                    activeLinkIdx = curLinkIdx;
-                    
-                    /* Update link rect for first char */
-                    if (j == links[curLinkIdx].startPos) {
-                        links[curLinkIdx].linkRect.left = currentX;
-                        links[curLinkIdx].linkRect.top = currentY;
-                        links[curLinkIdx].linkRect.bottom = currentY + lineMaxHeight;
-                    }
-                    links[curLinkIdx].linkRect.right = currentX;
-                }
-                
-                // Style handling
-                BOOL isBold = isAlertTitleLine;  // Alert title is bold
-                BOOL isItalic = FALSE;
-                BOOL isStrikethrough = FALSE;
-                
-                // Apply strikethrough for completed todo (skip checkbox symbol itself)
-                if (isCompletedTodo && j > currentLineStart) {
-                    isStrikethrough = TRUE;
-                }
-                
-                while (curStyleIdx < styleCount && j >= styles[curStyleIdx].endPos) curStyleIdx++;
-                if (curStyleIdx < styleCount && j >= styles[curStyleIdx].startPos) {
-                    MarkdownStyleType styleType = styles[curStyleIdx].type;
-                    if (styleType == STYLE_CODE) {
-                        drawColor = RGB(100, 100, 100);
-                    } else if (styleType == STYLE_BOLD) {
-                        isBold = TRUE;
-                    } else if (styleType == STYLE_ITALIC) {
-                        isItalic = TRUE;
-                    } else if (styleType == STYLE_BOLD_ITALIC) {
-                        isBold = TRUE;
-                        isItalic = TRUE;
-                    } else if (styleType == STYLE_STRIKETHROUGH) {
-                        isStrikethrough = TRUE;
-                    }
+        // Apply alert color only to title line (NOTE:, TIP:, etc.)
+        COLORREF lineColor = isAlertTitleLine ? GetAlertColor(activeAlertType) : color;
+        
+        // 2. Render this line
+        for (size_t j = currentLineStart; j < i; j++) {
+            if (text[j] == L'\r') continue;
+
+            if ((int)j >= runEnd) {
+                while (curRunIdx < runCount && (int)j >= runList[curRunIdx].end) curRunIdx++;
+                if (curRunIdx < runCount && (int)j >= runList[curRunIdx].start) {
+                    run = &runList[curRunIdx];
+                    runEnd = run->end;
+                } else {
+                    run = &baseRun;
+                    runEnd = (curRunIdx < runCount) ? runList[curRunIdx].start : INT_MAX;
                 }
 
-                /* Color tag handling - override drawColor with tag color or gradient */
-                BOOL useColorTagGradient = FALSE;
-                MarkdownColorTag* activeColorTag = NULL;
-                while (curColorTagIdx < colorTagCount && (int)j >= colorTags[curColorTagIdx].endPos) curColorTagIdx++;
-                if (curColorTagIdx < colorTagCount && (int)j >= colorTags[curColorTagIdx].startPos) {
-                    MarkdownColorTag* tag = &colorTags[curColorTagIdx];
-                    if (tag->colorCount == 1) {
-                        /* Single color */
-                        drawColor = tag->colors[0];
-                    } else if (tag->colorCount > 1) {
-                        /* Gradient - will use animated rendering */
-                        useColorTagGradient = TRUE;
-                        activeColorTag = tag;
+                /* Font tag face and its scale, used while its glyphs exist */
+                runFontInfo = fontInfo;
+                runFontScale = 0.0f;
+                if (run->fontName) {
+                    stbtt_fontinfo* cachedFont = GetCachedFontSTB(run->fontName);
+                    if (cachedFont) {
+                        runFontInfo = cachedFont;
+                        runFontScale = stbtt_ScaleForPixelHeight(cachedFont, (float)(fontSize * fontScale));
                     }
                 }
+            }
 
-                /* Font tag handling - use cached font if specified */
-                stbtt_fontinfo* charFontInfo = fontInfo;
-                float charScale = scale;
-                while (curFontTagIdx < fontTagCount && (int)j >= fontTags[curFontTagIdx].endPos) curFontTagIdx++;
-                if (curFontTagIdx < fontTagCount && (int)j >= fontTags[curFontTagIdx].startPos) {
-                    stbtt_fontinfo* cachedFont = GetCachedFontSTB(fontTags[curFontTagIdx].fontName);
-                    if (cachedFont) {
-                        charFontInfo = cachedFont;
-                        charScale = stbtt_ScaleForPixelHeight(cachedFont, (float)(fontSize * fontScale));
-                    }
+            // Heading scale is already resolved by the layout
+            const LayoutGlyph* lg = TextLayout_Glyph(layout, (int)j);
+            float scale = lg->scale;
+            float fallbackScale = lg->fallbackScale;
+            COLORREF drawColor = (run->flags & STYLE_RUN_COLOR) ? run->color : lineColor;
+
+            // Link - track region for click detection
+            int activeLinkIdx = run->linkIndex;
+            if (activeLinkIdx >= 0) {
+                MarkdownLink* link = &links[activeLinkIdx];
+                /* Update link rect for first char */
+                if ((int)j == link->startPos) {
+                    link->linkRect.left = currentX;
+                    link->linkRect.top = currentY;
+                    link->linkRect.bottom = currentY + lineMaxHeight;
                 }
+                link->linkRect.right = currentX;
+            }
 
-                GlyphMetrics gm;
-                /* Use custom font if in font tag, otherwise use default */
-                if (charFontInfo != fontInfo) {
-                    /* Custom font - get metrics directly */
-                    gm.index = stbtt_FindGlyphIndex(charFontInfo, (int)text[j]);
-                    gm.isFallback = FALSE;
-                    gm.kern = 0;
-                    if (gm.index != 0) {
-                        int adv, lsb;
-                        stbtt_GetGlyphHMetrics(charFontInfo, gm.index, &adv, &lsb);
-                        gm.advance = (int)(adv * charScale);
-                    } else {
-                        /* Fallback to main font if glyph not found */
-                        GetCharMetricsSTB(text[j], (j < i - 1) ? text[j+1] : 0, scale, fallbackScale, &gm);
-                        charFontInfo = fontInfo;
-                        charScale = scale;
-                    }
+            // Alert title is bold; completed todo is struck through (except the checkbox itself)
+            BOOL isBold = isAlertTitleLine || (run->flags & STYLE_RUN_BOLD);
+            BOOL isItalic = (run->flags & STYLE_RUN_ITALIC) != 0;
+            BOOL isStrikethrough = (isCompletedTodo && j > currentLineStart) || (run->flags & STYLE_RUN_STRIKE);
+
+            /* Color tag gradient - animated rendering instead of drawColor */
+            const MarkdownColorTag* activeColorTag = run->gradient;
+            BOOL useColorTagGradient = (activeColorTag != NULL);
+
+            stbtt_fontinfo* charFontInfo = runFontInfo;
+            float charScale = (runFontInfo != fontInfo) ? runFontScale : scale;
+
+            GlyphMetrics gm;
+            /* Use custom font if in font tag, otherwise use default */
+            if (charFontInfo != fontInfo) {
+                /* Custom font - get metrics directly */
+                gm.index = stbtt_FindGlyphIndex(charFontInfo, (int)text[j]);
+                gm.isFallback = FALSE;
+                gm.kern = 0;
+                if (gm.index != 0) {
+                    int adv, lsb;
+                    stbtt_GetGlyphHMetrics(charFontInfo, gm.index, &adv, &lsb);
+                    gm.advance = (int)(adv * charScale);
+                } else {
+                    /* Fallback to main font if glyph not found */
+                    charFontInfo = fontInfo;
+                    charScale = scale;
+                }
+            }
+            if (charFontInfo == fontInfo) {
+                gm.index = lg->index;
+                gm.isFallback = lg->isFallback;
+                gm.advance = lg->advance;
+                gm.kern = lg->kern;
+            }
+            
+            if (gm.index != 0 && text[j] != L' ' && text[j] != L'\t') {
+                int w = 0, h = 0, xoff = 0, yoff = 0;
+                unsigned char* bitmap = NULL;
+                const CachedGlyph* glyph;
+                
+                if (charFontInfo != fontInfo && !gm.isFallback) {
+                    /* Use custom font from font tag */
+                    glyph = GlyphCache_Get(charFontInfo, charScale, gm.index, FALSE);
+                } else if (gm.isFallback) {
+                    glyph = GlyphCache_Get(fallbackFontInfo, fallbackScale, gm.index, TRUE);
                 } else {
-                    GetCharMetricsSTB(text[j], (j < i - 1) ? text[j+1] : 0, scale, fallbackScale, &gm);
+                    glyph = GlyphCache_Get(fontInfo, scale, gm.index, FALSE);
+                }
+                
+                if (glyph) {
+                    bitmap = glyph->bitmap;
+                    w = glyph->w;
+                    h = glyph->h;
+                    xoff = glyph->xoff;
+                    yoff = glyph->yoff;
                 }
                 
-                if (gm.index != 0 && text[j] != L' ' && text[j] != L'\t') {
-                    int w, h, xoff, yoff;
-                    unsigned char* bitmap = NULL;
+                if (bitmap) {
+                    float slant = isItalic ? 0.35f : 0.0f;
                     
-                    if (charFontInfo != fontInfo && !gm.isFallback) {
-                        /* Use custom font from font tag */
-                        bitmap = stbtt_GetGlyphBitmap(charFontInfo, charScale, charScale, gm.index, &w, &h, &xoff, &yoff);
-                    } else if (gm.isFallback) {
-                        bitmap = stbtt_GetGlyphBitmap(fallbackFontInfo, fallbackScale, fallbackScale, gm.index, &w, &h, &xoff, &yoff);
-                    } else {
-                        bitmap = stbtt_GetGlyphBitmap(fontInfo, scale, scale, gm.index, &w, &h, &xoff, &yoff);
-                    }
+                    /* Use global gradient only if no color tag gradient is active */
+                    BOOL useGlobalGradient = (gradientMode != GRADIENT_NONE && drawColor == color && !useColorTagGradient);
                     
-                    if (bitmap) {
-                        float slant = isItalic ? 0.35f : 0.0f;
-                        
-                        /* Use global gradient only if no color tag gradient is active */
-                        BOOL useGlobalGradient = (gradientMode != GRADIENT_NONE && drawColor == color && !useColorTagGradient);
-                        
-                        if (useGlobalGradient) {
-                            if (isItalic) {
-                                // Use proper per-row shear for italic with gradient
+                    if (useGlobalGradient) {
+                        if (isItalic) {
+                            // Use proper per-row shear for italic with gradient
+                            BlendCharBitmapItalicGradientSTB(bits, width, height, 
+                                currentX + xoff, baselineY + yoff, 
+                                bitmap, w, h, slant, gradientMode, timeOffset, width);
+                            if (isBold) {
                                 BlendCharBitmapItalicGradientSTB(bits, width, height, 
-                                    currentX + xoff, baselineY + yoff, 
+                                    currentX + xoff + 1, baselineY + yoff, 
                                     bitmap, w, h, slant, gradientMode, timeOffset, width);
-                                if (isBold) {
-                                    BlendCharBitmapItalicGradientSTB(bits, width, height, 
-                                        currentX + xoff + 1, baselineY + yoff, 
-                                        bitmap, w, h, slant, gradientMode, timeOffset, width);
-                                }
-                            } else {
+                            }
+                        } else {
+                            BlendCharBitmapGradientSTB(bits, width, height, 
+                                currentX + xoff, baselineY + yoff, 
+                                bitmap, w, h, 0, width, gradientMode, timeOffset);
+                            if (isBold) {
+                                BlendCharBitmapGradientSTB(bits, width, height, 
+                                    currentX + xoff + 1, baselineY + yoff, 
+                                    bitmap, w, h, 0, width, gradientMode, timeOffset);
                                 BlendCharBitmapGradientSTB(bits, width, height, 
-                                    currentX + xoff, baselineY + yoff, 
+                                    currentX + xoff, baselineY + yoff + 1, 
                                     bitmap, w, h, 0, width, gradientMode, timeOffset);
-                                if (isBold) {
-                                    BlendCharBitmapGradientSTB(bits, width, height, 
-                                        currentX + xoff + 1, baselineY + yoff, 
-                                        bitmap, w, h, 0, width, gradientMode, timeOffset);
-                                    BlendCharBitmapGradientSTB(bits, width, height, 
-                                        currentX + xoff, baselineY + yoff + 1, 
-                                        bitmap, w, h, 0, width, gradientMode, timeOffset);
-                                }
                             }
-                        } else if (useColorTagGradient && activeColorTag) {
-                            /* Color tag gradient with animation */
-                            if (isItalic) {
+                        }
+                    } else if (useColorTagGradient && activeColorTag) {
+                        /* Color tag gradient with animation */
+                        if (isItalic) {
+                            BlendCharBitmapColorTagGradientItalicSTB(bits, width, height,
+                                currentX + xoff, baselineY + yoff,
+                                bitmap, w, h, activeColorTag, timeOffset, width, slant);
+                            if (isBold) {
                                 BlendCharBitmapColorTagGradientItalicSTB(bits, width, height,
-                                    currentX + xoff, baselineY + yoff,
+                                    currentX + xoff + 1, baselineY + yoff,
                                     bitmap, w, h, activeColorTag, timeOffset, width, slant);
-                                if (isBold) {
-                                    BlendCharBitmapColorTagGradientItalicSTB(bits, width, height,
-                                        currentX + xoff + 1, baselineY + yoff,
-                                        bitmap, w, h, activeColorTag, timeOffset, width, slant);
-                                }
-                            } else {
+                            }
+                        } else {
+                            BlendCharBitmapColorTagGradientSTB(bits, width, height,
+                                currentX + xoff, baselineY + yoff,
+                                bitmap, w, h, activeColorTag, timeOffset, width);
+                            if (isBold) {
                                 BlendCharBitmapColorTagGradientSTB(bits, width, height,
-                                    currentX + xoff, baselineY + yoff,
+                                    currentX + xoff + 1, baselineY + yoff,
+                                    bitmap, w, h, activeColorTag, timeOffset, width);
+                                BlendCharBitmapColorTagGradientSTB(bits, width, height,
+                                    currentX + xoff, baselineY + yoff + 1,
                                     bitmap, w, h, activeColorTag, timeOffset, width);
-                                if (isBold) {
-                                    BlendCharBitmapColorTagGradientSTB(bits, width, height,
-                                        currentX + xoff + 1, baselineY + yoff,
-                                        bitmap, w, h, activeColorTag, timeOffset, width);
-                                    BlendCharBitmapColorTagGradientSTB(bits, width, height,
-                                        currentX + xoff, baselineY + yoff + 1,
-                                        bitmap, w, h, activeColorTag, timeOffset, width);
-                                }
                             }
-                        } else if (isItalic) {
-                            // Use proper per-row shear for italic
+                        }
+                    } else if (isItalic) {
+                        // Use proper per-row shear for italic
+                        BlendCharBitmapItalicSTB(bits, width, height, 
+                            currentX + xoff, baselineY + yoff,  
+                            bitmap, w, h, 
+                            GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor), slant);
+                        if (isBold) {
                             BlendCharBitmapItalicSTB(bits, width, height, 
-                                currentX + xoff, baselineY + yoff,  
+                                currentX + xoff + 1, baselineY + yoff,  
                                 bitmap, w, h, 
                                 GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor), slant);
-                            if (isBold) {
-                                BlendCharBitmapItalicSTB(bits, width, height, 
-                                    currentX + xoff + 1, baselineY + yoff,  
-                                    bitmap, w, h, 
-                                    GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor), slant);
-                            }
-                        } else {
+                        }
+                    } else {
+                        BlendCharBitmapSTB(bits, width, height, 
+                            currentX + xoff, baselineY + yoff,  
+                            bitmap, w, h, 
+                            GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor));
+                        if (isBold) {
                             BlendCharBitmapSTB(bits, width, height, 
-                                currentX + xoff, baselineY + yoff,  
+                                currentX + xoff + 1, baselineY + yoff,  
+                                bitmap, w, h, 
+                                GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor));
+                            BlendCharBitmapSTB(bits, width, height, 
+                                currentX + xoff, baselineY + yoff + 1,  
                                 bitmap, w, h, 
                                 GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor));
-                            if (isBold) {
-                                BlendCharBitmapSTB(bits, width, height, 
-                                    currentX + xoff + 1, baselineY + yoff,  
-                                    bitmap, w, h, 
-                                    GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor));
-                                BlendCharBitmapSTB(bits, width, height, 
-                                    currentX + xoff, baselineY + yoff + 1,  
-                                    bitmap, w, h, 
-                                    GetRValue(drawColor), GetGValue(drawColor), GetBValue(drawColor));
-                            }
                         }
-                        stbtt_FreeBitmap(bitmap, NULL);
+                    }
+                    // Draw strikethrough line
+                    if (isStrikethrough) {
+                        int lineY = baselineY - h / 3;  // Position at ~1/3 from baseline
+                        DWORD* pixels = (DWORD*)bits;
                         
-                        // Draw strikethrough line
-                        if (isStrikethrough) {
-                            int lineY = baselineY - h / 3;  // Position at ~1/3 from baseline
-                            DWORD* pixels = (DWORD*)bits;
-                            
-                            // Get line color from gradient or solid color
-                            DWORD lineColor;
-                            if (gradientMode != GRADIENT_NONE && drawColor == color) {
-                                const GradientInfo* stInfo = GetGradientInfo((GradientType)gradientMode);
-                                if (stInfo && stInfo->palette && stInfo->paletteCount > 0) {
-                                    COLORREF c = stInfo->palette[0];
-                                    lineColor = 0xFF000000 | (GetRValue(c) << 16) | (GetGValue(c) << 8) | GetBValue(c);
-                                } else if (stInfo) {
-                                    lineColor = 0xFF000000 | (GetRValue(stInfo->startColor) << 16) | 
-                                                (GetGValue(stInfo->startColor) << 8) | GetBValue(stInfo->startColor);
-                                } else {
-                                    lineColor = 0xFF000000 | (GetRValue(drawColor) << 16) | 
-                                                (GetGValue(drawColor) << 8) | GetBValue(drawColor);
-                                }
+                        // Get line color from gradient or solid color
+                        DWORD lineColor;
+                        if (gradientMode != GRADIENT_NONE && drawColor == color) {
+                            const GradientInfo* stInfo = GetGradientInfo((GradientType)gradientMode);
+                            if (stInfo && stInfo->palette && stInfo->paletteCount > 0) {
+                                COLORREF c = stInfo->palette[0];
+                                lineColor = 0xFF000000 | (GetRValue(c) << 16) | (GetGValue(c) << 8) | GetBValue(c);
+                            } else if (stInfo) {
+                                lineColor = 0xFF000000 | (GetRValue(stInfo->startColor) << 16) | 
+                                            (GetGValue(stInfo->startColor) << 8) | GetBValue(stInfo->startColor);
                             } else {
                                 lineColor = 0xFF000000 | (GetRValue(drawColor) << 16) | 
                                             (GetGValue(drawColor) << 8) | GetBValue(drawColor);
                             }
-                            
-                            // Draw horizontal line through character
-                            for (int sx = currentX; sx < currentX + gm.advance && sx < width; sx++) {
-                                if (lineY >= 0 && lineY < height && sx >= 0) {
-                                    pixels[lineY * width + sx] = lineColor;
-                                }
+                        } else {
+                            lineColor = 0xFF000000 | (GetRValue(drawColor) << 16) | 
+                                        (GetGValue(drawColor) << 8) | GetBValue(drawColor);
+                        }
+                        
+                        // Draw horizontal line through character
+                        for (int sx = currentX; sx < currentX + gm.advance && sx < width; sx++) {
+                            if (lineY >= 0 && lineY < height && sx >= 0) {
+                                pixels[lineY * width + sx] = lineColor;
                             }
                         }
                     }
-                    /* Record checkbox region (□ = 0x25A1, ■ = 0x25A0) */
-                    if (text[j] == L'\x25A1' || text[j] == L'\x25A0') {
-                        /* Use character advance width for click area */
-                        RECT cbRect = {
-                            currentX, currentY,
-                            currentX + gm.advance, currentY + lineMaxHeight
-                        };
-                        AddCheckboxRegion(&cbRect, checkboxIndex, text[j] == L'\x25A0');
-                        checkboxIndex++;
-                    }
                 }
-                currentX += gm.advance + gm.kern;
-                
-                /* Update link rect right edge after advancing */
-                if (inLink && activeLinkIdx >= 0) {
-                    links[activeLinkIdx].linkRect.right = currentX;
+                /* Record checkbox region (□ = 0x25A1, ■ = 0x25A0) */
+                if (text[j] == L'\x25A1' || text[j] == L'\x25A0') {
+                    /* Use character advance width for click area */
+                    RECT cbRect = {
+                        currentX, currentY,
+                        currentX + gm.advance, currentY + lineMaxHeight
+                    };
+                    AddCheckboxRegion(&cbRect, checkboxIndex, text[j] == L'\x25A0');
+                    checkboxIndex++;
                 }
             }
-
-            currentY += lineMaxHeight;
-            currentLineStart = i + 1;
+            currentX += gm.advance + gm.kern;
+            
+            /* Update link rect right edge after advancing */
+            if (activeLinkIdx >= 0) {
+                links[activeLinkIdx].linkRect.right = currentX;
+            }
         }
+
     }
     
+    if (layerOpen) EndTextLayerSTB();
+
     /* Register all link regions for click detection */
     for (int i = 0; i < linkCount; i++) {
         if (links[i].linkUrl && links[i].linkRect.right > links[i].linkRect.left) {
@@ -0,0 +1,179 @@
+/**
+ * @file drawing_outline_cache.c
+ * @brief LRU cache of decoded glyph outlines with a fixed memory budget
+ */
+
+#include "drawing/drawing_outline_cache.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct OutlineEntry {
+    const stbtt_fontinfo* face;
+    int glyphIndex;
+    BOOL hasBox;             /* FALSE for glyphs without outline data */
+    int x0, y0, x1, y1;      /* Font-unit box from stbtt_GetGlyphBox */
+    int vertexCount;
+    stbtt_vertex* vertices;  /* Stored after the entry, same allocation */
+    SIZE_T bytes;
+    struct OutlineEntry* hashNext;
+    struct OutlineEntry* lruPrev;
+    struct OutlineEntry* lruNext;
+} OutlineEntry;
+
+static OutlineEntry* g_buckets[OUTLINE_CACHE_BUCKETS] = {0};
+static OutlineEntry* g_lruHead = NULL;  /* Most recently used */
+static OutlineEntry* g_lruTail = NULL;  /* Eviction candidate */
+static SIZE_T g_cacheBytes = 0;
+static DWORD g_hits = 0;
+static DWORD g_misses = 0;
+
+static UINT HashKey(const stbtt_fontinfo* face, int glyphIndex) {
+    UINT h = (UINT)((uintptr_t)face >> 4);
+    h = h * 31u + (UINT)glyphIndex;
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h & (OUTLINE_CACHE_BUCKETS - 1);
+}
+
+static void LruUnlink(OutlineEntry* e) {
+    if (e->lruPrev) e->lruPrev->lruNext = e->lruNext; else g_lruHead = e->lruNext;
+    if (e->lruNext) e->lruNext->lruPrev = e->lruPrev; else g_lruTail = e->lruPrev;
+    e->lruPrev = e->lruNext = NULL;
+}
+
+static void LruPushFront(OutlineEntry* e) {
+    e->lruPrev = NULL;
+    e->lruNext = g_lruHead;
+    if (g_lruHead) g_lruHead->lruPrev = e;
+    g_lruHead = e;
+    if (!g_lruTail) g_lruTail = e;
+}
+
+static void RemoveEntry(OutlineEntry* e) {
+    OutlineEntry** link = &g_buckets[HashKey(e->face, e->glyphIndex)];
+    while (*link && *link != e) link = &(*link)->hashNext;
+    if (*link) *link = e->hashNext;
+
+    LruUnlink(e);
+    g_cacheBytes -= e->bytes;
+    free(e);
+}
+
+static void EvictToFit(SIZE_T incoming) {
+    while (g_lruTail && g_cacheBytes + incoming > OUTLINE_CACHE_MAX_BYTES) {
+        RemoveEntry(g_lruTail);
+    }
+}
+
+/** @brief Decode outline and box once; the stbtt copy is freed right away */
+static OutlineEntry* DecodeOutline(const stbtt_fontinfo* face, int glyphIndex) {
+    stbtt_vertex* decoded = NULL;
+    int count = stbtt_GetGlyphShape(face, glyphIndex, &decoded);
+    if (count < 0) count = 0;
+
+    SIZE_T bytes = sizeof(OutlineEntry) + (SIZE_T)count * sizeof(stbtt_vertex);
+    OutlineEntry* e = (OutlineEntry*)calloc(1, bytes);
+    if (!e) {
+        stbtt_FreeShape(face, decoded);
+        return NULL;
+    }
+
+    e->face = face;
+    e->glyphIndex = glyphIndex;
+    e->hasBox = stbtt_GetGlyphBox(face, glyphIndex, &e->x0, &e->y0, &e->x1, &e->y1);
+    e->vertexCount = count;
+    e->vertices = (stbtt_vertex*)(e + 1);
+    if (count > 0) memcpy(e->vertices, decoded, (SIZE_T)count * sizeof(stbtt_vertex));
+    e->bytes = bytes;
+    stbtt_FreeShape(face, decoded);
+    return e;
+}
+
+static OutlineEntry* Lookup(const stbtt_fontinfo* face, int glyphIndex) {
+    UINT bucket = HashKey(face, glyphIndex);
+
+    for (OutlineEntry* e = g_buckets[bucket]; e; e = e->hashNext) {
+        if (e->face == face && e->glyphIndex == glyphIndex) {
+            if (e != g_lruHead) {
+                LruUnlink(e);
+                LruPushFront(e);
+            }
+            g_hits++;
+            return e;
+        }
+    }
+
+    g_misses++;
+
+    OutlineEntry* e = DecodeOutline(face, glyphIndex);
+    if (!e) return NULL;
+
+    /* Oversized outlines are still cached; they just displace everything else */
+    EvictToFit(e->bytes);
+
+    e->hashNext = g_buckets[bucket];
+    g_buckets[bucket] = e;
+    LruPushFront(e);
+    g_cacheBytes += e->bytes;
+    return e;
+}
+
+/* Mirrors stbtt_GetGlyphBitmapSubpixel with zero shift, minus the parsing */
+unsigned char* OutlineCache_Rasterize(const stbtt_fontinfo* face, float scale, int glyphIndex,
+                                      int* width, int* height, int* xoff, int* yoff) {
+    *width = *height = *xoff = *yoff = 0;
+    if (!face) return NULL;
+
+    OutlineEntry* e = Lookup(face, glyphIndex);
+    if (!e) return NULL;
+
+    int ix0 = 0, iy0 = 0, ix1 = 0, iy1 = 0;
+    if (e->hasBox) {
+        ix0 = (int)floorf(e->x0 * scale);
+        iy0 = (int)floorf(-e->y1 * scale);
+        ix1 = (int)ceilf(e->x1 * scale);
+        iy1 = (int)ceilf(-e->y0 * scale);
+    }
+
+    *width = ix1 - ix0;
+    *height = iy1 - iy0;
+    *xoff = ix0;
+    *yoff = iy0;
+    if (*width <= 0 || *height <= 0) return NULL;
+
+    stbtt__bitmap gbm;
+    gbm.w = *width;
+    gbm.h = *height;
+    gbm.stride = *width;
+    gbm.pixels = (unsigned char*)malloc((size_t)gbm.w * (size_t)gbm.h);
+    if (!gbm.pixels) return NULL;
+
+    stbtt_Rasterize(&gbm, OUTLINE_FLATNESS_PIXELS, e->vertices, e->vertexCount,
+                    scale, scale, 0.0f, 0.0f, ix0, iy0, 1, NULL);
+    return gbm.pixels;
+}
+
+void OutlineCache_InvalidateFace(const stbtt_fontinfo* face) {
+    OutlineEntry* e = g_lruHead;
+    while (e) {
+        OutlineEntry* next = e->lruNext;
+        if (e->face == face) RemoveEntry(e);
+        e = next;
+    }
+}
+
+void OutlineCache_Clear(void) {
+    while (g_lruHead) {
+        RemoveEntry(g_lruHead);
+    }
+    memset(g_buckets, 0, sizeof(g_buckets));
+    g_cacheBytes = 0;
+}
+
+void OutlineCache_GetStats(DWORD* hits, DWORD* misses, SIZE_T* bytes) {
+    if (hits) *hits = g_hits;
+    if (misses) *misses = g_misses;
+    if (bytes) *bytes = g_cacheBytes;
+}
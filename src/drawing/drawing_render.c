@@ -4,11 +4,14 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <windows.h>
 #include "drawing/drawing_render.h"
 #include "drawing/drawing_time_format.h"
 #include "drawing/drawing_text_stb.h"
-#include "drawing/drawing_markdown_stb.h"
+#include "drawing/drawing_render_core.h"
 #include "drawing.h"
 #include "font.h"
 #include "color/color.h"
@@ -20,8 +23,16 @@
 #include "menu_preview.h"
 #include "font/font_path_manager.h"
 #include "log.h"
+#include "log/log_probe.h"
+#include "log/log_trace.h"
 #include "plugin/plugin_data.h"
 #include "drawing/drawing_image.h"
+#include "drawing/drawing_surface.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_frame_governor.h"
+#include "drawing/drawing_blend_simd.h"
+#include "drawing/drawing_glyph_cache.h"
+#include "drawing/drawing_outline_cache.h"
 #include "markdown/markdown_parser.h"
 #include "markdown/markdown_image.h"
 #include "color/color_parser.h"
@@ -34,6 +45,25 @@ extern int CLOCK_BASE_FONT_SIZE;
 extern float CLOCK_FONT_SCALE_FACTOR;
 extern float PLUGIN_FONT_SCALE_FACTOR;
 
+/** @brief Plugin time slots reported to the parse memo; later slots stay in the key */
+#define PAINT_MAX_TIME_RANGES 16
+
+/* Expanded plugin text; grows with the plugin output instead of TIME_TEXT_MAX_LEN */
+static wchar_t* s_pluginText = NULL;
+static size_t s_pluginTextCapacity = 0;
+
+/**
+ * @return Buffer of at least chars characters, or NULL on allocation failure
+ */
+static wchar_t* ReservePluginText(size_t chars) {
+    if (chars <= s_pluginTextCapacity) return s_pluginText;
+    wchar_t* text = (wchar_t*)realloc(s_pluginText, chars * sizeof(wchar_t));
+    if (!text) return NULL;
+    s_pluginText = text;
+    s_pluginTextCapacity = chars;
+    return text;
+}
+
 /**
  * @param colorStr "#RRGGBB" or "R,G,B" format
  * @return COLORREF value, white on parse failure
@@ -109,14 +139,12 @@ static BOOL ResolveFontPath(const RenderContext* ctx, char* outPath) {
     return FALSE;
 }
 
-static BOOL MeasureTextMarkdown(const wchar_t* text, const RenderContext* ctx, SIZE* outSize,
-                               MarkdownHeading* headings, int headingCount) {
+static BOOL MeasureTextMarkdown(const RenderCoreDocument* doc, const RenderContext* ctx, SIZE* outSize) {
     char absoluteFontPath[MAX_PATH];
     if (ResolveFontPath(ctx, absoluteFontPath)) {
         if (InitFontSTB(absoluteFontPath)) {
             int w, h;
-            if (MeasureMarkdownSTB(text, headings, headingCount, 
-                                  (int)(CLOCK_BASE_FONT_SIZE * ctx->fontScaleFactor), &w, &h)) {
+            if (RenderCore_Measure(doc, (int)(CLOCK_BASE_FONT_SIZE * ctx->fontScaleFactor), &w, &h)) {
                 outSize->cx = w;
                 outSize->cy = h;
                 return TRUE;
@@ -127,30 +155,23 @@ static BOOL MeasureTextMarkdown(const wchar_t* text, const RenderContext* ctx, S
     return FALSE;
 }
 
-static BOOL RenderTextMarkdown(HDC hdc, const RECT* rect, const wchar_t* text, const RenderContext* ctx, BOOL editMode, void* bits,
-                              MarkdownLink* links, int linkCount,
-                              MarkdownHeading* headings, int headingCount,
-                              MarkdownStyle* styles, int styleCount,
-                              MarkdownBlockquote* blockquotes, int blockquoteCount,
-                              MarkdownColorTag* colorTags, int colorTagCount,
-                              MarkdownFontTag* fontTags, int fontTagCount) {
+static BOOL RenderTextMarkdown(const RECT* rect, const RenderCoreDocument* doc, const RenderContext* ctx,
+                               const int* scrollY, void* bits) {
     // Use STB Truetype for high-quality rendering
     char absoluteFontPath[MAX_PATH];
     
     // Resolve font path to absolute path for STB
     if (ResolveFontPath(ctx, absoluteFontPath)) {
         if (InitFontSTB(absoluteFontPath)) {
-            RenderMarkdownSTB(bits, rect->right, rect->bottom, text,
-                             links, linkCount,
-                             headings, headingCount,
-                             styles, styleCount,
-                             blockquotes, blockquoteCount,
-                             colorTags, colorTagCount,
-                             fontTags, fontTagCount,
-                             ctx->textColor, 
-                             (int)(CLOCK_BASE_FONT_SIZE * ctx->fontScaleFactor), 
-                             1.0f,
-                             ctx->gradientMode); // Internal scale is handled by font size
+            RenderCoreStyle style;
+            style.textColor = ctx->textColor;
+            style.gradientMode = ctx->gradientMode;
+            style.fontSize = (int)(CLOCK_BASE_FONT_SIZE * ctx->fontScaleFactor);
+            if (scrollY) {
+                RenderCore_DrawViewport(doc, &style, bits, rect->right, rect->bottom, *scrollY);
+            } else {
+                RenderCore_Draw(doc, &style, bits, rect->right, rect->bottom);
+            }
             return TRUE;
         }
     }
@@ -158,43 +179,6 @@ static BOOL RenderTextMarkdown(HDC hdc, const RECT* rect, const wchar_t* text, c
     return FALSE;
 }
 
-/** @note GM_ADVANCED + HALFTONE improve text quality on high-DPI displays */
-static BOOL SetupDoubleBufferDIB(HDC hdc, const RECT* rect, HDC* memDC, HBITMAP* memBitmap, HBITMAP* oldBitmap, void** ppvBits) {
-    *memDC = CreateCompatibleDC(hdc);
-    if (!*memDC) {
-        return FALSE;
-    }
-
-    BITMAPINFO bmi = {0};
-    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-    bmi.bmiHeader.biWidth = rect->right;
-    // Negative height creates a top-down DIB, matching STB's coordinate system
-    bmi.bmiHeader.biHeight = -rect->bottom;
-    bmi.bmiHeader.biPlanes = 1;
-    bmi.bmiHeader.biBitCount = 32;
-    bmi.bmiHeader.biCompression = BI_RGB;
-
-    *memBitmap = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, ppvBits, NULL, 0);
-    if (!*memBitmap) {
-        DeleteDC(*memDC);
-        return FALSE;
-    }
-
-    *oldBitmap = (HBITMAP)SelectObject(*memDC, *memBitmap);
-
-    SetGraphicsMode(*memDC, GM_ADVANCED);
-    SetBkMode(*memDC, TRANSPARENT);
-    SetStretchBltMode(*memDC, HALFTONE);
-    SetBrushOrgEx(*memDC, 0, 0, NULL);
-    SetTextAlign(*memDC, TA_LEFT | TA_TOP);
-    SetTextCharacterExtra(*memDC, 0);
-    SetMapMode(*memDC, MM_TEXT);
-    SetICMMode(*memDC, ICM_ON);
-    SetLayout(*memDC, 0);
-
-    return TRUE;
-}
-
 /** 
  * @brief Manually set alpha channel to opaque for non-black pixels
  * @details GDI text drawing leaves alpha channel as 0, which DWM treats as transparent.
@@ -246,122 +230,437 @@ static void AdjustWindowSize(HWND hwnd, const SIZE* textSize, RECT* rect) {
 // Global flag to suppress rendering during mode transitions
 BOOL g_IsTransitioning = FALSE;
 
+/* ============================================================================
+ * Scroll viewport - content taller than MAX_WINDOW_HEIGHT
+ * ============================================================================ */
+
+/**
+ * @brief Viewport of the last composed frame
+ * @note Heights come from the last paint; scrolling clamps against them
+ */
+static struct {
+    BOOL active;        /* Content taller than the window may grow */
+    int scrollY;        /* Content y at the top of the window */
+    int contentHeight;  /* Text plus images */
+    int viewHeight;     /* Client height */
+    int lineHeight;     /* Scroll step (base font pixel size) */
+    BOOL atEnd;         /* Scrolled to the end: stay there as content grows */
+} s_scroll = {0};
+
+static int ClampScroll(int scrollY) {
+    int maxScroll = s_scroll.contentHeight - s_scroll.viewHeight;
+    if (scrollY > maxScroll) scrollY = maxScroll;
+    if (scrollY < 0) scrollY = 0;
+    return scrollY;
+}
+
+/**
+ * @brief Switch to the viewport when content exceeds the height limit
+ * @param contentSize Measured content; height is cut to the limit when scrolling
+ */
+static void LimitContentHeight(SIZE* contentSize, int lineHeight) {
+    int maxHeight = g_AppConfig.display.max_window_height;
+    int maxContent = maxHeight - WINDOW_VERTICAL_PADDING;
+    if (maxHeight <= 0 || maxContent <= 0 || contentSize->cy <= maxContent) {
+        s_scroll.active = FALSE;
+        s_scroll.scrollY = 0;
+        s_scroll.atEnd = FALSE;
+        return;
+    }
+
+    s_scroll.active = TRUE;
+    s_scroll.contentHeight = contentSize->cy;
+    s_scroll.lineHeight = lineHeight > 0 ? lineHeight : 1;
+    contentSize->cy = maxContent;
+}
+
+/** @brief Clamp the scroll position to the window the content got */
+static void SetScrollViewHeight(int viewHeight) {
+    if (!s_scroll.active) return;
+    s_scroll.viewHeight = viewHeight;
+    s_scroll.scrollY = ClampScroll(s_scroll.atEnd ? INT_MAX : s_scroll.scrollY);
+}
+
+BOOL ScrollRenderedText(HWND hwnd, TextScrollUnit unit, int amount) {
+    if (!s_scroll.active) return FALSE;
+
+    int page = s_scroll.viewHeight - s_scroll.lineHeight;
+    if (page < s_scroll.lineHeight) page = s_scroll.lineHeight;
+
+    int target = s_scroll.scrollY;
+    switch (unit) {
+        case TEXT_SCROLL_WHEEL: {
+            UINT lines = 3;
+            SystemParametersInfoW(SPI_GETWHEELSCROLLLINES, 0, &lines, 0);
+            int step = (lines == WHEEL_PAGESCROLL) ? page : (int)lines * s_scroll.lineHeight;
+            target -= amount * step / WHEEL_DELTA;
+            break;
+        }
+        case TEXT_SCROLL_LINES:
+            target += amount * s_scroll.lineHeight;
+            break;
+        case TEXT_SCROLL_PAGES:
+            target += amount * page;
+            break;
+        case TEXT_SCROLL_EDGE:
+            target = (amount < 0) ? 0 : INT_MAX;
+            break;
+    }
+
+    target = ClampScroll(target);
+    s_scroll.atEnd = (target == ClampScroll(INT_MAX));
+    if (target != s_scroll.scrollY) {
+        s_scroll.scrollY = target;
+        InvalidateRect(hwnd, NULL, FALSE);
+    }
+    return TRUE;
+}
+
+BOOL IsRenderedTextScrollable(void) {
+    return s_scroll.active;
+}
+
+/* ============================================================================
+ * Frame signature - skip paints that would reproduce the last presented frame
+ * ============================================================================ */
+
+/**
+ * @brief Everything that influences the composed pixels
+ * @note Zero-initialized before filling so padding bytes hash deterministically
+ */
+typedef struct {
+    ULONGLONG textHash;
+    ULONGLONG fontHash;
+    COLORREF textColor;
+    int gradientMode;
+    uint32_t customGradientVersion;
+    float fontScaleFactor;
+    int baseFontSize;
+    int effect;
+    int effectQuality;
+    BOOL distanceFieldText;
+    BOOL editMode;
+    BOOL transitioning;
+    int opacity;
+    DWORD animPhase;
+    LONG width;
+    LONG height;
+    int scrollY;
+} FrameSignature;
+
+static FrameSignature s_lastFrameSig;
+static BOOL s_lastFrameSigValid = FALSE;
+static BOOL s_lastFrameHadColorTagGradient = FALSE;
+static DWORD s_framesRendered = 0;
+static DWORD s_framesSkipped = 0;
+
+/** @brief 64-bit FNV-1a */
+static ULONGLONG HashBytes(const void* data, size_t size, ULONGLONG hash) {
+    const BYTE* p = (const BYTE*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+#define FRAME_HASH_SEED 14695981039346656037ULL
+
+/**
+ * @return TRUE if output changes with time even when text does not
+ * @note Color tag gradients are only known after parsing; identical text
+ *       parses identically, so the previous frame's answer is reused
+ */
+static BOOL IsFrameTimeAnimated(const RenderContext* ctx, EffectType effect) {
+    if (IsEffectTimeDependent(effect)) return TRUE;
+    if (IsGradientAnimated((GradientType)ctx->gradientMode)) return TRUE;
+    return s_lastFrameHadColorTagGradient;
+}
+
+static void BuildFrameSignature(FrameSignature* sig, const wchar_t* text,
+                                const RenderContext* ctx, const RECT* rect) {
+    extern int CLOCK_WINDOW_OPACITY;
+    EffectType effect = GetActiveEffect();
+
+    memset(sig, 0, sizeof(*sig));
+    sig->textHash = HashBytes(text, wcslen(text) * sizeof(wchar_t), FRAME_HASH_SEED);
+    sig->fontHash = HashBytes(ctx->fontFileName, strlen(ctx->fontFileName), FRAME_HASH_SEED);
+    sig->textColor = ctx->textColor;
+    sig->gradientMode = ctx->gradientMode;
+    sig->customGradientVersion = GetCustomGradientVersion();
+    sig->fontScaleFactor = ctx->fontScaleFactor;
+    sig->baseFontSize = CLOCK_BASE_FONT_SIZE;
+    sig->effect = (int)effect;
+    sig->effectQuality = (int)GetEffectQuality();
+    sig->distanceFieldText = IsDistanceFieldTextSTB();
+    sig->editMode = CLOCK_EDIT_MODE;
+    sig->transitioning = g_IsTransitioning;
+    sig->opacity = CLOCK_WINDOW_OPACITY;
+    sig->animPhase = IsFrameTimeAnimated(ctx, effect) ? GetTickCount() : 0;
+    sig->width = rect->right;
+    sig->height = rect->bottom;
+    sig->scrollY = s_scroll.active ? s_scroll.scrollY : 0;
+}
+
+void InvalidateRenderedFrame(void) {
+    s_lastFrameSigValid = FALSE;
+}
+
+void LogRenderStats(void) {
+    DWORD paints = s_framesRendered + s_framesSkipped;
+    LOG_INFO("Paint frames: %lu rendered, %lu skipped as unchanged (%.1f%%)",
+             s_framesRendered, s_framesSkipped, paints ? 100.0 * s_framesSkipped / paints : 0.0);
+
+    DWORD hits = 0, misses = 0;
+    SIZE_T bytes = 0;
+    GlyphCache_GetStats(&hits, &misses, &bytes);
+    DWORD lookups = hits + misses;
+    LOG_INFO("Glyph cache: %lu hits, %lu misses (%.1f%% hit rate), %lu KB held",
+             hits, misses, lookups ? 100.0 * hits / lookups : 0.0, (unsigned long)(bytes / 1024));
+
+    RenderCore_GetParseCacheStats(&hits, &misses);
+    lookups = hits + misses;
+    LOG_INFO("Markdown parse memo: %lu hits, %lu misses (%.1f%% hit rate)",
+             hits, misses, lookups ? 100.0 * hits / lookups : 0.0);
+
+    OutlineCache_GetStats(&hits, &misses, &bytes);
+    lookups = hits + misses;
+    LOG_INFO("Outline cache: %lu hits, %lu misses (%.1f%% hit rate), %lu KB held",
+             hits, misses, lookups ? 100.0 * hits / lookups : 0.0, (unsigned long)(bytes / 1024));
+
+    static const char* const LEVEL_NAMES[] = { "configured", "half", "quarter", "suspended" };
+    FrameGovernorStats governor;
+    FrameGovernor_GetStats(&governor);
+    LOG_INFO("Frame governor: %lu frames, %.2f ms average (parse %.2f, layout %.2f, raster %.2f, "
+             "effect %.2f, present %.2f), CPU %.1f%% of %.1f%% budget, interval %u ms, effects %s",
+             governor.frames, governor.frameMs,
+             governor.stageMs[FRAME_STAGE_PARSE], governor.stageMs[FRAME_STAGE_LAYOUT],
+             governor.stageMs[FRAME_STAGE_RASTER], governor.stageMs[FRAME_STAGE_EFFECT],
+             governor.stageMs[FRAME_STAGE_PRESENT], governor.cpuPercent, governor.budgetPercent,
+             governor.animationInterval, LEVEL_NAMES[governor.level]);
+}
+
+/* Back buffer reused across paints (DC + DIB survive until size changes) */
+static RenderSurface s_surface = {0};
+
+/**
+ * @brief Push the back buffer to the layered window at its current position
+ * @return TRUE if UpdateLayeredWindow succeeded
+ */
+static BOOL PresentSurface(HWND hwnd, int width, int height) {
+    HDC hdcScreen = GetDC(NULL);
+    if (!hdcScreen) return FALSE;
+    POINT ptSrc = {0, 0};
+    SIZE sizeWnd = {width, height};
+    POINT ptDst = {0, 0};
+    
+    RECT rcWindow;
+    GetWindowRect(hwnd, &rcWindow);
+    ptDst.x = rcWindow.left;
+    ptDst.y = rcWindow.top;
+    
+    extern int CLOCK_WINDOW_OPACITY;
+    BYTE alpha = (BYTE)((CLOCK_WINDOW_OPACITY * 255) / 100);
+    
+    BLENDFUNCTION blend = {0};
+    blend.BlendOp = AC_SRC_OVER;
+    blend.BlendFlags = 0;
+    blend.SourceConstantAlpha = alpha;
+    blend.AlphaFormat = AC_SRC_ALPHA;
+
+    BOOL presented = UpdateLayeredWindow(hwnd, hdcScreen, &ptDst, &sizeWnd, s_surface.memDC, &ptSrc, 0, &blend, ULW_ALPHA);
+    if (!presented) {
+        DWORD err = GetLastError();
+        if (err == ERROR_INVALID_PARAMETER) {
+            // Error 87 often implies conflict between SetLayeredWindowAttributes and UpdateLayeredWindow
+            // Reset WS_EX_LAYERED style to clear the internal state
+            LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
+            SetWindowLong(hwnd, GWL_EXSTYLE, exStyle & ~WS_EX_LAYERED);
+            SetWindowLong(hwnd, GWL_EXSTYLE, exStyle | WS_EX_LAYERED);
+            
+            // Retry update
+            presented = UpdateLayeredWindow(hwnd, hdcScreen, &ptDst, &sizeWnd, s_surface.memDC, &ptSrc, 0, &blend, ULW_ALPHA);
+            if (!presented) {
+                err = GetLastError();
+                WriteLog(LOG_LEVEL_ERROR, "UpdateLayeredWindow failed retry! Error code: %lu", err);
+            }
+        } else {
+            WriteLog(LOG_LEVEL_ERROR, "UpdateLayeredWindow failed! Error code: %lu", err);
+        }
+    }
+    
+    ReleaseDC(NULL, hdcScreen);
+    return presented;
+}
+
+/* Last full-quality frame, stretched to the client size during a scale gesture */
+static struct {
+    BOOL active;
+    DWORD* frame;
+    int width;
+    int height;
+} s_interim = {0};
+
+void BeginInterimScale(void) {
+    if (s_interim.active) return;
+    s_interim.active = TRUE;
+
+    /* Without a presented frame there is nothing to stretch; paint normally */
+    if (!s_lastFrameSigValid || !s_surface.bits) return;
+
+    size_t bytes = (size_t)s_surface.width * (size_t)s_surface.height * sizeof(DWORD);
+    s_interim.frame = (DWORD*)malloc(bytes);
+    if (!s_interim.frame) return;
+    memcpy(s_interim.frame, s_surface.bits, bytes);
+    s_interim.width = s_surface.width;
+    s_interim.height = s_surface.height;
+}
+
+void EndInterimScale(void) {
+    if (!s_interim.active) return;
+    free(s_interim.frame);
+    memset(&s_interim, 0, sizeof(s_interim));
+    /* The window holds a stretched frame; compose the real one */
+    s_lastFrameSigValid = FALSE;
+}
+
+BOOL IsInterimScaleActive(void) {
+    return s_interim.active;
+}
+
+/**
+ * @brief Present the gesture snapshot resized to the client area
+ * @return FALSE if the caller should compose a full frame instead
+ */
+static BOOL PaintInterimFrame(HWND hwnd, HDC hdc, const RECT* rect) {
+    if (!s_interim.frame || rect->right <= 0 || rect->bottom <= 0) return FALSE;
+
+    LONGLONG traceStart = Trace_Begin();
+    PROBE_START(scaleStart);
+    if (!RenderSurface_Prepare(&s_surface, hdc, rect->right, rect->bottom) ||
+        !BlendKernels_ScaleImage(BlendKernels_Get(), (DWORD*)s_surface.bits, rect->right, rect->bottom,
+                                 s_interim.frame, s_interim.width, s_interim.height)) {
+        return FALSE;
+    }
+    PROBE_END(PROBE_INTERIM_SCALE, scaleStart);
+
+    PROBE_START(presentStart);
+    PresentSurface(hwnd, rect->right, rect->bottom);
+    PROBE_END(PROBE_PRESENT, presentStart);
+    s_lastFrameSigValid = FALSE;
+    Trace_End("Paint (interim scale)", traceStart);
+    return TRUE;
+}
+
+void CleanupDrawingRender(void) {
+    EndInterimScale();
+    RenderSurface_Destroy(&s_surface);
+    free(s_pluginText);
+    s_pluginText = NULL;
+    s_pluginTextCapacity = 0;
+    s_lastFrameSigValid = FALSE;
+}
+
 void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps) {
     wchar_t timeText[TIME_TEXT_MAX_LEN];
+    const wchar_t* paintText = timeText;
     HDC hdc = ps->hdc;
     RECT rect;
     GetClientRect(hwnd, &rect);
 
+    /* Scale gesture in progress: stretch the last frame, compose once it settles */
+    if (s_interim.active && PaintInterimFrame(hwnd, hdc, &rect)) {
+        return;
+    }
+
+    FrameGovernor_BeginFrame();
+    PROBE_START(paintStart);
+    LONGLONG traceStart = Trace_Begin();
+
     // If transitioning, skip text generation to avoid artifacts
-    // We still need to clear the window to transparent, so we proceed to SetupDoubleBufferDIB
+    // We still need to clear the window to transparent, so we proceed to RenderSurface_Prepare
     // but we will skip RenderText later.
     
+    PROBE_START(timeTextStart);
     GetTimeText(timeText, TIME_TEXT_MAX_LEN);
+    PROBE_END(PROBE_TIME_TEXT, timeTextStart);
 
     // Check for plugin data
-    wchar_t pluginText[TIME_TEXT_MAX_LEN] = {0};
+    PROBE_START(pluginStart);
     MarkdownImage* images = NULL;
     int imageCount = 0;
-    
-    if (PluginData_GetText(pluginText, TIME_TEXT_MAX_LEN)) {
-        // Get current time text once
-        wchar_t savedTime[256];
-        GetTimeText(savedTime, 256);
-        
-        // First pass: extract images and count them
-        int imgCapacity = CountMarkdownImages(pluginText);
-        if (imgCapacity > 0) {
-            images = (MarkdownImage*)calloc(imgCapacity, sizeof(MarkdownImage));
+    PluginTextRange pluginTimeRanges[PAINT_MAX_TIME_RANGES];
+    int pluginTimeRangeCount = 0;
+    
+    /* Compiled once per plugin text change; each frame only splices the time in */
+    const PluginTemplate* pluginTemplate = PluginData_GetTemplate();
+    if (pluginTemplate) {
+        if (pluginTemplate->imageCount > 0) {
+            images = (MarkdownImage*)calloc(pluginTemplate->imageCount, sizeof(MarkdownImage));
         }
         
-        // Replace ALL <catime></catime> tags and extract ![](path) images
-        wchar_t result[TIME_TEXT_MAX_LEN] = {0};
-        wchar_t* src = pluginText;
-        wchar_t* dst = result;
-        size_t remaining = TIME_TEXT_MAX_LEN - 1;
-        
-        while (*src && remaining > 0) {
-            // Check for image tag first: ![...](...)
-            if (*src == L'!' && *(src + 1) == L'[' && images && imageCount < imgCapacity) {
-                const wchar_t* imgSrc = src;
-                if (ExtractMarkdownImage(&imgSrc, images, &imageCount, imgCapacity, (int)(dst - result))) {
-                    src = (wchar_t*)imgSrc;
-                    continue;
-                }
-            }
-            
-            // Check for <catime> tag
-            wchar_t* tagStart = wcsstr(src, L"<catime>");
-            wchar_t* tagEnd = tagStart ? wcsstr(tagStart, L"</catime>") : NULL;
-            
-            if (tagStart && tagEnd && tagEnd > tagStart && tagStart == src) {
-                // Insert time text
-                size_t timeLen = wcslen(savedTime);
-                if (timeLen > remaining) timeLen = remaining;
-                wcsncpy(dst, savedTime, timeLen);
-                dst += timeLen;
-                remaining -= timeLen;
-                
-                // Move past </catime>
-                src = tagEnd + 9;
-            } else if (tagStart && tagEnd && tagEnd > tagStart) {
-                // Copy text before tag
-                size_t beforeLen = tagStart - src;
-                if (beforeLen > remaining) beforeLen = remaining;
-                wcsncpy(dst, src, beforeLen);
-                dst += beforeLen;
-                remaining -= beforeLen;
-                
-                // Insert time text
-                size_t timeLen = wcslen(savedTime);
-                if (timeLen > remaining) timeLen = remaining;
-                wcsncpy(dst, savedTime, timeLen);
-                dst += timeLen;
-                remaining -= timeLen;
-                
-                // Move past </catime>
-                src = tagEnd + 9;
-            } else {
-                // Copy single character
-                *dst++ = *src++;
-                remaining--;
-            }
+        /* Literals never exceed the source; every time slot gets the time text */
+        size_t capacity = (size_t)pluginTemplate->sourceLength +
+                          (size_t)pluginTemplate->timeSlotCount * wcslen(timeText) + 1;
+        wchar_t* result = ReservePluginText(capacity);
+        if (result) {
+            PluginTemplate_Expand(pluginTemplate, timeText, result, capacity, images, &imageCount,
+                                  pluginTimeRanges, PAINT_MAX_TIME_RANGES, &pluginTimeRangeCount);
+            paintText = result;
+        } else {
+            pluginTemplate = NULL;  /* Out of memory: show the time alone */
         }
-        *dst = L'\0';
-        
-        wcscpy_s(timeText, TIME_TEXT_MAX_LEN, result);
     }
+    PROBE_END(PROBE_PLUGIN_SUBST, pluginStart);
 
-    if (wcslen(timeText) == 0) {
+    if (paintText[0] == L'\0') {
         GetPreviewTimeText(timeText, TIME_TEXT_MAX_LEN);
+        paintText = timeText;
+        pluginTemplate = NULL;
     }
 
     RenderContext ctx = CreateRenderContext();
 
+    /* Layered window keeps its last UpdateLayeredWindow content, so an
+     * identical frame needs neither composition nor present.
+     * Image frames always render (download state is not part of the key). */
+    FrameSignature frameSig;
+    BuildFrameSignature(&frameSig, paintText, &ctx, &rect);
+    if (!images && s_lastFrameSigValid &&
+        memcmp(&frameSig, &s_lastFrameSig, sizeof(frameSig)) == 0) {
+        s_framesSkipped++;
+        FrameGovernor_CancelFrame();
+        Trace_End("Paint (unchanged)", traceStart);
+        return;
+    }
+
     // Parse Markdown
-    wchar_t* mdText = NULL;
-    MarkdownLink* links = NULL; int linkCount = 0;
-    MarkdownHeading* headings = NULL; int headingCount = 0;
-    MarkdownStyle* styles = NULL; int styleCount = 0;
-    MarkdownListItem* listItems = NULL; int listItemCount = 0;
-    MarkdownBlockquote* blockquotes = NULL; int blockquoteCount = 0;
-    MarkdownColorTag* colorTags = NULL; int colorTagCount = 0;
-    MarkdownFontTag* fontTags = NULL; int fontTagCount = 0;
-
-    BOOL isMarkdown = ParseMarkdownLinks(timeText, &mdText, 
-                                         &links, &linkCount, 
-                                         &headings, &headingCount, 
-                                         &styles, &styleCount,
-                                         &listItems, &listItemCount,
-                                         &blockquotes, &blockquoteCount,
-                                         &colorTags, &colorTagCount,
-                                         &fontTags, &fontTagCount);
-                                         
-    const wchar_t* textToRender = isMarkdown ? mdText : timeText;
+    RenderCoreDocument doc;
+    PROBE_START(parseStart);
+    /* Time digits are masked in the parse memo key, so ticking reuses the parse */
+    RenderCoreTextRange timeRanges[PAINT_MAX_TIME_RANGES];
+    int timeRangeCount = 0;
+    if (pluginTemplate) {
+        for (; timeRangeCount < pluginTimeRangeCount; timeRangeCount++) {
+            timeRanges[timeRangeCount].start = pluginTimeRanges[timeRangeCount].start;
+            timeRanges[timeRangeCount].length = pluginTimeRanges[timeRangeCount].length;
+        }
+    } else {
+        timeRanges[0].start = 0;
+        timeRanges[0].length = (int)wcslen(timeText);
+        timeRangeCount = 1;
+    }
+    RenderCore_ParseWithTime(paintText, timeRanges, timeRangeCount, &doc);
+    const wchar_t* textToRender = doc.text;
+    PROBE_END(PROBE_MARKDOWN_PARSE, parseStart);
+    FrameGovernor_EndStage(FRAME_STAGE_PARSE);
+
+    PROBE_START(measureStart);
 
     // Measure text and resize window BEFORE creating the buffer
     // This prevents buffer overflow if the window grows
     SIZE textSize = {0};
+    int measuredTextHeight = 0;  /* Text-only height, before image space is added */
     BOOL hasContent = (wcslen(textToRender) > 0) || (images && imageCount > 0);
     
     if (hasContent) {
@@ -369,16 +668,14 @@ void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps) {
         
         // Measure text if any
         if (wcslen(textToRender) > 0) {
-            if (isMarkdown) {
-                measured = MeasureTextMarkdown(textToRender, &ctx, &textSize, headings, headingCount);
-            } else {
-                measured = MeasureTextMarkdown(textToRender, &ctx, &textSize, NULL, 0);
-            }
+            measured = MeasureTextMarkdown(&doc, &ctx, &textSize);
 
             // If measurement failed, use default size
             if (!measured) {
                 textSize.cx = 100;
                 textSize.cy = 30;
+            } else {
+                measuredTextHeight = textSize.cy;
             }
         }
         
@@ -402,83 +699,71 @@ void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps) {
             }
         }
 
+        /* Content taller than MAX_WINDOW_HEIGHT scrolls inside the window */
+        LimitContentHeight(&textSize, (int)(CLOCK_BASE_FONT_SIZE * ctx.fontScaleFactor));
         AdjustWindowSize(hwnd, &textSize, &rect);
+        SetScrollViewHeight(rect.bottom);
+    } else {
+        s_scroll.active = FALSE;
     }
+    PROBE_END(PROBE_MEASURE, measureStart);
+    FrameGovernor_EndStage(FRAME_STAGE_LAYOUT);
     
-    HDC memDC;
-    HBITMAP memBitmap, oldBitmap;
-    void* pBits = NULL;
-    
-    // Create buffer with the final correct size
-    if (!SetupDoubleBufferDIB(hdc, &rect, &memDC, &memBitmap, &oldBitmap, &pBits)) {
-        if (isMarkdown) {
-            FreeMarkdownLinks(links, linkCount);
-            free(headings); free(styles); free(listItems); free(blockquotes);
-            free(colorTags); free(fontTags);
-            free(mdText);
-        }
+    // Reuse back buffer at the final correct size
+    PROBE_START(surfaceStart);
+    if (!RenderSurface_Prepare(&s_surface, hdc, rect.right, rect.bottom)) {
+        RenderCore_FreeDocument(&doc);
         if (images) {
             FreeMarkdownImages(images, imageCount);
         }
+        FrameGovernor_CancelFrame();
         return;
     }
     
-    // Manually clear background
-    // Edit Mode: Alpha=5 to capture mouse click on background
-    // Normal Mode: Alpha=0 for full transparency (clickable regions filled later)
-    int numPixels = rect.right * rect.bottom;
+    HDC memDC = s_surface.memDC;
+    void* pBits = s_surface.bits;
     DWORD* pixels = (DWORD*)pBits;
-    DWORD clearColor = CLOCK_EDIT_MODE ? 0x05000000 : 0x00000000;
     
-    // Simple loop is fast enough for small window
-    for (int i = 0; i < numPixels; i++) {
-        pixels[i] = clearColor;
-    }
+    // Manually clear background
+    // Edit Mode: Alpha=5 to capture mouse click on background
+    // Normal Mode: Alpha=0 for full transparency (clickable regions filled later),
+    // minimal alpha over a scrolling viewport so the wheel reaches the window
+    RenderSurface_Clear(&s_surface, CLOCK_EDIT_MODE ? 0x05000000 : (s_scroll.active ? 0x01000000 : 0x00000000));
+    PROBE_END(PROBE_DIB_SETUP, surfaceStart);
     
     // Skip rendering during transition to avoid black artifacts
     if (!g_IsTransitioning && hasContent) {
-        int textHeight = 0;
+        /* Measured above; the layout is cached so rendering reuses it */
+        int textHeight = measuredTextHeight;
         
         // Render text if any
         if (wcslen(textToRender) > 0) {
             RECT textRect = rect;
-            SIZE textSizeMeasured = {0};
-            
-            if (isMarkdown) {
-                MeasureTextMarkdown(textToRender, &ctx, &textSizeMeasured, headings, headingCount);
-            } else {
-                MeasureTextMarkdown(textToRender, &ctx, &textSizeMeasured, NULL, 0);
-            }
-            
-            if (textSizeMeasured.cy > 0) {
-                textHeight = textSizeMeasured.cy;
-            }
+            PROBE_START(rasterStart);
             
-            if (isMarkdown) {
-                RenderTextMarkdown(memDC, &textRect, textToRender, &ctx, CLOCK_EDIT_MODE, pBits,
-                                  links, linkCount, headings, headingCount, styles, styleCount,
-                                  blockquotes, blockquoteCount, colorTags, colorTagCount,
-                                  fontTags, fontTagCount);
-            } else {
-                RenderTextMarkdown(memDC, &textRect, textToRender, &ctx, CLOCK_EDIT_MODE, pBits,
-                                  NULL, 0, NULL, 0, NULL, 0, NULL, 0, NULL, 0, NULL, 0);
-            }
+            RenderTextMarkdown(&textRect, &doc, &ctx, s_scroll.active ? &s_scroll.scrollY : NULL, pBits);
+            PROBE_END(PROBE_RASTERIZE, rasterStart);
         }
         
         // Fill clickable regions with minimal alpha for mouse hit-testing (non-edit mode only)
         if (!CLOCK_EDIT_MODE) {
             extern void FillClickableRegionsAlpha(DWORD* pixels, int width, int height);
+            PROBE_START(hitStart);
             FillClickableRegionsAlpha(pixels, rect.right, rect.bottom);
+            PROBE_END(PROBE_HIT_REGIONS, hitStart);
         }
         
         // Render images below text (centered horizontally like text)
         if (images && imageCount > 0) {
+            PROBE_START(imageStart);
             int imgY = textHeight > 0 ? textHeight + 5 : 5;
             int maxW = rect.right - 10;
             if (maxW <= 0) maxW = rect.right;  // Fallback if window too narrow
+            if (s_scroll.active) imgY -= s_scroll.scrollY;
             
             for (int i = 0; i < imageCount; i++) {
-                int maxH = rect.bottom - imgY - 5;
+                /* A scrolling viewport shows images at their natural size, clipped */
+                int maxH = s_scroll.active ? (imgY < rect.bottom ? 10000 : 0) : rect.bottom - imgY - 5;
                 if (maxH <= 0) break;  // No more space for images
                 
                 // Check if network image needs async download
@@ -515,114 +800,61 @@ void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps) {
                     imgY += imgHeight + 5;
                 }
             }
+            PROBE_END(PROBE_IMAGE_DRAW, imageStart);
         }
     } else if (CLOCK_EDIT_MODE) {
         FixAlphaChannel(pBits, rect.right, rect.bottom);
     }
     
     /* Check if any color tag has gradient (multiple colors) before freeing */
-    BOOL hasColorTagGradient = FALSE;
-    if (colorTags && colorTagCount > 0) {
-        for (int i = 0; i < colorTagCount; i++) {
-            if (colorTags[i].colorCount > 1) {
-                hasColorTagGradient = TRUE;
-                break;
-            }
-        }
-    }
+    BOOL hasColorTagGradient = RenderCore_HasColorTagGradient(&doc);
+    s_lastFrameHadColorTagGradient = hasColorTagGradient;
     
     // Free markdown resources
-    if (isMarkdown) {
-        FreeMarkdownLinks(links, linkCount);
-        free(headings); free(styles); free(listItems); free(blockquotes);
-        free(colorTags); free(fontTags);
-        free(mdText);
-    }
+    RenderCore_FreeDocument(&doc);
     
     // Free image resources
     if (images) {
         FreeMarkdownImages(images, imageCount);
     }
     
-    HDC hdcScreen = GetDC(NULL);
-    if (!hdcScreen) {
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
-        return;
-    }
-    POINT ptSrc = {0, 0};
-    SIZE sizeWnd = {rect.right, rect.bottom};
-    POINT ptDst = {0, 0};
-    
-    RECT rcWindow;
-    GetWindowRect(hwnd, &rcWindow);
-    ptDst.x = rcWindow.left;
-    ptDst.y = rcWindow.top;
-    
-    extern int CLOCK_WINDOW_OPACITY;
-    BYTE alpha = (BYTE)((CLOCK_WINDOW_OPACITY * 255) / 100);
-    
-    BLENDFUNCTION blend = {0};
-    blend.BlendOp = AC_SRC_OVER;
-    blend.BlendFlags = 0;
-    blend.SourceConstantAlpha = alpha;
-    blend.AlphaFormat = AC_SRC_ALPHA;
+    FrameGovernor_EndStage(FRAME_STAGE_RASTER);
 
-    if (!UpdateLayeredWindow(hwnd, hdcScreen, &ptDst, &sizeWnd, memDC, &ptSrc, 0, &blend, ULW_ALPHA)) {
-        DWORD err = GetLastError();
-        if (err == ERROR_INVALID_PARAMETER) {
-            // Error 87 often implies conflict between SetLayeredWindowAttributes and UpdateLayeredWindow
-            // Reset WS_EX_LAYERED style to clear the internal state
-            LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
-            SetWindowLong(hwnd, GWL_EXSTYLE, exStyle & ~WS_EX_LAYERED);
-            SetWindowLong(hwnd, GWL_EXSTYLE, exStyle | WS_EX_LAYERED);
-            
-            // Retry update
-            if (!UpdateLayeredWindow(hwnd, hdcScreen, &ptDst, &sizeWnd, memDC, &ptSrc, 0, &blend, ULW_ALPHA)) {
-                err = GetLastError();
-                WriteLog(LOG_LEVEL_ERROR, "UpdateLayeredWindow failed retry! Error code: %lu", err);
-            }
-        } else {
-            WriteLog(LOG_LEVEL_ERROR, "UpdateLayeredWindow failed! Error code: %lu", err);
-        }
+    PROBE_START(presentStart);
+    LONGLONG tracePresent = Trace_Begin();
+    BOOL presented = PresentSurface(hwnd, rect.right, rect.bottom);
+    PROBE_END(PROBE_PRESENT, presentStart);
+    Trace_End("UpdateLayeredWindow", tracePresent);
+    FrameGovernor_EndStage(FRAME_STAGE_PRESENT);
+    FrameGovernor_EndFrame(frameSig.effect != EFFECT_TYPE_NONE || FrameGovernor_EffectsSuspended());
+    
+    /* Window may have been resized to fit the text; key on the final size */
+    frameSig.width = rect.right;
+    frameSig.height = rect.bottom;
+    frameSig.scrollY = s_scroll.active ? s_scroll.scrollY : 0;
+    s_lastFrameSig = frameSig;
+    s_lastFrameSigValid = presented;
+    s_framesRendered++;
+    PROBE_END(PROBE_PAINT_TOTAL, paintStart);
+    Trace_End("Paint", traceStart);
+    
+    if (((s_framesRendered + s_framesSkipped) % 3000) == 0) {
+        LOG_DEBUG("Paint frames: %lu rendered, %lu skipped (unchanged)",
+                  s_framesRendered, s_framesSkipped);
     }
     
-    ReleaseDC(NULL, hdcScreen);
-    
-    SelectObject(memDC, oldBitmap);
-    DeleteObject(memBitmap);
-    DeleteDC(memDC);
-    
-    /* Dynamic timer interval adjustment based on current window size */
-    /* This ensures smooth animation for small windows, reduced lag for large windows */
-    BOOL needsAnimationTimer = CLOCK_LIQUID_EFFECT || CLOCK_HOLOGRAPHIC_EFFECT ||
-                               CLOCK_NEON_EFFECT || CLOCK_GLOW_EFFECT || CLOCK_GLASS_EFFECT ||
-                               hasColorTagGradient;
+    /* Dynamic timer interval adjustment based on measured paint cost */
+    /* Cheap frames animate smoothly; expensive ones are spaced to fit the budget */
+    /* Static effects are served from the frame signature and effect cache */
+    BOOL needsAnimationTimer = IsEffectTimeDependent(GetActiveEffect()) || hasColorTagGradient;
     
     /* Track if color tag gradient timer was set by us (not by effect settings) */
     static BOOL s_colorTagTimerActive = FALSE;
+    static UINT s_lastInterval = 0;
     
     if (needsAnimationTimer) {
-        static UINT s_lastInterval = 0;
-        int pixelCount = rect.right * rect.bottom;
-        
-        /* Holographic effect is significantly heavier (double Gaussian blur + per-pixel HSV)
-         * and needs more aggressive throttling to prevent mouse lag */
-        UINT newInterval;
-        if (CLOCK_HOLOGRAPHIC_EFFECT) {
-            newInterval = (pixelCount < 30000) ? 50 : 
-                          (pixelCount < 100000) ? 80 : 
-                          (pixelCount < 300000) ? 120 : 200;
-        } else if (hasColorTagGradient) {
-            /* Color tag gradient animation - use moderate interval */
-            newInterval = (pixelCount < 50000) ? 33 : 
-                          (pixelCount < 200000) ? 50 : 80;
-        } else {
-            newInterval = (pixelCount < 50000) ? 33 : 
-                          (pixelCount < 200000) ? 50 : 
-                          (pixelCount < 500000) ? 80 : 120;
-        }
+        /* Paced from measured paint cost to stay within the CPU budget */
+        UINT newInterval = FrameGovernor_AnimationInterval();
         
         if (newInterval != s_lastInterval) {
             SetTimer(hwnd, TIMER_ID_RENDER_ANIMATION, newInterval, NULL);
@@ -632,13 +864,11 @@ void HandleWindowPaint(HWND hwnd, PAINTSTRUCT* ps) {
         if (hasColorTagGradient) {
             s_colorTagTimerActive = TRUE;
         }
-    } else if (s_colorTagTimerActive) {
-        /* Color tag gradient is gone, but we set the timer for it - kill it
-         * Only if no other effects need the timer */
-        if (!CLOCK_LIQUID_EFFECT && !CLOCK_HOLOGRAPHIC_EFFECT &&
-            !CLOCK_NEON_EFFECT && !CLOCK_GLOW_EFFECT && !CLOCK_GLASS_EFFECT) {
-            KillTimer(hwnd, TIMER_ID_RENDER_ANIMATION);
-        }
+    } else if (s_colorTagTimerActive || s_lastInterval != 0) {
+        /* Nothing animates any more (color tag gradient gone, effect
+         * static or suspended by the governor) - stop the timer */
+        KillTimer(hwnd, TIMER_ID_RENDER_ANIMATION);
+        s_lastInterval = 0;
         s_colorTagTimerActive = FALSE;
     }
 }
@@ -0,0 +1,452 @@
+/**
+ * @file drawing_render_core.c
+ * @brief Markdown parse, measure and STB rasterization without a window
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "drawing/drawing_render_core.h"
+#include "drawing/drawing_markdown_stb.h"
+#include "drawing/drawing_text_stb.h"
+
+/** @brief Private-use stand-in for time digits in memo keys */
+#define PARSE_DIGIT_MASK L'\xE000'
+
+typedef struct RenderCoreParseEntry {
+    BOOL used;
+    BOOL masked;            /* Key has the time digits masked */
+    BOOL patchable;         /* Masked key verified; FALSE marks it exact-only */
+    ULONGLONG hash;
+    wchar_t* key;
+    int keyLength;
+    RenderCoreDocument parsed;  /* Arrays and display text, owned by the entry */
+    int* digitPositions;    /* Display positions of the masked digits, in order */
+    int digitCount;
+    int refs;               /* Documents currently sharing parsed */
+    DWORD lastUse;
+} RenderCoreParseEntry;
+
+static BOOL g_timePinned = FALSE;
+static DWORD g_pinnedTime = 0;
+
+static RenderCoreParseEntry g_parseCache[RENDER_CORE_PARSE_CACHE_ENTRIES];
+static DWORD g_parseClock = 0;
+static DWORD g_parseHits = 0;
+static DWORD g_parseMisses = 0;
+
+static wchar_t* g_maskScratch = NULL;
+static int g_maskScratchLength = 0;
+
+/* ============================================================================
+ * Parse memo
+ * ============================================================================ */
+
+/** @brief 64-bit multiplicative hash, eight bytes per step */
+static ULONGLONG HashText(const wchar_t* text, int length) {
+    const unsigned char* p = (const unsigned char*)text;
+    size_t bytes = (size_t)length * sizeof(wchar_t);
+    ULONGLONG h = 0x9E3779B97F4A7C15ULL ^ (ULONGLONG)bytes;
+
+    while (bytes >= 8) {
+        ULONGLONG chunk;
+        memcpy(&chunk, p, 8);
+        h = (h ^ chunk) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+        p += 8;
+        bytes -= 8;
+    }
+    while (bytes > 0) {
+        h = (h ^ *p++) * 0x100000001B3ULL;
+        bytes--;
+    }
+    return h ^ (h >> 29);
+}
+
+static void ParseUncached(const wchar_t* text, RenderCoreDocument* doc) {
+    memset(doc, 0, sizeof(*doc));
+    MarkdownDocument md;
+    doc->isMarkdown = ParseMarkdownDocument(text, &md);
+    if (!doc->isMarkdown) {
+        doc->text = text;
+        return;
+    }
+    doc->text = md.displayText;
+    doc->links = md.links; doc->linkCount = md.linkCount;
+    doc->headings = md.headings; doc->headingCount = md.headingCount;
+    doc->styles = md.styles; doc->styleCount = md.styleCount;
+    doc->listItems = md.listItems; doc->listItemCount = md.listItemCount;
+    doc->blockquotes = md.blockquotes; doc->blockquoteCount = md.blockquoteCount;
+    doc->colorTags = md.colorTags; doc->colorTagCount = md.colorTagCount;
+    doc->fontTags = md.fontTags; doc->fontTagCount = md.fontTagCount;
+    doc->arena = md.arena;
+
+    /* Without runs the text still draws, just unstyled */
+    StyleRuns_Build(&doc->runs, &doc->arena, (int)wcslen(doc->text),
+                    doc->links, doc->linkCount, doc->styles, doc->styleCount,
+                    doc->colorTags, doc->colorTagCount, doc->fontTags, doc->fontTagCount);
+}
+
+static void FreeParsed(RenderCoreDocument* doc) {
+    FreeMarkdownArena(&doc->arena);
+    free(doc->ownedText);
+    memset(doc, 0, sizeof(*doc));
+}
+
+static void ReleaseEntry(RenderCoreParseEntry* e) {
+    FreeParsed(&e->parsed);
+    free(e->key);
+    free(e->digitPositions);
+    memset(e, 0, sizeof(*e));
+}
+
+static RenderCoreParseEntry* FindEntry(const wchar_t* key, int length, ULONGLONG hash, BOOL masked) {
+    for (int i = 0; i < RENDER_CORE_PARSE_CACHE_ENTRIES; i++) {
+        RenderCoreParseEntry* e = &g_parseCache[i];
+        if (e->used && e->masked == masked && e->hash == hash && e->keyLength == length &&
+            wmemcmp(e->key, key, (size_t)length) == 0) {
+            e->lastUse = ++g_parseClock;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Claim a slot for a new key: free, else least recently used unreferenced
+ * @return NULL when every entry is referenced (caller parses uncached)
+ */
+static RenderCoreParseEntry* ClaimEntry(const wchar_t* key, int length, ULONGLONG hash, BOOL masked) {
+    RenderCoreParseEntry* victim = NULL;
+    for (int i = 0; i < RENDER_CORE_PARSE_CACHE_ENTRIES; i++) {
+        RenderCoreParseEntry* e = &g_parseCache[i];
+        if (!e->used) {
+            victim = e;
+            break;
+        }
+        if (e->refs == 0 && (!victim || e->lastUse < victim->lastUse)) victim = e;
+    }
+    if (!victim) return NULL;
+    if (victim->used) ReleaseEntry(victim);
+
+    victim->key = (wchar_t*)malloc((size_t)length * sizeof(wchar_t) + sizeof(wchar_t));
+    if (!victim->key) return NULL;
+    wmemcpy(victim->key, key, (size_t)length);
+    victim->key[length] = L'\0';
+    victim->keyLength = length;
+    victim->hash = hash;
+    victim->masked = masked;
+    victim->used = TRUE;
+    victim->lastUse = ++g_parseClock;
+    return victim;
+}
+
+/** @brief Point doc at the entry's arrays; text is supplied by the caller */
+static void ShareEntry(RenderCoreParseEntry* e, RenderCoreDocument* doc) {
+    *doc = e->parsed;
+    doc->ownedText = NULL;
+    memset(&doc->arena, 0, sizeof(doc->arena));
+    doc->shared = e;
+    e->refs++;
+}
+
+/** @brief Parse into a new exact-key entry, or straight into doc without a free slot */
+static void ParseExact(const wchar_t* text, int length, ULONGLONG hash, RenderCoreDocument* doc) {
+    g_parseMisses++;
+
+    RenderCoreDocument parsed;
+    ParseUncached(text, &parsed);
+    /* Results that borrow the input cannot outlive it */
+    RenderCoreParseEntry* e = parsed.isMarkdown ?
+                              ClaimEntry(text, length, hash, FALSE) : NULL;
+    if (!e) {
+        *doc = parsed;
+        return;
+    }
+    e->parsed = parsed;
+    e->patchable = TRUE;
+    ShareEntry(e, doc);
+}
+
+static BOOL SameString(const wchar_t* a, const wchar_t* b) {
+    if (!a || !b) return a == b;
+    return wcscmp(a, b) == 0;
+}
+
+/**
+ * @brief Check that the masked parse equals the real one apart from the digits
+ * @param digits Time digits of the real input, in order
+ * @param positions Output display positions of the masks, digitCount entries
+ */
+static BOOL MaskedParseMatches(const RenderCoreDocument* real, const RenderCoreDocument* masked,
+                               const wchar_t* digits, int digitCount, int* positions) {
+    if (!real->isMarkdown || !masked->isMarkdown) return FALSE;
+    if (real->linkCount != masked->linkCount || real->headingCount != masked->headingCount ||
+        real->styleCount != masked->styleCount || real->listItemCount != masked->listItemCount ||
+        real->blockquoteCount != masked->blockquoteCount ||
+        real->colorTagCount != masked->colorTagCount || real->fontTagCount != masked->fontTagCount) {
+        return FALSE;
+    }
+
+    for (int i = 0; i < real->linkCount; i++) {
+        const MarkdownLink* a = &real->links[i];
+        const MarkdownLink* b = &masked->links[i];
+        if (a->startPos != b->startPos || a->endPos != b->endPos ||
+            !SameString(a->linkText, b->linkText) || !SameString(a->linkUrl, b->linkUrl)) return FALSE;
+    }
+    for (int i = 0; i < real->headingCount; i++) {
+        const MarkdownHeading* a = &real->headings[i];
+        const MarkdownHeading* b = &masked->headings[i];
+        if (a->level != b->level || a->startPos != b->startPos || a->endPos != b->endPos) return FALSE;
+    }
+    for (int i = 0; i < real->styleCount; i++) {
+        const MarkdownStyle* a = &real->styles[i];
+        const MarkdownStyle* b = &masked->styles[i];
+        if (a->type != b->type || a->startPos != b->startPos || a->endPos != b->endPos) return FALSE;
+    }
+    for (int i = 0; i < real->listItemCount; i++) {
+        const MarkdownListItem* a = &real->listItems[i];
+        const MarkdownListItem* b = &masked->listItems[i];
+        if (a->startPos != b->startPos || a->endPos != b->endPos ||
+            a->indentLevel != b->indentLevel || a->isChecked != b->isChecked) return FALSE;
+    }
+    for (int i = 0; i < real->blockquoteCount; i++) {
+        const MarkdownBlockquote* a = &real->blockquotes[i];
+        const MarkdownBlockquote* b = &masked->blockquotes[i];
+        if (a->startPos != b->startPos || a->endPos != b->endPos || a->alertType != b->alertType) return FALSE;
+    }
+    for (int i = 0; i < real->colorTagCount; i++) {
+        const MarkdownColorTag* a = &real->colorTags[i];
+        const MarkdownColorTag* b = &masked->colorTags[i];
+        if (a->startPos != b->startPos || a->endPos != b->endPos || a->colorCount != b->colorCount ||
+            memcmp(a->colors, b->colors, (size_t)a->colorCount * sizeof(COLORREF)) != 0) return FALSE;
+    }
+    for (int i = 0; i < real->fontTagCount; i++) {
+        const MarkdownFontTag* a = &real->fontTags[i];
+        const MarkdownFontTag* b = &masked->fontTags[i];
+        if (a->startPos != b->startPos || a->endPos != b->endPos ||
+            wcsncmp(a->fontName, b->fontName, MAX_FONT_NAME_LENGTH) != 0) return FALSE;
+    }
+
+    /* Every mask must survive in place of its digit, in input order */
+    const wchar_t* r = real->text;
+    const wchar_t* m = masked->text;
+    int found = 0;
+    int pos = 0;
+    for (; r[pos] && m[pos]; pos++) {
+        if (m[pos] == PARSE_DIGIT_MASK) {
+            if (found == digitCount || r[pos] != digits[found]) return FALSE;
+            positions[found++] = pos;
+        } else if (r[pos] != m[pos]) {
+            return FALSE;
+        }
+    }
+    return r[pos] == m[pos] && found == digitCount;
+}
+
+/** @brief Copy the masked display text into doc and write the digits in */
+static BOOL PatchDigits(const RenderCoreParseEntry* e, const wchar_t* digits, RenderCoreDocument* doc) {
+    size_t length = wcslen(e->parsed.text);
+    wchar_t* patched = (wchar_t*)malloc((length + 1) * sizeof(wchar_t));
+    if (!patched) return FALSE;
+    memcpy(patched, e->parsed.text, (length + 1) * sizeof(wchar_t));
+    for (int i = 0; i < e->digitCount; i++) {
+        patched[e->digitPositions[i]] = digits[i];
+    }
+    doc->ownedText = patched;
+    doc->text = patched;
+    return TRUE;
+}
+
+void RenderCore_Parse(const wchar_t* text, RenderCoreDocument* doc) {
+    memset(doc, 0, sizeof(*doc));
+    if (!text) return;
+
+    size_t length = wcslen(text);
+    if (length == 0 || length > RENDER_CORE_PARSE_CACHE_MAX_CHARS) {
+        g_parseMisses++;
+        ParseUncached(text, doc);
+        return;
+    }
+
+    ULONGLONG hash = HashText(text, (int)length);
+    RenderCoreParseEntry* e = FindEntry(text, (int)length, hash, FALSE);
+    if (e) {
+        g_parseHits++;
+        ShareEntry(e, doc);
+        return;
+    }
+    ParseExact(text, (int)length, hash, doc);
+}
+
+void RenderCore_ParseWithTime(const wchar_t* text, const RenderCoreTextRange* timeRanges,
+                              int rangeCount, RenderCoreDocument* doc) {
+    memset(doc, 0, sizeof(*doc));
+    if (!text) return;
+
+    int length = (int)wcslen(text);
+    if (rangeCount <= 0 || length == 0 || length > RENDER_CORE_PARSE_CACHE_MAX_CHARS ||
+        wcschr(text, PARSE_DIGIT_MASK)) {
+        RenderCore_Parse(text, doc);
+        return;
+    }
+
+    /* Masked key followed by the digits it hides; both fit twice the input */
+    if (g_maskScratchLength < length) {
+        wchar_t* grown = (wchar_t*)realloc(g_maskScratch, (size_t)length * 2 * sizeof(wchar_t) + sizeof(wchar_t));
+        if (!grown) {
+            RenderCore_Parse(text, doc);
+            return;
+        }
+        g_maskScratch = grown;
+        g_maskScratchLength = length;
+    }
+    wchar_t* masked = g_maskScratch;
+    wchar_t* digits = g_maskScratch + length + 1;
+    wmemcpy(masked, text, (size_t)length);
+    masked[length] = L'\0';
+
+    int digitCount = 0;
+    for (int r = 0; r < rangeCount; r++) {
+        int start = timeRanges[r].start;
+        int end = start + timeRanges[r].length;
+        if (start < 0) start = 0;
+        if (end > length) end = length;
+        for (int i = start; i < end; i++) {
+            if (masked[i] >= L'0' && masked[i] <= L'9') {
+                digits[digitCount++] = masked[i];
+                masked[i] = PARSE_DIGIT_MASK;
+            }
+        }
+    }
+    if (digitCount == 0) {
+        RenderCore_Parse(text, doc);
+        return;
+    }
+
+    ULONGLONG hash = HashText(masked, length);
+    RenderCoreParseEntry* e = FindEntry(masked, length, hash, TRUE);
+    if (e && !e->patchable) {
+        RenderCore_Parse(text, doc);
+        return;
+    }
+    if (e) {
+        g_parseHits++;
+        ShareEntry(e, doc);
+        if (!PatchDigits(e, digits, doc)) {
+            RenderCore_FreeDocument(doc);
+            ParseUncached(text, doc);
+        }
+        return;
+    }
+
+    /* First sight of this template: parse both ways and compare */
+    g_parseMisses++;
+    RenderCoreDocument real;
+    ParseUncached(text, &real);
+
+    e = ClaimEntry(masked, length, hash, TRUE);
+    if (!e) {
+        *doc = real;
+        return;
+    }
+
+    RenderCoreDocument maskedParse;
+    ParseUncached(masked, &maskedParse);
+    int* positions = (int*)malloc((size_t)digitCount * sizeof(int));
+    if (positions && MaskedParseMatches(&real, &maskedParse, digits, digitCount, positions)) {
+        e->parsed = maskedParse;
+        e->digitPositions = positions;
+        e->digitCount = digitCount;
+        e->patchable = TRUE;
+        FreeParsed(&real);
+        ShareEntry(e, doc);
+        if (!PatchDigits(e, digits, doc)) {
+            RenderCore_FreeDocument(doc);
+            ParseUncached(text, doc);
+        }
+        return;
+    }
+
+    /* Digits matter to the markup here; remember that and key on exact text */
+    free(positions);
+    FreeParsed(&maskedParse);
+    e->patchable = FALSE;
+    *doc = real;
+}
+
+void RenderCore_FreeDocument(RenderCoreDocument* doc) {
+    if (doc->shared) {
+        doc->shared->refs--;
+        free(doc->ownedText);
+        memset(doc, 0, sizeof(*doc));
+        return;
+    }
+    FreeParsed(doc);
+}
+
+void RenderCore_ClearParseCache(void) {
+    for (int i = 0; i < RENDER_CORE_PARSE_CACHE_ENTRIES; i++) {
+        if (g_parseCache[i].used && g_parseCache[i].refs == 0) ReleaseEntry(&g_parseCache[i]);
+    }
+}
+
+void RenderCore_GetParseCacheStats(DWORD* hits, DWORD* misses) {
+    if (hits) *hits = g_parseHits;
+    if (misses) *misses = g_parseMisses;
+}
+
+/* ============================================================================
+ * Measure and draw
+ * ============================================================================ */
+
+BOOL RenderCore_HasColorTagGradient(const RenderCoreDocument* doc) {
+    for (int i = 0; i < doc->colorTagCount; i++) {
+        if (doc->colorTags[i].colorCount > 1) return TRUE;
+    }
+    return FALSE;
+}
+
+BOOL RenderCore_Measure(const RenderCoreDocument* doc, int fontSize, int* width, int* height) {
+    if (!doc->text || doc->text[0] == L'\0' || !IsFontLoadedSTB()) return FALSE;
+    return MeasureMarkdownSTB(doc->text, doc->headings, doc->headingCount, fontSize, width, height);
+}
+
+static void DrawMarkdown(const RenderCoreDocument* doc, const RenderCoreStyle* style,
+                         void* bits, int width, int height, const MarkdownViewport* viewport) {
+    /* Link rects are per-draw output written into possibly shared arrays */
+    for (int i = 0; i < doc->linkCount; i++) {
+        memset(&doc->links[i].linkRect, 0, sizeof(RECT));
+    }
+
+    /* Internal scale is handled by font size */
+    RenderMarkdownSTB(bits, width, height, doc->text,
+                      doc->links, doc->linkCount,
+                      doc->headings, doc->headingCount,
+                      &doc->runs,
+                      doc->blockquotes, doc->blockquoteCount,
+                      style->textColor, style->fontSize, 1.0f, style->gradientMode,
+                      viewport);
+}
+
+void RenderCore_Draw(const RenderCoreDocument* doc, const RenderCoreStyle* style,
+                     void* bits, int width, int height) {
+    if (!doc->text || doc->text[0] == L'\0' || !bits || !IsFontLoadedSTB()) return;
+    DrawMarkdown(doc, style, bits, width, height, NULL);
+}
+
+void RenderCore_DrawViewport(const RenderCoreDocument* doc, const RenderCoreStyle* style,
+                             void* bits, int width, int height, int scrollY) {
+    if (!doc->text || doc->text[0] == L'\0' || !bits || !IsFontLoadedSTB()) return;
+
+    MarkdownViewport viewport = { scrollY };
+    DrawMarkdown(doc, style, bits, width, height, &viewport);
+}
+
+DWORD RenderCore_GetTime(void) {
+    return g_timePinned ? g_pinnedTime : GetTickCount();
+}
+
+void RenderCore_PinTime(BOOL pinned, DWORD timeMs) {
+    g_pinnedTime = timeMs;
+    g_timePinned = pinned;
+}
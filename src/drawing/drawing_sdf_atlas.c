@@ -0,0 +1,371 @@
+/**
+ * @file drawing_sdf_atlas.c
+ * @brief Per-face distance field atlas and arena of sampled glyphs
+ */
+
+#include "drawing/drawing_sdf_atlas.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "log.h"
+
+/* stbtt_GetGlyphSDF parameters: edge at 128, 128 / 16 steps per reference pixel */
+#define SDF_ON_EDGE 128
+#define SDF_DIST_SCALE ((float)SDF_ON_EDGE / (float)SDF_PADDING)
+
+/* Open-addressing slots per atlas; an atlas is reset before they fill up */
+#define SDF_ATLAS_SLOTS 1024
+#define SDF_ATLAS_MAX_GLYPHS (SDF_ATLAS_SLOTS / 2)
+
+#define SDF_SAMPLE_MAX 1024
+#define SDF_SAMPLE_BUCKETS 256
+
+typedef struct {
+    int key;            /* glyphIndex + 1, 0 = free */
+    short x, y, w, h;   /* Texel rectangle, w == 0 for empty glyphs */
+    short xoff, yoff;   /* Offset at the reference scale */
+} SdfSlot;
+
+typedef struct {
+    const stbtt_fontinfo* face;
+    float refScale;
+    unsigned char* texels;
+    int shelfX, shelfY, shelfH;
+    int glyphCount;
+    DWORD lastUse;
+    SdfSlot slots[SDF_ATLAS_SLOTS];
+} SdfAtlas;
+
+typedef struct SdfSample {
+    const stbtt_fontinfo* face;
+    DWORD scaleBits;
+    int glyphIndex;
+    CachedGlyph glyph;  /* bitmap = coverage, followed by the field */
+    struct SdfSample* next;
+} SdfSample;
+
+static SdfAtlas g_atlases[SDF_ATLAS_MAX_FACES];
+static DWORD g_atlasUseCounter = 0;
+
+static SdfSample g_samples[SDF_SAMPLE_MAX];
+static SdfSample* g_sampleBuckets[SDF_SAMPLE_BUCKETS];
+static int g_sampleCount = 0;
+
+static unsigned char* g_arena = NULL;
+static size_t g_arenaCapacity = 0;
+static size_t g_arenaUsed = 0;
+
+/* ============================================================================
+ * Atlas
+ * ============================================================================ */
+
+static void ResetAtlas(SdfAtlas* atlas) {
+    memset(atlas->slots, 0, sizeof(atlas->slots));
+    atlas->shelfX = atlas->shelfY = atlas->shelfH = 0;
+    atlas->glyphCount = 0;
+}
+
+static SdfAtlas* FindAtlas(const stbtt_fontinfo* face) {
+    SdfAtlas* victim = NULL;
+    for (int i = 0; i < SDF_ATLAS_MAX_FACES; i++) {
+        SdfAtlas* a = &g_atlases[i];
+        if (a->face == face) {
+            a->lastUse = ++g_atlasUseCounter;
+            return a;
+        }
+        if (!victim || (victim->face && (!a->face || a->lastUse < victim->lastUse))) victim = a;
+    }
+
+    /* Texels are reused across faces; only the first atlas in a slot allocates */
+    if (!victim->texels) {
+        victim->texels = (unsigned char*)malloc((size_t)SDF_ATLAS_SIZE * SDF_ATLAS_SIZE);
+        if (!victim->texels) return NULL;
+    }
+    victim->face = face;
+    victim->refScale = stbtt_ScaleForPixelHeight(face, SDF_REFERENCE_PIXELS);
+    victim->lastUse = ++g_atlasUseCounter;
+    ResetAtlas(victim);
+    return victim;
+}
+
+static SdfSlot* FindSlot(SdfAtlas* atlas, int glyphIndex) {
+    UINT i = ((UINT)glyphIndex * 2654435761u) & (SDF_ATLAS_SLOTS - 1);
+    while (atlas->slots[i].key != 0 && atlas->slots[i].key != glyphIndex + 1) {
+        i = (i + 1) & (SDF_ATLAS_SLOTS - 1);
+    }
+    return &atlas->slots[i];
+}
+
+/** Reserve a shelf position; FALSE when the atlas has no room left */
+static BOOL PackRect(SdfAtlas* atlas, int w, int h, int* x, int* y) {
+    if (atlas->shelfX + w > SDF_ATLAS_SIZE) {
+        atlas->shelfY += atlas->shelfH;
+        atlas->shelfX = 0;
+        atlas->shelfH = 0;
+    }
+    if (atlas->shelfY + h > SDF_ATLAS_SIZE) return FALSE;
+
+    *x = atlas->shelfX;
+    *y = atlas->shelfY;
+    atlas->shelfX += w;
+    if (h > atlas->shelfH) atlas->shelfH = h;
+    return TRUE;
+}
+
+static const SdfSlot* GetAtlasGlyph(SdfAtlas* atlas, int glyphIndex) {
+    SdfSlot* slot = FindSlot(atlas, glyphIndex);
+    if (slot->key != 0) return slot;
+
+    int w = 0, h = 0, xoff = 0, yoff = 0;
+    unsigned char* sdf = stbtt_GetGlyphSDF(atlas->face, atlas->refScale, glyphIndex,
+                                           SDF_PADDING, SDF_ON_EDGE, SDF_DIST_SCALE,
+                                           &w, &h, &xoff, &yoff);
+    if (sdf && (w > SDF_ATLAS_SIZE || h > SDF_ATLAS_SIZE)) {
+        LOG_WARNING("SDF glyph %d is %dx%d, larger than the atlas; drawn empty", glyphIndex, w, h);
+        stbtt_FreeSDF(sdf, NULL);
+        sdf = NULL;
+    }
+
+    int x = 0, y = 0;
+    if (sdf) {
+        /* A full atlas starts over; sampled glyphs keep their own copies */
+        if (atlas->glyphCount >= SDF_ATLAS_MAX_GLYPHS || !PackRect(atlas, w, h, &x, &y)) {
+            LOG_DEBUG("SDF atlas full after %d glyphs, resetting", atlas->glyphCount);
+            ResetAtlas(atlas);
+            PackRect(atlas, w, h, &x, &y);
+            slot = FindSlot(atlas, glyphIndex);
+        }
+        for (int j = 0; j < h; j++) {
+            memcpy(atlas->texels + (size_t)(y + j) * SDF_ATLAS_SIZE + x, sdf + (size_t)j * w, w);
+        }
+        stbtt_FreeSDF(sdf, NULL);
+    } else {
+        w = h = 0;
+    }
+
+    slot->key = glyphIndex + 1;
+    slot->x = (short)x;
+    slot->y = (short)y;
+    slot->w = (short)w;
+    slot->h = (short)h;
+    slot->xoff = (short)xoff;
+    slot->yoff = (short)yoff;
+    atlas->glyphCount++;
+    return slot;
+}
+
+/* ============================================================================
+ * Sampling
+ * ============================================================================ */
+
+static void ResetSamples(void) {
+    memset(g_sampleBuckets, 0, sizeof(g_sampleBuckets));
+    g_sampleCount = 0;
+    g_arenaUsed = 0;
+}
+
+/** Arena space for one glyph; resets the arena (and grows it for huge glyphs) when full */
+static unsigned char* ReserveArena(size_t bytes) {
+    if (g_sampleCount >= SDF_SAMPLE_MAX || g_arenaUsed + bytes > g_arenaCapacity) {
+        ResetSamples();
+        size_t wanted = (bytes > SDF_SAMPLE_ARENA_BYTES) ? bytes : SDF_SAMPLE_ARENA_BYTES;
+        if (wanted > g_arenaCapacity) {
+            unsigned char* grown = (unsigned char*)realloc(g_arena, wanted);
+            if (!grown) return NULL;
+            g_arena = grown;
+            g_arenaCapacity = wanted;
+        }
+    }
+    unsigned char* p = g_arena + g_arenaUsed;
+    g_arenaUsed += bytes;
+    return p;
+}
+
+/** Interpolated texels keep 4 fractional bits when looked up */
+#define SDF_LUT_SIZE (256 * 16)
+
+/* Coverage and field for every interpolated texel value at g_lutRatio */
+static unsigned char g_coverageLUT[SDF_LUT_SIZE];
+static unsigned char g_fieldLUT[SDF_LUT_SIZE];
+static float g_lutRatio = 0.0f;
+
+/* Per-column texel index and 8-bit weight, grown to the widest glyph */
+static int* g_columnTaps = NULL;
+static int g_columnTapCapacity = 0;
+
+/**
+ * @brief Map texel values to coverage and field for one scale ratio
+ * @details Distances are rescaled to destination pixels, so the smoothstep
+ *          edge stays one pixel wide at every size.
+ */
+static void BuildSampleLUT(float ratio) {
+    if (ratio == g_lutRatio) return;
+
+    float toPixels = ratio / SDF_DIST_SCALE;
+    for (int i = 0; i < SDF_LUT_SIZE; i++) {
+        float dist = ((float)i / 16.0f - SDF_ON_EDGE) * toPixels;
+
+        float t = dist + 0.5f;
+        if (t < 0.0f) t = 0.0f; else if (t > 1.0f) t = 1.0f;
+        g_coverageLUT[i] = (unsigned char)(t * t * (3.0f - 2.0f * t) * 255.0f + 0.5f);
+
+        float f = SDF_FIELD_EDGE + dist * SDF_FIELD_STEPS_PER_PIXEL + 0.5f;
+        if (f < 0.0f) f = 0.0f; else if (f > 255.0f) f = 255.0f;
+        g_fieldLUT[i] = (unsigned char)f;
+    }
+    g_lutRatio = ratio;
+}
+
+/** Texel index and 8-bit weight for destination pixel p, clamped to count texels */
+static void SampleTap(int p, int origin, int offset, float ratio, int count, int* index, int* weight) {
+    float pos = ((float)(origin + p) + 0.5f) / ratio - (float)offset - 0.5f;
+    if (pos <= 0.0f) {
+        *index = 0;
+        *weight = 0;
+    } else if (pos >= (float)(count - 1)) {
+        *index = count - 1;
+        *weight = 0;
+    } else {
+        *index = (int)pos;
+        *weight = (int)((pos - (float)*index) * 256.0f);
+    }
+}
+
+/**
+ * @brief Resample an atlas glyph to the destination scale
+ */
+static BOOL SampleGlyph(const SdfAtlas* atlas, const SdfSlot* slot, float scale, CachedGlyph* out) {
+    memset(out, 0, sizeof(*out));
+    if (slot->w == 0) return TRUE;
+
+    /* Keep only the margin the field encoding can express; the rest reads 0 anyway */
+    float ratio = scale / atlas->refScale;
+    float margin = SDF_PADDING * ratio;
+    if (margin > SDF_FIELD_REACH) margin = SDF_FIELD_REACH;
+    float inset = SDF_PADDING * ratio - margin;
+
+    int x0 = (int)floorf(slot->xoff * ratio + inset);
+    int y0 = (int)floorf(slot->yoff * ratio + inset);
+    int w = (int)ceilf((slot->xoff + slot->w) * ratio - inset) - x0;
+    int h = (int)ceilf((slot->yoff + slot->h) * ratio - inset) - y0;
+    if (w <= 0 || h <= 0) return TRUE;
+
+    if (w * 2 > g_columnTapCapacity) {
+        int* grown = (int*)realloc(g_columnTaps, sizeof(int) * (size_t)w * 2);
+        if (!grown) return FALSE;
+        g_columnTaps = grown;
+        g_columnTapCapacity = w * 2;
+    }
+
+    size_t pixels = (size_t)w * (size_t)h;
+    unsigned char* coverage = ReserveArena(pixels * 2);
+    if (!coverage) return FALSE;
+    unsigned char* field = coverage + pixels;
+
+    BuildSampleLUT(ratio);
+    for (int i = 0; i < w; i++) {
+        SampleTap(i, x0, slot->xoff, ratio, slot->w, &g_columnTaps[i * 2], &g_columnTaps[i * 2 + 1]);
+    }
+
+    const unsigned char* texels = atlas->texels + (size_t)slot->y * SDF_ATLAS_SIZE + slot->x;
+    for (int j = 0; j < h; j++) {
+        int row, fy;
+        SampleTap(j, y0, slot->yoff, ratio, slot->h, &row, &fy);
+        const unsigned char* row0 = texels + (size_t)row * SDF_ATLAS_SIZE;
+        const unsigned char* row1 = (row + 1 < slot->h) ? row0 + SDF_ATLAS_SIZE : row0;
+        unsigned char* covOut = coverage + (size_t)j * w;
+        unsigned char* fieldOut = field + (size_t)j * w;
+
+        for (int i = 0; i < w; i++) {
+            int ix = g_columnTaps[i * 2];
+            int fx = g_columnTaps[i * 2 + 1];
+            int ix1 = (ix + 1 < slot->w) ? ix + 1 : ix;
+            int top = row0[ix] * (256 - fx) + row0[ix1] * fx;
+            int bottom = row1[ix] * (256 - fx) + row1[ix1] * fx;
+            int v = (top * (256 - fy) + bottom * fy) >> 12;
+            covOut[i] = g_coverageLUT[v];
+            fieldOut[i] = g_fieldLUT[v];
+        }
+    }
+
+    out->bitmap = coverage;
+    out->w = w;
+    out->h = h;
+    out->xoff = x0;
+    out->yoff = y0;
+    return TRUE;
+}
+
+static UINT HashSample(const stbtt_fontinfo* face, DWORD scaleBits, int glyphIndex) {
+    UINT h = (UINT)((uintptr_t)face >> 4);
+    h = h * 31u + scaleBits;
+    h = h * 31u + (UINT)glyphIndex;
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h & (SDF_SAMPLE_BUCKETS - 1);
+}
+
+const CachedGlyph* SdfAtlas_Get(const stbtt_fontinfo* face, float scale, int glyphIndex) {
+    if (!face || scale <= 0.0f) return NULL;
+
+    DWORD scaleBits;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    UINT bucket = HashSample(face, scaleBits, glyphIndex);
+    for (SdfSample* s = g_sampleBuckets[bucket]; s; s = s->next) {
+        if (s->face == face && s->scaleBits == scaleBits && s->glyphIndex == glyphIndex) {
+            return &s->glyph;
+        }
+    }
+
+    SdfAtlas* atlas = FindAtlas(face);
+    if (!atlas) return NULL;
+    const SdfSlot* slot = GetAtlasGlyph(atlas, glyphIndex);
+
+    CachedGlyph glyph;
+    if (!SampleGlyph(atlas, slot, scale, &glyph)) return NULL;
+
+    /* Sampling may have reset the arena and buckets, so the entry is claimed afterwards */
+    SdfSample* s = &g_samples[g_sampleCount++];
+    s->face = face;
+    s->scaleBits = scaleBits;
+    s->glyphIndex = glyphIndex;
+    s->glyph = glyph;
+    s->next = g_sampleBuckets[bucket];
+    g_sampleBuckets[bucket] = s;
+    return &s->glyph;
+}
+
+const unsigned char* SdfAtlas_FieldOf(const unsigned char* coverage, int w, int h) {
+    if (!coverage || !g_arena || w <= 0 || h <= 0) return NULL;
+    size_t pixels = (size_t)w * (size_t)h;
+    if (coverage < g_arena || coverage + pixels * 2 > g_arena + g_arenaUsed) return NULL;
+    return coverage + pixels;
+}
+
+void SdfAtlas_InvalidateFace(const stbtt_fontinfo* face) {
+    for (int i = 0; i < SDF_ATLAS_MAX_FACES; i++) {
+        if (g_atlases[i].face == face) {
+            g_atlases[i].face = NULL;
+            ResetAtlas(&g_atlases[i]);
+        }
+    }
+    /* Samples are cheap to redo; keying them per face is not worth a walk */
+    ResetSamples();
+}
+
+void SdfAtlas_Clear(void) {
+    for (int i = 0; i < SDF_ATLAS_MAX_FACES; i++) {
+        free(g_atlases[i].texels);
+    }
+    memset(g_atlases, 0, sizeof(g_atlases));
+    g_atlasUseCounter = 0;
+
+    ResetSamples();
+    free(g_arena);
+    g_arena = NULL;
+    g_arenaCapacity = 0;
+    free(g_columnTaps);
+    g_columnTaps = NULL;
+    g_columnTapCapacity = 0;
+}
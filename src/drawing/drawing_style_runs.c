@@ -0,0 +1,136 @@
+/**
+ * @file drawing_style_runs.c
+ * @brief Style run table built from parsed markdown spans
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "drawing/drawing_style_runs.h"
+#include "log.h"
+
+static int CompareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int AddCut(int* cuts, int count, int pos, int textLength) {
+    if (pos > 0 && pos < textLength) cuts[count++] = pos;
+    return count;
+}
+
+static BOOL SameAttributes(const StyleRun* a, const StyleRun* b) {
+    return a->flags == b->flags && a->color == b->color && a->gradient == b->gradient &&
+           a->fontName == b->fontName && a->linkIndex == b->linkIndex;
+}
+
+/*
+ * Cursor semantics of the per-character renderer this replaces: skip
+ * elements ending at or before pos, then the current one is active once it
+ * has started. Positions are visited in increasing order, so the result
+ * depends only on pos and evaluating at cut points alone is exact.
+ */
+#define ADVANCE_CURSOR(array, count, cursor, pos) \
+    while ((cursor) < (count) && (pos) >= (array)[cursor].endPos) (cursor)++
+
+#define ACTIVE_INDEX(array, count, cursor, pos) \
+    (((cursor) < (count) && (pos) >= (array)[cursor].startPos) ? (cursor) : -1)
+
+BOOL StyleRuns_Build(StyleRunTable* table, MarkdownArena* arena, int textLength,
+                     const MarkdownLink* links, int linkCount,
+                     const MarkdownStyle* styles, int styleCount,
+                     const MarkdownColorTag* colorTags, int colorTagCount,
+                     const MarkdownFontTag* fontTags, int fontTagCount) {
+    memset(table, 0, sizeof(*table));
+    table->hasColorTags = colorTagCount > 0;
+    if (textLength <= 0) return TRUE;
+
+    /* Attributes can only change where some element starts or ends */
+    int maxCuts = 1 + 2 * (linkCount + styleCount + colorTagCount + fontTagCount);
+    int* cuts = (int*)malloc((size_t)maxCuts * sizeof(int));
+    if (!cuts) return FALSE;
+
+    int cutCount = 0;
+    cuts[cutCount++] = 0;
+    for (int i = 0; i < linkCount; i++) {
+        cutCount = AddCut(cuts, cutCount, links[i].startPos, textLength);
+        cutCount = AddCut(cuts, cutCount, links[i].endPos, textLength);
+    }
+    for (int i = 0; i < styleCount; i++) {
+        cutCount = AddCut(cuts, cutCount, styles[i].startPos, textLength);
+        cutCount = AddCut(cuts, cutCount, styles[i].endPos, textLength);
+    }
+    for (int i = 0; i < colorTagCount; i++) {
+        cutCount = AddCut(cuts, cutCount, colorTags[i].startPos, textLength);
+        cutCount = AddCut(cuts, cutCount, colorTags[i].endPos, textLength);
+    }
+    for (int i = 0; i < fontTagCount; i++) {
+        cutCount = AddCut(cuts, cutCount, fontTags[i].startPos, textLength);
+        cutCount = AddCut(cuts, cutCount, fontTags[i].endPos, textLength);
+    }
+    qsort(cuts, (size_t)cutCount, sizeof(int), CompareInts);
+
+    StyleRun* runs = (StyleRun*)MarkdownArenaAlloc(arena, (size_t)cutCount * sizeof(StyleRun));
+    if (!runs) {
+        free(cuts);
+        LOG_WARNING("Style run table allocation failed (%d runs)", cutCount);
+        return FALSE;
+    }
+
+    int linkCursor = 0, styleCursor = 0, colorCursor = 0, fontCursor = 0;
+    int runCount = 0;
+    for (int c = 0; c < cutCount; c++) {
+        int pos = cuts[c];
+        int end = (c + 1 < cutCount) ? cuts[c + 1] : textLength;
+        if (pos >= end) continue;  /* Duplicate cut */
+
+        ADVANCE_CURSOR(links, linkCount, linkCursor, pos);
+        ADVANCE_CURSOR(styles, styleCount, styleCursor, pos);
+        ADVANCE_CURSOR(colorTags, colorTagCount, colorCursor, pos);
+        ADVANCE_CURSOR(fontTags, fontTagCount, fontCursor, pos);
+        int link = ACTIVE_INDEX(links, linkCount, linkCursor, pos);
+        int style = ACTIVE_INDEX(styles, styleCount, styleCursor, pos);
+        int colorTag = ACTIVE_INDEX(colorTags, colorTagCount, colorCursor, pos);
+        int fontTag = ACTIVE_INDEX(fontTags, fontTagCount, fontCursor, pos);
+
+        StyleRun run = { pos, end, 0, 0, NULL, NULL, link };
+        if (link >= 0) {
+            run.flags |= STYLE_RUN_COLOR;
+            run.color = STYLE_RUN_LINK_COLOR;
+        }
+        if (style >= 0) {
+            switch (styles[style].type) {
+                case STYLE_CODE:
+                    run.flags |= STYLE_RUN_COLOR;
+                    run.color = STYLE_RUN_CODE_COLOR;
+                    break;
+                case STYLE_BOLD:          run.flags |= STYLE_RUN_BOLD; break;
+                case STYLE_ITALIC:        run.flags |= STYLE_RUN_ITALIC; break;
+                case STYLE_BOLD_ITALIC:   run.flags |= STYLE_RUN_BOLD | STYLE_RUN_ITALIC; break;
+                case STYLE_STRIKETHROUGH: run.flags |= STYLE_RUN_STRIKE; break;
+                default: break;
+            }
+        }
+        if (colorTag >= 0) {
+            const MarkdownColorTag* tag = &colorTags[colorTag];
+            if (tag->colorCount == 1) {
+                run.flags |= STYLE_RUN_COLOR;
+                run.color = tag->colors[0];
+            } else if (tag->colorCount > 1) {
+                run.gradient = tag;
+            }
+        }
+        if (fontTag >= 0) run.fontName = fontTags[fontTag].fontName;
+
+        if (runCount > 0 && SameAttributes(&runs[runCount - 1], &run)) {
+            runs[runCount - 1].end = end;
+        } else {
+            runs[runCount++] = run;
+        }
+    }
+    free(cuts);
+
+    table->runs = runs;
+    table->count = runCount;
+    return TRUE;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file drawing_surface.c
+ * @brief Persistent back buffer with bucketed section storage
+ */
+
+#include "drawing/drawing_surface.h"
+#include "log.h"
+#include <string.h>
+
+static SIZE_T BucketBytes(SIZE_T needed) {
+    SIZE_T bucket = RENDER_SURFACE_MIN_BYTES;
+    while (bucket < needed) bucket <<= 1;
+    return bucket;
+}
+
+static void ReleaseBitmap(RenderSurface* surface) {
+    if (surface->bitmap) {
+        SelectObject(surface->memDC, surface->oldBitmap);
+        DeleteObject(surface->bitmap);
+        surface->bitmap = NULL;
+        surface->oldBitmap = NULL;
+    }
+    surface->bits = NULL;
+    surface->width = 0;
+    surface->height = 0;
+}
+
+/** @note GM_ADVANCED + HALFTONE improve text quality on high-DPI displays */
+static BOOL CreateSurfaceDC(RenderSurface* surface, HDC refDC) {
+    surface->memDC = CreateCompatibleDC(refDC);
+    if (!surface->memDC) return FALSE;
+
+    /* DC state survives bitmap swaps, so it is configured once */
+    SetGraphicsMode(surface->memDC, GM_ADVANCED);
+    SetBkMode(surface->memDC, TRANSPARENT);
+    SetStretchBltMode(surface->memDC, HALFTONE);
+    SetBrushOrgEx(surface->memDC, 0, 0, NULL);
+    SetTextAlign(surface->memDC, TA_LEFT | TA_TOP);
+    SetTextCharacterExtra(surface->memDC, 0);
+    SetMapMode(surface->memDC, MM_TEXT);
+    SetICMMode(surface->memDC, ICM_ON);
+    SetLayout(surface->memDC, 0);
+    return TRUE;
+}
+
+/**
+ * @brief Ensure backing section holds neededBytes
+ * @note Shrinks only below a quarter of capacity to avoid bucket ping-pong
+ */
+static BOOL EnsureSection(RenderSurface* surface, SIZE_T neededBytes) {
+    BOOL fits = surface->hSection && neededBytes <= surface->sectionBytes;
+    BOOL oversized = surface->sectionBytes > RENDER_SURFACE_MIN_BYTES &&
+                     neededBytes < surface->sectionBytes / 4;
+    if (fits && !oversized) return TRUE;
+
+    ReleaseBitmap(surface);
+    if (surface->hSection) {
+        CloseHandle(surface->hSection);
+        surface->hSection = NULL;
+        surface->sectionBytes = 0;
+    }
+
+    SIZE_T bytes = BucketBytes(neededBytes);
+    ULONGLONG size64 = (ULONGLONG)bytes;
+    surface->hSection = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                           (DWORD)(size64 >> 32), (DWORD)(size64 & 0xFFFFFFFF), NULL);
+    if (!surface->hSection) {
+        LOG_WARNING("Render surface: section allocation failed (%lu bytes)", (unsigned long)bytes);
+        return FALSE;
+    }
+    surface->sectionBytes = bytes;
+    return TRUE;
+}
+
+BOOL RenderSurface_Prepare(RenderSurface* surface, HDC refDC, int width, int height) {
+    if (!surface || width <= 0 || height <= 0) return FALSE;
+
+    if (surface->bitmap && surface->width == width && surface->height == height) {
+        return TRUE;
+    }
+
+    if (!surface->memDC && !CreateSurfaceDC(surface, refDC)) {
+        return FALSE;
+    }
+
+    SIZE_T neededBytes = (SIZE_T)width * (SIZE_T)height * 4;
+    if (!EnsureSection(surface, neededBytes)) {
+        return FALSE;
+    }
+
+    ReleaseBitmap(surface);
+
+    BITMAPINFO bmi = {0};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    // Negative height creates a top-down DIB, matching STB's coordinate system
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = NULL;
+    HBITMAP bitmap = CreateDIBSection(refDC, &bmi, DIB_RGB_COLORS, &bits, surface->hSection, 0);
+    if (!bitmap) {
+        return FALSE;
+    }
+
+    surface->bitmap = bitmap;
+    surface->oldBitmap = (HBITMAP)SelectObject(surface->memDC, bitmap);
+    surface->bits = bits;
+    surface->width = width;
+    surface->height = height;
+    return TRUE;
+}
+
+void RenderSurface_Clear(RenderSurface* surface, DWORD clearColor) {
+    if (!surface || !surface->bits) return;
+
+    SIZE_T count = (SIZE_T)surface->width * (SIZE_T)surface->height;
+
+    if (clearColor == 0) {
+        memset(surface->bits, 0, count * sizeof(DWORD));
+        return;
+    }
+
+    /* Seed one row, then double the filled span with memcpy */
+    DWORD* pixels = (DWORD*)surface->bits;
+    SIZE_T seed = (SIZE_T)surface->width;
+    for (SIZE_T i = 0; i < seed; i++) {
+        pixels[i] = clearColor;
+    }
+    SIZE_T filled = seed;
+    while (filled < count) {
+        SIZE_T chunk = (filled < count - filled) ? filled : (count - filled);
+        memcpy(pixels + filled, pixels, chunk * sizeof(DWORD));
+        filled += chunk;
+    }
+}
+
+void RenderSurface_Destroy(RenderSurface* surface) {
+    if (!surface) return;
+    ReleaseBitmap(surface);
+    if (surface->memDC) {
+        DeleteDC(surface->memDC);
+    }
+    if (surface->hSection) {
+        CloseHandle(surface->hSection);
+    }
+    memset(surface, 0, sizeof(*surface));
+}
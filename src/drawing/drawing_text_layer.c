@@ -0,0 +1,184 @@
+/**
+ * @file drawing_text_layer.c
+ * @brief Per-run coverage mask for text effects
+ */
+
+#include "drawing/drawing_text_layer.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Window-sized mask; always zero outside the pending run's box */
+static unsigned char* g_mask = NULL;
+static size_t g_maskCapacity = 0;
+
+/* Compact copy of the box handed to the flush callback */
+static unsigned char* g_boxMask = NULL;
+static size_t g_boxCapacity = 0;
+
+/* Window-sized union of glyph distance fields, allocated on first use */
+static unsigned char* g_field = NULL;
+static unsigned char* g_boxField = NULL;
+static size_t g_boxFieldCapacity = 0;
+
+static DWORD* g_pixels = NULL;
+static int g_width = 0;
+static int g_height = 0;
+static TextLayerFlushFn g_flush = NULL;
+static BOOL g_open = FALSE;
+
+/* Pending run */
+static BOOL g_hasRun = FALSE;
+static BOOL g_runHasField = FALSE;
+static TextLayerPaint g_paint;
+static int g_left, g_top, g_right, g_bottom;
+
+static void FlushRun(void) {
+    if (!g_hasRun) return;
+    g_hasRun = FALSE;
+
+    int w = g_right - g_left;
+    int h = g_bottom - g_top;
+    size_t needed = (size_t)w * (size_t)h;
+
+    if (needed > g_boxCapacity) {
+        unsigned char* grown = (unsigned char*)realloc(g_boxMask, needed);
+        if (grown) {
+            g_boxMask = grown;
+            g_boxCapacity = needed;
+        }
+    }
+
+    BOOL haveField = g_runHasField;
+    if (haveField && needed > g_boxFieldCapacity) {
+        unsigned char* grown = (unsigned char*)realloc(g_boxField, needed);
+        if (grown) {
+            g_boxField = grown;
+            g_boxFieldCapacity = needed;
+        } else {
+            haveField = FALSE;
+        }
+    }
+
+    BOOL haveBox = (needed <= g_boxCapacity);
+    for (int j = 0; j < h; j++) {
+        unsigned char* row = g_mask + (size_t)(g_top + j) * g_width + g_left;
+        if (haveBox) memcpy(g_boxMask + (size_t)j * w, row, w);
+        memset(row, 0, w);
+
+        if (g_field) {
+            unsigned char* fieldRow = g_field + (size_t)(g_top + j) * g_width + g_left;
+            if (haveField) memcpy(g_boxField + (size_t)j * w, fieldRow, w);
+            memset(fieldRow, 0, w);
+        }
+    }
+
+    if (haveBox && g_flush) {
+        g_flush(g_pixels, g_width, g_height, g_left, g_top, g_boxMask, w, h,
+                haveField ? g_boxField : NULL, &g_paint);
+    }
+}
+
+BOOL TextLayer_Begin(void* bits, int width, int height, TextLayerFlushFn flush) {
+    if (g_open) TextLayer_End();
+    if (!bits || width <= 0 || height <= 0 || !flush) return FALSE;
+
+    size_t needed = (size_t)width * (size_t)height;
+    if (needed > g_maskCapacity) {
+        free(g_mask);
+        g_mask = (unsigned char*)calloc(needed, 1);
+        g_maskCapacity = g_mask ? needed : 0;
+        free(g_field);
+        g_field = NULL;
+        if (!g_mask) return FALSE;
+    }
+
+    g_pixels = (DWORD*)bits;
+    g_width = width;
+    g_height = height;
+    g_flush = flush;
+    g_hasRun = FALSE;
+    g_open = TRUE;
+    return TRUE;
+}
+
+BOOL TextLayer_AddGlyph(int x_pos, int y_pos, const unsigned char* bitmap, int w, int h,
+                        const unsigned char* field, const TextLayerPaint* paint) {
+    if (!g_open) return FALSE;
+
+    if (g_hasRun && memcmp(paint, &g_paint, sizeof(*paint)) != 0) {
+        FlushRun();
+    }
+
+    int start_i = (x_pos < 0) ? -x_pos : 0;
+    int end_i = (x_pos + w > g_width) ? g_width - x_pos : w;
+    int start_j = (y_pos < 0) ? -y_pos : 0;
+    int end_j = (y_pos + h > g_height) ? g_height - y_pos : h;
+    if (start_i >= end_i || start_j >= end_j) return TRUE;
+
+    /* Sized like the mask, so it shares the mask's capacity */
+    if (field && !g_field) {
+        g_field = (unsigned char*)calloc(g_maskCapacity, 1);
+        if (!g_field) field = NULL;
+    }
+
+    if (!g_hasRun) {
+        g_runHasField = (field != NULL);
+        g_paint = *paint;
+        g_left = x_pos + start_i;
+        g_top = y_pos + start_j;
+        g_right = x_pos + end_i;
+        g_bottom = y_pos + end_j;
+        g_hasRun = TRUE;
+    } else {
+        if (x_pos + start_i < g_left) g_left = x_pos + start_i;
+        if (y_pos + start_j < g_top) g_top = y_pos + start_j;
+        if (x_pos + end_i > g_right) g_right = x_pos + end_i;
+        if (y_pos + end_j > g_bottom) g_bottom = y_pos + end_j;
+        if (!field) g_runHasField = FALSE;
+    }
+
+    /* Overlapping glyphs (bold passes, tight kerning) keep the stronger coverage */
+    for (int j = start_j; j < end_j; j++) {
+        unsigned char* dst = g_mask + (size_t)(y_pos + j) * g_width + x_pos;
+        const unsigned char* src = bitmap + j * w;
+        for (int i = start_i; i < end_i; i++) {
+            if (src[i] > dst[i]) dst[i] = src[i];
+        }
+    }
+
+    /* The larger signed distance is the union of the shapes */
+    if (g_runHasField) {
+        for (int j = start_j; j < end_j; j++) {
+            unsigned char* dst = g_field + (size_t)(y_pos + j) * g_width + x_pos;
+            const unsigned char* src = field + j * w;
+            for (int i = start_i; i < end_i; i++) {
+                if (src[i] > dst[i]) dst[i] = src[i];
+            }
+        }
+    }
+    return TRUE;
+}
+
+void TextLayer_End(void) {
+    if (!g_open) return;
+    FlushRun();
+    g_open = FALSE;
+    g_pixels = NULL;
+    g_flush = NULL;
+}
+
+void TextLayer_Cleanup(void) {
+    g_open = FALSE;
+    g_hasRun = FALSE;
+    free(g_mask);
+    g_mask = NULL;
+    g_maskCapacity = 0;
+    free(g_boxMask);
+    g_boxMask = NULL;
+    g_boxCapacity = 0;
+    free(g_field);
+    g_field = NULL;
+    free(g_boxField);
+    g_boxField = NULL;
+    g_boxFieldCapacity = 0;
+}
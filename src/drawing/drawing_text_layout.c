@@ -0,0 +1,451 @@
+/**
+ * @file drawing_text_layout.c
+ * @brief Text layout: incremental line index plus glyphs for a line window
+ */
+
+#include "drawing/drawing_text_layout.h"
+#include "drawing/drawing_text_stb.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Most recent layout; a paint measures and renders the same text */
+static TextLayout g_layout = {0};
+static wchar_t* g_layoutText = NULL;
+static MarkdownHeading* g_layoutHeadings = NULL;
+static int g_layoutHeadingCount = 0;
+static int g_layoutFontSize = 0;
+static BOOL g_layoutValid = FALSE;
+
+/* Per line: hash of its characters and heading levels (reuse key) */
+static ULONGLONG* g_lineHashes = NULL;
+
+/* Glyph window storage, in entries */
+static int g_glyphCapacity = 0;
+
+/* A scrolled window keeps growing only while it stays this close to the request */
+#define GLYPH_WINDOW_SLACK_LINES 64
+
+/**
+ * @brief Font values every line needs, resolved once per build
+ */
+typedef struct {
+    BOOL fallbackLoaded;
+    float baseScale;
+    float fallbackBaseScale;
+    int ascent;
+    int descent;
+    int lineGap;
+    int baseLineHeight;
+    int baseAscent;
+} LayoutFont;
+
+static float GetScaleForHeading(int level, float baseScale) {
+    switch (level) {
+        case 1: return baseScale * 1.5f;
+        case 2: return baseScale * 1.35f;
+        case 3: return baseScale * 1.2f;
+        case 4: return baseScale * 1.1f;
+        case 5: return baseScale * 1.0f;
+        case 6: return baseScale * 0.9f;
+        default: return baseScale;
+    }
+}
+
+static void FreeLayout(void) {
+    free(g_layout.glyphs);
+    free(g_layout.lines);
+    free(g_layoutText);
+    free(g_layoutHeadings);
+    free(g_lineHashes);
+    memset(&g_layout, 0, sizeof(g_layout));
+    g_layoutText = NULL;
+    g_layoutHeadings = NULL;
+    g_lineHashes = NULL;
+    g_glyphCapacity = 0;
+    g_layoutHeadingCount = 0;
+    g_layoutFontSize = 0;
+    g_layoutValid = FALSE;
+}
+
+void TextLayout_Clear(void) {
+    FreeLayout();
+}
+
+static BOOL MatchesCached(const wchar_t* text, const MarkdownHeading* headings,
+                          int headingCount, int fontSize) {
+    if (!g_layoutValid) return FALSE;
+    if (g_layoutFontSize != fontSize || g_layoutHeadingCount != headingCount) return FALSE;
+    if (headingCount > 0 &&
+        memcmp(g_layoutHeadings, headings, headingCount * sizeof(MarkdownHeading)) != 0) {
+        return FALSE;
+    }
+    return wcscmp(g_layoutText, text) == 0;
+}
+
+static void GetLayoutFont(int fontSize, LayoutFont* font) {
+    stbtt_fontinfo* fontInfo = GetMainFontInfoSTB();
+    font->fallbackLoaded = IsFallbackFontLoadedSTB();
+    font->baseScale = stbtt_ScaleForPixelHeight(fontInfo, (float)fontSize);
+    font->fallbackBaseScale = font->fallbackLoaded ?
+        stbtt_ScaleForPixelHeight(GetFallbackFontInfoSTB(), (float)fontSize) : 0;
+    stbtt_GetFontVMetrics(fontInfo, &font->ascent, &font->descent, &font->lineGap);
+    font->baseLineHeight = (int)((font->ascent - font->descent + font->lineGap) * font->baseScale);
+    font->baseAscent = (int)(font->ascent * font->baseScale);
+}
+
+/** @brief First heading that does not end at or before pos (headings are in text order) */
+static int FirstHeadingFrom(const MarkdownHeading* headings, int headingCount, int pos) {
+    int lo = 0, hi = headingCount;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (headings[mid].endPos <= pos) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Measure one line and optionally lay out its glyphs
+ * @param headingCursor Heading cursor at or before line->start; advanced
+ * @param glyphs Entry for text[line->start], or NULL to measure only
+ * @note Kerning never crosses a line break; '\x2500' (horizontal rule marker)
+ *       occupies space on its line but not in the measured width, matching
+ *       the renderer's full-width rule drawing.
+ */
+static void LayOutLine(const LayoutFont* font, const wchar_t* text,
+                       const MarkdownHeading* headings, int headingCount, int* headingCursor,
+                       LayoutLine* line, LayoutGlyph* glyphs) {
+    line->height = font->baseLineHeight;
+    line->ascent = font->baseAscent;
+    line->width = 0;
+
+    int curHeadingIdx = *headingCursor;
+    int penX = 0;
+    for (int j = line->start; j < line->end; j++) {
+        LayoutGlyph* g = glyphs ? &glyphs[j - line->start] : NULL;
+        if (g) g->x = penX;
+        if (text[j] == L'\r') continue;
+
+        float scale = font->baseScale;
+        float fallbackScale = font->fallbackBaseScale;
+        while (curHeadingIdx < headingCount && j >= headings[curHeadingIdx].endPos) curHeadingIdx++;
+        if (curHeadingIdx < headingCount && j >= headings[curHeadingIdx].startPos) {
+            scale = GetScaleForHeading(headings[curHeadingIdx].level, font->baseScale);
+            if (font->fallbackLoaded) {
+                fallbackScale = GetScaleForHeading(headings[curHeadingIdx].level, font->fallbackBaseScale);
+            }
+        }
+
+        int h = (int)((font->ascent - font->descent + font->lineGap) * scale);
+        if (h > line->height) line->height = h;
+        int asc = (int)(font->ascent * scale);
+        if (asc > line->ascent) line->ascent = asc;
+
+        GlyphMetrics gm;
+        GetCharMetricsSTB(text[j], (j < line->end - 1) ? text[j + 1] : 0, scale, fallbackScale, &gm);
+        if (g) {
+            g->scale = scale;
+            g->fallbackScale = fallbackScale;
+            g->index = gm.index;
+            g->isFallback = gm.isFallback;
+            g->advance = gm.advance;
+            g->kern = gm.kern;
+        }
+
+        penX += gm.advance + gm.kern;
+        if (text[j] != L'\x2500') line->width += gm.advance + gm.kern;
+    }
+    *headingCursor = curHeadingIdx;
+}
+
+/**
+ * @brief Hash a line's characters with the heading level of each
+ * @param checkboxes Incremented by the checkbox markers on the line
+ */
+static ULONGLONG HashLine(const wchar_t* text, int start, int end,
+                          const MarkdownHeading* headings, int headingCount,
+                          int* headingCursor, int* checkboxes) {
+    /* FNV-1a over (character, level) pairs */
+    ULONGLONG hash = 14695981039346656037ULL ^ (ULONGLONG)(end - start);
+    int cursor = *headingCursor;
+    for (int j = start; j < end; j++) {
+        while (cursor < headingCount && j >= headings[cursor].endPos) cursor++;
+        int level = (cursor < headingCount && j >= headings[cursor].startPos) ? headings[cursor].level : 0;
+        hash ^= (ULONGLONG)(unsigned int)text[j] | ((ULONGLONG)level << 32);
+        hash *= 1099511628211ULL;
+        if (text[j] == L'\x25A1' || text[j] == L'\x25A0') (*checkboxes)++;
+    }
+    *headingCursor = cursor;
+    return hash;
+}
+
+/** @brief Make room for count glyph entries, keeping the first keep */
+static BOOL ReserveGlyphs(int count, int keep) {
+    if (count < 1) count = 1;
+    if (count <= g_glyphCapacity) return TRUE;
+
+    int capacity = g_glyphCapacity > 0 ? g_glyphCapacity : 64;
+    while (capacity < count) capacity *= 2;
+    LayoutGlyph* glyphs = (LayoutGlyph*)malloc((size_t)capacity * sizeof(LayoutGlyph));
+    if (!glyphs) return FALSE;
+    if (keep > g_glyphCapacity) keep = g_glyphCapacity;  /* Line breaks have no entry to keep */
+    if (keep > 0) memcpy(glyphs, g_layout.glyphs, (size_t)keep * sizeof(LayoutGlyph));
+    free(g_layout.glyphs);
+    g_layout.glyphs = glyphs;
+    g_glyphCapacity = capacity;
+    return TRUE;
+}
+
+/**
+ * @brief Old line index by hash (open addressing, 0 = empty, else line + 1)
+ */
+typedef struct {
+    int* slots;
+    unsigned int mask;
+} LineMap;
+
+static BOOL BuildLineMap(LineMap* map) {
+    map->slots = NULL;
+    map->mask = 0;
+    if (!g_layoutValid || g_layout.lineCount == 0) return TRUE;
+
+    unsigned int size = 16;
+    while (size < (unsigned int)g_layout.lineCount * 2) size *= 2;
+    map->slots = (int*)calloc(size, sizeof(int));
+    if (!map->slots) return FALSE;
+    map->mask = size - 1;
+
+    for (int i = 0; i < g_layout.lineCount; i++) {
+        unsigned int slot = (unsigned int)g_lineHashes[i] & map->mask;
+        while (map->slots[slot] && g_lineHashes[map->slots[slot] - 1] != g_lineHashes[i]) {
+            slot = (slot + 1) & map->mask;
+        }
+        /* Identical lines share one entry */
+        if (!map->slots[slot]) map->slots[slot] = i + 1;
+    }
+    return TRUE;
+}
+
+/** @return Old line with the same hash and characters, or NULL */
+static const LayoutLine* FindOldLine(const LineMap* map, ULONGLONG hash,
+                                     const wchar_t* text, int start, int end) {
+    if (!map->slots) return NULL;
+    unsigned int slot = (unsigned int)hash & map->mask;
+    while (map->slots[slot]) {
+        int old = map->slots[slot] - 1;
+        if (g_lineHashes[old] == hash) {
+            const LayoutLine* line = &g_layout.lines[old];
+            if (line->end - line->start == end - start &&
+                wmemcmp(g_layoutText + line->start, text + start, (size_t)(end - start)) == 0) {
+                return line;
+            }
+            return NULL;
+        }
+        slot = (slot + 1) & map->mask;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Build the line index for new text, reusing boxes of unchanged lines
+ * @param allGlyphs Lay out glyphs for every line (full layout)
+ * @details Without allGlyphs, glyphs are still kept for the leading lines
+ *          that had to be measured anyway, so a measure followed by a full
+ *          render of new text walks the glyphs only once.
+ */
+static BOOL BuildIndex(const wchar_t* text, const MarkdownHeading* headings,
+                       int headingCount, int fontSize, BOOL allGlyphs) {
+    LayoutFont font;
+    GetLayoutFont(fontSize, &font);
+
+    int len = (int)wcslen(text);
+    int lineCount = 1;
+    for (int i = 0; i < len; i++) {
+        if (text[i] == L'\n') lineCount++;
+    }
+
+    /* Same font (font changes clear the cache) and size: old boxes stay valid */
+    BOOL canReuse = !allGlyphs && g_layoutValid && g_layoutFontSize == fontSize;
+
+    wchar_t* newText = (wchar_t*)malloc((len + 1) * sizeof(wchar_t));
+    LayoutLine* lines = (LayoutLine*)calloc(lineCount, sizeof(LayoutLine));
+    ULONGLONG* hashes = (ULONGLONG*)malloc(lineCount * sizeof(ULONGLONG));
+    MarkdownHeading* newHeadings = NULL;
+    if (headingCount > 0) {
+        newHeadings = (MarkdownHeading*)malloc(headingCount * sizeof(MarkdownHeading));
+    }
+    LineMap map = { NULL, 0 };
+    if (!newText || !lines || !hashes || (headingCount > 0 && !newHeadings) ||
+        (canReuse && !BuildLineMap(&map))) {
+        free(newText);
+        free(lines);
+        free(hashes);
+        free(newHeadings);
+        FreeLayout();
+        return FALSE;
+    }
+
+    /* The glyph buffer is rewritten from the start; its old content is not needed */
+    g_layout.glyphStart = 0;
+    g_layout.glyphLineStart = 0;
+    g_layout.glyphLineEnd = 0;
+    if (allGlyphs && !ReserveGlyphs(len, 0)) {
+        free(map.slots);
+        free(newText);
+        free(lines);
+        free(hashes);
+        free(newHeadings);
+        FreeLayout();
+        return FALSE;
+    }
+
+    int hashCursor = 0;
+    int layoutCursor = 0;
+    int checkboxes = 0;
+    int lineStart = 0;
+    int lineIdx = 0;
+    int width = 0;
+    int y = 0;
+    BOOL glyphRun = TRUE;  /* Every line so far has glyphs */
+
+    for (int i = 0; i <= len; i++) {
+        if (i < len && text[i] != L'\n') continue;
+
+        LayoutLine* line = &lines[lineIdx];
+        line->start = lineStart;
+        line->end = i;
+        line->y = y;
+        line->checkboxesBefore = checkboxes;
+        hashes[lineIdx] = HashLine(text, lineStart, i, headings, headingCount, &hashCursor, &checkboxes);
+
+        const LayoutLine* old = canReuse ?
+            FindOldLine(&map, hashes[lineIdx], text, lineStart, i) : NULL;
+        if (old) {
+            line->height = old->height;
+            line->ascent = old->ascent;
+            line->width = old->width;
+            glyphRun = FALSE;
+        } else {
+            LayoutGlyph* glyphs = NULL;
+            if (glyphRun && ReserveGlyphs(i, lineStart)) {
+                glyphs = g_layout.glyphs + lineStart;
+                memset(glyphs, 0, (size_t)(i - lineStart) * sizeof(LayoutGlyph));
+            } else {
+                glyphRun = FALSE;
+            }
+            LayOutLine(&font, text, headings, headingCount, &layoutCursor, line, glyphs);
+            if (glyphRun) g_layout.glyphLineEnd = lineIdx + 1;
+        }
+
+        if (line->width > width) width = line->width;
+        y += line->height;
+        lineStart = i + 1;
+        lineIdx++;
+    }
+    free(map.slots);
+
+    memcpy(newText, text, (len + 1) * sizeof(wchar_t));
+    if (headingCount > 0) {
+        memcpy(newHeadings, headings, headingCount * sizeof(MarkdownHeading));
+    }
+
+    free(g_layout.lines);
+    free(g_layoutText);
+    free(g_layoutHeadings);
+    free(g_lineHashes);
+    g_layoutText = newText;
+    g_layoutHeadings = newHeadings;
+    g_lineHashes = hashes;
+    g_layoutHeadingCount = headingCount;
+    g_layoutFontSize = fontSize;
+    g_layout.text = g_layoutText;
+    g_layout.length = len;
+    g_layout.lines = lines;
+    g_layout.lineCount = lineCount;
+    g_layout.width = width;
+    g_layout.height = y;
+    g_layoutValid = TRUE;
+    return TRUE;
+}
+
+/**
+ * @brief Make glyphs available for lines [first, last)
+ * @details A window that already covers the start of the range is extended
+ *          in place (scrolling down, or the full layout after a measure);
+ *          anything else is laid out afresh.
+ */
+static BOOL EnsureGlyphs(int first, int last) {
+    if (first >= last) return TRUE;
+    if (g_layout.glyphLineStart <= first && last <= g_layout.glyphLineEnd) return TRUE;
+
+    int from;
+    if (g_layout.glyphLineEnd > g_layout.glyphLineStart &&
+        g_layout.glyphLineStart <= first && first <= g_layout.glyphLineEnd &&
+        last - g_layout.glyphLineStart <= 2 * (last - first) + GLYPH_WINDOW_SLACK_LINES) {
+        from = g_layout.glyphLineEnd;
+    } else {
+        g_layout.glyphStart = g_layout.lines[first].start;
+        g_layout.glyphLineStart = first;
+        g_layout.glyphLineEnd = first;
+        from = first;
+    }
+
+    int keep = g_layout.lines[from].start - g_layout.glyphStart;
+    if (!ReserveGlyphs(g_layout.lines[last - 1].end - g_layout.glyphStart, keep)) {
+        g_layout.glyphLineStart = g_layout.glyphLineEnd = 0;
+        return FALSE;
+    }
+
+    LayoutFont font;
+    GetLayoutFont(g_layoutFontSize, &font);
+    int headingCursor = FirstHeadingFrom(g_layoutHeadings, g_layoutHeadingCount, g_layout.lines[from].start);
+    for (int l = from; l < last; l++) {
+        LayoutLine box = g_layout.lines[l];
+        LayoutGlyph* glyphs = g_layout.glyphs + (box.start - g_layout.glyphStart);
+        memset(glyphs, 0, (size_t)(box.end - box.start) * sizeof(LayoutGlyph));
+        LayOutLine(&font, g_layoutText, g_layoutHeadings, g_layoutHeadingCount, &headingCursor, &box, glyphs);
+    }
+    g_layout.glyphLineEnd = last;
+    return TRUE;
+}
+
+const TextLayout* TextLayout_Get(const wchar_t* text,
+                                 const MarkdownHeading* headings, int headingCount,
+                                 int fontSize) {
+    if (!text || !IsFontLoadedSTB()) return NULL;
+    if (!headings) headingCount = 0;
+
+    if (!MatchesCached(text, headings, headingCount, fontSize)) {
+        if (!BuildIndex(text, headings, headingCount, fontSize, TRUE)) return NULL;
+    }
+    if (!EnsureGlyphs(0, g_layout.lineCount)) return NULL;
+    return &g_layout;
+}
+
+const TextLayout* TextLayout_GetLines(const wchar_t* text,
+                                      const MarkdownHeading* headings, int headingCount,
+                                      int fontSize, int top, int bottom) {
+    if (!text || !IsFontLoadedSTB()) return NULL;
+    if (!headings) headingCount = 0;
+
+    if (!MatchesCached(text, headings, headingCount, fontSize)) {
+        if (!BuildIndex(text, headings, headingCount, fontSize, FALSE)) return NULL;
+    }
+    if (top < bottom) {
+        int first = TextLayout_LineAt(&g_layout, top);
+        int last = TextLayout_LineAt(&g_layout, bottom - 1) + 1;
+        if (!EnsureGlyphs(first, last)) return NULL;
+    }
+    return &g_layout;
+}
+
+int TextLayout_LineAt(const TextLayout* layout, int y) {
+    /* Last line whose top is at or above y */
+    int lo = 0, hi = layout->lineCount - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (layout->lines[mid].y <= y) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
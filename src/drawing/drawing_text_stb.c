@@ -5,8 +5,18 @@
 
 #include "drawing/drawing_text_stb.h"
 #include "drawing/drawing_effect.h"
+#include "drawing/drawing_effect_cache.h"
+#include "drawing/drawing_blend_simd.h"
+#include "drawing/drawing_glyph_cache.h"
+#include "drawing/drawing_sdf_atlas.h"
+#include "drawing/drawing_font_metrics.h"
+#include "drawing/drawing_frame_governor.h"
+#include "drawing/drawing_text_layout.h"
+#include "drawing/drawing_text_layer.h"
+#include "drawing/drawing_render_core.h"
 #include "menu_preview.h"
 #include "log.h"
+#include "log/log_probe.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <windows.h>
@@ -117,6 +127,7 @@ void CleanupFontSTB(void) {
     
     /* Cleanup font cache */
     ClearFontCacheSTB();
+    FontMetrics_Reset();
     
     g_fontLoaded = FALSE;
     g_fallbackFontLoaded = FALSE;
@@ -124,6 +135,8 @@ void CleanupFontSTB(void) {
     
     /* Also cleanup effect buffers */
     CleanupDrawingEffects();
+    TextLayer_Cleanup();
+    EffectCache_Clear();
 }
 
 BOOL InitFontSTB(const char* fontFilePath) {
@@ -151,7 +164,7 @@ BOOL InitFontSTB(const char* fontFilePath) {
         return FALSE;
     }
 
-    // Success - now replace the global state
+    // Success - now replace the global state (also drops cached glyphs of the old face)
     CleanupFontSTB();
     
     g_fontBuffer = newBuffer;
@@ -210,76 +223,6 @@ BOOL InitFontSTB(const char* fontFilePath) {
     return TRUE;
 }
 
-/**
- * @brief Blend a single character bitmap into the destination buffer
- */
-void BlendCharBitmapSTB(void* destBits, int destWidth, int destHeight, 
-                          int x_pos, int y_pos, 
-                          unsigned char* bitmap, int w, int h, 
-                          int r, int g, int b) {
-    DWORD* pixels = (DWORD*)destBits;
-
-    /* Determine active effect (supports live preview) */
-    EffectType effect = GetActiveEffect();
-    
-    /* 
-     * FIX: Use raw GetTickCount() instead of % 10000.
-     * The previous modulo 10000 caused a visual "jump" every 10 seconds because
-     * 9999 -> 0 is a discontinuity in the phase calculation.
-     * The internal effect functions use sin() or bitwise masking which handles
-     * large numbers naturally and continuously.
-     */
-    int timeOffset = (int)GetTickCount();
-
-    /* Render glow or glass effect if enabled */
-    if (effect == EFFECT_TYPE_GLOW) {
-        RenderGlowEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, NULL, NULL);
-    } else if (effect == EFFECT_TYPE_GLASS) {
-        RenderGlassEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, NULL, NULL);
-        /* Critical: Return early */
-        return;
-    } else if (effect == EFFECT_TYPE_NEON) {
-        RenderNeonEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, NULL, NULL);
-        /* Critical: Return early (Tube replaces solid text) */
-        return;
-    } else if (effect == EFFECT_TYPE_HOLOGRAPHIC) {
-        RenderHolographicEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, NULL, NULL, timeOffset);
-        /* Critical: Return early */
-        return;
-    } else if (effect == EFFECT_TYPE_LIQUID) {
-        RenderLiquidEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, NULL, NULL, timeOffset);
-        /* Critical: Return early */
-        return;
-    }
-
-    for (int j = 0; j < h; ++j) {
-        for (int i = 0; i < w; ++i) {
-            int screen_x = x_pos + i;
-            int screen_y = y_pos + j;
-
-            if (screen_x >= 0 && screen_x < destWidth && screen_y >= 0 && screen_y < destHeight) {
-                unsigned char alpha = bitmap[j * w + i];
-                if (alpha == 0) continue;
-
-                /* Calculate premultiplied color values for UpdateLayeredWindow */
-                DWORD finalR = (r * alpha) / 255;
-                DWORD finalG = (g * alpha) / 255;
-                DWORD finalB = (b * alpha) / 255;
-                DWORD finalA = (DWORD)alpha;
-
-                DWORD currentPixel = pixels[screen_y * destWidth + screen_x];
-                DWORD currentA = (currentPixel >> 24) & 0xFF;
-                
-                /* If new pixel is more opaque, overwrite */
-                if (alpha > currentA) {
-                    pixels[screen_y * destWidth + screen_x] = 
-                        (finalA << 24) | (finalR << 16) | (finalG << 8) | finalB;
-                }
-            }
-        }
-    }
-}
-
 /* Pre-calculated gradient LUT to reduce CPU usage */
 #define LUT_SIZE GRADIENT_LUT_SIZE
 static COLORREF g_gradientLUT[LUT_SIZE];
@@ -394,38 +337,125 @@ static void InitializeGradientLUT(const GradientInfo* info) {
     g_lutType = info->type;
 }
 
-void BlendCharBitmapGradientSTB(void* destBits, int destWidth, int destHeight, 
-                                int x_pos, int y_pos, 
-                                unsigned char* bitmap, int w, int h, 
-                                int startX, int totalWidth, int gradientType,
-                                int timeOffset) {
-    DWORD* pixels = (DWORD*)destBits;
-    
+
+/**
+ * @brief Resolve gradient info and refresh the animation LUT if needed
+ */
+static const GradientInfo* PrepareGradientSTB(int gradientType) {
     const GradientInfo* info = GetGradientInfo((GradientType)gradientType);
-    // Allow isAnimated check to gate LUT logic
-    if (!info && !IsGradientAnimated((GradientType)gradientType)) return;
+    if (!info || !info->isAnimated) return info;
+
+    BOOL needLutUpdate = (g_lutType != (GradientType)gradientType);
+
+    /* Check for custom gradient updates */
+    if ((GradientType)gradientType == GRADIENT_CUSTOM) {
+        static uint32_t lastCustomVer = 0;
+        uint32_t currVer = GetCustomGradientVersion();
+        if (currVer != lastCustomVer) {
+            needLutUpdate = TRUE;
+            lastCustomVer = currVer;
+        }
+    }
+
+    if (needLutUpdate) InitializeGradientLUT(info);
+    return info;
+}
+
+/**
+ * @brief Run the active effect over a glyph or a whole text run
+ * @return TRUE if the effect replaces the text body, FALSE if it must still be drawn
+ */
+static BOOL RenderTextEffectSTB(DWORD* pixels, int destWidth, int destHeight,
+                                int x_pos, int y_pos, unsigned char* bitmap, int w, int h,
+                                const unsigned char* field, const TextLayerPaint* paint) {
+    EffectType effect = GetActiveEffect();
+    if (effect == EFFECT_TYPE_NONE) return FALSE;
 
+    GlowGradientContext ctx = { NULL, paint->startX, paint->totalWidth, paint->timeOffset };
+    GlowColorCallback colorCb = NULL;
+    int timeOffset;
+
+    if (paint->gradientType != GRADIENT_NONE) {
+        /* Gradient start color as base, callback for per-pixel color */
+        ctx.info = GetGradientInfo((GradientType)paint->gradientType);
+        if (!ctx.info) return FALSE;
+        colorCb = GetGlowGradientColor;
+        timeOffset = paint->timeOffset;
+    } else {
+        /*
+         * FIX: Use the raw tick count instead of % 10000.
+         * The previous modulo 10000 caused a visual "jump" every 10 seconds because
+         * 9999 -> 0 is a discontinuity in the phase calculation.
+         * The internal effect functions use sin() or bitwise masking which handles
+         * large numbers naturally and continuously.
+         */
+        timeOffset = (int)RenderCore_GetTime();
+    }
+
+    int r = paint->r, g = paint->g, b = paint->b;
+    LONGLONG effectStart = FrameGovernor_Now();
+    BOOL replacesBody = TRUE;
+
+    if (effect == EFFECT_TYPE_GLOW) {
+        RenderGlowEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, colorCb, &ctx, field);
+        /* Glow sits under the regular text body */
+        replacesBody = FALSE;
+    } else if (effect == EFFECT_TYPE_GLASS) {
+        RenderGlassEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, colorCb, &ctx, field);
+    } else if (effect == EFFECT_TYPE_NEON) {
+        /* Tube replaces solid text */
+        RenderNeonEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b, colorCb, &ctx, field);
+    } else if (effect == EFFECT_TYPE_HOLOGRAPHIC) {
+        RenderHolographicEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b,
+                                colorCb, &ctx, timeOffset);
+    } else if (effect == EFFECT_TYPE_LIQUID) {
+        RenderLiquidEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b,
+                           colorCb, &ctx, timeOffset);
+    } else {
+        return FALSE;
+    }
+
+    FrameGovernor_AddNested(FRAME_STAGE_EFFECT, effectStart);
+    PROBE_END(PROBE_EFFECTS, effectStart);
+    return replacesBody;
+}
+
+/**
+ * @brief Composite solid-colored coverage where it is more opaque than the destination
+ */
+static void BlendSolidCoverageSTB(DWORD* pixels, int destWidth, int destHeight,
+                                  int x_pos, int y_pos, const unsigned char* bitmap, int w, int h,
+                                  int r, int g, int b) {
+    /* Clip once per glyph, then composite whole row spans */
+    int start_i = (x_pos < 0) ? -x_pos : 0;
+    int end_i = (x_pos + w > destWidth) ? destWidth - x_pos : w;
+    int start_j = (y_pos < 0) ? -y_pos : 0;
+    int end_j = (y_pos + h > destHeight) ? destHeight - y_pos : h;
+    if (start_i >= end_i || start_j >= end_j) return;
+
+    const BlendKernels* kernels = BlendKernels_Get();
+    DWORD color = ((DWORD)r << 16) | ((DWORD)g << 8) | (DWORD)b;
+    for (int j = start_j; j < end_j; ++j) {
+        kernels->maxSolid(pixels + (y_pos + j) * destWidth + x_pos + start_i,
+                          bitmap + j * w + start_i, end_i - start_i, color);
+    }
+}
+
+/**
+ * @brief Composite gradient-colored coverage where it is more opaque than the destination
+ * @param info Gradient (LUT already prepared for animated ones), may be NULL
+ */
+static void BlendGradientCoverageSTB(DWORD* pixels, int destWidth, int destHeight,
+                                     int x_pos, int y_pos, const unsigned char* bitmap, int w, int h,
+                                     int startX, int totalWidth, const GradientInfo* info,
+                                     int timeOffset) {
     int r1 = 0, g1 = 0, b1 = 0;
     int r2 = 0, g2 = 0, b2 = 0;
 
     /* Animation parameters */
     float lutStep = 0.0f;
-    
-    if (info && info->isAnimated) {
-        BOOL needLutUpdate = (g_lutType != (GradientType)gradientType);
-        
-        /* Check for custom gradient updates */
-        if ((GradientType)gradientType == GRADIENT_CUSTOM) {
-            static uint32_t lastCustomVer = 0;
-            uint32_t currVer = GetCustomGradientVersion();
-            if (currVer != lastCustomVer) {
-                needLutUpdate = TRUE;
-                lastCustomVer = currVer;
-            }
-        }
-
-        if (needLutUpdate) InitializeGradientLUT(info);
 
+    if (info && info->isAnimated) {
         if (totalWidth > 0) {
             lutStep = (float)LUT_SIZE / (float)totalWidth;
         }
@@ -433,151 +463,210 @@ void BlendCharBitmapGradientSTB(void* destBits, int destWidth, int destHeight,
         r1 = GetRValue(info->startColor);
         g1 = GetGValue(info->startColor);
         b1 = GetBValue(info->startColor);
-        
+
         r2 = GetRValue(info->endColor);
         g2 = GetGValue(info->endColor);
         b2 = GetBValue(info->endColor);
     }
 
-    /* Render glow effect if enabled - use gradient start color as base but use callback for per-pixel color */
-    EffectType effect = GetActiveEffect();
+    /* Compute clipping for X (identical for every row) */
+    int start_i = 0;
+    int end_i = w;
 
-    if (effect == EFFECT_TYPE_GLOW && info) {
-        int glowR = GetRValue(info->startColor);
-        int glowG = GetGValue(info->startColor);
-        int glowB = GetBValue(info->startColor);
-        
-        GlowGradientContext ctx = { info, startX, totalWidth, timeOffset };
-        RenderGlowEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, 
-                         glowR, glowG, glowB, GetGlowGradientColor, &ctx);
-    } else if (effect == EFFECT_TYPE_GLASS && info) {
-        int glassR = GetRValue(info->startColor);
-        int glassG = GetGValue(info->startColor);
-        int glassB = GetBValue(info->startColor);
-        
-        GlowGradientContext ctx = { info, startX, totalWidth, timeOffset };
-        RenderGlassEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, 
-                         glassR, glassG, glassB, GetGlowGradientColor, &ctx);
-        /* 
-           CRITICAL: Return early to prevent solid gradient overwriting the glass effect.
-        */
-        return;
-    } else if (effect == EFFECT_TYPE_NEON && info) {
-        int neonR = GetRValue(info->startColor);
-        int neonG = GetGValue(info->startColor);
-        int neonB = GetBValue(info->startColor);
-        
-        GlowGradientContext ctx = { info, startX, totalWidth, timeOffset };
-        RenderNeonEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, 
-                         neonR, neonG, neonB, GetGlowGradientColor, &ctx);
-        /* Neon replaces solid text */
-        return;
-    } else if (effect == EFFECT_TYPE_HOLOGRAPHIC && info) {
-        int holoR = GetRValue(info->startColor);
-        int holoG = GetGValue(info->startColor);
-        int holoB = GetBValue(info->startColor);
-        
-        GlowGradientContext ctx = { info, startX, totalWidth, timeOffset };
-        RenderHolographicEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, 
-                                holoR, holoG, holoB, GetGlowGradientColor, &ctx, timeOffset);
-        /* Critical: Return early */
-        return;
-    } else if (effect == EFFECT_TYPE_LIQUID && info) {
-        int liquidR = GetRValue(info->startColor);
-        int liquidG = GetGValue(info->startColor);
-        int liquidB = GetBValue(info->startColor);
-        
-        GlowGradientContext ctx = { info, startX, totalWidth, timeOffset };
-        RenderLiquidEffect(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, 
-                           liquidR, liquidG, liquidB, GetGlowGradientColor, &ctx, timeOffset);
-        /* Critical: Return early */
-        return;
-    }
+    if (x_pos < 0) start_i = -x_pos;
+    if (x_pos + w > destWidth) end_i = destWidth - x_pos;
 
-    for (int j = 0; j < h; ++j) {
-        /* Compute clipping for Y */
-        int screen_y = y_pos + j;
-        if (screen_y < 0 || screen_y >= destHeight) {
-            /* Skip this row, but must advance gradient state if Animated */
-            if (info && info->isAnimated) {
-                // logic handled by row start calc
-            }
-            continue;
-        }
+    if (start_i >= end_i) return;
 
-        /* Compute clipping for X */
-        int start_i = 0;
-        int end_i = w;
-        
-        if (x_pos < 0) start_i = -x_pos;
-        if (x_pos + w > destWidth) end_i = destWidth - x_pos;
-        
-        if (start_i >= end_i) continue;
+    /* Gradient color depends only on the column, so resolve it once per glyph */
+    int spanWidth = end_i - start_i;
+    DWORD* columnColors = BlendKernels_ColumnScratch(spanWidth);
+    if (!columnColors) return;
+
+    float currentLutIdxFloat = 0.0f;
+    if (info && info->isAnimated) {
+        int rowStartX = (x_pos + start_i) - startX;
+        if (totalWidth > 0) {
+            currentLutIdxFloat = ((float)rowStartX / (float)totalWidth) * LUT_SIZE;
+        }
+    }
 
-        /* Pointers */
-        DWORD* destRow = pixels + (screen_y * destWidth) + (x_pos + start_i);
-        unsigned char* srcRow = bitmap + (j * w) + start_i;
+    for (int i = start_i; i < end_i; ++i) {
+        int r, g, b;
 
-        /* Pre-calculate starting LUT index for this row if Animated */
-        float currentLutIdxFloat = 0.0f;
         if (info && info->isAnimated) {
-            int rowStartX = (x_pos + start_i) - startX;
+            /* Optimized LUT Lookup */
+            int lutIdx = (int)currentLutIdxFloat - timeOffset;
+            currentLutIdxFloat += lutStep;
+
+            /* Optimized wrap-around logic */
+            lutIdx = lutIdx & (LUT_SIZE - 1);
+
+            COLORREF c = g_gradientLUT[lutIdx];
+            r = GetRValue(c);
+            g = GetGValue(c);
+            b = GetBValue(c);
+        } else {
+            /* Standard Logic */
+            float t = 0.0f;
             if (totalWidth > 0) {
-                currentLutIdxFloat = ((float)rowStartX / (float)totalWidth) * LUT_SIZE;
+                t = (float)((x_pos + i) - startX) / (float)totalWidth;
             }
+            if (t < 0.0f) t = 0.0f; else if (t > 1.0f) t = 1.0f;
+
+            r = (int)(r1 + (r2 - r1) * t);
+            g = (int)(g1 + (g2 - g1) * t);
+            b = (int)(b1 + (b2 - b1) * t);
         }
 
-        for (int i = start_i; i < end_i; ++i) {
-            unsigned char alpha = *srcRow++;
-            
-            if (alpha == 0) {
-                if (info && info->isAnimated) currentLutIdxFloat += lutStep;
-                destRow++;
-                continue;
-            }
+        columnColors[i - start_i] = ((DWORD)r << 16) | ((DWORD)g << 8) | (DWORD)b;
+    }
 
-            int r, g, b;
-
-            if (info && info->isAnimated) {
-                /* Optimized LUT Lookup */
-                int lutIdx = (int)currentLutIdxFloat - timeOffset;
-                currentLutIdxFloat += lutStep;
-                
-                /* Optimized wrap-around logic */
-                lutIdx = lutIdx & (LUT_SIZE - 1);
-                
-                COLORREF c = g_gradientLUT[lutIdx];
-                r = GetRValue(c);
-                g = GetGValue(c);
-                b = GetBValue(c);
-            } else {
-                /* Standard Logic */
-                float t = 0.0f;
-                if (totalWidth > 0) {
-                    t = (float)((x_pos + i) - startX) / (float)totalWidth;
-                }
-                if (t < 0.0f) t = 0.0f; else if (t > 1.0f) t = 1.0f;
-
-                r = (int)(r1 + (r2 - r1) * t);
-                g = (int)(g1 + (g2 - g1) * t);
-                b = (int)(b1 + (b2 - b1) * t);
-            }
+    /* Blend rows where the new pixel is more opaque */
+    const BlendKernels* kernels = BlendKernels_Get();
+    for (int j = 0; j < h; ++j) {
+        int screen_y = y_pos + j;
+        if (screen_y < 0 || screen_y >= destHeight) continue;
 
-            /* Blend */
-            DWORD currentPixel = *destRow;
-            DWORD currentA = (currentPixel >> 24) & 0xFF;
-            
-            if (alpha > currentA) {
-                DWORD finalR = (r * alpha) / 255;
-                DWORD finalG = (g * alpha) / 255;
-                DWORD finalB = (b * alpha) / 255;
-                DWORD finalA = (DWORD)alpha;
-                
-                *destRow = (finalA << 24) | (finalR << 16) | (finalG << 8) | finalB;
-            }
-            destRow++;
+        kernels->maxColumns(pixels + (screen_y * destWidth) + (x_pos + start_i),
+                            bitmap + (j * w) + start_i, columnColors, spanWidth);
+    }
+}
+
+/**
+ * @brief Key a run drawn with a time-invariant effect for the effect cache
+ * @param region Output: destination area the effect and body can touch
+ * @return FALSE if the run's output changes with time and must be redrawn
+ */
+static BOOL GetEffectRunKeySTB(const DWORD* pixels, int destWidth, int destHeight,
+                               int x, int y, const unsigned char* mask, int w, int h,
+                               const unsigned char* field, const TextLayerPaint* paint,
+                               RECT* region, ULONGLONG* key) {
+    EffectType effect = GetActiveEffect();
+    const EffectTraits* traits = GetEffectTraits(effect);
+    if (!traits || traits->timeDependent) return FALSE;
+    if (paint->gradientType != GRADIENT_NONE &&
+        IsGradientAnimated((GradientType)paint->gradientType)) return FALSE;
+
+    region->left = (x - traits->padding < 0) ? 0 : x - traits->padding;
+    region->top = (y - traits->padding < 0) ? 0 : y - traits->padding;
+    region->right = (x + w + traits->padding > destWidth) ? destWidth : x + w + traits->padding;
+    region->bottom = (y + h + traits->padding > destHeight) ? destHeight : y + h + traits->padding;
+    if (region->left >= region->right || region->top >= region->bottom) return FALSE;
+
+    /* Custom gradients change colors without changing their type */
+    int header[7] = { (int)effect, (int)GetEffectQuality(), x, y, w, h,
+                      (int)GetCustomGradientVersion() };
+    ULONGLONG hash = EffectCache_Hash(header, sizeof(header), EFFECT_CACHE_HASH_SEED);
+
+    /* Static paints ignore timeOffset; callers may still pass a clock */
+    TextLayerPaint stablePaint = *paint;
+    stablePaint.timeOffset = 0;
+    hash = EffectCache_Hash(&stablePaint, sizeof(stablePaint), hash);
+    hash = EffectCache_Hash(mask, (size_t)w * (size_t)h, hash);
+    if (field) hash = EffectCache_Hash(field, (size_t)w * (size_t)h, hash);
+
+    /* Effects blend with what is underneath (earlier runs, background) */
+    *key = EffectCache_HashRegion(pixels, destWidth, region, hash);
+    return TRUE;
+}
+
+/**
+ * @brief Draw one finished text run: effect over the union mask, then the body
+ */
+static void FlushTextLayerSTB(DWORD* pixels, int destWidth, int destHeight,
+                              int x, int y, unsigned char* mask, int w, int h,
+                              const unsigned char* field, const TextLayerPaint* paint) {
+    RECT region;
+    ULONGLONG key = 0;
+    BOOL cacheable = GetEffectRunKeySTB(pixels, destWidth, destHeight, x, y, mask, w, h,
+                                        field, paint, &region, &key);
+    if (cacheable && EffectCache_Restore(key, pixels, destWidth, &region)) return;
+
+    const GradientInfo* info = NULL;
+    if (paint->gradientType != GRADIENT_NONE) {
+        info = PrepareGradientSTB(paint->gradientType);
+    }
+
+    if (!RenderTextEffectSTB(pixels, destWidth, destHeight, x, y, mask, w, h, field, paint)) {
+        if (paint->gradientType != GRADIENT_NONE) {
+            BlendGradientCoverageSTB(pixels, destWidth, destHeight, x, y, mask, w, h,
+                                     paint->startX, paint->totalWidth, info, paint->timeOffset);
+        } else {
+            BlendSolidCoverageSTB(pixels, destWidth, destHeight, x, y, mask, w, h,
+                                  paint->r, paint->g, paint->b);
         }
     }
+
+    if (cacheable) EffectCache_Store(key, pixels, destWidth, &region);
+}
+
+BOOL BeginTextLayerSTB(void* bits, int width, int height) {
+    /* Without an effect glyphs are cheapest drawn directly */
+    if (GetActiveEffect() == EFFECT_TYPE_NONE) return FALSE;
+    return TextLayer_Begin(bits, width, height, FlushTextLayerSTB);
+}
+
+void EndTextLayerSTB(void) {
+    TextLayer_End();
+}
+
+/**
+ * @brief Blend a single character bitmap into the destination buffer
+ */
+void BlendCharBitmapSTB(void* destBits, int destWidth, int destHeight,
+                          int x_pos, int y_pos,
+                          unsigned char* bitmap, int w, int h,
+                          int r, int g, int b) {
+    DWORD* pixels = (DWORD*)destBits;
+
+    /* Determine active effect (supports live preview) */
+    if (GetActiveEffect() != EFFECT_TYPE_NONE) {
+        TextLayerPaint paint;
+        memset(&paint, 0, sizeof(paint));
+        paint.gradientType = GRADIENT_NONE;
+        paint.r = r;
+        paint.g = g;
+        paint.b = b;
+
+        /* Inside a text layer the effect runs once for the whole run */
+        const unsigned char* field = SdfAtlas_FieldOf(bitmap, w, h);
+        if (TextLayer_AddGlyph(x_pos, y_pos, bitmap, w, h, field, &paint)) return;
+        if (RenderTextEffectSTB(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, field, &paint)) return;
+    }
+
+    BlendSolidCoverageSTB(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, r, g, b);
+}
+
+void BlendCharBitmapGradientSTB(void* destBits, int destWidth, int destHeight,
+                                int x_pos, int y_pos,
+                                unsigned char* bitmap, int w, int h,
+                                int startX, int totalWidth, int gradientType,
+                                int timeOffset) {
+    DWORD* pixels = (DWORD*)destBits;
+
+    const GradientInfo* info = PrepareGradientSTB(gradientType);
+    // Allow isAnimated check to gate LUT logic
+    if (!info && !IsGradientAnimated((GradientType)gradientType)) return;
+
+    if (info && GetActiveEffect() != EFFECT_TYPE_NONE) {
+        TextLayerPaint paint;
+        memset(&paint, 0, sizeof(paint));
+        paint.gradientType = gradientType;
+        paint.r = GetRValue(info->startColor);
+        paint.g = GetGValue(info->startColor);
+        paint.b = GetBValue(info->startColor);
+        paint.startX = startX;
+        paint.totalWidth = totalWidth;
+        paint.timeOffset = timeOffset;
+
+        const unsigned char* field = SdfAtlas_FieldOf(bitmap, w, h);
+        if (TextLayer_AddGlyph(x_pos, y_pos, bitmap, w, h, field, &paint)) return;
+        if (RenderTextEffectSTB(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h, field, &paint)) return;
+    }
+
+    BlendGradientCoverageSTB(pixels, destWidth, destHeight, x_pos, y_pos, bitmap, w, h,
+                             startX, totalWidth, info, timeOffset);
 }
 
 void GetCharMetricsSTB(wchar_t c, wchar_t nextC, float scale, float fallbackScale, GlyphMetrics* out) {
@@ -590,157 +679,34 @@ void GetCharMetricsSTB(wchar_t c, wchar_t nextC, float scale, float fallbackScal
     
     if (c == L'\t') {
         // Tab = 4 spaces
-        int spaceIdx = stbtt_FindGlyphIndex(&g_fontInfo, ' ');
-        int adv, lsb;
-        stbtt_GetGlyphHMetrics(&g_fontInfo, spaceIdx, &adv, &lsb);
-        out->advance = (int)(adv * scale * 4);
+        const CodepointGlyph* space = FontMetrics_Lookup(L' ');
+        if (space) out->advance = (int)(space->advanceUnits * scale * 4);
         return;
     }
 
-    out->index = stbtt_FindGlyphIndex(&g_fontInfo, (int)c);
-    
-    if (out->index == 0 && g_fallbackFontLoaded && c != L' ') {
-        int fallbackIndex = stbtt_FindGlyphIndex(&g_fallbackFontInfo, (int)c);
-        if (fallbackIndex != 0) {
-            out->index = fallbackIndex;
-            out->isFallback = TRUE;
-        }
-    }
+    /* Fallback chain and advance are resolved once per codepoint */
+    const CodepointGlyph* glyph = FontMetrics_Lookup(c);
+    if (!glyph) return;
+
+    out->index = glyph->index;
+    out->isFallback = glyph->isFallback;
 
-    int adv, lsb;
     if (out->isFallback) {
-        stbtt_GetGlyphHMetrics(&g_fallbackFontInfo, out->index, &adv, &lsb);
-        out->advance = (int)(adv * fallbackScale);
+        out->advance = (int)(glyph->advanceUnits * fallbackScale);
     } else {
-        stbtt_GetGlyphHMetrics(&g_fontInfo, out->index, &adv, &lsb);
-        out->advance = (int)(adv * scale);
+        out->advance = (int)(glyph->advanceUnits * scale);
         
         // Kerning
         if (nextC && nextC != L'\n' && nextC != L'\r') {
-            int nextIdx = stbtt_FindGlyphIndex(&g_fontInfo, (int)nextC);
-            if (nextIdx != 0) {
-                out->kern = (int)(stbtt_GetGlyphKernAdvance(&g_fontInfo, out->index, nextIdx) * scale);
+            const CodepointGlyph* next = FontMetrics_Lookup(nextC);
+            /* Only main-face glyphs kern; a fallback glyph has no main index */
+            if (next && next->index != 0 && !next->isFallback) {
+                out->kern = (int)(FontMetrics_KernUnits(out->index, next->index) * scale);
             }
         }
     }
 }
 
-BOOL MeasureTextSTB(const wchar_t* text, int fontSize, int* width, int* height) {
-    if (!g_fontLoaded || !text) return FALSE;
-
-    float scale = stbtt_ScaleForPixelHeight(&g_fontInfo, (float)fontSize);
-    float fallbackScale = g_fallbackFontLoaded ? stbtt_ScaleForPixelHeight(&g_fallbackFontInfo, (float)fontSize) : 0;
-
-    int maxWidth = 0;
-    int curLineWidth = 0;
-    int lineCount = 1;
-    size_t len = wcslen(text);
-
-    for (size_t i = 0; i < len; i++) {
-        if (text[i] == L'\n') {
-            if (curLineWidth > maxWidth) maxWidth = curLineWidth;
-            curLineWidth = 0;
-            lineCount++;
-            continue;
-        }
-        if (text[i] == L'\r') continue;
-
-        GlyphMetrics gm;
-        GetCharMetricsSTB(text[i], (i < len - 1) ? text[i+1] : 0, scale, fallbackScale, &gm);
-        curLineWidth += gm.advance + gm.kern;
-    }
-    if (curLineWidth > maxWidth) maxWidth = curLineWidth;
-
-    int ascent, descent, lineGap;
-    stbtt_GetFontVMetrics(&g_fontInfo, &ascent, &descent, &lineGap);
-    int lineHeight = (int)((ascent - descent + lineGap) * scale);
-
-    if (width) *width = maxWidth;
-    if (height) *height = lineCount * lineHeight;
-    
-    return TRUE;
-}
-
-void RenderTextSTB(void* bits, int width, int height, const wchar_t* text, 
-                   COLORREF color, int fontSize, float fontScale, BOOL editMode) {
-    if (!g_fontLoaded || !text || !bits) return;
-
-    float scale = stbtt_ScaleForPixelHeight(&g_fontInfo, (float)(fontSize * fontScale));
-    float fallbackScale = g_fallbackFontLoaded ? stbtt_ScaleForPixelHeight(&g_fallbackFontInfo, (float)(fontSize * fontScale)) : 0;
-    
-    int ascent, descent, lineGap;
-    stbtt_GetFontVMetrics(&g_fontInfo, &ascent, &descent, &lineGap);
-    int lineHeight = (int)((ascent - descent + lineGap) * scale);
-    int baselineOffset = (int)(ascent * scale);
-    
-    int r = GetRValue(color);
-    int g = GetGValue(color);
-    int b = GetBValue(color);
-
-    // Pre-calculate line widths for centering
-    // We can do a quick pass or re-use Measure logic per line
-    size_t len = wcslen(text);
-    int currentY = 0;
-    
-    // Calculate total text height to vertically center the whole block
-    int totalTextHeight = 0;
-    int numLines = 0;
-    {
-        int w, h;
-        MeasureTextSTB(text, (int)(fontSize * fontScale), &w, &h);
-        totalTextHeight = h;
-        numLines = (lineHeight > 0) ? (h / lineHeight) : 1;
-    }
-    
-    int startY = (height - totalTextHeight) / 2;
-    int currentLineStart = 0;
-    
-    for (size_t i = 0; i <= len; i++) {
-        if (text[i] == L'\n' || text[i] == L'\0') {
-            // Line complete, render it
-            int lineWidth = 0;
-            // Calculate width of this line
-            for (size_t j = currentLineStart; j < i; j++) {
-                if (text[j] == L'\r') continue;
-                GlyphMetrics gm;
-                GetCharMetricsSTB(text[j], (j < i - 1) ? text[j+1] : 0, scale, fallbackScale, &gm);
-                lineWidth += gm.advance + gm.kern;
-            }
-            
-            int currentX = (width - lineWidth) / 2;
-            int lineY = startY + currentY * lineHeight + baselineOffset;
-
-            // Render line
-            for (size_t j = currentLineStart; j < i; j++) {
-                if (text[j] == L'\r') continue;
-                
-                GlyphMetrics gm;
-                GetCharMetricsSTB(text[j], (j < i - 1) ? text[j+1] : 0, scale, fallbackScale, &gm);
-                
-                if (gm.index != 0 && text[j] != L' ' && text[j] != L'\t') {
-                    int w, h, xoff, yoff;
-                    unsigned char* bitmap = NULL;
-                    
-                    if (gm.isFallback) {
-                        bitmap = stbtt_GetGlyphBitmap(&g_fallbackFontInfo, fallbackScale, fallbackScale, gm.index, &w, &h, &xoff, &yoff);
-                    } else {
-                        bitmap = stbtt_GetGlyphBitmap(&g_fontInfo, scale, scale, gm.index, &w, &h, &xoff, &yoff);
-                    }
-                    
-                    if (bitmap) {
-                        BlendCharBitmapSTB(bits, width, height, currentX + xoff, lineY + yoff, bitmap, w, h, r, g, b);
-                        stbtt_FreeBitmap(bitmap, NULL);
-                    }
-                }
-                currentX += gm.advance + gm.kern;
-            }
-            
-            currentY++;
-            currentLineStart = i + 1;
-        }
-    }
-}
-
 /* ============================================================================
  * Font Cache Implementation for <font:> Tags
  * ============================================================================ */
@@ -823,6 +789,10 @@ static BOOL ResolveFontTagPath(const wchar_t* fontPath, char* outPath, size_t pa
 }
 
 void ClearFontCacheSTB(void) {
+    /* Glyph cache keys on face pointers, which are about to be reused */
+    GlyphCache_Clear();
+    TextLayout_Clear();
+    
     for (int i = 0; i < MAX_CACHED_FONTS; i++) {
         if (g_fontCache[i].isLoaded) {
             if (g_fontCache[i].fontBuffer) {
@@ -841,6 +811,20 @@ void ClearFontCacheSTB(void) {
     g_fontCacheAccessCounter = 0;
 }
 
+void SetDistanceFieldTextSTB(BOOL enabled) {
+    enabled = enabled ? TRUE : FALSE;
+    if (enabled == GlyphCache_IsDistanceField()) return;
+
+    /* Cached runs were composed from the other coverage */
+    GlyphCache_SetDistanceField(enabled);
+    EffectCache_Clear();
+    LOG_INFO("Distance field text %s", enabled ? "enabled" : "disabled");
+}
+
+BOOL IsDistanceFieldTextSTB(void) {
+    return GlyphCache_IsDistanceField();
+}
+
 /**
  * @brief Get cached font by file path
  * 
@@ -891,6 +875,7 @@ stbtt_fontinfo* GetCachedFontSTB(const wchar_t* fontPath) {
     
     /* Evict if necessary */
     if (g_fontCache[targetSlot].isLoaded) {
+        GlyphCache_InvalidateFace(&g_fontCache[targetSlot].fontInfo);
         if (g_fontCache[targetSlot].fontBuffer) {
             UnmapViewOfFile(g_fontCache[targetSlot].fontBuffer);
         }
@@ -0,0 +1,148 @@
+/**
+ * @file drawing_worker_pool.c
+ * @brief Band-parallel helper threads for effect passes
+ */
+
+#include "drawing/drawing_worker_pool.h"
+#include "log.h"
+
+/* Bands per thread; extra bands balance rows of uneven cost */
+#define BANDS_PER_THREAD 4
+
+static HANDLE g_threads[WORKER_POOL_MAX_THREADS];
+static HANDLE g_startEvents[WORKER_POOL_MAX_THREADS];
+static HANDLE g_doneEvent = NULL;
+static int g_workerCount = 0;
+static BOOL g_started = FALSE;
+static BOOL g_busy = FALSE;
+static volatile LONG g_quit = 0;
+
+/* Current pass (published by SetEvent, read after the wait) */
+static WorkerBandFn g_jobFn = NULL;
+static void* g_jobData = NULL;
+static int g_jobCount = 0;
+static int g_jobBands = 0;
+static volatile LONG g_nextBand = 0;
+static volatile LONG g_pendingWorkers = 0;
+
+static int DesiredWorkers(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int workers = (int)info.dwNumberOfProcessors - 1;
+    if (workers < 0) workers = 0;
+    if (workers > WORKER_POOL_MAX_THREADS) workers = WORKER_POOL_MAX_THREADS;
+    return workers;
+}
+
+static void RunBands(void) {
+    for (;;) {
+        LONG band = InterlockedIncrement(&g_nextBand) - 1;
+        if (band >= g_jobBands) break;
+        int begin = (int)((LONGLONG)g_jobCount * band / g_jobBands);
+        int end = (int)((LONGLONG)g_jobCount * (band + 1) / g_jobBands);
+        g_jobFn(begin, end, g_jobData);
+    }
+}
+
+static DWORD WINAPI WorkerThreadProc(LPVOID param) {
+    HANDLE startEvent = (HANDLE)param;
+    for (;;) {
+        WaitForSingleObject(startEvent, INFINITE);
+        if (g_quit) break;
+        RunBands();
+        if (InterlockedDecrement(&g_pendingWorkers) == 0) {
+            SetEvent(g_doneEvent);
+        }
+    }
+    return 0;
+}
+
+static void StartWorkers(void) {
+    g_started = TRUE;
+    g_quit = 0;
+
+    int desired = DesiredWorkers();
+    if (desired == 0) return;
+
+    g_doneEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!g_doneEvent) return;
+
+    for (int i = 0; i < desired; i++) {
+        HANDLE startEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+        if (!startEvent) break;
+        HANDLE thread = CreateThread(NULL, 0, WorkerThreadProc, startEvent, 0, NULL);
+        if (!thread) {
+            CloseHandle(startEvent);
+            break;
+        }
+        g_startEvents[g_workerCount] = startEvent;
+        g_threads[g_workerCount] = thread;
+        g_workerCount++;
+    }
+
+    LOG_INFO("Effect worker pool started with %d helper thread(s)", g_workerCount);
+}
+
+void WorkerPool_ParallelFor(int count, int grain, WorkerBandFn fn, void* userData) {
+    if (count <= 0 || !fn) return;
+    if (grain < 1) grain = 1;
+
+    if (!g_started) StartWorkers();
+
+    int bands = count / grain;
+    if (bands > (g_workerCount + 1) * BANDS_PER_THREAD) {
+        bands = (g_workerCount + 1) * BANDS_PER_THREAD;
+    }
+
+    if (bands <= 1 || g_workerCount == 0 || g_busy) {
+        fn(0, count, userData);
+        return;
+    }
+
+    int helpers = (bands - 1 < g_workerCount) ? bands - 1 : g_workerCount;
+
+    g_busy = TRUE;
+    g_jobFn = fn;
+    g_jobData = userData;
+    g_jobCount = count;
+    g_jobBands = bands;
+    g_nextBand = 0;
+    g_pendingWorkers = helpers;
+
+    for (int i = 0; i < helpers; i++) {
+        SetEvent(g_startEvents[i]);
+    }
+    RunBands();
+    WaitForSingleObject(g_doneEvent, INFINITE);
+
+    g_jobFn = NULL;
+    g_jobData = NULL;
+    g_busy = FALSE;
+}
+
+int WorkerPool_ThreadCount(void) {
+    return (g_started ? g_workerCount : DesiredWorkers()) + 1;
+}
+
+void WorkerPool_Shutdown(void) {
+    if (!g_started) return;
+
+    if (g_workerCount > 0) {
+        g_quit = 1;
+        for (int i = 0; i < g_workerCount; i++) {
+            SetEvent(g_startEvents[i]);
+        }
+        WaitForMultipleObjects((DWORD)g_workerCount, g_threads, TRUE, INFINITE);
+        for (int i = 0; i < g_workerCount; i++) {
+            CloseHandle(g_threads[i]);
+            CloseHandle(g_startEvents[i]);
+        }
+    }
+    if (g_doneEvent) {
+        CloseHandle(g_doneEvent);
+        g_doneEvent = NULL;
+    }
+
+    g_workerCount = 0;
+    g_started = FALSE;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file log_probe.c
+ * @brief Timing probe history and percentile dump
+ */
+
+#include <stdlib.h>
+#include "log/log_probe.h"
+#include "log.h"
+
+/* Each slot packs (stage + 1) in the top byte and the duration below it,
+ * so a single 64-bit exchange publishes a sample; 0 marks an empty slot */
+#define PROBE_STAGE_SHIFT 56
+#define PROBE_TICKS_MASK ((1ULL << PROBE_STAGE_SHIFT) - 1)
+
+static volatile LONG64 g_history[PROBE_HISTORY_SIZE];
+static volatile LONG g_next = 0;
+
+LONGLONG Probe_Now(void) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+void Probe_Record(ProbeStage stage, LONGLONG ticks) {
+    if ((unsigned)stage >= PROBE_STAGE_COUNT) return;
+    if (ticks < 0) ticks = 0;
+
+    ULONGLONG packed = ((ULONGLONG)(stage + 1) << PROBE_STAGE_SHIFT) |
+                       ((ULONGLONG)ticks & PROBE_TICKS_MASK);
+    LONG slot = (InterlockedIncrement(&g_next) - 1) & (PROBE_HISTORY_SIZE - 1);
+    InterlockedExchange64(&g_history[slot], (LONG64)packed);
+}
+
+#ifdef CATIME_PROBES
+
+static const char* const PROBE_STAGE_NAMES[PROBE_STAGE_COUNT] = {
+    [PROBE_PAINT_TOTAL]    = "paint total",
+    [PROBE_TIME_TEXT]      = "time text",
+    [PROBE_PLUGIN_SUBST]   = "plugin substitution",
+    [PROBE_MARKDOWN_PARSE] = "markdown parse",
+    [PROBE_MEASURE]        = "measure",
+    [PROBE_DIB_SETUP]      = "DIB setup",
+    [PROBE_RASTERIZE]      = "rasterize",
+    [PROBE_EFFECTS]        = "effects (per run)",
+    [PROBE_IMAGE_DRAW]     = "image draw",
+    [PROBE_HIT_REGIONS]    = "hit-region fill",
+    [PROBE_PRESENT]        = "UpdateLayeredWindow",
+    [PROBE_TRAY_ICON]      = "tray icon update",
+    [PROBE_PLUGIN_POLL]    = "plugin file poll",
+    [PROBE_INTERIM_SCALE]  = "interim scale",
+};
+
+static int CompareTicks(const void* a, const void* b) {
+    ULONGLONG x = *(const ULONGLONG*)a;
+    ULONGLONG y = *(const ULONGLONG*)b;
+    return (x > y) - (x < y);
+}
+
+/** Nearest-rank percentile of a sorted array */
+static ULONGLONG Percentile(const ULONGLONG* sorted, int count, int percent) {
+    int rank = (count * percent + 99) / 100;
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+void Probe_LogStats(void) {
+    ULONGLONG* samples = (ULONGLONG*)malloc(sizeof(ULONGLONG) * PROBE_HISTORY_SIZE);
+    ULONGLONG* durations = (ULONGLONG*)malloc(sizeof(ULONGLONG) * PROBE_HISTORY_SIZE);
+    if (!samples || !durations) {
+        free(samples);
+        free(durations);
+        return;
+    }
+
+    /* Slots are copied one atomic read at a time; writers keep running */
+    for (int i = 0; i < PROBE_HISTORY_SIZE; i++) {
+        samples[i] = (ULONGLONG)InterlockedCompareExchange64(&g_history[i], 0, 0);
+    }
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    double msPerTick = 1000.0 / (double)freq.QuadPart;
+
+    LOG_INFO("Timing probes (last %d samples, ms): stage: count p50 / p95 / p99 / max",
+             PROBE_HISTORY_SIZE);
+
+    for (int stage = 0; stage < PROBE_STAGE_COUNT; stage++) {
+        int count = 0;
+        for (int i = 0; i < PROBE_HISTORY_SIZE; i++) {
+            if ((samples[i] >> PROBE_STAGE_SHIFT) == (ULONGLONG)(stage + 1)) {
+                durations[count++] = samples[i] & PROBE_TICKS_MASK;
+            }
+        }
+        if (count == 0) continue;
+
+        qsort(durations, (size_t)count, sizeof(ULONGLONG), CompareTicks);
+        LOG_INFO("  %-20s %5d  %.3f / %.3f / %.3f / %.3f",
+                 PROBE_STAGE_NAMES[stage], count,
+                 Percentile(durations, count, 50) * msPerTick,
+                 Percentile(durations, count, 95) * msPerTick,
+                 Percentile(durations, count, 99) * msPerTick,
+                 durations[count - 1] * msPerTick);
+    }
+
+    free(samples);
+    free(durations);
+}
+
+#else
+
+void Probe_LogStats(void) {
+    LOG_INFO("Timing probes are not compiled into this build (configure with -DCATIME_PROBES=ON)");
+}
+
+#endif /* CATIME_PROBES */
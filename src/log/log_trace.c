@@ -0,0 +1,206 @@
+/**
+ * @file log_trace.c
+ * @brief Bounded trace ring and Chrome trace_event JSON writer
+ */
+
+#include <stdio.h>
+#include <wchar.h>
+#include "log/log_trace.h"
+#include "log/log_core.h"
+#include "log.h"
+
+#define TRACE_MAX_THREADS 64
+#define TRACE_FILE_NAME L"Catime_Trace.json"
+
+typedef struct {
+    volatile LONGLONG seq;  /* 0 while being written, else claim index + 1 */
+    LONG generation;        /* g_generation when the writer claimed the slot */
+    DWORD tid;
+    const char* name;
+    LONGLONG start;
+    LONGLONG duration;      /* -1 for instant events */
+} TraceEvent;
+
+typedef struct {
+    DWORD tid;
+    const char* name;
+} TraceThread;
+
+static TraceEvent g_events[TRACE_BUFFER_EVENTS];
+static volatile LONGLONG g_next = 0;  /* 64-bit: never wraps in practice */
+static volatile LONG g_generation = 0;     /* bumped on every restart */
+
+static TraceThread g_threads[TRACE_MAX_THREADS];
+static volatile LONG g_threadCount = 0;
+
+static volatile LONG g_enabled = 0;
+static BOOL g_configWants = FALSE;
+static BOOL g_sessionWants = FALSE;
+static LONGLONG g_origin = 0;
+
+static LONGLONG TraceNow(void) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static void Push(const char* name, LONGLONG start, LONGLONG duration) {
+    /* Read before claiming: a claim that races a restart keeps the old
+     * generation, and Trace_Save drops it */
+    LONG generation = g_generation;
+    LONGLONG index = InterlockedIncrement64(&g_next) - 1;
+    TraceEvent* ev = &g_events[index & (TRACE_BUFFER_EVENTS - 1)];
+
+    InterlockedExchange64(&ev->seq, 0);
+    ev->generation = generation;
+    ev->tid = GetCurrentThreadId();
+    ev->name = name;
+    ev->start = start;
+    ev->duration = duration;
+    InterlockedExchange64(&ev->seq, index + 1);
+}
+
+/** Start or stop recording to match the config and session requests */
+static void UpdateState(void) {
+    BOOL want = g_configWants || g_sessionWants;
+    if (want == (g_enabled != 0)) return;
+
+    if (want) {
+        /* Other threads may still be inside Push from the last session */
+        g_origin = TraceNow();
+        for (int i = 0; i < TRACE_BUFFER_EVENTS; i++) {
+            InterlockedExchange64(&g_events[i].seq, 0);
+        }
+        InterlockedExchange64(&g_next, 0);
+        InterlockedIncrement(&g_generation);
+        InterlockedExchange(&g_enabled, 1);
+        LOG_INFO("Tracing started (last %d events are kept)", TRACE_BUFFER_EVENTS);
+    } else {
+        InterlockedExchange(&g_enabled, 0);
+        Trace_Save();
+        LOG_INFO("Tracing stopped");
+    }
+}
+
+void Trace_Configure(BOOL enabled) {
+    g_configWants = enabled;
+    UpdateState();
+}
+
+void Trace_EnableForSession(void) {
+    g_sessionWants = TRUE;
+    UpdateState();
+}
+
+BOOL Trace_IsEnabled(void) {
+    return g_enabled != 0;
+}
+
+void Trace_NameThread(const char* name) {
+    DWORD tid = GetCurrentThreadId();
+    LONG count = g_threadCount;
+    if (count > TRACE_MAX_THREADS) count = TRACE_MAX_THREADS;
+
+    for (LONG i = 0; i < count; i++) {
+        if (g_threads[i].tid == tid) {
+            g_threads[i].name = name;
+            return;
+        }
+    }
+
+    LONG slot = InterlockedIncrement(&g_threadCount) - 1;
+    if (slot >= TRACE_MAX_THREADS) return;
+    g_threads[slot].tid = tid;
+    g_threads[slot].name = name;
+}
+
+LONGLONG Trace_Begin(void) {
+    if (!g_enabled) return 0;
+    return TraceNow();
+}
+
+void Trace_End(const char* name, LONGLONG start) {
+    if (!g_enabled || start == 0) return;
+    LONGLONG duration = TraceNow() - start;
+    Push(name, start, duration < 0 ? 0 : duration);
+}
+
+void Trace_Instant(const char* name) {
+    if (!g_enabled) return;
+    Push(name, TraceNow(), -1);
+}
+
+static void GetTraceFilePath(wchar_t* path, size_t size) {
+    GetLogFilePath(path, size);
+    wchar_t* lastSeparator = wcsrchr(path, L'\\');
+    wchar_t* fileName = lastSeparator ? lastSeparator + 1 : path;
+    size_t used = (size_t)(fileName - path);
+    _snwprintf_s(fileName, size - used, _TRUNCATE, TRACE_FILE_NAME);
+}
+
+BOOL Trace_Save(void) {
+    LONGLONG next = InterlockedCompareExchange64(&g_next, 0, 0);
+    if (next == 0) return FALSE;
+
+    wchar_t path[MAX_PATH];
+    GetTraceFilePath(path, MAX_PATH);
+    FILE* f = _wfopen(path, L"wb");
+    if (!f) {
+        LOG_WARNING("Trace: cannot write %ls", path);
+        return FALSE;
+    }
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    double usPerTick = 1000000.0 / (double)freq.QuadPart;
+    DWORD pid = GetCurrentProcessId();
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":0,\"args\":{\"name\":\"Catime\"}}",
+            (unsigned long)pid);
+
+    LONG threadCount = g_threadCount;
+    if (threadCount > TRACE_MAX_THREADS) threadCount = TRACE_MAX_THREADS;
+    for (LONG i = 0; i < threadCount; i++) {
+        if (!g_threads[i].name) continue;
+        fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+                (unsigned long)pid, (unsigned long)g_threads[i].tid, g_threads[i].name);
+    }
+
+    /* Oldest surviving event first; slots rewritten meanwhile are skipped,
+     * as are events from before the last restart (an older generation, or
+     * a span whose Trace_Begin predates g_origin) */
+    LONG generation = g_generation;
+    LONGLONG first = (next > TRACE_BUFFER_EVENTS) ? next - TRACE_BUFFER_EVENTS : 0;
+    int written = 0;
+    for (LONGLONG index = first; index < next; index++) {
+        TraceEvent* slot = &g_events[index & (TRACE_BUFFER_EVENTS - 1)];
+        if (InterlockedCompareExchange64(&slot->seq, 0, 0) != index + 1) continue;
+        TraceEvent ev = *slot;
+        if (InterlockedCompareExchange64(&slot->seq, 0, 0) != index + 1 || !ev.name) continue;
+        if (ev.generation != generation || ev.start < g_origin) continue;
+
+        double ts = (double)(ev.start - g_origin) * usPerTick;
+        if (ev.duration < 0) {
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%lu,\"tid\":%lu}",
+                    ev.name, ts, (unsigned long)pid, (unsigned long)ev.tid);
+        } else {
+            fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu}",
+                    ev.name, ts, (double)ev.duration * usPerTick,
+                    (unsigned long)pid, (unsigned long)ev.tid);
+        }
+        written++;
+    }
+
+    fputs("\n]}\n", f);
+    fclose(f);
+
+    LOG_INFO("Trace: wrote %d events to %ls (%lld recorded)", written, path, (long long)next);
+    return TRUE;
+}
+
+void Trace_Shutdown(void) {
+    if (!g_enabled) return;
+    InterlockedExchange(&g_enabled, 0);
+    Trace_Save();
+}
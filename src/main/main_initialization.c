@@ -11,6 +11,7 @@
 #include "main/main_initialization.h"
 #include "main/main_single_instance.h"
 #include "log.h"
+#include "log/log_trace.h"
 #include "config.h"
 #include "timer/timer.h"
 #include "timer/timer_events.h"
@@ -23,6 +24,7 @@
 #include "plugin/plugin_data.h"
 #include "plugin/plugin_manager.h"
 #include "drawing/drawing_image.h"
+#include "drawing/drawing_render.h"
 #include "markdown/markdown_interactive.h"
 #include "../resource/resource.h"
 #include <tlhelp32.h>
@@ -441,6 +443,8 @@ void InitializeDialogLanguages(void) {
 BOOL SetupMainWindow(HINSTANCE hInstance, HWND hwnd, int nCmdShow) {
     (void)nCmdShow; // Unused parameter
     
+    Trace_NameThread("UI");
+    
     // Initialize Plugin Data subsystem early - needed by CLI handlers and startup mode
     PluginData_Init(hwnd);
     PluginManager_SetNotifyWindow(hwnd);
@@ -463,6 +467,14 @@ BOOL SetupMainWindow(HINSTANCE hInstance, HWND hwnd, int nCmdShow) {
             wmemmove(pStartup, pStartup + len, wcslen(pStartup + len) + 1);
         }
         
+        /* --trace may accompany a timer argument; --trace-save is left for the CLI */
+        wchar_t* pTrace = wcsstr(cmdBuf, L"--trace");
+        if (pTrace && (pTrace[7] == L'\0' || pTrace[7] == L' ')) {
+            Trace_EnableForSession();
+            size_t len = wcslen(L"--trace");
+            wmemmove(pTrace, pTrace + len, wcslen(pTrace + len) + 1);
+        }
+        
         char* cmdUtf8 = WideToUtf8Alloc(lpCmdLineW);
         if (cmdUtf8) {
             LOG_INFO("Command line detected: %s", cmdUtf8);
@@ -563,6 +575,9 @@ void CleanupResources(HANDLE hMutex) {
     extern void CleanupPluginTrustCS(void);
     CleanupPluginTrustCS();
 
+    LOG_INFO("Releasing render back buffer");
+    CleanupDrawingRender();
+
     LOG_INFO("Shutting down GDI+");
     ShutdownDrawingImage();
 
@@ -578,5 +593,6 @@ void CleanupResources(HANDLE hMutex) {
     }
 
     CoUninitialize();
+    Trace_Shutdown();
     CleanupLogSystem();
 }
@@ -137,7 +137,8 @@ BOOL ParseList(const wchar_t** src, ParseState* state, wchar_t** dest,
     }
     
     // Check for unordered list: -, +, or * followed by space
-    BOOL isUnorderedList = (*p == L'-' || *p == L'+' || (*p == L'*' && *(p + 1) == L' '));
+    // (the marker and the space are consumed, so the space must be there)
+    BOOL isUnorderedList = (*p == L'-' || *p == L'+' || *p == L'*') && *(p + 1) == L' ';
     
     if (!isOrderedList && !isUnorderedList) return FALSE;
     
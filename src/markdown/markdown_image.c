@@ -7,6 +7,7 @@
 #include "drawing/drawing_image.h"
 #include "plugin/plugin_data.h"
 #include "log.h"
+#include "log/log_trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -277,9 +278,12 @@ typedef struct {
 
 static DWORD WINAPI AsyncDownloadThread(LPVOID param) {
     AsyncDownloadParams* p = (AsyncDownloadParams*)param;
+    Trace_NameThread("Image download");
     
     /* Download synchronously in background */
+    LONGLONG traceStart = Trace_Begin();
     DownloadImageToCache(p->url, p->cachePath);
+    Trace_End("Download image", traceStart);
     
     /* Remove from downloading list */
     RemoveDownloadingUrl(p->url);
@@ -9,211 +9,6 @@
 #include <stdio.h>
 #include <wchar.h>
 
-/* ============================================================================
- * Helper Functions
- * ============================================================================ */
-
-BOOL ExtractWideString(const wchar_t* start, const wchar_t* end, wchar_t** output) {
-    if (!start || !end || start >= end || !output) return FALSE;
-
-    size_t length = end - start;
-    *output = (wchar_t*)malloc((length + 1) * sizeof(wchar_t));
-    if (!*output) return FALSE;
-
-    wcsncpy(*output, start, length);
-    (*output)[length] = L'\0';
-    return TRUE;
-}
-
-/* ============================================================================
- * Pre-count Functions (for efficient allocation)
- * ============================================================================ */
-
-int CountMarkdownLinks(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-
-    while (*p) {
-        if (*p == L'[') {
-            const wchar_t* textEnd = wcschr(p + 1, L']');
-            if (textEnd && textEnd[1] == L'(' && wcschr(textEnd + 2, L')')) {
-                count++;
-            }
-        }
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownHeadings(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-    BOOL atLineStart = TRUE;
-
-    while (*p) {
-        if (atLineStart && *p == L'#') {
-            const wchar_t* hashEnd = p;
-            while (*hashEnd == L'#' && (hashEnd - p) < 6) {
-                hashEnd++;
-            }
-            if (*hashEnd == L' ' && (hashEnd - p) >= 1 && (hashEnd - p) <= 6) {
-                count++;
-            }
-        }
-        atLineStart = (*p == L'\n' || *p == L'\r');
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownStyles(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-
-    while (*p) {
-        if (*p == L'`') {
-            const wchar_t* end = p + 1;
-            while (*end && *end != L'`') end++;
-            if (*end == L'`' && end > p + 1) {
-                count++;
-                p = end;
-            }
-        } else if (*p == L'*' || *p == L'_') {
-            wchar_t marker = *p;
-            int markerCount = 0;
-            while (*p == marker && markerCount < 3) {
-                markerCount++;
-                p++;
-            }
-            if (markerCount > 0 && *p != L' ' && *p != L'\0') {
-                const wchar_t* searchStart = p;
-                for (int i = markerCount; i >= 1; i--) {
-                    const wchar_t* end = searchStart;
-                    while (*end) {
-                        if (*end == marker) {
-                            int endCount = 0;
-                            const wchar_t* endCheck = end;
-                            while (*endCheck == marker && endCount < i) {
-                                endCount++;
-                                endCheck++;
-                            }
-                            if (endCount == i && end > searchStart) {
-                                count++;
-                                p = endCheck - 1;
-                                break;
-                            }
-                        }
-                        end++;
-                    }
-                    if (*p != marker) break;
-                }
-            }
-        }
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownListItems(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-    BOOL atLineStart = TRUE;
-
-    while (*p) {
-        if (atLineStart) {
-            // Skip leading spaces
-            while (*p == L' ') p++;
-            // Unordered: -, *, +
-            if ((*p == L'-' || *p == L'*' || *p == L'+') && *(p + 1) == L' ') {
-                count++;
-            }
-            // Ordered: digit(s) + '.' + ' '
-            else {
-                const wchar_t* numCheck = p;
-                while (*numCheck >= L'0' && *numCheck <= L'9') numCheck++;
-                if (numCheck > p && *numCheck == L'.' && *(numCheck + 1) == L' ') {
-                    count++;
-                }
-            }
-        }
-        atLineStart = (*p == L'\n' || *p == L'\r');
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownBlockquotes(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-    BOOL atLineStart = TRUE;
-
-    while (*p) {
-        if (atLineStart && *p == L'>') {
-            count++;
-        }
-        atLineStart = (*p == L'\n' || *p == L'\r');
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownColorTags(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-
-    while (*p) {
-        if (wcsncmp(p, L"<color:", 7) == 0) {
-            const wchar_t* end = wcsstr(p, L"</color>");
-            if (end) {
-                count++;
-                p = end + 8;
-                continue;
-            }
-        }
-        p++;
-    }
-
-    return count;
-}
-
-int CountMarkdownFontTags(const wchar_t* input) {
-    if (!input) return 0;
-
-    int count = 0;
-    const wchar_t* p = input;
-
-    while (*p) {
-        if (wcsncmp(p, L"<font:", 6) == 0) {
-            const wchar_t* end = wcsstr(p, L"</font>");
-            if (end) {
-                count++;
-                p = end + 7;
-                continue;
-            }
-        }
-        p++;
-    }
-
-    return count;
-}
-
 /* ============================================================================
  * Inline Element Extractors
  * ============================================================================ */
@@ -355,13 +150,9 @@ BOOL ExtractMarkdownLink(const wchar_t** src, ParseState* state) {
     MarkdownLink* link = &state->links[state->linkCount];
 
     /* Store clean text (without markers) */
-    link->linkText = _wcsdup(cleanText);
-    if (!link->linkText) return FALSE;
-
-    if (!ExtractWideString(urlStart, actualUrlEnd, &link->linkUrl)) {
-        free(link->linkText);
-        return FALSE;
-    }
+    link->linkText = MarkdownArenaCopyString(state->arena, cleanText, (size_t)cleanLen);
+    link->linkUrl = MarkdownArenaCopyString(state->arena, urlStart, (size_t)urlLen);
+    if (!link->linkText || !link->linkUrl) return FALSE;
 
     link->startPos = state->currentPos;
     link->endPos = state->currentPos + cleanLen;
@@ -514,6 +305,27 @@ BOOL ExtractMarkdownStrikethrough(const wchar_t** src, ParseState* state) {
     return FALSE;
 }
 
+/**
+ * Style or strikethrough inside a color/font tag. A style whose closing
+ * marker lies past the tag's closing tag is rolled back; otherwise the
+ * tag would resume after its closing tag and copy that text twice.
+ */
+static BOOL ExtractNestedStyle(const wchar_t** src, const wchar_t* closeTag, ParseState* state,
+                               BOOL strikethrough) {
+    const wchar_t* start = *src;
+    int pos = state->currentPos;
+    int styleCount = state->styleCount;
+
+    BOOL ok = strikethrough ? ExtractMarkdownStrikethrough(src, state) : ExtractMarkdownStyle(src, state);
+    if (ok && *src > closeTag) {
+        *src = start;
+        state->currentPos = pos;
+        state->styleCount = styleCount;
+        return FALSE;
+    }
+    return ok;
+}
+
 /* Parse hex color from wide string: #RRGGBB -> COLORREF */
 static COLORREF ParseWideHexColor(const wchar_t* hex) {
     if (!hex || *hex != L'#') return RGB(0, 0, 0);
@@ -544,6 +356,8 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
     /* Extract color specification (between : and >) */
     int colorSpecLen = (int)(tagEnd - colorStart);
     if (colorSpecLen <= 0 || colorSpecLen >= 128) return FALSE;
+    /* A '<' means the '>' found belongs to a later tag, e.g. "<color:#</color>" */
+    if (wmemchr(colorStart, L'<', colorSpecLen)) return FALSE;
     
     wchar_t colorSpec[128];
     wcsncpy(colorSpec, colorStart, colorSpecLen);
@@ -551,7 +365,9 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
     
     if (!EnsureColorTagCapacity(state)) return FALSE;
     
-    MarkdownColorTag* tag = &state->colorTags[state->colorTagCount];
+    /* Nested tags may grow the arrays, so the record is re-fetched by index */
+    int tagIndex = state->colorTagCount;
+    MarkdownColorTag* tag = &state->colorTags[tagIndex];
     tag->startPos = state->currentPos;
     tag->colorCount = 0;
     
@@ -570,6 +386,7 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
     }
     
     if (tag->colorCount == 0) return FALSE;
+    state->colorTagCount++;
     
     /* Parse content (between > and </color>) - supports nested tags and styles */
     const wchar_t* contentSrc = tagEnd + 1;
@@ -590,7 +407,7 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
         
         /* Try Markdown styles (bold, italic, strikethrough) */
         if ((*contentSrc == L'*' || *contentSrc == L'_') && contentSrc + 1 < closeTag) {
-            if (ExtractMarkdownStyle(&contentSrc, state)) {
+            if (ExtractNestedStyle(&contentSrc, closeTag, state, FALSE)) {
                 dest = state->displayText + state->currentPos;
                 continue;
             }
@@ -598,7 +415,7 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
         
         /* Try strikethrough ~~text~~ */
         if (*contentSrc == L'~' && contentSrc + 1 < closeTag && *(contentSrc + 1) == L'~') {
-            if (ExtractMarkdownStrikethrough(&contentSrc, state)) {
+            if (ExtractNestedStyle(&contentSrc, closeTag, state, TRUE)) {
                 dest = state->displayText + state->currentPos;
                 continue;
             }
@@ -609,8 +426,7 @@ BOOL ExtractMarkdownColorTag(const wchar_t** src, ParseState* state) {
         state->currentPos++;
     }
     
-    tag->endPos = state->currentPos;
-    state->colorTagCount++;
+    state->colorTags[tagIndex].endPos = state->currentPos;
     
     *src = closeTag + 8;  /* Skip </color> */
     return TRUE;
@@ -635,10 +451,12 @@ BOOL ExtractMarkdownFontTag(const wchar_t** src, ParseState* state) {
     /* Extract font name (between : and >) */
     int fontNameLen = (int)(tagEnd - fontStart);
     if (fontNameLen <= 0 || fontNameLen >= MAX_FONT_NAME_LENGTH) return FALSE;
+    if (wmemchr(fontStart, L'<', fontNameLen)) return FALSE;
     
     if (!EnsureFontTagCapacity(state)) return FALSE;
     
-    MarkdownFontTag* tag = &state->fontTags[state->fontTagCount];
+    int tagIndex = state->fontTagCount;
+    MarkdownFontTag* tag = &state->fontTags[tagIndex];
     tag->startPos = state->currentPos;
     
     /* Copy font name */
@@ -655,6 +473,7 @@ BOOL ExtractMarkdownFontTag(const wchar_t** src, ParseState* state) {
     while (len > 0 && tag->fontName[len - 1] == L' ') {
         tag->fontName[--len] = L'\0';
     }
+    state->fontTagCount++;
     
     /* Parse content (between > and </font>) - supports nested tags and styles */
     const wchar_t* contentSrc = tagEnd + 1;
@@ -675,7 +494,7 @@ BOOL ExtractMarkdownFontTag(const wchar_t** src, ParseState* state) {
         
         /* Try Markdown styles (bold, italic, strikethrough) */
         if ((*contentSrc == L'*' || *contentSrc == L'_') && contentSrc + 1 < closeTag) {
-            if (ExtractMarkdownStyle(&contentSrc, state)) {
+            if (ExtractNestedStyle(&contentSrc, closeTag, state, FALSE)) {
                 dest = state->displayText + state->currentPos;
                 continue;
             }
@@ -683,7 +502,7 @@ BOOL ExtractMarkdownFontTag(const wchar_t** src, ParseState* state) {
         
         /* Try strikethrough ~~text~~ */
         if (*contentSrc == L'~' && contentSrc + 1 < closeTag && *(contentSrc + 1) == L'~') {
-            if (ExtractMarkdownStrikethrough(&contentSrc, state)) {
+            if (ExtractNestedStyle(&contentSrc, closeTag, state, TRUE)) {
                 dest = state->displayText + state->currentPos;
                 continue;
             }
@@ -694,8 +513,7 @@ BOOL ExtractMarkdownFontTag(const wchar_t** src, ParseState* state) {
         state->currentPos++;
     }
     
-    tag->endPos = state->currentPos;
-    state->fontTagCount++;
+    state->fontTags[tagIndex].endPos = state->currentPos;
     
     *src = closeTag + 7;  /* Skip </font> */
     return TRUE;
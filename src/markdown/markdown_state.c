@@ -15,13 +15,110 @@
 #define INITIAL_COLOR_TAG_CAPACITY 10
 #define INITIAL_FONT_TAG_CAPACITY 10
 
-/** Unified capacity management macro to eliminate code duplication */
-#define ENSURE_CAPACITY(state, type, field, count_field, capacity_field) \
+#define ARENA_ALIGN 16
+#define ARENA_MIN_CHUNK 4096
+#define ARENA_MAX_CHUNK (4 * 1024 * 1024)
+
+struct MarkdownArenaChunk {
+    MarkdownArenaChunk* prev;
+    size_t size;
+    size_t used;
+};
+
+#define ARENA_ALIGN_UP(n) (((n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_HEADER ARENA_ALIGN_UP(sizeof(MarkdownArenaChunk))
+#define ARENA_DATA(chunk) ((char*)(chunk) + ARENA_HEADER)
+
+/* ============================================================================
+ * Arena
+ * ============================================================================ */
+
+/** Chunks double with each one added, so a parse needs O(log n) mallocs */
+static BOOL AddArenaChunk(MarkdownArena* arena, size_t minBytes) {
+    int shift = arena->chunkCount < 10 ? arena->chunkCount : 10;
+    size_t size = (size_t)ARENA_MIN_CHUNK << shift;
+    if (size > ARENA_MAX_CHUNK) size = ARENA_MAX_CHUNK;
+    if (size < minBytes) size = minBytes;
+
+    MarkdownArenaChunk* chunk = (MarkdownArenaChunk*)malloc(ARENA_HEADER + size);
+    if (!chunk) return FALSE;
+    chunk->prev = arena->chunk;
+    chunk->size = size;
+    chunk->used = 0;
+    arena->chunk = chunk;
+    arena->chunkCount++;
+    return TRUE;
+}
+
+void* MarkdownArenaAlloc(MarkdownArena* arena, size_t bytes) {
+    if (!arena) return NULL;
+    bytes = ARENA_ALIGN_UP(bytes ? bytes : 1);
+
+    MarkdownArenaChunk* chunk = arena->chunk;
+    if (!chunk || chunk->size - chunk->used < bytes) {
+        if (!AddArenaChunk(arena, bytes)) return NULL;
+        chunk = arena->chunk;
+    }
+
+    void* block = ARENA_DATA(chunk) + chunk->used;
+    chunk->used += bytes;
+    return block;
+}
+
+/** Extends in place when block is the last allocation, otherwise copies */
+void* MarkdownArenaGrow(MarkdownArena* arena, void* block, size_t oldBytes, size_t newBytes) {
+    if (!block) return MarkdownArenaAlloc(arena, newBytes);
+
+    MarkdownArenaChunk* chunk = arena->chunk;
+    if (chunk) {
+        char* data = ARENA_DATA(chunk);
+        char* p = (char*)block;
+        if (p >= data && p + ARENA_ALIGN_UP(oldBytes) == data + chunk->used &&
+            (size_t)(p - data) + ARENA_ALIGN_UP(newBytes) <= chunk->size) {
+            chunk->used = (size_t)(p - data) + ARENA_ALIGN_UP(newBytes);
+            return block;
+        }
+    }
+
+    void* grown = MarkdownArenaAlloc(arena, newBytes);
+    if (!grown) return NULL;
+    memcpy(grown, block, oldBytes);
+    return grown;
+}
+
+wchar_t* MarkdownArenaCopyString(MarkdownArena* arena, const wchar_t* start, size_t length) {
+    wchar_t* copy = (wchar_t*)MarkdownArenaAlloc(arena, (length + 1) * sizeof(wchar_t));
+    if (!copy) return NULL;
+    if (length > 0) memcpy(copy, start, length * sizeof(wchar_t));
+    copy[length] = L'\0';
+    return copy;
+}
+
+void FreeMarkdownArena(MarkdownArena* arena) {
+    if (!arena) return;
+    MarkdownArenaChunk* chunk = arena->chunk;
+    while (chunk) {
+        MarkdownArenaChunk* prev = chunk->prev;
+        free(chunk);
+        chunk = prev;
+    }
+    arena->chunk = NULL;
+    arena->chunkCount = 0;
+}
+
+/* ============================================================================
+ * Element arrays
+ * ============================================================================ */
+
+/** Unified capacity management macro; arrays grow inside the parse arena */
+#define ENSURE_CAPACITY(state, type, field, count_field, capacity_field, initial) \
     do { \
         if (!state) return FALSE; \
         if ((state)->count_field < (state)->capacity_field) return TRUE; \
-        int newCapacity = (state)->capacity_field * 2; \
-        type* newArray = (type*)realloc((state)->field, newCapacity * sizeof(type)); \
+        int newCapacity = (state)->capacity_field ? (state)->capacity_field * 2 : (initial); \
+        type* newArray = (type*)MarkdownArenaGrow((state)->arena, (state)->field, \
+                                                  (size_t)(state)->capacity_field * sizeof(type), \
+                                                  (size_t)newCapacity * sizeof(type)); \
         if (!newArray) return FALSE; \
         (state)->field = newArray; \
         (state)->capacity_field = newCapacity; \
@@ -29,91 +126,40 @@
     } while(0)
 
 BOOL EnsureLinkCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownLink, links, linkCount, linkCapacity);
+    ENSURE_CAPACITY(state, MarkdownLink, links, linkCount, linkCapacity, INITIAL_LINK_CAPACITY);
 }
 
 BOOL EnsureHeadingCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownHeading, headings, headingCount, headingCapacity);
+    ENSURE_CAPACITY(state, MarkdownHeading, headings, headingCount, headingCapacity, INITIAL_HEADING_CAPACITY);
 }
 
 BOOL EnsureStyleCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownStyle, styles, styleCount, styleCapacity);
+    ENSURE_CAPACITY(state, MarkdownStyle, styles, styleCount, styleCapacity, INITIAL_STYLE_CAPACITY);
 }
 
 BOOL EnsureListItemCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownListItem, listItems, listItemCount, listItemCapacity);
+    ENSURE_CAPACITY(state, MarkdownListItem, listItems, listItemCount, listItemCapacity, INITIAL_LIST_ITEM_CAPACITY);
 }
 
 BOOL EnsureBlockquoteCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownBlockquote, blockquotes, blockquoteCount, blockquoteCapacity);
+    ENSURE_CAPACITY(state, MarkdownBlockquote, blockquotes, blockquoteCount, blockquoteCapacity, INITIAL_BLOCKQUOTE_CAPACITY);
 }
 
 BOOL EnsureColorTagCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownColorTag, colorTags, colorTagCount, colorTagCapacity);
+    ENSURE_CAPACITY(state, MarkdownColorTag, colorTags, colorTagCount, colorTagCapacity, INITIAL_COLOR_TAG_CAPACITY);
 }
 
 BOOL EnsureFontTagCapacity(ParseState* state) {
-    ENSURE_CAPACITY(state, MarkdownFontTag, fontTags, fontTagCount, fontTagCapacity);
+    ENSURE_CAPACITY(state, MarkdownFontTag, fontTags, fontTagCount, fontTagCapacity, INITIAL_FONT_TAG_CAPACITY);
 }
 
+/** Everything the state points to lives in its arena */
 void CleanupParseState(ParseState* state) {
     if (!state) return;
-
-    if (state->links) {
-        FreeMarkdownLinks(state->links, state->linkCount);
-        state->links = NULL;
-    }
-
-    if (state->headings) {
-        free(state->headings);
-        state->headings = NULL;
-    }
-
-    if (state->styles) {
-        free(state->styles);
-        state->styles = NULL;
-    }
-
-    if (state->listItems) {
-        free(state->listItems);
-        state->listItems = NULL;
-    }
-
-    if (state->blockquotes) {
-        free(state->blockquotes);
-        state->blockquotes = NULL;
-    }
-
-    if (state->colorTags) {
-        free(state->colorTags);
-        state->colorTags = NULL;
-    }
-
-    if (state->fontTags) {
-        free(state->fontTags);
-        state->fontTags = NULL;
-    }
-
-    if (state->displayText) {
-        free(state->displayText);
-        state->displayText = NULL;
-    }
-
-    state->linkCount = 0;
-    state->linkCapacity = 0;
-    state->headingCount = 0;
-    state->headingCapacity = 0;
-    state->styleCount = 0;
-    state->styleCapacity = 0;
-    state->listItemCount = 0;
-    state->listItemCapacity = 0;
-    state->blockquoteCount = 0;
-    state->blockquoteCapacity = 0;
-    state->colorTagCount = 0;
-    state->colorTagCapacity = 0;
-    state->fontTagCount = 0;
-    state->fontTagCapacity = 0;
-    state->currentPos = 0;
+    FreeMarkdownArena(state->arena);
+    MarkdownArena* arena = state->arena;
+    memset(state, 0, sizeof(*state));
+    state->arena = arena;
 }
 
 void FreeMarkdownLinks(MarkdownLink* links, int linkCount) {
@@ -225,31 +271,3 @@ BOOL HandleMarkdownClick(MarkdownLink* links, int linkCount, POINT clickPoint) {
     }
     return FALSE;
 }
-
-int GetInitialLinkCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_LINK_CAPACITY;
-}
-
-int GetInitialHeadingCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_HEADING_CAPACITY;
-}
-
-int GetInitialStyleCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_STYLE_CAPACITY;
-}
-
-int GetInitialListItemCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_LIST_ITEM_CAPACITY;
-}
-
-int GetInitialBlockquoteCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_BLOCKQUOTE_CAPACITY;
-}
-
-int GetInitialColorTagCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_COLOR_TAG_CAPACITY;
-}
-
-int GetInitialFontTagCapacity(int estimatedCount) {
-    return estimatedCount > 0 ? estimatedCount + 2 : INITIAL_FONT_TAG_CAPACITY;
-}
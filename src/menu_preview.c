@@ -14,6 +14,7 @@
 #include "timer/timer.h"
 #include "tray/tray_animation_core.h"
 #include "window/window_core.h"
+#include "drawing/drawing_frame_governor.h"
 #include "log.h"
 
 /* ============================================================================
@@ -261,6 +262,11 @@ EffectType GetActiveEffect(void) {
         return g_previewState.data.effect;
     }
     
+    /* Render budget exceeded even at the lowest effect resolution */
+    if (FrameGovernor_EffectsSuspended()) {
+        return EFFECT_TYPE_NONE;
+    }
+    
     /* Priority matches drawing_text_stb.c original logic */
     if (CLOCK_LIQUID_EFFECT) return EFFECT_TYPE_LIQUID;
     if (CLOCK_HOLOGRAPHIC_EFFECT) return EFFECT_TYPE_HOLOGRAPHIC;
@@ -5,9 +5,12 @@
 
 #include "plugin/plugin_data.h"
 #include "plugin/plugin_exit.h"
+#include "plugin/plugin_template.h"
 #include "notification.h"
 #include "../resource/resource.h"
 #include "log.h"
+#include "log/log_probe.h"
+#include "log/log_trace.h"
 #include <windows.h>
 #include <shlobj.h>
 #include <stdio.h>
@@ -21,6 +24,8 @@
 wchar_t* g_pluginDisplayText = NULL;
 size_t g_pluginDisplayTextLen = 0;
 BOOL g_hasPluginData = FALSE;
+/* Bumped under g_dataCS by every writer of the two fields above */
+DWORD g_pluginTextVersion = 0;
 
 /* ============================================================================
  * Internal State
@@ -36,6 +41,11 @@ static HANDLE g_hWatchThread = NULL;
 static HWND g_hNotifyWnd = NULL;
 static volatile BOOL g_isRunning = FALSE;
 
+/* Display text compiled for the paint thread, and the text version it reflects */
+static PluginTemplate g_template = {0};
+static DWORD g_templateVersion = 0;
+static BOOL g_templateValid = FALSE;
+
 /* Cache for change detection */
 static char* g_lastContent = NULL;
 static size_t g_lastContentSize = 0;
@@ -319,12 +329,14 @@ static BOOL ParseContent(const char* content, size_t contentLen) {
         /* Process <exit> tag - if countdown starts, set data flag and return */
         if (PluginExit_ParseTag(g_pluginDisplayText, &len, g_pluginDisplayTextLen)) {
             g_hasPluginData = TRUE;
+            g_pluginTextVersion++;
             LeaveCriticalSection(&g_dataCS);
             return TRUE;
         }
         
         g_hasPluginData = TRUE;
     }
+    g_pluginTextVersion++;
 
     LeaveCriticalSection(&g_dataCS);
     return len > 0;
@@ -378,6 +390,7 @@ static DWORD WINAPI FileWatcherThread(LPVOID lpParam) {
     }
     
     LOG_INFO("PluginData: Watching file %s", filePath);
+    Trace_NameThread("Plugin watcher");
 
     while (g_isRunning) {
         // Check if we need to force an update (reset cache)
@@ -388,6 +401,9 @@ static DWORD WINAPI FileWatcherThread(LPVOID lpParam) {
             }
         }
         
+        PROBE_START(pollStart);
+        LONGLONG tracePoll = Trace_Begin();
+
         // Use Win32 API for lower overhead (no CRT buffer)
         HANDLE hFile = CreateFileA(
             filePath,
@@ -431,7 +447,10 @@ static DWORD WINAPI FileWatcherThread(LPVOID lpParam) {
                                 memcpy(g_lastContent, currentContent, bytesRead + 1);
                             }
                             
-                            if (ParseContent(currentContent, bytesRead)) {
+                            LONGLONG traceParse = Trace_Begin();
+                            BOOL parsed = ParseContent(currentContent, bytesRead);
+                            Trace_End("Plugin ParseContent (holds g_dataCS)", traceParse);
+                            if (parsed) {
                                 // Notify main window to repaint immediately
                                 // Note: <exit> tag is now handled inside ParseContent
                                 if (g_hNotifyWnd) {
@@ -445,6 +464,8 @@ static DWORD WINAPI FileWatcherThread(LPVOID lpParam) {
             }
             CloseHandle(hFile);
         }
+        PROBE_END(PROBE_PLUGIN_POLL, pollStart);
+        Trace_End("Plugin file poll", tracePoll);
         
         // Dynamic poll frequency (controlled by <fps:N> tag, default 500ms)
         Sleep(g_pollIntervalMs);
@@ -507,6 +528,8 @@ void PluginData_Shutdown(void) {
         g_lastContent = NULL;
         g_lastContentSize = 0;
     }
+    PluginTemplate_Free(&g_template);
+    g_templateValid = FALSE;
     LeaveCriticalSection(&g_dataCS);
     
     DeleteCriticalSection(&g_dataCS);
@@ -518,7 +541,9 @@ BOOL PluginData_GetText(wchar_t* buffer, size_t maxLen) {
     if (!g_pluginDataInitialized) return FALSE;
 
     BOOL hasData = FALSE;
+    LONGLONG traceWait = Trace_Begin();
     EnterCriticalSection(&g_dataCS);
+    Trace_End("PluginData_GetText wait for g_dataCS", traceWait);
     
     if (g_pluginModeActive) {
         if (g_hasPluginData && g_pluginDisplayText && wcslen(g_pluginDisplayText) > 0) {
@@ -555,6 +580,7 @@ void PluginData_Clear(void) {
     if (g_pluginDisplayText) {
         g_pluginDisplayText[0] = L'\0';
     }
+    g_pluginTextVersion++;
     /* Clear any pending notification to prevent stale notifications */
     g_pendingNotify.pending = FALSE;
     LeaveCriticalSection(&g_dataCS);
@@ -579,6 +605,7 @@ void PluginData_SetText(const wchar_t* text) {
         wcscpy_s(g_pluginDisplayText, g_pluginDisplayTextLen, text);
         g_hasPluginData = TRUE;
         g_pluginModeActive = TRUE;
+        g_pluginTextVersion++;
     }
     
     LeaveCriticalSection(&g_dataCS);
@@ -602,6 +629,7 @@ void PluginData_SetActive(BOOL active) {
     if (!g_pluginDataInitialized) return;
     EnterCriticalSection(&g_dataCS);
     g_pluginModeActive = active;
+    g_pluginTextVersion++;
     if (active) {
         // When activating, force file watcher to re-read immediately
         g_forceNextUpdate = TRUE;
@@ -646,6 +674,29 @@ void PluginData_SetActive(BOOL active) {
     }
 }
 
+const PluginTemplate* PluginData_GetTemplate(void) {
+    if (!g_pluginDataInitialized) return NULL;
+
+    const PluginTemplate* result = NULL;
+    LONGLONG traceWait = Trace_Begin();
+    EnterCriticalSection(&g_dataCS);
+    Trace_End("PluginData_GetTemplate wait for g_dataCS", traceWait);
+
+    if (g_pluginModeActive) {
+        if (!g_templateValid || g_templateVersion != g_pluginTextVersion) {
+            /* Same text PluginData_GetText would return */
+            BOOL hasText = g_hasPluginData && g_pluginDisplayText && g_pluginDisplayText[0];
+            g_templateValid = PluginTemplate_Compile(&g_template,
+                                                     hasText ? g_pluginDisplayText : L"Loading...");
+            g_templateVersion = g_pluginTextVersion;
+        }
+        if (g_templateValid) result = &g_template;
+    }
+
+    LeaveCriticalSection(&g_dataCS);
+    return result;
+}
+
 BOOL PluginData_IsActive(void) {
     if (!g_pluginDataInitialized) return FALSE;
     BOOL active;
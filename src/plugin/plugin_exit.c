@@ -32,6 +32,7 @@ static CRITICAL_SECTION* g_dataCS = NULL;
 extern wchar_t* g_pluginDisplayText;
 extern size_t g_pluginDisplayTextLen;
 extern BOOL g_hasPluginData;
+extern DWORD g_pluginTextVersion;
 
 /* ============================================================================
  * Exit Countdown Thread
@@ -69,6 +70,7 @@ static DWORD WINAPI ExitCountdownThread(LPVOID lpParam) {
                 wcsncat_s(g_pluginDisplayText, totalLen, countdownNum, numLen);
                 if (g_exitSuffix) wcsncat_s(g_pluginDisplayText, totalLen, g_exitSuffix, suffixLen);
                 g_hasPluginData = TRUE;
+                g_pluginTextVersion++;
             }
             
             LeaveCriticalSection(g_dataCS);
@@ -0,0 +1,188 @@
+/**
+ * @file plugin_template.c
+ * @brief Single-pass plugin text compiler and per-frame time splicing
+ */
+
+#include "plugin/plugin_template.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CATIME_OPEN_TAG L"<catime>"
+#define CATIME_CLOSE_TAG L"</catime>"
+#define CATIME_CLOSE_TAG_LEN 9
+
+static BOOL AddSegment(PluginTemplate* tmpl, PluginSegmentType type, int start, int length) {
+    if (length <= 0 && type == PLUGIN_SEGMENT_LITERAL) return TRUE;
+
+    if (tmpl->segmentCount == tmpl->segmentCapacity) {
+        int newCapacity = tmpl->segmentCapacity ? tmpl->segmentCapacity * 2 : 16;
+        PluginSegment* grown = (PluginSegment*)realloc(tmpl->segments, newCapacity * sizeof(PluginSegment));
+        if (!grown) return FALSE;
+        tmpl->segments = grown;
+        tmpl->segmentCapacity = newCapacity;
+    }
+
+    PluginSegment* seg = &tmpl->segments[tmpl->segmentCount++];
+    seg->type = type;
+    seg->start = start;
+    seg->length = length;
+    if (type == PLUGIN_SEGMENT_IMAGE) tmpl->imageCount++;
+    if (type == PLUGIN_SEGMENT_TIME) tmpl->timeSlotCount++;
+    return TRUE;
+}
+
+/**
+ * @brief Next complete <catime>...</catime> pair at or after p
+ * @note Without a closing tag after the first opening tag no later pair
+ *       can exist, so both pointers come back NULL
+ */
+static void FindTimeTag(const wchar_t* p, const wchar_t** open, const wchar_t** close) {
+    *open = wcsstr(p, CATIME_OPEN_TAG);
+    *close = *open ? wcsstr(*open, CATIME_CLOSE_TAG) : NULL;
+    if (!*close) *open = NULL;
+}
+
+/** @brief Length of the image syntax at p, 0 if ExtractMarkdownImage would reject it */
+static int MeasureImage(const wchar_t* p) {
+    MarkdownImage probe;
+    const wchar_t* end = p;
+    int count = 0;
+    if (!ExtractMarkdownImage(&end, &probe, &count, 1, 0)) return 0;
+    free(probe.imagePath);
+    return (int)(end - p);
+}
+
+BOOL PluginTemplate_Compile(PluginTemplate* tmpl, const wchar_t* text) {
+    if (!tmpl) return FALSE;
+    if (!text) text = L"";
+
+    tmpl->segmentCount = 0;
+    tmpl->imageCount = 0;
+    tmpl->timeSlotCount = 0;
+
+    int length = (int)wcslen(text);
+    if (!tmpl->source || tmpl->sourceLength < length) {
+        wchar_t* grown = (wchar_t*)realloc(tmpl->source, (length + 1) * sizeof(wchar_t));
+        if (!grown) {
+            tmpl->sourceLength = 0;
+            return FALSE;
+        }
+        tmpl->source = grown;
+    }
+    memcpy(tmpl->source, text, (length + 1) * sizeof(wchar_t));
+    tmpl->sourceLength = length;
+
+    const wchar_t* base = tmpl->source;
+    const wchar_t* p = base;
+    const wchar_t* literal = base;
+    const wchar_t* open;
+    const wchar_t* close;
+    FindTimeTag(p, &open, &close);
+
+    /* Tag search restarts only after a tag is consumed, so the scan is linear */
+    while (*p) {
+        if (p == open) {
+            if (!AddSegment(tmpl, PLUGIN_SEGMENT_LITERAL, (int)(literal - base), (int)(p - literal)) ||
+                !AddSegment(tmpl, PLUGIN_SEGMENT_TIME, (int)(p - base),
+                            (int)(close + CATIME_CLOSE_TAG_LEN - p))) {
+                goto fail;
+            }
+            p = close + CATIME_CLOSE_TAG_LEN;
+            literal = p;
+            FindTimeTag(p, &open, &close);
+            continue;
+        }
+
+        if (p[0] == L'!' && p[1] == L'[') {
+            int imageLength = MeasureImage(p);
+            if (imageLength > 0) {
+                if (!AddSegment(tmpl, PLUGIN_SEGMENT_LITERAL, (int)(literal - base), (int)(p - literal)) ||
+                    !AddSegment(tmpl, PLUGIN_SEGMENT_IMAGE, (int)(p - base), imageLength)) {
+                    goto fail;
+                }
+                p += imageLength;
+                literal = p;
+                /* The image may have swallowed the opening tag */
+                if (open && open < p) FindTimeTag(p, &open, &close);
+                continue;
+            }
+        }
+        p++;
+    }
+
+    if (!AddSegment(tmpl, PLUGIN_SEGMENT_LITERAL, (int)(literal - base), (int)(p - literal))) {
+        goto fail;
+    }
+    return TRUE;
+
+fail:
+    tmpl->segmentCount = 0;
+    tmpl->imageCount = 0;
+    tmpl->timeSlotCount = 0;
+    return FALSE;
+}
+
+int PluginTemplate_Expand(const PluginTemplate* tmpl, const wchar_t* timeText,
+                          wchar_t* out, size_t outLen,
+                          MarkdownImage* images, int* imageCount,
+                          PluginTextRange* timeRanges, int timeRangeCapacity, int* timeRangeCount) {
+    if (imageCount) *imageCount = 0;
+    if (timeRangeCount) *timeRangeCount = 0;
+    if (!out || outLen == 0) return 0;
+    out[0] = L'\0';
+    if (!tmpl || !tmpl->source) return 0;
+
+    size_t timeLength = timeText ? wcslen(timeText) : 0;
+    size_t written = 0;
+    size_t remaining = outLen - 1;
+    int extracted = 0;
+    int ranges = 0;
+
+    for (int i = 0; i < tmpl->segmentCount; i++) {
+        const PluginSegment* seg = &tmpl->segments[i];
+        const wchar_t* from = NULL;
+        size_t count = 0;
+
+        switch (seg->type) {
+            case PLUGIN_SEGMENT_LITERAL:
+                from = tmpl->source + seg->start;
+                count = (size_t)seg->length;
+                break;
+            case PLUGIN_SEGMENT_TIME:
+                from = timeText;
+                count = timeLength;
+                break;
+            case PLUGIN_SEGMENT_IMAGE:
+                /* Nothing past a full buffer is shown, images included */
+                if (images && remaining > 0 && extracted < tmpl->imageCount) {
+                    const wchar_t* src = tmpl->source + seg->start;
+                    ExtractMarkdownImage(&src, images, &extracted, tmpl->imageCount, (int)written);
+                }
+                continue;
+        }
+
+        if (count > remaining) count = remaining;
+        if (seg->type == PLUGIN_SEGMENT_TIME && count > 0 && timeRanges && ranges < timeRangeCapacity) {
+            timeRanges[ranges].start = (int)written;
+            timeRanges[ranges].length = (int)count;
+            ranges++;
+        }
+        if (count > 0) {
+            memcpy(out + written, from, count * sizeof(wchar_t));
+            written += count;
+            remaining -= count;
+        }
+    }
+
+    out[written] = L'\0';
+    if (imageCount) *imageCount = extracted;
+    if (timeRangeCount) *timeRangeCount = ranges;
+    return (int)written;
+}
+
+void PluginTemplate_Free(PluginTemplate* tmpl) {
+    if (!tmpl) return;
+    free(tmpl->source);
+    free(tmpl->segments);
+    memset(tmpl, 0, sizeof(*tmpl));
+}
@@ -8,6 +8,7 @@
 
 #include "timer/main_timer.h"
 #include "../../resource/resource.h"
+#include "log/log_trace.h"
 #include <mmsystem.h>
 
 #pragma comment(lib, "winmm.lib")
@@ -26,6 +27,11 @@ static void CALLBACK MainTimerCallback(UINT uTimerID, UINT uMsg,
                                        DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2) {
     (void)uTimerID; (void)uMsg; (void)dwUser; (void)dw1; (void)dw2;
     
+    if (Trace_IsEnabled()) {
+        Trace_NameThread("MM timer");
+        Trace_Instant("Main timer tick");
+    }
+    
     if (g_mainHwnd && IsWindow(g_mainHwnd)) {
         PostMessage(g_mainHwnd, CLOCK_WM_MAIN_TIMER_TICK, 0, 0);
     }
@@ -17,6 +17,7 @@
 #include "config.h"
 #include "window.h"
 #include "drawing.h"
+#include "drawing/drawing_frame_governor.h"
 #include "audio_player.h"
 #include "drag_scale.h"
 #include "tray/tray_animation_core.h"
@@ -220,6 +221,7 @@ static BOOL HandleFontValidation(HWND hwnd) {
 
 static BOOL HandleForceRedraw(HWND hwnd) {
     KillTimer(hwnd, TIMER_ID_FORCE_REDRAW);
+        InvalidateRenderedFrame();
         ShowWindow(hwnd, SW_SHOWNOACTIVATE);
         SetWindowPos(hwnd, HWND_TOP, 0, 0, 0, 0,
                      SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_SHOWWINDOW);
@@ -469,11 +471,9 @@ static BOOL HandleMainTimer(HWND hwnd) {
     DWORD now_tick = GetTickCount();
     BOOL shouldRender = TRUE;
     
-    if (CLOCK_HOLOGRAPHIC_EFFECT) {
-        RECT rect;
-        GetClientRect(hwnd, &rect);
-        int pixels = rect.right * rect.bottom;
-        DWORD minInterval = (pixels < 30000) ? 0 : (pixels < 100000) ? 50 : (pixels < 300000) ? 100 : 150;
+    /* Expensive effect frames are spaced to fit the render CPU budget */
+    if (CLOCK_TEXT_EFFECT != TEXT_EFFECT_NONE) {
+        DWORD minInterval = FrameGovernor_FrameSpacing();
         if (minInterval > 0 && (now_tick - s_lastRenderTime) < minInterval) shouldRender = FALSE;
     }
     
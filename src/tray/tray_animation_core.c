@@ -15,6 +15,8 @@
 #include "timer/timer.h"
 #include "tray/tray.h"
 #include "log.h"
+#include "log/log_probe.h"
+#include "log/log_trace.h"
 #include "../resource/resource.h"
 #include <shellapi.h>
 #include <string.h>
@@ -181,9 +183,9 @@ static UINT ComputeScaledDelay(UINT baseDelay) {
 }
 
 /**
- * @brief Update tray icon to current frame (UI thread only)
+ * @brief Push the current frame (or generated icon) to the tray
  */
-static void UpdateTrayIconToCurrentFrame(void) {
+static void ApplyCurrentTrayFrame(void) {
     if (!g_trayHwnd || !IsWindow(g_trayHwnd)) return;
     
     if (g_criticalSectionInitialized) {
@@ -318,6 +320,17 @@ static void UpdateTrayIconToCurrentFrame(void) {
     }
 }
 
+/**
+ * @brief Update tray icon to current frame (UI thread only)
+ */
+static void UpdateTrayIconToCurrentFrame(void) {
+    PROBE_START(trayStart);
+    LONGLONG traceStart = Trace_Begin();
+    ApplyCurrentTrayFrame();
+    Trace_End("Tray icon update", traceStart);
+    PROBE_END(PROBE_TRAY_ICON, trayStart);
+}
+
 /**
  * @brief Request tray update (thread-safe)
  */
@@ -635,6 +648,7 @@ static DWORD WINAPI AsyncLoadPreviewThread(LPVOID param) {
     }
 
     WriteLog(LOG_LEVEL_INFO, "AsyncLoadPreviewThread: loading '%s'", name);
+    Trace_NameThread("Tray animation loader");
 
     LoadedAnimation tempAnim;
     LoadedAnimation_Init(&tempAnim);
@@ -642,7 +656,9 @@ static DWORD WINAPI AsyncLoadPreviewThread(LPVOID param) {
     int cx = GetSystemMetrics(SM_CXSMICON);
     int cy = GetSystemMetrics(SM_CYSMICON);
 
+    LONGLONG traceStart = Trace_Begin();
     LoadAnimationByName(name, &tempAnim, g_memoryPool, cx, cy);
+    Trace_End("Load tray animation", traceStart);
 
     WriteLog(LOG_LEVEL_INFO, "AsyncLoadPreviewThread: loaded count=%d sourceType=%d",
              tempAnim.count, tempAnim.sourceType);
@@ -4,6 +4,7 @@
  */
 
 #include "tray/tray_animation_timer.h"
+#include "log/log_trace.h"
 #include <mmsystem.h>
 
 #pragma comment(lib, "winmm.lib")
@@ -119,7 +120,10 @@ static void CALLBACK MMTimerCallback(UINT uTimerID, UINT uMsg,
     (void)uTimerID; (void)uMsg; (void)dwUser; (void)dw1; (void)dw2;
     
     if (g_callback) {
+        if (Trace_IsEnabled()) Trace_NameThread("MM timer");
+        LONGLONG traceStart = Trace_Begin();
         g_callback(g_userData);
+        Trace_End("Tray animation tick", traceStart);
     }
 }
 
@@ -4,6 +4,7 @@
  */
 
 #include "window/window_visual_effects.h"
+#include "drawing/drawing_render.h"
 #include "log.h"
 #include <dwmapi.h>
 
@@ -132,7 +133,8 @@ void UpdateClickThroughState(HWND hwnd) {
     
     LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
     
-    if (region) {
+    /* A scrolling viewport takes the mouse everywhere, for the wheel */
+    if (region || IsRenderedTextScrollable()) {
         /* Mouse over clickable region - remove WS_EX_TRANSPARENT to allow clicks */
         if (g_currentlyTransparent) {
             exStyle &= ~WS_EX_TRANSPARENT;
@@ -12,6 +12,8 @@
 #include "tray/tray_events.h"
 #include "window_procedure/window_events.h"
 #include "drag_scale.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_frame_governor.h"
 #include "timer/timer.h"
 #include "window.h"
 #include "config.h"
@@ -76,41 +78,14 @@ static LRESULT CmdToggleTopmost(HWND hwnd, WPARAM wp, LPARAM lp) {
     return 0;
 }
 
-/* Adaptive frame interval based on window size to prevent mouse lag */
-static UINT GetAdaptiveAnimationInterval(HWND hwnd) {
-    RECT rect;
-    GetClientRect(hwnd, &rect);
-    int pixels = rect.right * rect.bottom;
-    
-    /* 
-     * Larger windows need longer intervals to avoid blocking DWM.
-     * UpdateLayeredWindow is synchronous and blocks until DWM composites.
-     * 
-     * Holographic effect is significantly heavier (double Gaussian blur + 
-     * per-pixel HSV conversion) and needs more aggressive throttling.
-     */
-    if (CLOCK_HOLOGRAPHIC_EFFECT) {
-        if (pixels < 30000) return 50;
-        if (pixels < 100000) return 80;
-        if (pixels < 300000) return 120;
-        return 200;
-    }
-    
-    /* Standard thresholds for other effects */
-    if (pixels < 50000) return 33;
-    if (pixels < 200000) return 50;
-    if (pixels < 500000) return 80;
-    return 120;
-}
-
 static void UpdateAnimationTimer(HWND hwnd) {
     /*
-     * Temporal Decoupling: Animated effects use a dedicated timer
+     * Temporal Decoupling: Time-dependent effects use a dedicated timer
      * to drive visual flow independently of the 1FPS logic clock.
-     * Interval is adaptive to window size to prevent mouse lag.
+     * The frame governor paces it from measured paint cost.
      */
-    if (CLOCK_TEXT_EFFECT != TEXT_EFFECT_NONE) {
-        UINT interval = GetAdaptiveAnimationInterval(hwnd);
+    if (IsEffectTimeDependent(GetActiveEffect())) {
+        UINT interval = FrameGovernor_AnimationInterval();
         SetTimer(hwnd, TIMER_ID_RENDER_ANIMATION, interval, NULL);
     } else {
         KillTimer(hwnd, TIMER_ID_RENDER_ANIMATION);
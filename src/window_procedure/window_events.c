@@ -7,6 +7,9 @@
 #include "tray/tray.h"
 #include "config.h"
 #include "drag_scale.h"
+#include "drawing/drawing_effect.h"
+#include "drawing/drawing_worker_pool.h"
+#include "drawing/drawing_frame_governor.h"
 #include "window_procedure/window_events.h"
 #include "window_procedure/window_utils.h"
 #include "window_procedure/ole_drop_target.h"
@@ -45,25 +48,10 @@ BOOL HandleWindowCreate(HWND hwnd) {
     InitializeOleDropTarget(hwnd);
     LOG_INFO("OLE Drag and drop enabled (requires Edit Mode if Click-Through is active)");
 
-    /* Start Animation Timer if effects are active (Fixes startup animation issue) */
-    /* Use adaptive interval based on window size to prevent mouse lag */
-    if (CLOCK_LIQUID_EFFECT || CLOCK_HOLOGRAPHIC_EFFECT || 
-        CLOCK_NEON_EFFECT || CLOCK_GLOW_EFFECT || CLOCK_GLASS_EFFECT) {
-        RECT rect;
-        GetClientRect(hwnd, &rect);
-        int pixels = rect.right * rect.bottom;
-        
-        /* Holographic effect needs more aggressive throttling */
-        UINT interval;
-        if (CLOCK_HOLOGRAPHIC_EFFECT) {
-            interval = (pixels < 30000) ? 50 : 
-                       (pixels < 100000) ? 80 : 
-                       (pixels < 300000) ? 120 : 200;
-        } else {
-            interval = (pixels < 50000) ? 33 : 
-                       (pixels < 200000) ? 50 : 
-                       (pixels < 500000) ? 80 : 120;
-        }
+    /* Start Animation Timer if the effect animates (Fixes startup animation issue) */
+    /* Interval comes from measured paint cost to prevent mouse lag */
+    if (IsEffectTimeDependent(GetActiveEffect())) {
+        UINT interval = FrameGovernor_AnimationInterval();
         SetTimer(hwnd, TIMER_ID_RENDER_ANIMATION, interval, NULL); 
         LOG_INFO("Animation render timer started (adaptive interval: %ums)", interval);
     }
@@ -124,6 +112,9 @@ void HandleWindowDestroy(HWND hwnd) {
     } else {
         LOG_INFO("Font resources unloaded");
     }
+
+    WorkerPool_Shutdown();
+    LOG_INFO("Effect worker pool stopped");
     
     CleanupUpdateThread();
     LOG_INFO("Update checker thread cleaned up");
@@ -117,6 +117,13 @@ LRESULT HandleLButtonUp(HWND hwnd, WPARAM wp, LPARAM lp) {
 LRESULT HandleMouseWheel(HWND hwnd, WPARAM wp, LPARAM lp) {
     (void)lp;
     int delta = GET_WHEEL_DELTA_WPARAM(wp);
+
+    /* Overflowing text scrolls; in edit mode the plain wheel keeps scaling */
+    BOOL shiftDown = (GET_KEYSTATE_WPARAM(wp) & MK_SHIFT) != 0;
+    if ((!CLOCK_EDIT_MODE || shiftDown) && ScrollRenderedText(hwnd, TEXT_SCROLL_WHEEL, delta)) {
+        return 0;
+    }
+
     HandleScaleWindow(hwnd, delta);
     return 0;
 }
@@ -262,8 +269,31 @@ LRESULT HandleLButtonDblClk(HWND hwnd, WPARAM wp, LPARAM lp) {
     return DefWindowProc(hwnd, WM_LBUTTONDBLCLK, wp, lp);
 }
 
+/**
+ * @brief Scrolling meaning of a key, if it has one
+ * @note Up/Down move the window in edit mode, so they only scroll outside it
+ */
+static BOOL GetScrollKey(WPARAM key, TextScrollUnit* unit, int* amount) {
+    switch (key) {
+        case VK_PRIOR: *unit = TEXT_SCROLL_PAGES; *amount = -1; return TRUE;
+        case VK_NEXT:  *unit = TEXT_SCROLL_PAGES; *amount = 1;  return TRUE;
+        case VK_HOME:  *unit = TEXT_SCROLL_EDGE;  *amount = -1; return TRUE;
+        case VK_END:   *unit = TEXT_SCROLL_EDGE;  *amount = 1;  return TRUE;
+        case VK_UP:    *unit = TEXT_SCROLL_LINES; *amount = -1; return !CLOCK_EDIT_MODE;
+        case VK_DOWN:  *unit = TEXT_SCROLL_LINES; *amount = 1;  return !CLOCK_EDIT_MODE;
+        default: return FALSE;
+    }
+}
+
 LRESULT HandleKeyDown(HWND hwnd, WPARAM wp, LPARAM lp) {
     (void)lp;
+    TextScrollUnit scrollUnit;
+    int scrollAmount;
+    if (GetScrollKey(wp, &scrollUnit, &scrollAmount) &&
+        ScrollRenderedText(hwnd, scrollUnit, scrollAmount)) {
+        return 0;
+    }
+
     if (CLOCK_EDIT_MODE) {
         /* Only process arrow keys in edit mode */
         if (wp != VK_UP && wp != VK_DOWN && wp != VK_LEFT && wp != VK_RIGHT) {